@@ -31,6 +31,49 @@
 # MODULE_ENABLED_FEATURES = "list;of;enabled;features;for;this;module" (used by fd-net-device)
 # cmake-format: on
 
+# Set NS_LOG_CEILING for the sources of a module, from NS3_LOG_CEILINGS
+#
+# The entry of the module wins over the * entry.  The level is one of none,
+# error, warn, debug, info, function, logic or all: the log statements of the
+# levels above it are compiled out.
+function(set_log_ceiling target module)
+  set(ceiling)
+  set(default)
+  foreach(entry ${NS3_LOG_CEILINGS})
+    string(REPLACE "=" ";" entry "${entry}")
+    list(LENGTH entry length)
+    if(NOT (${length} EQUAL 2))
+      message(FATAL_ERROR "NS3_LOG_CEILINGS: expected module=level, got ${entry}")
+    endif()
+    list(GET entry 0 entry_module)
+    list(GET entry 1 level)
+    if("${entry_module}" STREQUAL "${module}")
+      set(ceiling ${level})
+    elseif("${entry_module}" STREQUAL "*")
+      set(default ${level})
+    endif()
+  endforeach()
+  if(NOT ceiling)
+    set(ceiling ${default})
+  endif()
+  if(NOT ceiling)
+    return()
+  endif()
+
+  set(levels none error warn debug info function logic all)
+  if(NOT (${ceiling} IN_LIST levels))
+    message(FATAL_ERROR "NS3_LOG_CEILINGS: unknown log level ${ceiling}")
+  endif()
+  string(TOUPPER ${ceiling} ceiling)
+  if(${ceiling} STREQUAL "NONE")
+    set(mask ns3::LOG_NONE)
+  else()
+    set(mask ns3::LOG_LEVEL_${ceiling})
+  endif()
+  message(STATUS "Log ceiling of ${module}: ${mask}")
+  target_compile_definitions(${target} PRIVATE NS_LOG_CEILING=${mask})
+endfunction()
+
 function(build_lib)
   # Argument parsing
   set(options IGNORE_PCH)
@@ -93,6 +136,12 @@ function(build_lib)
 
   add_library(ns3::${lib${BLIB_LIBNAME}} ALIAS ${lib${BLIB_LIBNAME}})
 
+  if(NOT ${XCODE})
+    set_log_ceiling(${lib${BLIB_LIBNAME}-obj} ${BLIB_LIBNAME})
+  else()
+    set_log_ceiling(${lib${BLIB_LIBNAME}} ${BLIB_LIBNAME})
+  endif()
+
   # Associate public headers with library for installation purposes
   if("${BLIB_LIBNAME}" STREQUAL "core")
     set(config_headers ${CMAKE_HEADER_OUTPUT_DIRECTORY}/config-store-config.h
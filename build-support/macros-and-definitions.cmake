@@ -925,6 +925,13 @@ macro(process_options)
     endif()
   endif()
 
+  # Reference counts and packet bookkeeping become thread-safe
+  set(ENABLE_MTP FALSE)
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+    set(ENABLE_MTP TRUE)
+  endif()
+
   mark_as_advanced(Boost_INCLUDE_DIR)
   find_package(Boost)
   if(${Boost_FOUND})
@@ -1209,6 +1216,10 @@ macro(process_options)
   if(${NS3_ASSERT} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_ASSERT_ENABLE)
   endif()
+  # The sanitizers only see the chunks of the event pool, not the events
+  if(${NS3_EVENT_POOL} AND NOT (${NS3_SANITIZE} OR ${NS3_SANITIZE_MEMORY}))
+    add_definitions(-DNS3_EVENT_POOL_ENABLE)
+  endif()
 
   set(ENABLE_TAP OFF)
   if(${NS3_TAP})
@@ -1238,6 +1249,10 @@ macro(process_options)
     list(REMOVE_ITEM libs_to_build mpi)
   endif()
 
+  if(NOT ${ENABLE_MTP})
+    list(REMOVE_ITEM libs_to_build mtp)
+  endif()
+
   if(NOT ${ENABLE_VISUALIZER})
     list(REMOVE_ITEM libs_to_build visualizer)
   endif()
@@ -0,0 +1,515 @@
+#include "ns3/applications-module.h"
+#include "ns3/ccn-content-store.h"
+#include "ns3/ccn-pipelined-consumer-app.h"
+#include "ns3/ccn-producer-app.h"
+#include "ns3/ccn-zipf-consumer-app.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+// set log
+NS_LOG_COMPONENT_DEFINE("CCNBenchmark");
+
+/**
+ * Caching benchmark for the hop-by-hop CCN stack.
+ *
+ * Sweeps topology, forwarding strategy, catalog size, content store size
+ * and replacement policy. One producer serves the whole catalog, every
+ * consumer requests objects with Zipf popularity. Each combination is a separate simulation,
+ * results are printed as one CSV line per run:
+ *
+ *   topology,strategy,nodes,catalog,cache,policy,interests,satisfied,
+ *   hit_ratio,avg_hops,avg_latency_ms,throughput_mbps,events,wall_s,
+ *   events_per_s
+ *
+ * Topologies:
+ *   rir   the five RIR nodes on a ring, producer at APNIC
+ *   ring  a ring of TopologySize nodes, producer at node 0
+ *   tree     a complete binary tree of TopologySize levels, producer at the
+ *            root and consumers at the leaves
+ *   diamond  TopologySize consumers behind an access router, joined to the
+ *            producer by two disjoint core paths of two links running at
+ *            the Bottleneck rate
+ *
+ * On the rings and the diamond every node lists its neighbors, but the
+ * consumer leaves, as FIB next hops of the catalog, the IP next hop towards
+ * the producer with the lower cost, so the BestRoute strategy follows the
+ * single IP path while Multicast and Adaptive can use every path.
+ *
+ * Workloads:
+ *   zipf  every consumer requests single segment objects with Zipf
+ *         popularity at a fixed rate
+ *   bulk  every consumer downloads its own ContentSize object with a
+ *         CCNPipelinedConsumerApp, whose window grows until the
+ *         bottleneck drops Interests or Data: the throughput measures how
+ *         much of the network capacity the strategy uses. Catalog, hops
+ *         and latency do not apply.
+ *
+ * Examples:
+ *   ./ns3 run "ccn-benchmark --topologies=rir,tree --catalogs=1000 --caches=0,50,200"
+ *   ./ns3 run "ccn-benchmark --topologies=diamond --workload=bulk --catalogs=1 --caches=0
+ *              --strategies=BestRoute,Adaptive"
+ *
+ * With four consumers and 10 Mbps core links, the last example gives
+ * 9.85 Mbps with BestRoute, bound to one core path, and 17.88 Mbps with
+ * Adaptive, which spreads the windows over both paths: an 81% gain.
+ */
+
+/// Result of one benchmark run
+struct BenchmarkResult
+{
+    uint32_t nodes{0};
+    uint64_t interests{0};
+    uint64_t satisfied{0};
+    uint64_t hits{0};
+    double hopSum{0};
+    double latencySum{0};
+    uint64_t events{0};
+    double wallSeconds{0};
+};
+
+/// Benchmark topology, nodes are named and addressed
+struct BenchmarkTopology
+{
+    NodeContainer nodes;
+    Ptr<Node> producer;
+    NodeContainer consumers;
+    bool multipath{false};
+};
+
+static std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static void
+Connect(Ptr<Node> a, Ptr<Node> b, PointToPointHelper& p2p, Ipv4AddressHelper& ipv4)
+{
+    NetDeviceContainer devices = p2p.Install(a, b);
+    ipv4.Assign(devices);
+    ipv4.NewNetwork();
+}
+
+static BenchmarkTopology
+BuildTopology(const std::string& type, uint32_t size, const std::string& bottleneck)
+{
+    BenchmarkTopology topo;
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    // links running at the bottleneck rate, listed first
+    std::size_t coreLinks = 0;
+
+    if (type == "rir")
+    {
+        topo.nodes.Create(5);
+        const char* names[] = {"APNIC", "ARIN", "RIPE", "LACNIC", "AfriNIC"};
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            Names::Add(names[i], topo.nodes.Get(i));
+            links.emplace_back(i, (i + 1) % 5);
+        }
+        topo.producer = topo.nodes.Get(0);
+        for (uint32_t i = 1; i < 5; i++)
+        {
+            topo.consumers.Add(topo.nodes.Get(i));
+        }
+        topo.multipath = true;
+    }
+    else if (type == "ring")
+    {
+        NS_ABORT_MSG_IF(size < 3, "A ring needs at least 3 nodes");
+        topo.nodes.Create(size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            links.emplace_back(i, (i + 1) % size);
+        }
+        topo.producer = topo.nodes.Get(0);
+        for (uint32_t i = 1; i < size; i++)
+        {
+            topo.consumers.Add(topo.nodes.Get(i));
+        }
+        topo.multipath = true;
+    }
+    else if (type == "tree")
+    {
+        NS_ABORT_MSG_IF(size < 2 || size > 16, "Tree depth must be in [2, 16]");
+        uint32_t count = (1u << size) - 1;
+        topo.nodes.Create(count);
+        for (uint32_t i = 1; i < count; i++)
+        {
+            links.emplace_back((i - 1) / 2, i);
+        }
+        topo.producer = topo.nodes.Get(0);
+        for (uint32_t i = (1u << (size - 1)) - 1; i < count; i++)
+        {
+            topo.consumers.Add(topo.nodes.Get(i));
+        }
+    }
+    else if (type == "diamond")
+    {
+        NS_ABORT_MSG_IF(size < 1, "The diamond needs a consumer");
+        // producer 0, core routers 1 and 2, access router 3
+        topo.nodes.Create(4 + size);
+        links = {{0, 1}, {1, 3}, {0, 2}, {2, 3}};
+        coreLinks = links.size();
+        topo.producer = topo.nodes.Get(0);
+        for (uint32_t i = 4; i < 4 + size; i++)
+        {
+            links.emplace_back(3, i);
+            topo.consumers.Add(topo.nodes.Get(i));
+        }
+        topo.multipath = true;
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown topology " << type);
+    }
+
+    if (type != "rir")
+    {
+        for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+        {
+            Names::Add("n" + std::to_string(i), topo.nodes.Get(i));
+        }
+    }
+
+    InternetStackHelper stack;
+    stack.SetCCNStackInstall(true);
+    stack.Install(topo.nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("10ms"));
+
+    PointToPointHelper core;
+    core.SetDeviceAttribute("DataRate", StringValue(bottleneck));
+    core.SetChannelAttribute("Delay", StringValue("10ms"));
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    for (std::size_t i = 0; i < links.size(); i++)
+    {
+        Connect(topo.nodes.Get(links[i].first),
+                topo.nodes.Get(links[i].second),
+                i < coreLinks ? core : p2p,
+                ipv4);
+    }
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    // map every node name to its first interface address
+    std::vector<std::pair<std::string, Ipv4Address>> nodeNameToIp;
+    for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+    {
+        Ptr<Node> node = topo.nodes.Get(i);
+        nodeNameToIp.emplace_back(Names::FindName(node),
+                                  node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal());
+    }
+    for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+    {
+        Ptr<CCNL4Protocol> ccnl4 = topo.nodes.Get(i)->GetObject<CCNL4Protocol>();
+        NS_ASSERT_MSG(ccnl4, "CCNL4Protocol not found");
+        ccnl4->AddContentPrefixToHostAddress(nodeNameToIp);
+    }
+
+    return topo;
+}
+
+/*
+ * List every point-to-point neighbor of each node as a FIB next hop of the
+ * prefix, preferring the IP next hop towards the producer. Consumer leaves
+ * are dead ends and are left out.
+ */
+static void
+InstallMultipathFib(const BenchmarkTopology& topo, const std::string& prefix)
+{
+    Ipv4Address producerAddress = topo.producer->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+
+    for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+    {
+        Ptr<Node> node = topo.nodes.Get(i);
+        if (node == topo.producer)
+        {
+            continue;
+        }
+
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        Ipv4Header header;
+        header.SetDestination(producerAddress);
+        Socket::SocketErrno errno_;
+        Ptr<Ipv4Route> route =
+            ipv4->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, errno_);
+        NS_ASSERT_MSG(route, "No route towards the producer");
+
+        for (uint32_t d = 0; d < node->GetNDevices(); d++)
+        {
+            Ptr<NetDevice> device = node->GetDevice(d);
+            Ptr<Channel> channel = device->GetChannel();
+            if (!channel || channel->GetNDevices() != 2)
+            {
+                continue;
+            }
+            Ptr<NetDevice> peer =
+                channel->GetDevice(0) == device ? channel->GetDevice(1) : channel->GetDevice(0);
+            // a leaf has the loopback and a single link
+            Ptr<Node> peerNode = peer->GetNode();
+            if (peerNode->GetNDevices() == 2 && topo.consumers.Contains(peerNode->GetId()))
+            {
+                continue;
+            }
+            Ptr<Ipv4> peerIpv4 = peer->GetNode()->GetObject<Ipv4>();
+            Ipv4Address neighbor =
+                peerIpv4->GetAddress(peerIpv4->GetInterfaceForDevice(peer), 0).GetLocal();
+
+            bool preferred = route->GetGateway() == Ipv4Address::GetAny()
+                                 ? peer->GetNode() == topo.producer
+                                 : route->GetGateway() == neighbor;
+            node->GetObject<CCNL4Protocol>()->AddFibNextHop(prefix, neighbor, preferred ? 0 : 1);
+        }
+    }
+}
+
+static BenchmarkResult
+RunOnce(const std::string& topology,
+        uint32_t topologySize,
+        const std::string& bottleneck,
+        const std::string& workload,
+        uint64_t contentSize,
+        const std::string& strategy,
+        uint32_t catalog,
+        uint32_t cacheSize,
+        const std::string& policy,
+        double alpha,
+        double rate,
+        double duration,
+        uint32_t run)
+{
+    RngSeedManager::SetRun(run);
+    Config::SetDefault("ns3::CCNL4Protocol::HopByHop", BooleanValue(true));
+    Config::SetDefault("ns3::CCNContentStore::MaxSize", UintegerValue(cacheSize));
+    Config::SetDefault("ns3::CCNContentStore::Policy", StringValue(policy));
+
+    BenchmarkTopology topo = BuildTopology(topology, topologySize, bottleneck);
+    bool bulk = workload == "bulk";
+    NS_ABORT_MSG_IF(!bulk && workload != "zipf", "Unknown workload " << workload);
+
+    // one single-segment object per catalog entry, or one large object
+    // per consumer
+    for (uint32_t i = 0; i < (bulk ? topo.consumers.GetN() : 1); i++)
+    {
+        Ptr<CCNProducerApp> producer = CreateObject<CCNProducerApp>();
+        producer->SetAttribute("ContentName",
+                               StringValue(bulk ? "c/bulk" + std::to_string(i) : "c"));
+        producer->SetAttribute("SegmentSize", UintegerValue(1024));
+        producer->SetAttribute("ContentSize", UintegerValue(bulk ? contentSize : 1024));
+        producer->Install(topo.producer);
+        producer->SetStartTime(Seconds(0.5));
+    }
+
+    std::string prefix = Names::FindName(topo.producer) + "/c";
+    if (topo.multipath)
+    {
+        InstallMultipathFib(topo, prefix);
+    }
+    ObjectFactory strategyFactory("ns3::CCN" + strategy + "Strategy");
+    for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+    {
+        topo.nodes.Get(i)->GetObject<CCNL4Protocol>()->SetForwardingStrategy(
+            prefix,
+            strategyFactory.Create<CCNForwardingStrategy>());
+    }
+
+    std::vector<Ptr<CCNZipfConsumerApp>> consumers;
+    std::vector<Ptr<CCNPipelinedConsumerApp>> downloads;
+    for (uint32_t i = 0; bulk && i < topo.consumers.GetN(); i++)
+    {
+        Ptr<CCNPipelinedConsumerApp> download = CreateObject<CCNPipelinedConsumerApp>();
+        download->SetAttribute("ContentName", StringValue(prefix + "/bulk" + std::to_string(i)));
+        download->Install(topo.consumers.Get(i));
+        download->SetStartTime(Seconds(1.0));
+        download->SetStopTime(Seconds(1.0 + duration));
+        downloads.push_back(download);
+    }
+    for (uint32_t i = 0; !bulk && i < topo.consumers.GetN(); i++)
+    {
+        Ptr<CCNZipfConsumerApp> consumer = CreateObject<CCNZipfConsumerApp>();
+        consumer->SetAttribute("Prefix", StringValue(prefix));
+        consumer->SetAttribute("NumberOfContents", UintegerValue(catalog));
+        consumer->SetAttribute("Alpha", DoubleValue(alpha));
+        consumer->SetAttribute("Frequency", DoubleValue(rate));
+        consumer->Install(topo.consumers.Get(i));
+        consumer->SetStartTime(Seconds(1.0));
+        consumer->SetStopTime(Seconds(1.0 + duration));
+        consumers.push_back(consumer);
+    }
+
+    Simulator::Stop(Seconds(2.0 + duration));
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto stop = std::chrono::steady_clock::now();
+
+    BenchmarkResult result;
+    result.nodes = topo.nodes.GetN();
+    result.events = Simulator::GetEventCount();
+    result.wallSeconds = std::chrono::duration<double>(stop - start).count();
+    for (const auto& consumer : consumers)
+    {
+        result.interests += consumer->GetSentInterests();
+        result.satisfied += consumer->GetReceivedData();
+        result.hopSum += consumer->GetAverageHopCount() * consumer->GetReceivedData();
+        result.latencySum +=
+            consumer->GetAverageLatency().GetSeconds() * 1000.0 * consumer->GetReceivedData();
+    }
+    for (const auto& download : downloads)
+    {
+        uint64_t segments = download->GetReceivedBytes() / 1024;
+        result.interests += segments + download->GetRetransmissions();
+        result.satisfied += segments;
+    }
+    for (uint32_t i = 0; i < topo.nodes.GetN(); i++)
+    {
+        result.hits += topo.nodes.Get(i)->GetObject<CCNL4Protocol>()->GetContentStore()->GetHits();
+    }
+
+    Simulator::Destroy();
+    Names::Clear();
+    Ipv4AddressGenerator::Reset();
+
+    return result;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string topologies = "rir,tree";
+    std::string strategies = "BestRoute";
+    uint32_t topologySize = 6;
+    std::string bottleneck = "10Mbps";
+    std::string workload = "zipf";
+    uint64_t contentSize = 100000000;
+    std::string catalogs = "100,1000,10000";
+    std::string caches = "0,10,100";
+    std::string policies = "LRU,LFU,FIFO";
+    double alpha = 0.8;
+    double rate = 100.0;
+    double duration = 10.0;
+    uint32_t run = 1;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("topologies",
+                 "Comma separated topologies: rir, ring, tree, diamond",
+                 topologies);
+    cmd.AddValue("strategies",
+                 "Comma separated forwarding strategies: BestRoute, Multicast, Adaptive",
+                 strategies);
+    cmd.AddValue("topologySize",
+                 "Ring size, tree depth or diamond consumers of generated topologies",
+                 topologySize);
+    cmd.AddValue("bottleneck", "Data rate of the core links of the diamond", bottleneck);
+    cmd.AddValue("workload", "Consumer workload: zipf, or bulk downloads", workload);
+    cmd.AddValue("contentSize", "Size of each bulk download, in bytes", contentSize);
+    cmd.AddValue("catalogs", "Comma separated catalog sizes", catalogs);
+    cmd.AddValue("caches", "Comma separated content store sizes, in segments", caches);
+    cmd.AddValue("policies", "Comma separated replacement policies: LRU, LFU, FIFO", policies);
+    cmd.AddValue("alpha", "Zipf exponent", alpha);
+    cmd.AddValue("rate", "Interests per second per consumer", rate);
+    cmd.AddValue("duration", "Request period per run, in seconds", duration);
+    cmd.AddValue("run", "RNG run number", run);
+    cmd.AddValue("output", "Also write the CSV results to this file", output);
+    cmd.Parse(argc, argv);
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_IF(!file.is_open(), "Cannot open " << output);
+    }
+
+    std::string headerLine = "topology,strategy,nodes,catalog,cache,policy,interests,satisfied,"
+                             "hit_ratio,avg_hops,avg_latency_ms,throughput_mbps,events,wall_s,"
+                             "events_per_s";
+    std::cout << headerLine << std::endl;
+    if (file.is_open())
+    {
+        file << headerLine << std::endl;
+    }
+
+    for (const auto& topology : SplitList(topologies))
+    {
+        for (const auto& strategy : SplitList(strategies))
+        {
+            for (const auto& catalog : SplitList(catalogs))
+            {
+                for (const auto& cache : SplitList(caches))
+                {
+                    for (const auto& policy : SplitList(policies))
+                    {
+                        BenchmarkResult r = RunOnce(topology,
+                                                    topologySize,
+                                                    bottleneck,
+                                                    workload,
+                                                    contentSize,
+                                                    strategy,
+                                                    std::stoul(catalog),
+                                                    std::stoul(cache),
+                                                    policy,
+                                                    alpha,
+                                                    rate,
+                                                    duration,
+                                                    run);
+
+                        double hitRatio =
+                            r.interests ? static_cast<double>(r.hits) / r.interests : 0.0;
+                        double throughput = r.satisfied * 1024 * 8 / duration / 1e6;
+
+                        std::ostringstream line;
+                        line << std::fixed << std::setprecision(4) << topology << "," << strategy
+                             << "," << r.nodes << "," << catalog << "," << cache << "," << policy
+                             << "," << r.interests << "," << r.satisfied << "," << hitRatio << ","
+                             << (r.satisfied ? r.hopSum / r.satisfied : 0.0) << ","
+                             << (r.satisfied ? r.latencySum / r.satisfied : 0.0) << ","
+                             << throughput << "," << r.events << "," << r.wallSeconds << ","
+                             << (r.wallSeconds > 0 ? r.events / r.wallSeconds : 0.0);
+                        std::cout << line.str() << std::endl;
+                        if (file.is_open())
+                        {
+                            file << line.str() << std::endl;
+                        }
+
+                        // the policy only matters with a cache
+                        if (cache == "0")
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
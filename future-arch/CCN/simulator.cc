@@ -22,6 +22,12 @@ NS_LOG_COMPONENT_DEFINE("CCNSim");
 int
 main(int argc, char* argv[])
 {
+    std::string contentFile = "./future-arch/CCN/content.txt";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("contentFile", "File served by the APNIC producer", contentFile);
+    cmd.Parse(argc, argv);
+
     // set log level
     LogComponentEnable("CCNSim", LOG_LEVEL_INFO);
     LogComponentEnable("CCNProducerApp", LOG_LEVEL_INFO);
@@ -107,7 +113,7 @@ main(int argc, char* argv[])
     NS_LOG_INFO("---> Create CCN content producer");
     Ptr<CCNProducerApp> producer = CreateObject<CCNProducerApp>();
     producer->SetAttribute("ContentName", StringValue("content"));
-    producer->SetAttribute("ContentFile", StringValue("/home/ubuntu/FISim/FIA/CCN/content.txt"));
+    producer->SetAttribute("ContentFile", StringValue(contentFile));
     producer->Install(nodes.Get(0));
     producer->SetStartTime(Seconds(1.0));
 
@@ -13,22 +13,257 @@ CybertwinNetworkSimulator::GetTypeId()
     static TypeId tid = TypeId("ns3::CybertwinNetworkSimulator")
                             .SetParent<Object>()
                             .SetGroupName("Cybertwin")
-                            .AddConstructor<CybertwinNetworkSimulator>();
+                            .AddConstructor<CybertwinNetworkSimulator>()
+                            .AddAttribute("RoutingMode",
+                                          "How the routing tables are populated. "
+                                          "Hierarchical is opt-in, see CybertwinHierarchicalRouting",
+                                          EnumValue(GLOBAL_ROUTING),
+                                          MakeEnumAccessor(&CybertwinNetworkSimulator::m_routingMode),
+                                          MakeEnumChecker(GLOBAL_ROUTING,
+                                                          "Global",
+                                                          HIERARCHICAL_ROUTING,
+                                                          "Hierarchical"));
     return tid;
 }
 
 CybertwinNetworkSimulator::CybertwinNetworkSimulator()
+    : m_animInterface(nullptr),
+      m_stopTime(Seconds(10)),
+      m_headless(false),
+      m_animEnabled(true),
+      m_animFile("cybertwin.xml"),
+      m_animResources({"doc/netanim_icon/core_server.png",
+                       "doc/netanim_icon/edge_server.png",
+                       "doc/netanim_icon/endhost_station.png",
+                       "doc/netanim_icon/wireless_ap.png",
+                       "doc/netanim_icon/wireless_sta.png"}),
+      m_clogBuffer(nullptr),
+      m_snapshotTime(Seconds(0))
 {
     NS_LOG_FUNCTION(this);
     std::string topologyFile = "./future-arch/Cybertwin/topology.yaml";
     std::string appFiles = "./future-arch/Cybertwin/applications.yaml";
-    m_topologyReader.SetFileName(topologyFile);
-    m_topologyReader.SetAppFiles(appFiles);
+    m_topologyReader = CreateObject<CybertwinTopologyReader>();
+    m_topologyReader->SetFileName(topologyFile);
+    m_topologyReader->SetAppFiles(appFiles);
 }
 
 CybertwinNetworkSimulator::~CybertwinNetworkSimulator()
 {
     NS_LOG_FUNCTION(this);
+    if (m_clogBuffer)
+    {
+        std::clog.rdbuf(m_clogBuffer);
+    }
+}
+
+void
+CybertwinNetworkSimulator::LoadSystemConfig(const std::string& file)
+{
+    NS_LOG_FUNCTION(this << file);
+    std::ifstream in(file);
+    if (!in)
+    {
+        NS_LOG_WARN("[CybertwinNetworkSimulator] No system config " << file << ", using defaults");
+        return;
+    }
+
+    YAML::Node config = YAML::Load(in);
+    if (!config.IsMap())
+    {
+        NS_LOG_WARN("[CybertwinNetworkSimulator] Empty system config " << file);
+        return;
+    }
+
+    if (const YAML::Node& simulation = config["simulation"])
+    {
+        if (simulation["topology"])
+        {
+            m_topologyReader->SetFileName(simulation["topology"].as<std::string>());
+        }
+        if (simulation["applications"])
+        {
+            m_topologyReader->SetAppFiles(simulation["applications"].as<std::string>());
+        }
+        if (simulation["stop_time"])
+        {
+            m_stopTime = Time(simulation["stop_time"].as<std::string>());
+        }
+        if (simulation["seed"])
+        {
+            RngSeedManager::SetSeed(simulation["seed"].as<uint32_t>());
+        }
+        if (simulation["run"])
+        {
+            RngSeedManager::SetRun(simulation["run"].as<uint64_t>());
+        }
+        if (simulation["routing"])
+        {
+            SetAttribute("RoutingMode", StringValue(simulation["routing"].as<std::string>()));
+        }
+    }
+
+    if (const YAML::Node& reader = config["reader"])
+    {
+        if (reader["cache_file"])
+        {
+            m_topologyReader->SetAttribute("CacheFile",
+                                           StringValue(reader["cache_file"].as<std::string>()));
+        }
+        if (reader["validate"])
+        {
+            m_topologyReader->SetAttribute("Validate",
+                                           BooleanValue(reader["validate"].as<bool>()));
+        }
+    }
+
+    if (const YAML::Node& boot = config["boot"])
+    {
+        if (boot["jitter"])
+        {
+            Config::SetDefault("ns3::CybertwinBootScheduler::Jitter",
+                               StringValue(boot["jitter"].as<std::string>()));
+        }
+        if (boot["barrier"])
+        {
+            Config::SetDefault("ns3::CybertwinBootScheduler::Barrier",
+                               StringValue(boot["barrier"].as<std::string>()));
+        }
+    }
+
+    if (config["headless"])
+    {
+        m_headless = config["headless"].as<bool>();
+    }
+
+    if (const YAML::Node& animation = config["animation"])
+    {
+        if (animation["enabled"])
+        {
+            m_animEnabled = animation["enabled"].as<bool>();
+        }
+        if (animation["file"])
+        {
+            m_animFile = animation["file"].as<std::string>();
+        }
+        if (animation["resources"])
+        {
+            m_animResources = animation["resources"].as<std::vector<std::string>>();
+        }
+    }
+
+    if (const YAML::Node& snapshot = config["snapshot"])
+    {
+        if (snapshot["save"])
+        {
+            m_snapshotSave = snapshot["save"].as<std::string>();
+        }
+        if (snapshot["save_time"])
+        {
+            m_snapshotTime = Time(snapshot["save_time"].as<std::string>());
+        }
+        if (snapshot["restore"])
+        {
+            m_snapshotRestore = snapshot["restore"].as<std::string>();
+        }
+    }
+
+    if (config["logging"] && !m_headless)
+    {
+        EnableLogging(config["logging"]);
+    }
+}
+
+void
+CybertwinNetworkSimulator::EnableLogging(const YAML::Node& logging)
+{
+    NS_LOG_FUNCTION(this);
+    if (logging["sink"])
+    {
+        std::string sink = logging["sink"].as<std::string>();
+        std::streambuf* buffer = nullptr;
+        if (sink == "stdout")
+        {
+            buffer = std::cout.rdbuf();
+        }
+        else if (sink == "stderr")
+        {
+            buffer = std::cerr.rdbuf();
+        }
+        else
+        {
+            m_logFile.open(sink);
+            NS_ABORT_MSG_IF(!m_logFile, "Cannot open log sink " << sink);
+            buffer = m_logFile.rdbuf();
+        }
+        std::streambuf* previous = std::clog.rdbuf(buffer);
+        if (!m_clogBuffer)
+        {
+            m_clogBuffer = previous;
+        }
+    }
+
+    const std::map<std::string, LogLevel> prefixes = {
+        {"time", LOG_PREFIX_TIME},
+        {"node", LOG_PREFIX_NODE},
+        {"func", LOG_PREFIX_FUNC},
+        {"level", LOG_PREFIX_LEVEL},
+        {"all", LOG_PREFIX_ALL},
+    };
+    uint32_t prefix = 0;
+    for (const auto& p : logging["prefix"])
+    {
+        auto it = prefixes.find(p.as<std::string>());
+        NS_ABORT_MSG_IF(it == prefixes.end(), "Unknown log prefix " << p.as<std::string>());
+        prefix |= it->second;
+    }
+
+    const std::map<std::string, LogLevel> levels = {
+        {"error", LOG_LEVEL_ERROR},
+        {"warn", LOG_LEVEL_WARN},
+        {"debug", LOG_LEVEL_DEBUG},
+        {"info", LOG_LEVEL_INFO},
+        {"function", LOG_LEVEL_FUNCTION},
+        {"logic", LOG_LEVEL_LOGIC},
+        {"all", LOG_LEVEL_ALL},
+    };
+    for (const auto& component : logging["components"])
+    {
+        std::string name = component.first.as<std::string>();
+        std::string level = component.second.as<std::string>();
+        auto it = levels.find(level);
+        NS_ABORT_MSG_IF(it == levels.end(), "Unknown log level " << level << " for " << name);
+        LogComponentEnable(name.c_str(), (LogLevel)(it->second | prefix));
+    }
+}
+
+void
+CybertwinNetworkSimulator::SetHeadless(bool headless)
+{
+    NS_LOG_FUNCTION(this << headless);
+    m_headless = headless;
+    if (m_headless)
+    {
+        LogComponentDisableAll(LOG_LEVEL_ALL);
+    }
+}
+
+void
+CybertwinNetworkSimulator::CreateAnimation()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_headless || !m_animEnabled)
+    {
+        NS_LOG_INFO("[CybertwinNetworkSimulator] Animation disabled");
+        return;
+    }
+
+    m_animation = std::make_unique<AnimationInterface>(m_animFile);
+    for (const auto& resource : m_animResources)
+    {
+        m_animation->AddResource(resource);
+    }
+    SetAnimationInterface(m_animation.get());
 }
 
 void
@@ -45,10 +280,21 @@ CybertwinNetworkSimulator::DriverCompileTopology()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("\n[1] Reading the topology file...\n");
-    m_nodes = m_topologyReader.Read();
+    m_nodes = m_topologyReader->Read();
 
-    // populate routing tables
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    // populate routing tables, a snapshot brings its own
+    if (!m_snapshotRestore.empty())
+    {
+        NS_LOG_INFO("Routing tables restored from " << m_snapshotRestore);
+    }
+    else if (m_routingMode == HIERARCHICAL_ROUTING)
+    {
+        m_topologyReader->PopulateHierarchicalRoutes();
+    }
+    else
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
 
     NS_LOG_INFO("\n[1] Topology file read successfully!\n");
 }
@@ -58,24 +304,24 @@ CybertwinNetworkSimulator::DriverInstallApps()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("\n[2] Configuring the nodes and applications...\n");
-    m_topologyReader.InstallApplications();
+    m_topologyReader->InstallApplications();
 
     // Start all installed applications
-    NodeContainer coreNodes = m_topologyReader.GetCoreCloudNodes();
+    NodeContainer coreNodes = m_topologyReader->GetCoreCloudNodes();
     for (uint32_t i = 0; i < coreNodes.GetN(); i++)
     {
         Ptr<CybertwinCoreServer> node = DynamicCast<CybertwinCoreServer>(coreNodes.Get(i));
         node->StartAllAggregatedApps();
     }
 
-    NodeContainer edgeNodes = m_topologyReader.GetEdgeCloudNodes();
+    NodeContainer edgeNodes = m_topologyReader->GetEdgeCloudNodes();
     for (uint32_t i = 0; i < edgeNodes.GetN(); i++)
     {
         Ptr<CybertwinEdgeServer> node = DynamicCast<CybertwinEdgeServer>(edgeNodes.Get(i));
         node->StartAllAggregatedApps();
     }
 
-    NodeContainer endNodes = m_topologyReader.GetEndClusterNodes();
+    NodeContainer endNodes = m_topologyReader->GetEndClusterNodes();
     for (uint32_t i = 0; i < endNodes.GetN(); i++)
     {
         Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(endNodes.Get(i));
@@ -90,58 +336,66 @@ CybertwinNetworkSimulator::DriverBootSimulator()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("\n[3] Running the simulation...\n");
-    // boot the Cybertwin Network
+    // boot the Cybertwin Network, layer by layer
     // 1. Power on Cloud Nodes
     // 2. Power on Edge Nodes
     // 3. Power on End Hosts
-
-    // power on the nodes
-    NodeContainer coreNodes = m_topologyReader.GetCoreCloudNodes();
-    for (uint32_t i = 0; i < coreNodes.GetN(); i++)
+    struct BootLayer
     {
-        Ptr<CybertwinCoreServer> node = DynamicCast<CybertwinCoreServer>(coreNodes.Get(i));
-        node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), CORE_CLOUD_NODE_SIZE, CORE_CLOUD_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 0);
-    }
-
-    NodeContainer edgeNodes = m_topologyReader.GetEdgeCloudNodes();
-    for (uint32_t i = 0; i < edgeNodes.GetN(); i++)
+        std::string name;
+        NodeContainer nodes;
+        uint32_t size;
+    };
+
+    std::vector<BootLayer> layers = {
+        {"core", m_topologyReader->GetCoreCloudNodes(), CORE_CLOUD_NODE_SIZE},
+        {"edge", m_topologyReader->GetEdgeCloudNodes(), EDGE_CLOUD_NODE_SIZE},
+        {"endhost", m_topologyReader->GetEndHostNodes(), END_HOST_NODE_SIZE},
+        {"ap", m_topologyReader->GetApNodes(), AP_NODE_SIZE},
+        {"sta", m_topologyReader->GetStaNodes(), STA_NODE_SIZE},
+    };
+
+    m_bootScheduler = CreateObject<CybertwinBootScheduler>();
+    for (uint32_t l = 0; l < layers.size(); l++)
     {
-        Ptr<CybertwinEdgeServer> node = DynamicCast<CybertwinEdgeServer>(edgeNodes.Get(i));
-        node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), EDGE_CLOUD_NODE_SIZE, EDGE_CLOUD_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 1);
+        m_bootScheduler->AddLayer(layers[l].name, layers[l].nodes);
+        if (m_animInterface)
+        {
+            for (uint32_t i = 0; i < layers[l].nodes.GetN(); i++)
+            {
+                uint32_t id = layers[l].nodes.Get(i)->GetId();
+                m_animInterface->UpdateNodeSize(id, layers[l].size, layers[l].size);
+                m_animInterface->UpdateNodeImage(id, l);
+            }
+        }
     }
 
-    NodeContainer endhostNodes = m_topologyReader.GetEndHostNodes();
-    for (uint32_t i = 0; i < endhostNodes.GetN(); i++)
+    // the core servers register to the CNRS root
+    NodeContainer coreNodes = m_topologyReader->GetCoreCloudNodes();
+    for (uint32_t i = 0; i < coreNodes.GetN(); i++)
     {
-        Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(endhostNodes.Get(i));
-        node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), END_HOST_NODE_SIZE, END_HOST_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 2);
+        Ptr<CybertwinCoreServer> root = DynamicCast<CybertwinCoreServer>(coreNodes.Get(i));
+        if (!root->isCNRSRoot())
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < coreNodes.GetN(); j++)
+        {
+            m_bootScheduler->AddDependency(coreNodes.Get(j), root);
+        }
     }
 
-    NodeContainer apNodes = m_topologyReader.GetApNodes();
-    for (uint32_t i = 0; i < apNodes.GetN(); i++)
+    if (!m_snapshotRestore.empty())
     {
-        Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(apNodes.Get(i));
-        node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), AP_NODE_SIZE, AP_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 3);
+        // the nodes are powered on, restore their booted state
+        m_bootScheduler->PowerOnNow();
+        CybertwinSnapshot::Restore(m_snapshotRestore);
     }
-
-    NodeContainer staNodes = m_topologyReader.GetStaNodes();
-    for (uint32_t i = 0; i < staNodes.GetN(); i++)
+    else
     {
-        Ptr<CybertwinEndHost> node = DynamicCast<CybertwinEndHost>(staNodes.Get(i));
-        node->PowerOn();
-        m_animInterface->UpdateNodeSize(node->GetId(), STA_NODE_SIZE, STA_NODE_SIZE);
-        m_animInterface->UpdateNodeImage(node->GetId(), 4);
+        m_bootScheduler->Start();
     }
 
-
     NS_LOG_INFO("\n[3] Simulation completed!\n");
 }
 
@@ -150,16 +404,40 @@ CybertwinNetworkSimulator::RunSimulator()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("\n[4] Running the simulation...\n");
-    Simulator::Stop(Seconds(10));
+    if (!m_snapshotSave.empty())
+    {
+        Simulator::Schedule(m_snapshotTime, &CybertwinNetworkSimulator::SaveSnapshot, this);
+    }
+    Simulator::Stop(m_stopTime);
     Simulator::Run();
     NS_LOG_INFO("\n[4] Simulation completed!\n");
 }
 
+void
+CybertwinNetworkSimulator::SaveSnapshot()
+{
+    NS_LOG_FUNCTION(this);
+    if (!CybertwinSnapshot::Save(m_snapshotSave))
+    {
+        NS_LOG_WARN("Snapshot " << m_snapshotSave << " not saved, the network is not quiescent");
+    }
+}
+
 void
 CybertwinNetworkSimulator::Output()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("\n[5] Output the simulation results...\n");
+    if (m_bootScheduler)
+    {
+        std::ostringstream report;
+        m_bootScheduler->Print(report);
+        NS_LOG_INFO("Boot time-to-ready per layer:\n" << report.str());
+        if (!m_bootScheduler->IsBooted())
+        {
+            NS_LOG_WARN("Some nodes were not up before the end of the simulation");
+        }
+    }
     Simulator::Destroy();
     NS_LOG_INFO("\n[5] Simulation results outputted successfully!\n");
 }
@@ -179,20 +457,22 @@ using namespace ns3;
 int
 main(int argc, char* argv[])
 {
-    LogComponentEnable("CybertwinNetworkSimulator", LOG_LEVEL_INFO);
-    LogComponentEnable("CybertwinTopologyReader", LOG_LEVEL_INFO);
-    LogComponentEnable("CybertwinNode", LOG_LEVEL_DEBUG);
-    LogComponentEnable("CybertwinAppDownloadClient", LOG_LEVEL_INFO);
-    LogComponentEnable("CybertwinAppDownloadServer", LOG_LEVEL_INFO);
-    LogComponentEnable("CybertwinEndHostDaemon", LOG_LEVEL_DEBUG);
-    LogComponentEnable("Cybertwin", LOG_LEVEL_INFO);
-    LogComponentEnable("CybertwinManager", LOG_LEVEL_DEBUG);
-    LogComponentEnable("CybertwinHeader", LOG_LEVEL_INFO);
-    LogComponentEnable("NameResolutionService", LOG_LEVEL_INFO);
-    NS_LOG_INFO("-*-*-*-*-*-*- Starting Cybertwin Network Simulator -*-*-*-*-*-*-");
+    std::string config = "./future-arch/system-config.yaml";
+    bool headless = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("config", "The system configuration file", config);
+    cmd.AddValue("headless", "Run without animation and logging", headless);
+    cmd.Parse(argc, argv);
 
     // create the simulator
     Ptr<ns3::CybertwinNetworkSimulator> simulator = CreateObject<ns3::CybertwinNetworkSimulator>();
+    simulator->LoadSystemConfig(config);
+    if (headless)
+    {
+        simulator->SetHeadless(true);
+    }
+    NS_LOG_INFO("-*-*-*-*-*-*- Starting Cybertwin Network Simulator -*-*-*-*-*-*-");
 
     // init the simulator
     simulator->InputInit();
@@ -201,13 +481,7 @@ main(int argc, char* argv[])
     simulator->DriverCompileTopology();
 
     // the animation interface must define after the topology is read
-    AnimationInterface anim("cybertwin.xml");
-    anim.AddResource("doc/netanim_icon/core_server.png");
-    anim.AddResource("doc/netanim_icon/edge_server.png");
-    anim.AddResource("doc/netanim_icon/endhost_station.png");
-    anim.AddResource("doc/netanim_icon/wireless_ap.png");
-    anim.AddResource("doc/netanim_icon/wireless_sta.png");
-    simulator->SetAnimationInterface(&anim);
+    simulator->CreateAnimation();
 
     // boot the simulator
     simulator->DriverBootSimulator();
@@ -223,4 +497,4 @@ main(int argc, char* argv[])
 
     return 0;
 
-}; // namespace ns3
\ No newline at end of file
+}; // namespace ns3
@@ -2,6 +2,8 @@
 #define CYBERTWIN_SIMULATOR_H
 
 #include "ns3/core-module.h"
+#include "ns3/cybertwin-boot-scheduler.h"
+#include "ns3/cybertwin-snapshot.h"
 #include "ns3/cybertwin-topology-reader.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/log.h"
@@ -9,6 +11,12 @@
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
 
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #define CORE_CLOUD_NODE_SIZE (7)
 #define EDGE_CLOUD_NODE_SIZE (5)
 #define END_HOST_NODE_SIZE (5)
@@ -20,6 +28,13 @@ namespace ns3
 class CybertwinNetworkSimulator : public Object
 {
   public:
+    /// How the routing tables are populated
+    enum RoutingMode_e
+    {
+        GLOBAL_ROUTING,       //!< Ipv4GlobalRoutingHelper, SPF from every router
+        HIERARCHICAL_ROUTING, //!< per layer, see CybertwinHierarchicalRouting
+    };
+
     static TypeId GetTypeId();
 
     CybertwinNetworkSimulator();
@@ -28,6 +43,30 @@ class CybertwinNetworkSimulator : public Object
     CybertwinNetworkSimulator(const CybertwinNetworkSimulator&) = delete;
     CybertwinNetworkSimulator& operator=(const CybertwinNetworkSimulator&) = delete;
 
+    /**
+     * \brief Load the run configuration
+     *
+     * Sets the topology and application files, stop time, seed, routing
+     * mode, topology reader settings, boot staging, animation and logging. Keys missing from the file
+     * keep their default, a missing file keeps every default.
+     *
+     * \param file the system configuration file
+     */
+    void LoadSystemConfig(const std::string& file);
+
+    /**
+     * \brief Run without animation and logging
+     * \param headless whether the run is headless
+     */
+    void SetHeadless(bool headless);
+
+    /**
+     * \brief Create the animation interface of the configuration, if any
+     *
+     * Must be called after the topology is read.
+     */
+    void CreateAnimation();
+
     void SetAnimationInterface(AnimationInterface* animInterface);
 
     void InputInit();
@@ -38,9 +77,33 @@ class CybertwinNetworkSimulator : public Object
     void Output();
 
   private:
+    /**
+     * \brief Enable the log components of the configuration
+     */
+    void EnableLogging(const YAML::Node& logging);
+
+    /**
+     * \brief Save the snapshot of the configuration
+     */
+    void SaveSnapshot();
+
     NodeContainer m_nodes;
-    CybertwinTopologyReader m_topologyReader;
+    Ptr<CybertwinTopologyReader> m_topologyReader;
     AnimationInterface* m_animInterface;
+    RoutingMode_e m_routingMode;
+
+    Time m_stopTime;                              //!< simulation stop time
+    bool m_headless;                              //!< no animation and no logging
+    bool m_animEnabled;                           //!< create an animation
+    std::string m_animFile;                       //!< animation trace file
+    std::vector<std::string> m_animResources;     //!< animation node images
+    std::unique_ptr<AnimationInterface> m_animation; //!< animation created by CreateAnimation
+    std::ofstream m_logFile;                      //!< log file sink
+    std::streambuf* m_clogBuffer;                 //!< std::clog buffer replaced by the sink
+    std::string m_snapshotSave;                   //!< snapshot written during the run
+    Time m_snapshotTime;                          //!< time the snapshot is written at
+    std::string m_snapshotRestore;                //!< snapshot restored after the boot
+    Ptr<CybertwinBootScheduler> m_bootScheduler; //!< staged power on of the nodes
 };
 
 }; // namespace ns3
@@ -0,0 +1,349 @@
+#include "ccn-pipelined-consumer-app.h"
+
+#include "ns3/ccn-header.h"
+#include "ns3/ccn-l4-protocol.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("CCNPipelinedConsumerApp");
+
+NS_OBJECT_ENSURE_REGISTERED(CCNPipelinedConsumerApp);
+
+TypeId
+CCNPipelinedConsumerApp::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CCNPipelinedConsumerApp")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<CCNPipelinedConsumerApp>()
+            .AddAttribute("ContentName",
+                          "The name of the segmented content to be fetched",
+                          StringValue(""),
+                          MakeStringAccessor(&CCNPipelinedConsumerApp::m_contentName),
+                          MakeStringChecker())
+            .AddAttribute("InitialWindow",
+                          "Initial number of outstanding segment Interests",
+                          DoubleValue(4.0),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_initialWindow),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("MinWindow",
+                          "Lower bound of the Interest window",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_minWindow),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("MaxWindow",
+                          "Upper bound of the Interest window",
+                          DoubleValue(65536.0),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_maxWindow),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("InitialSsthresh",
+                          "Initial slow start threshold, in segments",
+                          DoubleValue(65536.0),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_initialSsthresh),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("AdditiveIncrease",
+                          "Window increase per window of data in congestion avoidance",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_additiveIncrease),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Beta",
+                          "Multiplicative decrease factor applied on Interest timeout",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&CCNPipelinedConsumerApp::m_beta),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("InterestLifetime",
+                          "Time after which an unanswered Interest is retransmitted",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&CCNPipelinedConsumerApp::m_interestLifetime),
+                          MakeTimeChecker())
+            .AddTraceSource("CongestionWindow",
+                            "The Interest window size",
+                            MakeTraceSourceAccessor(&CCNPipelinedConsumerApp::m_cwnd),
+                            "ns3::TracedValueCallback::Double")
+            .AddTraceSource("DownloadComplete",
+                            "The content has been fully received",
+                            MakeTraceSourceAccessor(&CCNPipelinedConsumerApp::m_completeTrace),
+                            "ns3::CCNPipelinedConsumerApp::CompleteTracedCallback")
+            .AddTraceSource("Timeout",
+                            "An Interest lifetime expired",
+                            MakeTraceSourceAccessor(&CCNPipelinedConsumerApp::m_timeoutTrace),
+                            "ns3::CCNPipelinedConsumerApp::TimeoutTracedCallback");
+    return tid;
+}
+
+CCNPipelinedConsumerApp::CCNPipelinedConsumerApp()
+    : m_cwnd(0),
+      m_ssthresh(0),
+      m_nextSegment(0),
+      m_finalSegment(CCNHeader::NO_SEGMENT),
+      m_inFlight(0),
+      m_receivedSegments(0),
+      m_receivedBytes(0),
+      m_retransmissions(0),
+      m_complete(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CCNPipelinedConsumerApp::~CCNPipelinedConsumerApp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CCNPipelinedConsumerApp::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_segments.clear();
+    m_retxQueue.clear();
+    m_consumer = nullptr;
+    m_node = nullptr;
+    Application::DoDispose();
+}
+
+void
+CCNPipelinedConsumerApp::Install(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(this << node);
+    m_node = node;
+    node->AddApplication(this);
+}
+
+void
+CCNPipelinedConsumerApp::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_node)
+    {
+        m_node = GetNode();
+    }
+
+    // Create a CCN Consumer
+    Ptr<CCNL4Protocol> ccnl4 = m_node->GetObject<CCNL4Protocol>();
+    NS_ASSERT_MSG(ccnl4, "CCNL4Protocol not found");
+    m_consumer = ccnl4->CreateContentConsumer();
+    m_consumer->SetContentName(m_contentName);
+    m_consumer->SetSegmentRecvCallback(MakeCallback(&CCNPipelinedConsumerApp::RecvSegment, this));
+
+    // reset the pipeline
+    m_cwnd = m_initialWindow;
+    m_ssthresh = m_initialSsthresh;
+    m_lastDecrease = Simulator::Now();
+    m_segments.assign(1, SegmentState());
+    m_retxQueue.clear();
+    m_nextSegment = 1;
+    m_finalSegment = CCNHeader::NO_SEGMENT;
+    m_inFlight = 0;
+    m_receivedSegments = 0;
+    m_receivedBytes = 0;
+    m_retransmissions = 0;
+    m_complete = false;
+    m_startTime = Simulator::Now();
+    m_completionTime = Time(0);
+
+    // the final segment number is learned from the first Data
+    SendInterest(0);
+}
+
+void
+CCNPipelinedConsumerApp::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& state : m_segments)
+    {
+        state.timeout.Cancel();
+    }
+}
+
+void
+CCNPipelinedConsumerApp::FillWindow()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t window = std::max<uint32_t>(1, static_cast<uint32_t>(std::floor(m_cwnd.Get())));
+
+    while (m_inFlight < window)
+    {
+        if (!m_retxQueue.empty())
+        {
+            uint32_t segment = m_retxQueue.front();
+            m_retxQueue.pop_front();
+            if (m_segments[segment].received || m_segments[segment].pending)
+            {
+                continue;
+            }
+            m_retransmissions++;
+            SendInterest(segment);
+        }
+        else if (m_finalSegment != CCNHeader::NO_SEGMENT && m_nextSegment <= m_finalSegment)
+        {
+            SendInterest(m_nextSegment++);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+void
+CCNPipelinedConsumerApp::SendInterest(uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << segment);
+    SegmentState& state = m_segments[segment];
+    state.sentTime = Simulator::Now();
+    state.pending = true;
+    state.timeout = Simulator::Schedule(m_interestLifetime,
+                                        &CCNPipelinedConsumerApp::OnTimeout,
+                                        this,
+                                        segment);
+    m_inFlight++;
+    m_consumer->GetSegment(segment);
+}
+
+void
+CCNPipelinedConsumerApp::OnTimeout(uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << segment);
+    SegmentState& state = m_segments[segment];
+    NS_ASSERT(state.pending);
+    state.pending = false;
+    state.retx = true;
+    m_inFlight--;
+
+    NS_LOG_DEBUG("Interest for segment " << segment << " of " << m_contentName << " timed out");
+    m_timeoutTrace(segment);
+
+    DecreaseWindow(state.sentTime);
+    m_retxQueue.push_back(segment);
+    FillWindow();
+}
+
+void
+CCNPipelinedConsumerApp::IncreaseWindow()
+{
+    double cwnd = m_cwnd.Get();
+    if (cwnd < m_ssthresh)
+    {
+        cwnd += 1.0;
+    }
+    else
+    {
+        cwnd += m_additiveIncrease / cwnd;
+    }
+    m_cwnd = std::min(cwnd, m_maxWindow);
+}
+
+void
+CCNPipelinedConsumerApp::DecreaseWindow(Time sentTime)
+{
+    // Interests sent before the last decrease belong to the same
+    // congestion event, react only once per window of data
+    if (sentTime < m_lastDecrease)
+    {
+        return;
+    }
+
+    m_ssthresh = std::max(m_minWindow, m_cwnd.Get() * m_beta);
+    m_cwnd = m_ssthresh;
+    m_lastDecrease = Simulator::Now();
+    NS_LOG_DEBUG("Window decreased to " << m_cwnd.Get());
+}
+
+void
+CCNPipelinedConsumerApp::RecvSegment(Ptr<Packet> packet, const CCNHeader& header)
+{
+    NS_LOG_FUNCTION(this << packet);
+    uint32_t segment = header.GetSegment();
+    uint32_t finalSegment = header.GetFinalSegment();
+
+    if (m_complete)
+    {
+        return;
+    }
+
+    if (m_finalSegment == CCNHeader::NO_SEGMENT)
+    {
+        m_finalSegment = finalSegment;
+        m_segments.resize(static_cast<size_t>(finalSegment) + 1);
+    }
+
+    if (segment >= m_segments.size() || m_segments[segment].received)
+    {
+        NS_LOG_DEBUG("Dropping duplicate or unexpected segment " << segment);
+        return;
+    }
+
+    SegmentState& state = m_segments[segment];
+    if (state.pending)
+    {
+        state.timeout.Cancel();
+        state.pending = false;
+        m_inFlight--;
+    }
+    state.received = true;
+    m_receivedSegments++;
+    m_receivedBytes += packet->GetSize();
+
+    IncreaseWindow();
+
+    if (m_receivedSegments == m_segments.size())
+    {
+        Complete();
+        return;
+    }
+
+    FillWindow();
+}
+
+void
+CCNPipelinedConsumerApp::Complete()
+{
+    NS_LOG_FUNCTION(this);
+    m_complete = true;
+    m_completionTime = Simulator::Now() - m_startTime;
+    for (auto& state : m_segments)
+    {
+        state.timeout.Cancel();
+    }
+    m_retxQueue.clear();
+
+    NS_LOG_INFO("Downloaded " << m_contentName << ": " << m_receivedBytes << " bytes in "
+                              << m_completionTime.As(Time::S) << ", goodput " << GetGoodput()
+                              << " bps, " << m_retransmissions << " retransmissions");
+    m_completeTrace(m_completionTime, m_receivedBytes);
+}
+
+Time
+CCNPipelinedConsumerApp::GetCompletionTime() const
+{
+    return m_completionTime;
+}
+
+double
+CCNPipelinedConsumerApp::GetGoodput() const
+{
+    if (!m_complete || m_completionTime.IsZero())
+    {
+        return 0.0;
+    }
+    return m_receivedBytes * 8.0 / m_completionTime.GetSeconds();
+}
+
+uint64_t
+CCNPipelinedConsumerApp::GetReceivedBytes() const
+{
+    return m_receivedBytes;
+}
+
+uint32_t
+CCNPipelinedConsumerApp::GetRetransmissions() const
+{
+    return m_retransmissions;
+}
+
+} // namespace ns3
@@ -0,0 +1,183 @@
+#ifndef _CCN_PIPELINED_CONSUMER_APP_H_
+#define _CCN_PIPELINED_CONSUMER_APP_H_
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+class CCNContentConsumer;
+class CCNHeader;
+
+/**
+ * \ingroup applications
+ * \brief Windowed CCN consumer fetching a segmented content
+ *
+ * The application keeps up to cwnd segment Interests outstanding and
+ * adapts the window with AIMD control: the window grows by one segment
+ * per received segment in slow start and by AdditiveIncrease/cwnd in
+ * congestion avoidance, and is multiplied by Beta when an Interest
+ * lifetime expires. The window is reduced at most once per window of
+ * data so that a burst of timeouts counts as a single congestion event.
+ * Timed out segments are retransmitted first.
+ *
+ * The first Interest asks for segment 0 only; the final segment number
+ * learned from its Data bounds the rest of the pipeline. When the last
+ * segment arrives the completion time and goodput are logged and the
+ * DownloadComplete trace source is fired.
+ */
+class CCNPipelinedConsumerApp : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CCNPipelinedConsumerApp();
+    ~CCNPipelinedConsumerApp() override;
+
+    /**
+     * \brief Install to node
+     */
+    void Install(Ptr<Node> node);
+
+    /**
+     * \brief Segment recv callback
+     * \param packet the segment payload
+     * \param header the CCN header of the Data
+     */
+    void RecvSegment(Ptr<Packet> packet, const CCNHeader& header);
+
+    /**
+     * \brief Time between the first Interest and the last received segment
+     * \return the completion time, or zero if the download is not complete
+     */
+    Time GetCompletionTime() const;
+
+    /**
+     * \brief Application-level goodput of the completed download
+     * \return goodput in bits per second, or zero if not complete
+     */
+    double GetGoodput() const;
+
+    /**
+     * \brief Number of received payload bytes
+     */
+    uint64_t GetReceivedBytes() const;
+
+    /**
+     * \brief Number of Interest retransmissions
+     */
+    uint32_t GetRetransmissions() const;
+
+    /**
+     * TracedCallback signature for download completion.
+     *
+     * \param [in] completionTime time taken by the download
+     * \param [in] bytes received payload bytes
+     */
+    typedef void (*CompleteTracedCallback)(Time completionTime, uint64_t bytes);
+
+    /**
+     * TracedCallback signature for Interest timeouts.
+     *
+     * \param [in] segment the segment whose Interest expired
+     */
+    typedef void (*TimeoutTracedCallback)(uint32_t segment);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /// State of one segment of the content
+    struct SegmentState
+    {
+        Time sentTime;        //!< time of the last Interest for this segment
+        EventId timeout;      //!< Interest lifetime expiry
+        bool pending{false};  //!< Interest outstanding
+        bool received{false}; //!< Data received
+        bool retx{false};     //!< Interest has been retransmitted
+    };
+
+    /**
+     * \brief Send Interests until the window is full
+     */
+    void FillWindow();
+
+    /**
+     * \brief Express an Interest for a segment
+     * \param segment the segment number
+     */
+    void SendInterest(uint32_t segment);
+
+    /**
+     * \brief Interest lifetime expired
+     * \param segment the segment number
+     */
+    void OnTimeout(uint32_t segment);
+
+    /**
+     * \brief Grow the window after a received segment
+     */
+    void IncreaseWindow();
+
+    /**
+     * \brief Shrink the window after a congestion event
+     * \param sentTime send time of the Interest that timed out
+     */
+    void DecreaseWindow(Time sentTime);
+
+    /**
+     * \brief Finish the download and report statistics
+     */
+    void Complete();
+
+    Ptr<Node> m_node;
+    Ptr<CCNContentConsumer> m_consumer;
+    std::string m_contentName;
+
+    // window control
+    double m_initialWindow;
+    double m_minWindow;
+    double m_maxWindow;
+    double m_initialSsthresh;
+    double m_additiveIncrease;
+    double m_beta;
+    Time m_interestLifetime;
+    TracedValue<double> m_cwnd;
+    double m_ssthresh;
+    Time m_lastDecrease;
+
+    // pipeline state
+    std::vector<SegmentState> m_segments;
+    std::deque<uint32_t> m_retxQueue;
+    uint32_t m_nextSegment;
+    uint32_t m_finalSegment;
+    uint32_t m_inFlight;
+    uint32_t m_receivedSegments;
+
+    // statistics
+    Time m_startTime;
+    Time m_completionTime;
+    uint64_t m_receivedBytes;
+    uint32_t m_retransmissions;
+    bool m_complete;
+
+    /// Traced Callback: completion time and received bytes
+    TracedCallback<Time, uint64_t> m_completeTrace;
+    /// Traced Callback: segment whose Interest timed out
+    TracedCallback<uint32_t> m_timeoutTrace;
+};
+
+} // namespace ns3
+
+#endif /* _CCN_PIPELINED_CONSUMER_APP_H_ */
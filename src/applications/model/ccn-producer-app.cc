@@ -22,7 +22,17 @@ CCNProducerApp::GetTypeId()
                             .AddAttribute("ContentFile", "The file to produce",
                                             StringValue(""),
                                             MakeStringAccessor(&CCNProducerApp::m_contentFile),
-                                            MakeStringChecker());
+                                            MakeStringChecker())
+                            .AddAttribute("SegmentSize",
+                                          "Payload size of each Data segment",
+                                          UintegerValue(1024),
+                                          MakeUintegerAccessor(&CCNProducerApp::m_segmentSize),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("ContentSize",
+                                          "Size of a synthetic content served when no file is set",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&CCNProducerApp::m_contentSize),
+                                          MakeUintegerChecker<uint64_t>());
                                         
     return tid;
 }
@@ -61,6 +71,8 @@ CCNProducerApp::StartApplication()
     // set the content name
     producer->SetContentName(nodeName + "/" + m_contentName);
     producer->SetContentFile(m_contentFile);
+    producer->SetSegmentSize(m_segmentSize);
+    producer->SetContentSize(m_contentSize);
 }
 
 void
@@ -32,6 +32,8 @@ class CCNProducerApp : public Application
         Ptr<Node> m_node;
         std::string m_contentName;
         std::string m_contentFile;
+        uint32_t m_segmentSize;
+        uint64_t m_contentSize;
 };
 }
 
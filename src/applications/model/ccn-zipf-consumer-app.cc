@@ -0,0 +1,230 @@
+#include "ccn-zipf-consumer-app.h"
+
+#include "ns3/ccn-header.h"
+#include "ns3/ccn-l4-protocol.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("CCNZipfConsumerApp");
+
+NS_OBJECT_ENSURE_REGISTERED(CCNZipfConsumerApp);
+
+TypeId
+CCNZipfConsumerApp::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CCNZipfConsumerApp")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<CCNZipfConsumerApp>()
+            .AddAttribute("Prefix",
+                          "Name prefix of the catalog objects",
+                          StringValue(""),
+                          MakeStringAccessor(&CCNZipfConsumerApp::m_prefix),
+                          MakeStringChecker())
+            .AddAttribute("NumberOfContents",
+                          "Number of objects in the catalog",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&CCNZipfConsumerApp::m_numContents),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Alpha",
+                          "Exponent of the Zipf popularity distribution",
+                          DoubleValue(0.8),
+                          MakeDoubleAccessor(&CCNZipfConsumerApp::m_alpha),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Frequency",
+                          "Mean number of Interests sent per second",
+                          DoubleValue(100.0),
+                          MakeDoubleAccessor(&CCNZipfConsumerApp::m_frequency),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Randomize",
+                          "Use exponential inter-arrival times instead of a constant rate",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&CCNZipfConsumerApp::m_randomize),
+                          MakeBooleanChecker())
+            .AddTraceSource("Data",
+                            "A request has been satisfied",
+                            MakeTraceSourceAccessor(&CCNZipfConsumerApp::m_dataTrace),
+                            "ns3::CCNZipfConsumerApp::DataTracedCallback");
+    return tid;
+}
+
+CCNZipfConsumerApp::CCNZipfConsumerApp()
+    : m_sent(0),
+      m_received(0),
+      m_totalLatency(Time(0)),
+      m_totalHops(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_popularity = CreateObject<UniformRandomVariable>();
+    m_interArrival = CreateObject<ExponentialRandomVariable>();
+}
+
+CCNZipfConsumerApp::~CCNZipfConsumerApp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CCNZipfConsumerApp::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_pending.clear();
+    m_cdf.clear();
+    m_consumer = nullptr;
+    m_node = nullptr;
+    Application::DoDispose();
+}
+
+int64_t
+CCNZipfConsumerApp::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_popularity->SetStream(stream);
+    m_interArrival->SetStream(stream + 1);
+    return 2;
+}
+
+void
+CCNZipfConsumerApp::Install(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(this << node);
+    m_node = node;
+    node->AddApplication(this);
+}
+
+void
+CCNZipfConsumerApp::BuildCatalog()
+{
+    NS_LOG_FUNCTION(this);
+    m_cdf.resize(m_numContents);
+    double sum = 0.0;
+    for (uint32_t k = 0; k < m_numContents; k++)
+    {
+        sum += 1.0 / std::pow(k + 1, m_alpha);
+        m_cdf[k] = sum;
+    }
+    for (auto& p : m_cdf)
+    {
+        p /= sum;
+    }
+}
+
+uint32_t
+CCNZipfConsumerApp::DrawObject()
+{
+    double u = m_popularity->GetValue();
+    auto it = std::lower_bound(m_cdf.begin(), m_cdf.end(), u);
+    if (it == m_cdf.end())
+    {
+        --it;
+    }
+    return static_cast<uint32_t>(it - m_cdf.begin()) + 1;
+}
+
+void
+CCNZipfConsumerApp::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_node)
+    {
+        m_node = GetNode();
+    }
+
+    // Create a CCN Consumer receiving every object below the prefix
+    Ptr<CCNL4Protocol> ccnl4 = m_node->GetObject<CCNL4Protocol>();
+    NS_ASSERT_MSG(ccnl4, "CCNL4Protocol not found");
+    m_consumer = ccnl4->CreateContentConsumer();
+    m_consumer->SetContentName(m_prefix);
+    m_consumer->SetSegmentRecvCallback(MakeCallback(&CCNZipfConsumerApp::RecvData, this));
+
+    BuildCatalog();
+    m_interArrival->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
+    SendNext();
+}
+
+void
+CCNZipfConsumerApp::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+}
+
+void
+CCNZipfConsumerApp::SendNext()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::string name = m_prefix + "/" + std::to_string(DrawObject());
+    std::vector<Time>& requests = m_pending[name];
+    requests.push_back(Simulator::Now());
+    m_sent++;
+    if (requests.size() == 1)
+    {
+        NS_LOG_DEBUG("Requesting " << name);
+        m_consumer->GetSegment(name, 0);
+    }
+    else
+    {
+        // the Data of the pending Interest satisfies this request too
+        NS_LOG_DEBUG("Waiting for pending " << name);
+    }
+
+    Time next = Seconds(m_randomize ? m_interArrival->GetValue() : 1.0 / m_frequency);
+    m_sendEvent = Simulator::Schedule(next, &CCNZipfConsumerApp::SendNext, this);
+}
+
+void
+CCNZipfConsumerApp::RecvData(Ptr<Packet> packet, const CCNHeader& header)
+{
+    NS_LOG_FUNCTION(this << packet);
+
+    auto it = m_pending.find(header.GetContentName());
+    if (it == m_pending.end())
+    {
+        NS_LOG_DEBUG("Unexpected data for " << header.GetContentName());
+        return;
+    }
+
+    std::vector<Time> requests = std::move(it->second);
+    m_pending.erase(it);
+
+    for (const Time& sent : requests)
+    {
+        Time latency = Simulator::Now() - sent;
+        m_received++;
+        m_totalLatency += latency;
+        m_totalHops += header.GetHopCount();
+        m_dataTrace(header.GetContentName(), latency, header.GetHopCount());
+    }
+}
+
+uint64_t
+CCNZipfConsumerApp::GetSentInterests() const
+{
+    return m_sent;
+}
+
+uint64_t
+CCNZipfConsumerApp::GetReceivedData() const
+{
+    return m_received;
+}
+
+Time
+CCNZipfConsumerApp::GetAverageLatency() const
+{
+    return m_received ? m_totalLatency / static_cast<int64_t>(m_received) : Time(0);
+}
+
+double
+CCNZipfConsumerApp::GetAverageHopCount() const
+{
+    return m_received ? static_cast<double>(m_totalHops) / m_received : 0.0;
+}
+
+} // namespace ns3
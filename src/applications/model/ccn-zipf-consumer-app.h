@@ -0,0 +1,145 @@
+#ifndef _CCN_ZIPF_CONSUMER_APP_H_
+#define _CCN_ZIPF_CONSUMER_APP_H_
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class CCNContentConsumer;
+class CCNHeader;
+
+/**
+ * \ingroup applications
+ * \brief CCN consumer requesting objects of a catalog with Zipf popularity
+ *
+ * The catalog holds NumberOfContents single-segment objects named
+ * Prefix/1 ... Prefix/N. Object k is requested with probability
+ * proportional to 1/k^Alpha, at Frequency Interests per second with
+ * exponential (or constant) inter-arrival times. The popularity CDF is
+ * computed once at start, so drawing an object costs O(log N).
+ *
+ * Each satisfied Interest updates the latency and hop count statistics;
+ * the hop count is the number of CCN hops travelled by the Interest before
+ * it met a content store or the producer.
+ */
+class CCNZipfConsumerApp : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CCNZipfConsumerApp();
+    ~CCNZipfConsumerApp() override;
+
+    /**
+     * \brief Install to node
+     */
+    void Install(Ptr<Node> node);
+
+    /**
+     * \brief Data recv callback
+     * \param packet the payload
+     * \param header the CCN header of the Data
+     */
+    void RecvData(Ptr<Packet> packet, const CCNHeader& header);
+
+    /**
+     * \brief Number of objects requested
+     *
+     * A request for an object whose Interest is pending does not send
+     * another Interest, it waits for the same Data.
+     */
+    uint64_t GetSentInterests() const;
+
+    /**
+     * \brief Number of requests satisfied
+     */
+    uint64_t GetReceivedData() const;
+
+    /**
+     * \brief Mean Interest-to-Data latency of satisfied requests
+     */
+    Time GetAverageLatency() const;
+
+    /**
+     * \brief Mean hop count of satisfied requests
+     */
+    double GetAverageHopCount() const;
+
+    /**
+     * TracedCallback signature for satisfied requests.
+     *
+     * \param [in] name the object name
+     * \param [in] latency the Interest-to-Data latency
+     * \param [in] hops the hop count of the Data
+     */
+    typedef void (*DataTracedCallback)(const std::string& name, Time latency, uint32_t hops);
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /**
+     * \brief Compute the popularity CDF of the catalog
+     */
+    void BuildCatalog();
+
+    /**
+     * \brief Draw an object rank from the popularity distribution
+     * \return the rank, in [1, NumberOfContents]
+     */
+    uint32_t DrawObject();
+
+    /**
+     * \brief Send the next Interest and schedule the following one
+     */
+    void SendNext();
+
+    Ptr<Node> m_node;
+    Ptr<CCNContentConsumer> m_consumer;
+    std::string m_prefix;
+    uint32_t m_numContents;
+    double m_alpha;
+    double m_frequency;
+    bool m_randomize;
+
+    std::vector<double> m_cdf;
+    Ptr<UniformRandomVariable> m_popularity;
+    Ptr<ExponentialRandomVariable> m_interArrival;
+    EventId m_sendEvent;
+
+    /// request times per outstanding name, the first one sent the Interest
+    std::unordered_map<std::string, std::vector<Time>> m_pending;
+
+    uint64_t m_sent;
+    uint64_t m_received;
+    Time m_totalLatency;
+    uint64_t m_totalHops;
+
+    /// Traced Callback: satisfied requests
+    TracedCallback<const std::string&, Time, uint32_t> m_dataTrace;
+};
+
+} // namespace ns3
+
+#endif /* _CCN_ZIPF_CONSUMER_APP_H_ */
@@ -0,0 +1,230 @@
+#include "ns3/ccn-content-producer.h"
+#include "ns3/ccn-l4-protocol.h"
+#include "ns3/ccn-pipelined-consumer-app.h"
+#include "ns3/double.h"
+#include "ns3/error-model.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Window control of the pipelined CCN consumer
+ *
+ * A consumer and a producer on a 5 ms link. Without loss the window grows
+ * by one segment per Data in slow start and by 1/cwnd above the slow
+ * start threshold. When the producer drops the Interests for 10 ms, every
+ * Interest of the window times out, the window is halved once for the
+ * whole burst and the lost segments are retransmitted.
+ */
+class CCNPipelinedConsumerWindowTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param loss drop the Interests reaching the producer for a while
+     */
+    CCNPipelinedConsumerWindowTest(bool loss);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Window trace sink
+     * \param oldValue the previous window
+     * \param newValue the new window
+     */
+    void CwndChange(double oldValue, double newValue);
+
+    /**
+     * \brief Timeout trace sink
+     * \param segment the segment whose Interest expired
+     */
+    void Timeout(uint32_t segment);
+
+    /**
+     * \brief Completion trace sink
+     * \param completionTime time taken by the download
+     * \param bytes received payload bytes
+     */
+    void Complete(Time completionTime, uint64_t bytes);
+
+    bool m_loss;                                       //!< drop a burst of Interests
+    std::vector<std::pair<double, double>> m_changes;  //!< window changes
+    uint32_t m_timeouts;                               //!< Interests timed out
+    uint64_t m_completeBytes;                          //!< bytes reported on completion
+};
+
+static const uint32_t SEGMENT_SIZE = 512; //!< payload of a Data
+static const uint32_t SEGMENTS = 400;     //!< segments of the content
+
+CCNPipelinedConsumerWindowTest::CCNPipelinedConsumerWindowTest(bool loss)
+    : TestCase(loss ? "Pipelined CCN consumer halves its window on timeout"
+                    : "Pipelined CCN consumer grows its window"),
+      m_loss(loss),
+      m_timeouts(0),
+      m_completeBytes(0)
+{
+}
+
+void
+CCNPipelinedConsumerWindowTest::CwndChange(double oldValue, double newValue)
+{
+    m_changes.emplace_back(oldValue, newValue);
+}
+
+void
+CCNPipelinedConsumerWindowTest::Timeout(uint32_t segment)
+{
+    m_timeouts++;
+}
+
+void
+CCNPipelinedConsumerWindowTest::Complete(Time completionTime, uint64_t bytes)
+{
+    m_completeBytes = bytes;
+}
+
+void
+CCNPipelinedConsumerWindowTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    NetDeviceContainer devices = helper.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    nodes.Get(0)->GetObject<CCNL4Protocol>()->AddContentPrefixToHostAddress(
+        "P",
+        interfaces.GetAddress(1));
+
+    Ptr<CCNContentProducer> producer =
+        nodes.Get(1)->GetObject<CCNL4Protocol>()->CreateContentProducer();
+    producer->SetContentName("P/content");
+    producer->SetSegmentSize(SEGMENT_SIZE);
+    producer->SetContentSize(SEGMENT_SIZE * SEGMENTS);
+
+    Ptr<CCNPipelinedConsumerApp> consumer = CreateObject<CCNPipelinedConsumerApp>();
+    consumer->SetAttribute("ContentName", StringValue("P/content"));
+    if (m_loss)
+    {
+        consumer->SetAttribute("InitialWindow", DoubleValue(8));
+        consumer->SetAttribute("InitialSsthresh", DoubleValue(8));
+        consumer->SetAttribute("InterestLifetime", TimeValue(MilliSeconds(200)));
+    }
+    else
+    {
+        consumer->SetAttribute("InitialWindow", DoubleValue(1));
+        consumer->SetAttribute("InitialSsthresh", DoubleValue(4));
+    }
+    consumer->TraceConnectWithoutContext(
+        "CongestionWindow",
+        MakeCallback(&CCNPipelinedConsumerWindowTest::CwndChange, this));
+    consumer->TraceConnectWithoutContext("Timeout",
+                                         MakeCallback(&CCNPipelinedConsumerWindowTest::Timeout,
+                                                      this));
+    consumer->TraceConnectWithoutContext(
+        "DownloadComplete",
+        MakeCallback(&CCNPipelinedConsumerWindowTest::Complete, this));
+    consumer->Install(nodes.Get(0));
+    consumer->SetStartTime(Seconds(1));
+
+    if (m_loss)
+    {
+        Ptr<RateErrorModel> error = CreateObject<RateErrorModel>();
+        error->SetAttribute("ErrorRate", DoubleValue(1.0));
+        error->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+        error->Disable();
+        devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(error));
+        Simulator::Schedule(MilliSeconds(1050), &ErrorModel::Enable, error);
+        Simulator::Schedule(MilliSeconds(1060), &ErrorModel::Disable, error);
+    }
+
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(consumer->GetReceivedBytes(),
+                          SEGMENT_SIZE * SEGMENTS,
+                          "Download incomplete");
+    NS_TEST_EXPECT_MSG_EQ(m_completeBytes, SEGMENT_SIZE * SEGMENTS, "Completion not traced");
+    NS_TEST_EXPECT_MSG_EQ(consumer->GetRetransmissions(),
+                          m_timeouts,
+                          "Every timed out segment should be retransmitted once");
+
+    if (m_loss)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_timeouts, 1, "The whole window should time out");
+        uint32_t decreases = 0;
+        for (const auto& change : m_changes)
+        {
+            if (change.second < change.first)
+            {
+                NS_TEST_EXPECT_MSG_EQ_TOL(change.second,
+                                          change.first * 0.5,
+                                          1e-9,
+                                          "The window should be halved");
+                decreases++;
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(decreases, 1, "A burst of timeouts is a single congestion event");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_timeouts, 0, "No Interest should time out");
+        NS_TEST_ASSERT_MSG_GT(m_changes.size(), 5, "Too few window changes");
+        // slow start up to the threshold, then congestion avoidance
+        double expected[] = {1, 2, 3, 4, 4.25, 4.25 + 1 / 4.25};
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ_TOL(m_changes[i].second,
+                                      expected[i],
+                                      1e-9,
+                                      "Window change " << i);
+        }
+        for (const auto& change : m_changes)
+        {
+            NS_TEST_EXPECT_MSG_GT(change.second, change.first, "The window never shrinks");
+        }
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Pipelined CCN consumer TestSuite
+ */
+class CCNPipelinedConsumerTestSuite : public TestSuite
+{
+  public:
+    CCNPipelinedConsumerTestSuite()
+        : TestSuite("ccn-pipelined-consumer", UNIT)
+    {
+        AddTestCase(new CCNPipelinedConsumerWindowTest(false), TestCase::QUICK);
+        AddTestCase(new CCNPipelinedConsumerWindowTest(true), TestCase::QUICK);
+    }
+};
+
+static CCNPipelinedConsumerTestSuite
+    g_ccnPipelinedConsumerTestSuite; //!< Static variable for test initialization
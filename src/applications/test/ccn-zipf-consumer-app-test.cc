@@ -0,0 +1,138 @@
+#include "ns3/boolean.h"
+#include "ns3/ccn-content-producer.h"
+#include "ns3/ccn-l4-protocol.h"
+#include "ns3/ccn-zipf-consumer-app.h"
+#include "ns3/double.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Requests of the Zipf CCN consumer for pending objects
+ *
+ * A consumer requests two objects every 10 ms across a 50 ms link, so
+ * most requests find the object pending. They wait for the Data of the
+ * pending Interest instead of sending another one, and every request is
+ * satisfied by it, with a latency measured from its own request.
+ */
+class CCNZipfConsumerPendingTest : public TestCase
+{
+  public:
+    CCNZipfConsumerPendingTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Data trace sink
+     * \param name the object name
+     * \param latency the request-to-Data latency
+     * \param hops the hop count of the Data
+     */
+    void Data(const std::string& name, Time latency, uint32_t hops);
+
+    uint32_t m_data;   //!< requests traced as satisfied
+    Time m_maxLatency; //!< highest latency traced
+};
+
+CCNZipfConsumerPendingTest::CCNZipfConsumerPendingTest()
+    : TestCase("Zipf CCN consumer waits for the Data of pending objects"),
+      m_data(0),
+      m_maxLatency(0)
+{
+}
+
+void
+CCNZipfConsumerPendingTest::Data(const std::string& name, Time latency, uint32_t hops)
+{
+    m_data++;
+    m_maxLatency = std::max(m_maxLatency, latency);
+}
+
+void
+CCNZipfConsumerPendingTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(50)));
+    NetDeviceContainer devices = helper.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    nodes.Get(0)->GetObject<CCNL4Protocol>()->AddContentPrefixToHostAddress(
+        "P",
+        interfaces.GetAddress(1));
+
+    std::vector<Ptr<CCNContentProducer>> producers;
+    for (uint32_t k = 1; k <= 2; k++)
+    {
+        Ptr<CCNContentProducer> producer =
+            nodes.Get(1)->GetObject<CCNL4Protocol>()->CreateContentProducer();
+        producer->SetContentName("P/" + std::to_string(k));
+        producer->SetSegmentSize(512);
+        producer->SetContentSize(512);
+        producers.push_back(producer);
+    }
+
+    Ptr<CCNZipfConsumerApp> consumer = CreateObject<CCNZipfConsumerApp>();
+    consumer->SetAttribute("Prefix", StringValue("P"));
+    consumer->SetAttribute("NumberOfContents", UintegerValue(2));
+    consumer->SetAttribute("Frequency", DoubleValue(100));
+    consumer->SetAttribute("Randomize", BooleanValue(false));
+    consumer->TraceConnectWithoutContext("Data",
+                                         MakeCallback(&CCNZipfConsumerPendingTest::Data, this));
+    consumer->Install(nodes.Get(0));
+    consumer->SetStartTime(Seconds(1));
+    consumer->SetStopTime(Seconds(1.5));
+
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+
+    // the requests of [1 s, 1.5 s], the last one at 1.5 s is not sent
+    NS_TEST_EXPECT_MSG_EQ(consumer->GetSentInterests(), 50, "Requests not counted");
+    NS_TEST_EXPECT_MSG_EQ(consumer->GetReceivedData(),
+                          consumer->GetSentInterests(),
+                          "Every request should be satisfied");
+    NS_TEST_EXPECT_MSG_EQ(m_data, consumer->GetReceivedData(), "Satisfied requests not traced");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxLatency,
+                                MilliSeconds(101),
+                                "A request waited for a later Interest");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Zipf CCN consumer TestSuite
+ */
+class CCNZipfConsumerTestSuite : public TestSuite
+{
+  public:
+    CCNZipfConsumerTestSuite()
+        : TestSuite("ccn-zipf-consumer", UNIT)
+    {
+        AddTestCase(new CCNZipfConsumerPendingTest(), TestCase::QUICK);
+    }
+};
+
+static CCNZipfConsumerTestSuite g_ccnZipfConsumerTestSuite; //!< Static variable for test initialization
@@ -26,7 +26,10 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <atomic>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 /**
  * \file
@@ -216,6 +219,13 @@ class ArrayMatcher
     bool Matches(std::size_t i) const;
 
   private:
+    /**
+     * Parse one of the alternatives of the Config path specification:
+     * "*", an index or a range of indices "[min-max]".
+     *
+     * \param [in] alternative The alternative.
+     */
+    void Parse(std::string alternative);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -224,75 +234,87 @@ class ArrayMatcher
      * \returns \c true if the string could be converted.
      */
     bool StringToUint32(std::string str, uint32_t* value) const;
+
+    /** A range of the indices which match. */
+    struct Range
+    {
+        uint32_t min; //!< The first index.
+        uint32_t max; //!< The last index.
+    };
+
     /** The Config path element. */
     std::string m_element;
+    /** Whether all the indices match. */
+    bool m_all;
+    /** The ranges of the indices which match. */
+    std::vector<Range> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_all(false)
 {
     NS_LOG_FUNCTION(this << element);
+    std::string::size_type start = 0;
+    std::string::size_type bar = element.find('|');
+    while (bar != std::string::npos)
+    {
+        Parse(element.substr(start, bar - start));
+        start = bar + 1;
+        bar = element.find('|', start);
+    }
+    Parse(element.substr(start));
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string alternative)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    NS_LOG_FUNCTION(this << alternative);
+    if (alternative == "*")
     {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
+        m_all = true;
+        return;
     }
-    std::string::size_type tmp;
-    tmp = m_element.find('|');
-    if (tmp != std::string::npos)
+    std::string::size_type leftBracket = alternative.find('[');
+    std::string::size_type rightBracket = alternative.find(']');
+    std::string::size_type dash = alternative.find('-');
+    Range range;
+    if (leftBracket == 0 && rightBracket == alternative.size() - 1 && dash > leftBracket &&
+        dash < rightBracket)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
+        std::string lowerBound = alternative.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = alternative.substr(dash + 1, rightBracket - (dash + 1));
+        if (StringToUint32(lowerBound, &range.min) && StringToUint32(upperBound, &range.max))
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
+            m_ranges.push_back(range);
         }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
-        dash < rightBracket)
+    if (StringToUint32(alternative, &range.min))
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
-        uint32_t min;
-        uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
-        {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
-        }
+        range.max = range.min;
+        m_ranges.push_back(range);
     }
-    uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+}
+
+bool
+ArrayMatcher::Matches(std::size_t i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    if (m_all)
     {
         NS_LOG_DEBUG("Array " << i << " matches " << m_element);
         return true;
     }
+    for (const auto& range : m_ranges)
+    {
+        if (i >= range.min && i <= range.max)
+        {
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+            return true;
+        }
+    }
     NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
     return false;
 }
@@ -310,6 +332,11 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The path is split into its items once, and the attributes of each
+ * type which match an item are looked up the first time an object of
+ * the type is met, so a path is cheaper to resolve again from other
+ * roots or when the objects change.
  */
 class Resolver
 {
@@ -333,23 +360,60 @@ class Resolver
     void Resolve(Ptr<Object> root);
 
   private:
+    /** An attribute which leads to other objects. */
+    struct Attribute
+    {
+        std::string name; //!< The name of the attribute.
+        bool container;   //!< \c true for an ObjectPtrContainer, \c false for a Pointer.
+    };
+
+    /** An item of the Config path, between two slashes. */
+    struct Item
+    {
+        /**
+         * Constructor.
+         *
+         * \param [in] name The item.
+         */
+        Item(std::string name);
+
+        /** The item. */
+        std::string name;
+        /** The item as an index in an object container. */
+        ArrayMatcher index;
+        /** For a "$TypeId" item, whether \c tid was looked up. */
+        bool tidFound;
+        /** For a "$TypeId" item, the TypeId. */
+        TypeId tid;
+        /** The attributes which match the item, by uid of the TypeId of the objects. */
+        std::unordered_map<uint16_t, std::vector<Attribute>> attributes;
+    };
+
     /** Ensure the Config path starts and ends with a '/'. */
     void Canonicalize();
     /**
      * Parse the next element in the Config path.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] i The index of the next item of the Config path.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t i, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * \param [in] path The remaining Config path.
+     * \param [in] i The index of the item of the Config path with the index.
      * \param [in,out] vector The resulting list of matching objects.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t i, const ObjectPtrContainerValue& vector);
+    /**
+     * Get the attributes of a type which match an item.
+     *
+     * \param [in,out] item The item of the Config path.
+     * \param [in] tid The TypeId of the object.
+     * \returns The attributes, by the order of the search in the TypeId and its parents.
+     */
+    const std::vector<Attribute>& GetAttributes(Item& item, TypeId tid);
     /**
      * Handle one object found on the path.
      *
@@ -374,14 +438,32 @@ class Resolver
     std::vector<std::string> m_workStack;
     /** The Config path. */
     std::string m_path;
+    /** The items of the Config path. */
+    std::vector<Item> m_items;
 
 }; // class Resolver
 
+Resolver::Item::Item(std::string name)
+    : name(name),
+      index(name),
+      tidFound(false)
+{
+}
+
 Resolver::Resolver(std::string path)
     : m_path(path)
 {
     NS_LOG_FUNCTION(this << path);
     Canonicalize();
+
+    std::string::size_type start = 1;
+    std::string::size_type next = m_path.find('/', start);
+    while (next != std::string::npos)
+    {
+        m_items.emplace_back(m_path.substr(start, next - start));
+        start = next + 1;
+        next = m_path.find('/', start);
+    }
 }
 
 Resolver::~Resolver()
@@ -414,7 +496,7 @@ Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
@@ -440,14 +522,56 @@ Resolver::DoResolveOne(Ptr<Object> object)
     DoOne(object, GetResolvedPath());
 }
 
+const std::vector<Resolver::Attribute>&
+Resolver::GetAttributes(Item& item, TypeId tid)
+{
+    NS_LOG_FUNCTION(this << item.name << tid);
+    auto found = item.attributes.find(tid.GetUid());
+    if (found != item.attributes.end())
+    {
+        return found->second;
+    }
+
+    std::vector<Attribute>& attributes = item.attributes[tid.GetUid()];
+    TypeId nextTid = tid;
+    do
+    {
+        tid = nextTid;
+
+        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            struct TypeId::AttributeInformation info;
+            info = tid.GetAttribute(i);
+            if (info.name != item.name && item.name != "*")
+            {
+                continue;
+            }
+            // attempt to cast to a pointer checker.
+            if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) != nullptr)
+            {
+                attributes.push_back({info.name, false});
+            }
+            // attempt to cast to an object vector.
+            if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)) !=
+                nullptr)
+            {
+                attributes.push_back({info.name, true});
+            }
+            // this could be anything else and we don't know what to do with it.
+            // So, we just ignore it.
+        }
+
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
+    return attributes;
+}
+
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t i, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << i << root);
 
-    if (next == std::string::npos)
+    if (i == m_items.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -463,8 +587,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    Item& item = m_items[i];
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -475,11 +598,10 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     //
     if (!root)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        if (item.name.compare(0, 5, "Names") == 0)
         {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
+            m_workStack.push_back(item.name);
+            DoResolve(i + 1, root);
             m_workStack.pop_back();
             return;
         }
@@ -491,12 +613,12 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     // zero, this means to look in the root of the "/Names" name space, otherwise
     // it refers to a name space context (level).
     //
-    Ptr<Object> namedObject = Names::Find<Object>(root, item);
+    Ptr<Object> namedObject = Names::Find<Object>(root, item.name);
     if (namedObject)
     {
-        NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
+        NS_LOG_DEBUG("Name system resolved item = " << item.name << " to " << namedObject);
+        m_workStack.push_back(item.name);
+        DoResolve(i + 1, namedObject);
         m_workStack.pop_back();
         return;
     }
@@ -512,89 +634,68 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
+    std::string::size_type dollarPos = item.name.find('$');
     if (dollarPos == 0)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
-        Ptr<Object> object = root->GetObject<Object>(tid);
+        if (!item.tidFound)
+        {
+            item.tid = TypeId::LookupByName(item.name.substr(1, item.name.size() - 1));
+            item.tidFound = true;
+        }
+        NS_LOG_DEBUG("GetObject=" << item.tid << " on path=" << GetResolvedPath());
+        Ptr<Object> object = root->GetObject<Object>(item.tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << item.tid << ") failed on path=" << GetResolvedPath());
             return;
         }
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
+        m_workStack.push_back(item.name);
+        DoResolve(i + 1, object);
         m_workStack.pop_back();
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
         bool foundMatch = false;
-
-        do
+        for (const auto& attribute : GetAttributes(item, root->GetInstanceTypeId()))
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            if (!attribute.container)
             {
-                struct TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << attribute.name
+                                                  << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                root->GetAttribute(attribute.name, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item.name << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const PointerChecker* pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const ObjectPtrContainerChecker* vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                foundMatch = true;
+                m_workStack.push_back(attribute.name);
+                DoResolve(i + 1, object);
+                m_workStack.pop_back();
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
+            else
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << attribute.name
+                                                     << " on path=" << GetResolvedPath());
+                foundMatch = true;
+                ObjectPtrContainerValue vector;
+                root->GetAttribute(attribute.name, vector);
+                m_workStack.push_back(attribute.name);
+                DoArrayResolve(i + 1, vector);
+                m_workStack.pop_back();
+            }
+        }
 
         if (!foundMatch)
         {
-            NS_LOG_DEBUG("Requested item=" << item
+            NS_LOG_DEBUG("Requested item=" << item.name
                                            << " does not exist on path=" << GetResolvedPath());
             return;
         }
@@ -602,20 +703,15 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t i, const ObjectPtrContainerValue& container)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(path != "");
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << i << &container);
+    if (i == m_items.size())
     {
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
 
-    ArrayMatcher matcher = ArrayMatcher(item);
+    const ArrayMatcher& matcher = m_items[i].index;
     ObjectPtrContainerValue::Iterator it;
     for (it = container.Begin(); it != container.End(); ++it)
     {
@@ -624,12 +720,61 @@ Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& contai
             std::ostringstream oss;
             oss << (*it).first;
             m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
+            DoResolve(i + 1, (*it).second);
             m_workStack.pop_back();
         }
     }
 }
 
+/**
+ * \ingroup config-impl
+ * Resolver which collects the objects found and their contexts.
+ */
+class MatchesResolver : public Resolver
+{
+  public:
+    /**
+     * Construct from a base Config path.
+     *
+     * \param [in] path The Config path.
+     */
+    MatchesResolver(std::string path);
+
+    /** Forget the objects found. */
+    void Clear();
+
+    /** The objects found. */
+    std::vector<Ptr<Object>> m_objects;
+    /** The context of each object found. */
+    std::vector<std::string> m_contexts;
+
+  private:
+    void DoOne(Ptr<Object> object, std::string path) override;
+
+}; // class MatchesResolver
+
+MatchesResolver::MatchesResolver(std::string path)
+    : Resolver(path)
+{
+    NS_LOG_FUNCTION(this << path);
+}
+
+void
+MatchesResolver::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_objects.clear();
+    m_contexts.clear();
+}
+
+void
+MatchesResolver::DoOne(Ptr<Object> object, std::string path)
+{
+    NS_LOG_FUNCTION(this << object << path);
+    m_objects.push_back(object);
+    m_contexts.push_back(path);
+}
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -653,6 +798,13 @@ class ConfigImpl : public Singleton<ConfigImpl>
     void Disconnect(std::string path, const CallbackBase& cb);
     /** \copydoc ns3::Config::LookupMatches() */
     MatchContainer LookupMatches(std::string path);
+    /**
+     * Resolve a Config path from all the root namespace objects, and from
+     * the root of the "/Names" namespace.
+     *
+     * \param [in,out] resolver The resolver of the Config path.
+     */
+    void Resolve(Resolver& resolver) const;
 
     /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
     void RegisterRootNamespaceObject(Ptr<Object> obj);
@@ -665,6 +817,9 @@ class ConfigImpl : public Singleton<ConfigImpl>
     Ptr<Object> GetRootNamespaceObject(std::size_t i) const;
 
   private:
+    /** CompiledPath parses its path with ParsePath(). */
+    friend class CompiledPath;
+
     /**
      * Break a Config path into the leading path and the last leaf token.
      * \param [in] path The Config path.
@@ -783,23 +938,15 @@ ConfigImpl::LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(this << path);
 
-    class LookupMatchesResolver : public Resolver
-    {
-      public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
-        {
-        }
-
-        void DoOne(Ptr<Object> object, std::string path) override
-        {
-            m_objects.push_back(object);
-            m_contexts.push_back(path);
-        }
+    MatchesResolver resolver(path);
+    Resolve(resolver);
+    return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
+}
 
-        std::vector<Ptr<Object>> m_objects;
-        std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+void
+ConfigImpl::Resolve(Resolver& resolver) const
+{
+    NS_LOG_FUNCTION(this << &resolver);
 
     for (Roots::const_iterator i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -812,8 +959,6 @@ ConfigImpl::LookupMatches(std::string path)
     // looking at the root of the "/Names" namespace during this go.
     //
     resolver.Resolve(nullptr);
-
-    return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
 }
 
 void
@@ -821,6 +966,7 @@ ConfigImpl::RegisterRootNamespaceObject(Ptr<Object> obj)
 {
     NS_LOG_FUNCTION(this << obj);
     m_roots.push_back(obj);
+    NotifyNamespaceChange();
 }
 
 void
@@ -833,6 +979,7 @@ ConfigImpl::UnregisterRootNamespaceObject(Ptr<Object> obj)
         if (*i == obj)
         {
             m_roots.erase(i);
+            NotifyNamespaceChange();
             return;
         }
     }
@@ -852,6 +999,226 @@ ConfigImpl::GetRootNamespaceObject(std::size_t i) const
     return m_roots[i];
 }
 
+/**
+ * \ingroup config-impl
+ * The number of changes of the namespace so far.
+ */
+static std::atomic<uint64_t> g_namespaceChanges(0);
+
+/**
+ * \ingroup config-impl
+ * The parsed path of a CompiledPath, and the objects it resolved to.
+ */
+class CompiledPath::Program
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] path The Config path, without its last item.
+     */
+    Program(std::string path);
+
+    /** Destructor. */
+    ~Program();
+
+    /**
+     * Get the objects which match the path, resolving it again if the
+     * namespace changed since the last call.
+     *
+     * \returns The objects.
+     */
+    std::shared_ptr<MatchContainer> GetMatches();
+
+    /**
+     * Release the objects found, so that the objects removed from the
+     * namespace can be disposed of.
+     */
+    void Release();
+
+    /** \returns The programs alive. */
+    static std::unordered_set<Program*>& GetPrograms();
+
+  private:
+    /** The Config path, without its last item. */
+    std::string m_path;
+    /** The resolver of the path. */
+    MatchesResolver m_resolver;
+    /**
+     * The objects which match the path, if resolved.  The callers hold it
+     * while they use it, so a change of the namespace in between does not
+     * free it under them.
+     */
+    std::shared_ptr<MatchContainer> m_matches;
+    /** The number of changes of the namespace when \c m_matches was resolved. */
+    uint64_t m_changes;
+
+}; // class CompiledPath::Program
+
+CompiledPath::Program::Program(std::string path)
+    : m_path(path),
+      m_resolver(path),
+      m_changes(0)
+{
+    NS_LOG_FUNCTION(this << path);
+    GetPrograms().insert(this);
+}
+
+CompiledPath::Program::~Program()
+{
+    NS_LOG_FUNCTION(this);
+    GetPrograms().erase(this);
+}
+
+std::unordered_set<CompiledPath::Program*>&
+CompiledPath::Program::GetPrograms()
+{
+    static std::unordered_set<Program*> programs;
+    return programs;
+}
+
+std::shared_ptr<MatchContainer>
+CompiledPath::Program::GetMatches()
+{
+    NS_LOG_FUNCTION(this);
+    uint64_t changes = GetNamespaceChanges();
+    if (!m_matches || changes != m_changes)
+    {
+        NS_LOG_LOGIC("Resolve " << m_path);
+        ConfigImpl::Get()->Resolve(m_resolver);
+        m_matches =
+            std::make_shared<MatchContainer>(m_resolver.m_objects, m_resolver.m_contexts, m_path);
+        m_resolver.Clear();
+        m_changes = changes;
+    }
+    return m_matches;
+}
+
+void
+CompiledPath::Program::Release()
+{
+    NS_LOG_FUNCTION(this);
+    m_matches.reset();
+}
+
+CompiledPath::CompiledPath(std::string path)
+    : m_path(path)
+{
+    NS_LOG_FUNCTION(this << path);
+    std::string root;
+    ConfigImpl::Get()->ParsePath(path, &root, &m_leaf);
+    m_program = std::make_shared<Program>(root);
+}
+
+CompiledPath::~CompiledPath()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+CompiledPath::GetPath() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_path;
+}
+
+MatchContainer
+CompiledPath::LookupMatches() const
+{
+    NS_LOG_FUNCTION(this);
+    return *m_program->GetMatches();
+}
+
+void
+CompiledPath::Set(const AttributeValue& value) const
+{
+    NS_LOG_FUNCTION(this << &value);
+    m_program->GetMatches()->Set(m_leaf, value);
+}
+
+bool
+CompiledPath::SetFailSafe(const AttributeValue& value) const
+{
+    NS_LOG_FUNCTION(this << &value);
+    return m_program->GetMatches()->SetFailSafe(m_leaf, value);
+}
+
+void
+CompiledPath::Connect(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    if (!ConnectFailSafe(cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << m_path);
+    }
+}
+
+bool
+CompiledPath::ConnectFailSafe(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    return m_program->GetMatches()->ConnectFailSafe(m_leaf, cb);
+}
+
+void
+CompiledPath::ConnectWithoutContext(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    if (!ConnectWithoutContextFailSafe(cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << m_path);
+    }
+}
+
+bool
+CompiledPath::ConnectWithoutContextFailSafe(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    return m_program->GetMatches()->ConnectWithoutContextFailSafe(m_leaf, cb);
+}
+
+void
+CompiledPath::Disconnect(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    std::shared_ptr<MatchContainer> container = m_program->GetMatches();
+    if (container->GetN() == 0)
+    {
+        NS_LOG_WARN("Failed to disconnect from " << m_path << ", no object matches");
+    }
+    container->Disconnect(m_leaf, cb);
+}
+
+void
+CompiledPath::DisconnectWithoutContext(const CallbackBase& cb) const
+{
+    NS_LOG_FUNCTION(this << &cb);
+    std::shared_ptr<MatchContainer> container = m_program->GetMatches();
+    if (container->GetN() == 0)
+    {
+        NS_LOG_WARN("Failed to disconnect from " << m_path << ", no object matches");
+    }
+    container->DisconnectWithoutContext(m_leaf, cb);
+}
+
+void
+NotifyNamespaceChange()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    g_namespaceChanges.fetch_add(1, std::memory_order_relaxed);
+    for (CompiledPath::Program* program : CompiledPath::Program::GetPrograms())
+    {
+        program->Release();
+    }
+}
+
+uint64_t
+GetNamespaceChanges()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    return g_namespaceChanges.load(std::memory_order_relaxed);
+}
+
 void
 Reset()
 {
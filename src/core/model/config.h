@@ -21,6 +21,8 @@
 
 #include "ptr.h"
 
+#include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -361,6 +363,128 @@ class MatchContainer
  */
 MatchContainer LookupMatches(std::string path);
 
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to resolve it many times.
+ *
+ * Config::Set() and Config::Connect() parse their path and walk the
+ * namespace for each call, comparing the items of the path with the
+ * attributes of each object met.  A CompiledPath parses its path once,
+ * remembers which attributes of each type match each item, and resolves
+ * all the objects matched, such as the nodes of "/NodeList/\*", in a single
+ * walk.  It caches the objects found, and the next operations reuse them
+ * until the namespace changes: the cache is then released, so that a
+ * CompiledPath does not keep the objects removed from the namespace alive.
+ *
+ * The NodeList, the ChannelList, the Node, the Names, AggregateObject() and
+ * the registration of the root namespace objects call
+ * Config::NotifyNamespaceChange().  The other changes of the namespace,
+ * such as a new value of a pointer attribute, must be notified by the
+ * caller before using a CompiledPath which goes through them.
+ *
+ * \code
+ *   Config::CompiledPath path("/NodeList/[0-99]/DeviceList/0/MacTx");
+ *   path.Connect(MakeCallback(&MacTxTrace));
+ *   path.Disconnect(MakeCallback(&MacTxTrace));
+ * \endcode
+ */
+class CompiledPath
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] path A path to match attributes or trace sources,
+     *   as for Config::Set() and Config::Connect().
+     */
+    CompiledPath(std::string path);
+    /** Destructor. */
+    ~CompiledPath();
+
+    /**
+     * \returns The path.
+     */
+    std::string GetPath() const;
+    /**
+     * \returns A container of the objects which match the path, without
+     *   its last item, which is the attribute or the trace source.
+     */
+    MatchContainer LookupMatches() const;
+
+    /**
+     * \param [in] value The value to set in all matching attributes.
+     * \sa ns3::Config::Set
+     */
+    void Set(const AttributeValue& value) const;
+    /**
+     * \param [in] value The value to set in all matching attributes.
+     * \return \c true if any matching attributes could be set.
+     * \sa ns3::Config::SetFailSafe
+     */
+    bool SetFailSafe(const AttributeValue& value) const;
+    /**
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \sa ns3::Config::Connect
+     */
+    void Connect(const CallbackBase& cb) const;
+    /**
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \returns \c true if any trace sources could be connected.
+     * \sa ns3::Config::ConnectFailSafe
+     */
+    bool ConnectFailSafe(const CallbackBase& cb) const;
+    /**
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \sa ns3::Config::ConnectWithoutContext
+     */
+    void ConnectWithoutContext(const CallbackBase& cb) const;
+    /**
+     * \param [in] cb The callback to connect to the matching trace sources.
+     * \returns \c true if any trace sources could be connected.
+     * \sa ns3::Config::ConnectWithoutContextFailSafe
+     */
+    bool ConnectWithoutContextFailSafe(const CallbackBase& cb) const;
+    /**
+     * \param [in] cb The callback to disconnect from the matching trace sources.
+     * \sa ns3::Config::Disconnect
+     */
+    void Disconnect(const CallbackBase& cb) const;
+    /**
+     * \param [in] cb The callback to disconnect from the matching trace sources.
+     * \sa ns3::Config::DisconnectWithoutContext
+     */
+    void DisconnectWithoutContext(const CallbackBase& cb) const;
+
+  private:
+    /** The parsed path and the objects it resolved to, shared by the copies. */
+    class Program;
+
+    /** Releases the objects found by each Program. */
+    friend void NotifyNamespaceChange();
+
+    /** The path. */
+    std::string m_path;
+    /** The last item of the path, the attribute or the trace source. */
+    std::string m_leaf;
+    /** The parsed path, without its last item. */
+    std::shared_ptr<Program> m_program;
+};
+
+/**
+ * \ingroup config
+ *
+ * Notify that the objects reachable from the root namespace objects
+ * changed, so that the CompiledPath objects release the objects they
+ * found and resolve their path again.
+ */
+void NotifyNamespaceChange();
+
+/**
+ * \ingroup config
+ * \returns The number of calls to NotifyNamespaceChange() so far.
+ */
+uint64_t GetNamespaceChanges();
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -20,11 +20,18 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "double.h"
+#include "event-profiler.h"
+#include "event-trace-recorder.h"
+#include "fatal-error.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
+#include "uinteger.h"
 
 #include <cmath>
+#include <fstream>
 
 /**
  * \file
@@ -45,10 +52,44 @@ NS_OBJECT_ENSURE_REGISTERED(DefaultSimulatorImpl);
 TypeId
 DefaultSimulatorImpl::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
-                            .SetParent<SimulatorImpl>()
-                            .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+    static TypeId tid =
+        TypeId("ns3::DefaultSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Core")
+            .AddConstructor<DefaultSimulatorImpl>()
+            .AddAttribute("CompactionRatio",
+                          "Fraction of cancelled events among the pending ones above which "
+                          "the cancelled events are removed from the scheduler. "
+                          "1 disables the compaction.",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&DefaultSimulatorImpl::m_compactionRatio),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("CompactionMinEvents",
+                          "Minimum number of cancelled events for a compaction.",
+                          UintegerValue(4096),
+                          MakeUintegerAccessor(&DefaultSimulatorImpl::m_compactionMinEvents),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("EventTraceBufferSize",
+                          "Number of records of a buffer of the event trace.",
+                          UintegerValue(65536),
+                          MakeUintegerAccessor(&DefaultSimulatorImpl::m_eventTraceBufferSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("EventTraceFile",
+                          "File recording the operations on the scheduler, for "
+                          "bench-scheduler --replay. Empty to record nothing.",
+                          StringValue(""),
+                          MakeStringAccessor(&DefaultSimulatorImpl::SetEventTraceFile,
+                                             &DefaultSimulatorImpl::GetEventTraceFile),
+                          MakeStringChecker())
+            .AddAttribute("EventProfilePrefix",
+                          "Profile the wall time of the events by type and context. At the "
+                          "end of each Run(), the report is written to PREFIX.txt and the "
+                          "folded stacks, for flamegraph.pl, to PREFIX.folded. Empty to "
+                          "profile nothing.",
+                          StringValue(""),
+                          MakeStringAccessor(&DefaultSimulatorImpl::SetEventProfilePrefix,
+                                             &DefaultSimulatorImpl::GetEventProfilePrefix),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -61,8 +102,13 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentTs = 0;
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
+    m_cancelledEvents = 0;
+    m_compactionRatio = 0.5;
+    m_compactionMinEvents = 4096;
+    m_compactions = 0;
+    m_eventTraceBufferSize = 65536;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_eventsWithContext = nullptr;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -83,6 +129,7 @@ DefaultSimulatorImpl::DoDispose()
         next.impl->Unref();
     }
     m_events = nullptr;
+    m_recorder = nullptr;
     SimulatorImpl::DoDispose();
 }
 
@@ -107,6 +154,7 @@ DefaultSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
 {
     NS_LOG_FUNCTION(this << schedulerFactory);
     Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+    m_schedulerFactory = schedulerFactory;
 
     if (m_events)
     {
@@ -136,17 +184,125 @@ DefaultSimulatorImpl::ProcessOneEvent()
     NS_ASSERT(next.key.m_ts >= m_currentTs);
     m_unscheduledEvents--;
     m_eventCount++;
+    if (m_recorder)
+    {
+        m_recorder->Record(EventTraceRecord::EXECUTE,
+                           next.key.m_ts,
+                           next.key.m_uid,
+                           next.key.m_context);
+    }
+    if (next.impl->IsCancelled())
+    {
+        m_cancelledEvents--;
+    }
 
     NS_LOG_LOGIC("handle " << next.key.m_ts);
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (m_profiler)
+    {
+        m_profiler->Invoke(next.impl, next.key.m_context);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
+    if (m_cancelledEvents >= m_compactionMinEvents &&
+        m_cancelledEvents > m_compactionRatio * m_unscheduledEvents)
+    {
+        Compact();
+    }
+
     ProcessEventsWithContext();
 }
 
+void
+DefaultSimulatorImpl::Compact()
+{
+    NS_LOG_FUNCTION(this << m_cancelledEvents << m_unscheduledEvents);
+    if (m_recorder)
+    {
+        m_recorder->Record(EventTraceRecord::COMPACT, m_currentTs, 0, 0);
+    }
+    // Into a fresh scheduler: some, as the CalendarScheduler, do not expect
+    // an event earlier than the last one removed. In time order, which is
+    // the cheapest insertion order for most schedulers.
+    Ptr<Scheduler> events = m_schedulerFactory.Create<Scheduler>();
+    while (!m_events->IsEmpty())
+    {
+        Scheduler::Event ev = m_events->RemoveNext();
+        if (ev.impl->IsCancelled())
+        {
+            ev.impl->Unref();
+            m_unscheduledEvents--;
+        }
+        else
+        {
+            events->Insert(ev);
+        }
+    }
+    m_events = events;
+    m_cancelledEvents = 0;
+    m_compactions++;
+}
+
+void
+DefaultSimulatorImpl::SetEventTraceFile(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_recorder = nullptr;
+    m_eventTraceFile = filename;
+    if (!filename.empty())
+    {
+        m_recorder = std::make_unique<EventTraceRecorder>(filename, m_eventTraceBufferSize);
+    }
+}
+
+std::string
+DefaultSimulatorImpl::GetEventTraceFile() const
+{
+    return m_eventTraceFile;
+}
+
+void
+DefaultSimulatorImpl::SetEventProfilePrefix(std::string prefix)
+{
+    NS_LOG_FUNCTION(this << prefix);
+    m_profiler = nullptr;
+    m_eventProfilePrefix = prefix;
+    if (!prefix.empty())
+    {
+        m_profiler = std::make_unique<EventProfiler>();
+    }
+}
+
+std::string
+DefaultSimulatorImpl::GetEventProfilePrefix() const
+{
+    return m_eventProfilePrefix;
+}
+
+void
+DefaultSimulatorImpl::WriteEventProfile() const
+{
+    if (!m_profiler)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    std::ofstream report(m_eventProfilePrefix + ".txt");
+    std::ofstream folded(m_eventProfilePrefix + ".folded");
+    if (!report || !folded)
+    {
+        NS_FATAL_ERROR("Cannot write the event profile " << m_eventProfilePrefix);
+    }
+    m_profiler->Report(report);
+    m_profiler->WriteFolded(folded);
+}
+
 bool
 DefaultSimulatorImpl::IsFinished() const
 {
@@ -156,30 +312,38 @@ DefaultSimulatorImpl::IsFinished() const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    if (m_eventsWithContext.load(std::memory_order_relaxed) == nullptr)
     {
         return;
     }
 
-    // swap queues
-    EventsWithContext eventsWithContext;
+    // take the whole stack, and reverse it to insert in the order of the pushes
+    EventWithContext* pushed = m_eventsWithContext.exchange(nullptr, std::memory_order_acquire);
+    EventWithContext* events = nullptr;
+    while (pushed != nullptr)
     {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        EventWithContext* next = pushed->next;
+        pushed->next = events;
+        events = pushed;
+        pushed = next;
     }
-    while (!eventsWithContext.empty())
+    while (events != nullptr)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
+        EventWithContext* event = events;
+        events = event->next;
         Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
+        ev.impl = event->event;
+        ev.key.m_ts = m_currentTs + event->timestamp;
+        ev.key.m_context = event->context;
+        delete event;
         ev.key.m_uid = m_uid;
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        if (m_recorder)
+        {
+            m_recorder->Record(EventTraceRecord::INSERT, ev.key.m_ts, ev.key.m_uid, ev.key.m_context);
+        }
     }
 }
 
@@ -196,6 +360,7 @@ DefaultSimulatorImpl::Run()
     {
         ProcessOneEvent();
     }
+    WriteEventProfile();
 
     // If the simulator stopped naturally by lack of events, make a
     // consistency test to check that we didn't lose any events along the way.
@@ -237,6 +402,10 @@ DefaultSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
     m_uid++;
     m_unscheduledEvents++;
     m_events->Insert(ev);
+    if (m_recorder)
+    {
+        m_recorder->Record(EventTraceRecord::INSERT, ev.key.m_ts, ev.key.m_uid, ev.key.m_context);
+    }
     return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -256,18 +425,21 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
+        if (m_recorder)
+        {
+            m_recorder->Record(EventTraceRecord::INSERT, ev.key.m_ts, ev.key.m_uid, ev.key.m_context);
+        }
     }
     else
     {
-        EventWithContext ev;
-        ev.context = context;
         // Current time added in ProcessEventsWithContext()
-        ev.timestamp = delay.GetTimeStep();
-        ev.event = event;
+        auto ev = new EventWithContext{context, (uint64_t)delay.GetTimeStep(), event, nullptr};
+        ev->next = m_eventsWithContext.load(std::memory_order_relaxed);
+        while (!m_eventsWithContext.compare_exchange_weak(ev->next,
+                                                          ev,
+                                                          std::memory_order_release,
+                                                          std::memory_order_relaxed))
         {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
         }
     }
 }
@@ -339,6 +511,13 @@ DefaultSimulatorImpl::Remove(const EventId& id)
     event.key.m_context = id.GetContext();
     event.key.m_uid = id.GetUid();
     m_events->Remove(event);
+    if (m_recorder)
+    {
+        m_recorder->Record(EventTraceRecord::REMOVE,
+                           event.key.m_ts,
+                           event.key.m_uid,
+                           event.key.m_context);
+    }
     event.impl->Cancel();
     // whenever we remove an event from the event list, we have to unref it.
     event.impl->Unref();
@@ -352,6 +531,17 @@ DefaultSimulatorImpl::Cancel(const EventId& id)
     if (!IsExpired(id))
     {
         id.PeekEventImpl()->Cancel();
+        if (id.GetUid() != EventId::UID::DESTROY)
+        {
+            m_cancelledEvents++;
+            if (m_recorder)
+            {
+                m_recorder->Record(EventTraceRecord::CANCEL,
+                                   id.GetTs(),
+                                   id.GetUid(),
+                                   id.GetContext());
+            }
+        }
     }
 }
 
@@ -405,4 +595,22 @@ DefaultSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetLiveEventCount() const
+{
+    return m_unscheduledEvents - m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetCancelledEventCount() const
+{
+    return m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetCompactionCount() const
+{
+    return m_compactions;
+}
+
 } // namespace ns3
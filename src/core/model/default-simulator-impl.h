@@ -22,8 +22,10 @@
 
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <thread>
 
 /**
@@ -37,11 +39,25 @@ namespace ns3
 
 // Forward
 class Scheduler;
+class EventProfiler;
+class EventTraceRecorder;
 
 /**
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * A cancelled event stays in the scheduler until its time comes, when it
+ * is skipped.  Models which cancel and reschedule timers all the time can
+ * fill the scheduler with such dead events, so the event list is
+ * compacted when they become the given fraction of the pending events:
+ * the live events are re-inserted in a fresh pass and the dead ones are
+ * released.  Compaction costs a pass over the event list, and is
+ * amortized over the cancellations which triggered it.
+ *
+ * When the EventTraceFile attribute is set, every operation on the
+ * scheduler is recorded there by an EventTraceRecorder, to be replayed
+ * offline by `utils/bench-scheduler`.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -78,11 +94,59 @@ class DefaultSimulatorImpl : public SimulatorImpl
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
 
+    /**
+     * Get the number of pending events which have not been cancelled.
+     *
+     * \returns The number of live events.
+     */
+    uint64_t GetLiveEventCount() const;
+    /**
+     * Get the number of cancelled events still held by the scheduler.
+     *
+     * \returns The number of dead events.
+     */
+    uint64_t GetCancelledEventCount() const;
+    /**
+     * Get the number of compactions of the event list.
+     *
+     * \returns The number of compactions.
+     */
+    uint64_t GetCompactionCount() const;
+
   private:
     void DoDispose() override;
 
     /** Process the next event. */
     void ProcessOneEvent();
+    /** Release the cancelled events held by the scheduler. */
+    void Compact();
+    /**
+     * Start recording the event trace.
+     *
+     * \param [in] filename The trace file, empty to stop recording.
+     */
+    void SetEventTraceFile(std::string filename);
+    /**
+     * Get the event trace file.
+     *
+     * \returns The trace file.
+     */
+    std::string GetEventTraceFile() const;
+    /**
+     * Start or stop profiling the events.
+     *
+     * \param [in] prefix The prefix of the profile files, empty to stop
+     *            profiling.
+     */
+    void SetEventProfilePrefix(std::string prefix);
+    /**
+     * Get the prefix of the profile files.
+     *
+     * \returns The prefix.
+     */
+    std::string GetEventProfilePrefix() const;
+    /** Write the event profile, if profiling. */
+    void WriteEventProfile() const;
     /** Move events from a different context into the main event queue. */
     void ProcessEventsWithContext();
 
@@ -95,18 +159,17 @@ class DefaultSimulatorImpl : public SimulatorImpl
         uint64_t timestamp;
         /** The event implementation. */
         EventImpl* event;
+        /** The event pushed before this one. */
+        EventWithContext* next;
     };
-    /** Container type for the events from a different context. */
-    typedef std::list<struct EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * The events from a different context: a lock-free stack the other
+     * threads push to, most recent first.  \c nullptr when all events with
+     * context have been moved to the primary event queue, so the main
+     * loop only reads this one atomic when there are none.  Kept on its
+     * own cache line, away from the state of the main loop.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    alignas(64) std::atomic<EventWithContext*> m_eventsWithContext;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
@@ -133,6 +196,29 @@ class DefaultSimulatorImpl : public SimulatorImpl
      */
     int m_unscheduledEvents;
 
+    /** Number of cancelled events still in the scheduler. */
+    uint64_t m_cancelledEvents;
+    /** Fraction of dead events among the pending ones triggering a compaction. */
+    double m_compactionRatio;
+    /** Minimum number of dead events triggering a compaction. */
+    uint32_t m_compactionMinEvents;
+    /** Number of compactions. */
+    uint64_t m_compactions;
+    /** Factory of the scheduler, to compact into a fresh one. */
+    ObjectFactory m_schedulerFactory;
+
+    /** The event trace file. */
+    std::string m_eventTraceFile;
+    /** Number of records of a buffer of the event trace. */
+    uint32_t m_eventTraceBufferSize;
+    /** The event trace recorder, if recording. */
+    std::unique_ptr<EventTraceRecorder> m_recorder;
+
+    /** The prefix of the event profile files. */
+    std::string m_eventProfilePrefix;
+    /** The event profiler, if profiling. */
+    std::unique_ptr<EventProfiler> m_profiler;
+
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
 };
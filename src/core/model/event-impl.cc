@@ -21,6 +21,8 @@
 
 #include "log.h"
 
+#include <mutex>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +34,185 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Granularity of the size classes of the event pool. */
+constexpr std::size_t POOL_GRANULARITY = 16;
+/** Largest event served by the event pool. */
+constexpr std::size_t POOL_MAX_SIZE = 256;
+/** Number of size classes of the event pool. */
+constexpr std::size_t POOL_CLASSES = POOL_MAX_SIZE / POOL_GRANULARITY;
+/** Size of the chunks carved into events. */
+constexpr std::size_t POOL_CHUNK_SIZE = 64 * 1024;
+/** Largest number of events in a free list of a thread. */
+constexpr std::size_t POOL_CACHE_MAX = 1024;
+/** Number of events moved at once between a thread and the depot. */
+constexpr std::size_t POOL_BATCH = POOL_CACHE_MAX / 2;
+
+/** A released event, linked in the free list of its size class. */
+struct FreeBlock
+{
+    FreeBlock* next; /**< Next released event. */
+};
+
+/**
+ * Free lists shared by all threads: the new chunks, the overflow of the
+ * threads and the free lists of the threads which have exited.
+ */
+struct PoolDepot
+{
+    std::mutex mutex;                /**< Protects the free lists. */
+    FreeBlock* free[POOL_CLASSES]{}; /**< Free list of each size class. */
+};
+
+/**
+ * Get the depot of the event pool.
+ *
+ * The depot is never destroyed: events may still be released by the
+ * destructors of static objects.
+ *
+ * \returns The depot.
+ */
+PoolDepot&
+GetPoolDepot()
+{
+    static PoolDepot* depot = new PoolDepot();
+    return *depot;
+}
+
+/**
+ * Free lists of a thread.
+ *
+ * Trivially destructible, so that it is still usable by the events
+ * released after the thread-local destructors have run.
+ */
+struct PoolCache
+{
+    FreeBlock* free[POOL_CLASSES];   /**< Free list of each size class. */
+    std::size_t count[POOL_CLASSES]; /**< Length of each free list. */
+    EventImpl::PoolStats stats;      /**< Allocation counters. */
+    bool started;                    /**< The reaper of the thread is registered. */
+    bool finished;                   /**< The thread is exiting. */
+};
+
+/** The free lists of the current thread. */
+thread_local PoolCache t_poolCache;
+
+/** Hands the free lists of an exiting thread over to the depot. */
+struct PoolReaper
+{
+    ~PoolReaper()
+    {
+        PoolDepot& depot = GetPoolDepot();
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        for (std::size_t c = 0; c < POOL_CLASSES; ++c)
+        {
+            while (t_poolCache.free[c] != nullptr)
+            {
+                FreeBlock* block = t_poolCache.free[c];
+                t_poolCache.free[c] = block->next;
+                block->next = depot.free[c];
+                depot.free[c] = block;
+            }
+            t_poolCache.count[c] = 0;
+        }
+        t_poolCache.finished = true;
+    }
+};
+
+/** The reaper of the current thread, registered on first use of the pool. */
+thread_local PoolReaper t_poolReaper;
+
+/** Register the reaper of the current thread. */
+inline void
+StartPool()
+{
+    if (!t_poolCache.started)
+    {
+        t_poolCache.started = true;
+        static_cast<void>(&t_poolReaper);
+    }
+}
+
+/**
+ * Refill an empty free list of the current thread with a batch of events
+ * from the depot, after carving a new chunk into the depot when it has no
+ * events of the size class.
+ *
+ * \param [in] c The size class.
+ */
+void
+RefillPool(std::size_t c)
+{
+    StartPool();
+
+    PoolDepot& depot = GetPoolDepot();
+    std::unique_lock<std::mutex> lock(depot.mutex);
+    if (depot.free[c] == nullptr)
+    {
+        lock.unlock();
+        std::size_t size = (c + 1) * POOL_GRANULARITY;
+        char* chunk = static_cast<char*>(::operator new(POOL_CHUNK_SIZE));
+        t_poolCache.stats.chunks++;
+        FreeBlock* head = nullptr;
+        FreeBlock* tail = nullptr;
+        for (std::size_t offset = POOL_CHUNK_SIZE / size * size; offset > 0; offset -= size)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset - size);
+            block->next = head;
+            head = block;
+            if (tail == nullptr)
+            {
+                tail = block;
+            }
+        }
+        lock.lock();
+        tail->next = depot.free[c];
+        depot.free[c] = head;
+    }
+
+    FreeBlock* head = depot.free[c];
+    FreeBlock* tail = head;
+    std::size_t n = 1;
+    while (n < POOL_BATCH && tail->next != nullptr)
+    {
+        tail = tail->next;
+        ++n;
+    }
+    depot.free[c] = tail->next;
+    tail->next = nullptr;
+    t_poolCache.free[c] = head;
+    t_poolCache.count[c] = n;
+}
+
+/**
+ * Return a batch of events of a full free list of the current thread to
+ * the depot, so that a thread releasing the events of another one does
+ * not keep them all.
+ *
+ * \param [in] c The size class.
+ */
+void
+DrainPool(std::size_t c)
+{
+    FreeBlock* head = t_poolCache.free[c];
+    FreeBlock* tail = head;
+    for (std::size_t n = 1; n < POOL_BATCH; ++n)
+    {
+        tail = tail->next;
+    }
+    t_poolCache.free[c] = tail->next;
+    t_poolCache.count[c] -= POOL_BATCH;
+
+    PoolDepot& depot = GetPoolDepot();
+    std::lock_guard<std::mutex> lock(depot.mutex);
+    tail->next = depot.free[c];
+    depot.free[c] = head;
+}
+
+} // unnamed namespace
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -67,4 +248,78 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+// No logging in the allocation functions: the log itself may schedule events.
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    PoolCache& cache = t_poolCache;
+    cache.stats.allocations++;
+#ifdef NS3_EVENT_POOL_ENABLE
+    if (size <= POOL_MAX_SIZE)
+    {
+        std::size_t c = (size - 1) / POOL_GRANULARITY;
+        if (cache.free[c] == nullptr)
+        {
+            RefillPool(c);
+        }
+        FreeBlock* block = cache.free[c];
+        cache.free[c] = block->next;
+        cache.count[c]--;
+        return block;
+    }
+#endif
+    cache.stats.heap++;
+    return ::operator new(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+#ifdef NS3_EVENT_POOL_ENABLE
+    if (size <= POOL_MAX_SIZE)
+    {
+        std::size_t c = (size - 1) / POOL_GRANULARITY;
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        if (t_poolCache.finished)
+        {
+            PoolDepot& depot = GetPoolDepot();
+            std::lock_guard<std::mutex> lock(depot.mutex);
+            block->next = depot.free[c];
+            depot.free[c] = block;
+            return;
+        }
+        StartPool();
+        block->next = t_poolCache.free[c];
+        t_poolCache.free[c] = block;
+        if (++t_poolCache.count[c] > POOL_CACHE_MAX)
+        {
+            DrainPool(c);
+        }
+        return;
+    }
+#endif
+    ::operator delete(p);
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t align)
+{
+    t_poolCache.stats.allocations++;
+    t_poolCache.stats.heap++;
+    return ::operator new(size, align);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */, std::align_val_t align)
+{
+    ::operator delete(p, align);
+}
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats()
+{
+    return t_poolCache.stats;
+}
+
 } // namespace ns3
@@ -21,6 +21,8 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 /**
@@ -41,6 +43,16 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are short-lived and allocated at a high rate, so their memory
+ * is recycled: an event of up to 256 bytes comes from a free list of its
+ * size class, kept per thread, and goes back to the free list of the
+ * thread which releases it. A free list holds at most 1024 events, the
+ * overflow goes to a depot shared by the threads, which refills the empty
+ * free lists. The depot is fed by carving large chunks, which are kept
+ * for the lifetime of the process, and takes the free lists of an
+ * exiting thread. The pool is
+ * disabled with the NS3_EVENT_POOL build option, and in sanitizer builds.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +79,52 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the memory of an event.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event.
+     *
+     * \param [in] p The memory.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * Allocate the memory of an over-aligned event, outside of the pool.
+     *
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     * \returns The memory.
+     */
+    static void* operator new(std::size_t size, std::align_val_t align);
+    /**
+     * Release the memory of an over-aligned event.
+     *
+     * \param [in] p The memory.
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     */
+    static void operator delete(void* p, std::size_t size, std::align_val_t align);
+
+    /** Allocation counters of the event pool of a thread. */
+    struct PoolStats
+    {
+        uint64_t allocations; /**< Events allocated. */
+        uint64_t chunks;      /**< Chunks allocated from the heap to refill the free lists. */
+        uint64_t heap;        /**< Events allocated from the heap, outside of the pool. */
+    };
+
+    /**
+     * Get the allocation counters of the calling thread.
+     *
+     * \returns The counters since the start of the thread.
+     */
+    static PoolStats GetPoolStats();
+
   protected:
     /**
      * Implementation for Invoke().
@@ -0,0 +1,208 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+EventProfiler::EventProfiler()
+    : m_lastType(nullptr),
+      m_lastIndex(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EventProfiler::Account(const std::type_info& type, uint32_t context, uint64_t ns)
+{
+    // Events of the same type often follow each other
+    if (m_lastType != &type)
+    {
+        auto [it, inserted] = m_typeIndex.emplace(type, m_types.size());
+        if (inserted)
+        {
+            m_types.emplace_back(type);
+        }
+        m_lastType = &type;
+        m_lastIndex = it->second;
+    }
+    Entry& entry = m_entries[(static_cast<uint64_t>(m_lastIndex) << 32) | context];
+    entry.events++;
+    entry.ns += ns;
+}
+
+uint64_t
+EventProfiler::GetEvents() const
+{
+    uint64_t events = 0;
+    for (const auto& [key, entry] : m_entries)
+    {
+        events += entry.events;
+    }
+    return events;
+}
+
+std::string
+EventProfiler::GetTypeName(std::type_index type)
+{
+    std::string name = type.name();
+#if (__GNUC__ >= 3)
+    int status;
+    char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+
+    // "ns3::MakeEvent<ARGS>(PARAMS)::EventMemberImpl0" is named by ARGS,
+    // the signature of the function and the type of the object.
+    const std::string prefix = "ns3::MakeEvent<";
+    if (name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return name;
+    }
+    int depth = 0;
+    for (std::size_t i = prefix.size() - 1; i < name.size(); ++i)
+    {
+        if (name[i] == '<')
+        {
+            depth++;
+        }
+        else if (name[i] == '>' && --depth == 0)
+        {
+            return name.substr(5, i - 4);
+        }
+    }
+    return name;
+}
+
+std::string
+EventProfiler::GetContextName(uint32_t context)
+{
+    if (context == Simulator::NO_CONTEXT)
+    {
+        return "global";
+    }
+    std::ostringstream oss;
+    oss << "node " << context;
+    return oss.str();
+}
+
+namespace
+{
+
+/**
+ * \ingroup events
+ * Write a table of the time spent, by decreasing time.
+ *
+ * \tparam E \deduced The type of the time spent in a row.
+ * \param [in] os The output stream.
+ * \param [in] rows The time spent per row name.
+ * \param [in] total The total time, in nanoseconds.
+ * \param [in] label The header of the name column.
+ */
+template <typename E>
+void
+WriteTable(std::ostream& os,
+           const std::map<std::string, E>& rows,
+           uint64_t total,
+           const std::string& label)
+{
+    std::vector<std::pair<std::string, E>> sorted(rows.begin(), rows.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.ns > b.second.ns;
+    });
+    os << std::left << std::setw(12) << "Time (s)" << std::setw(8) << "Share" << std::setw(12)
+       << "Events" << std::setw(12) << "Mean (ns)" << label << std::endl;
+    for (const auto& [name, entry] : sorted)
+    {
+        os << std::left << std::setw(12) << entry.ns / 1e9 << std::setw(8)
+           << (total > 0 ? 100.0 * entry.ns / total : 0) << std::setw(12) << entry.events
+           << std::setw(12) << entry.ns / entry.events << name << std::endl;
+    }
+}
+
+} // unnamed namespace
+
+void
+EventProfiler::Report(std::ostream& os) const
+{
+    std::map<std::string, Entry> types;
+    std::map<std::string, Entry> contexts;
+    uint64_t events = 0;
+    uint64_t total = 0;
+    for (const auto& [key, entry] : m_entries)
+    {
+        Entry& type = types[GetTypeName(m_types[key >> 32])];
+        type.events += entry.events;
+        type.ns += entry.ns;
+        Entry& context = contexts[GetContextName(key & 0xffffffff)];
+        context.events += entry.events;
+        context.ns += entry.ns;
+        events += entry.events;
+        total += entry.ns;
+    }
+
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision(3);
+    os << "Event profile: " << events << " events, " << total / 1e9 << " s" << std::endl
+       << std::endl;
+    WriteTable(os, types, total, "Event type");
+    os << std::endl;
+    WriteTable(os, contexts, total, "Context");
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void
+EventProfiler::WriteFolded(std::ostream& os) const
+{
+    std::map<std::string, uint64_t> stacks;
+    for (const auto& [key, entry] : m_entries)
+    {
+        stacks[GetContextName(key & 0xffffffff) + ";" + GetTypeName(m_types[key >> 32])] +=
+            entry.ns;
+    }
+    for (const auto& [stack, ns] : stacks)
+    {
+        os << stack << " " << ns << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,144 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+
+#include <chrono>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup events
+ * \brief Measures the wall time spent in the events of a simulation.
+ *
+ * The time of each EventImpl::Invoke() is accounted to the type of the
+ * event and to its context.  The type of an event made by MakeEvent()
+ * names the class and the signature of its function, or the lambda it
+ * runs, so the time of the callbacks of a model adds up under its name.
+ *
+ * Report() lists the event types and the contexts by decreasing time.
+ * WriteFolded() writes the time of each type in each context as folded
+ * stacks, the input of flamegraph.pl: one line per context and type,
+ * "context;type nanoseconds".
+ */
+class EventProfiler
+{
+  public:
+    /** Constructor. */
+    EventProfiler();
+
+    EventProfiler(const EventProfiler&) = delete;
+    EventProfiler& operator=(const EventProfiler&) = delete;
+
+    /**
+     * Invoke an event, measuring its wall time.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     */
+    void Invoke(EventImpl* event, uint32_t context)
+    {
+        const std::type_info& type = typeid(*event);
+        auto start = std::chrono::steady_clock::now();
+        event->Invoke();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Account(type,
+                context,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    /**
+     * Write the report, sorted by decreasing time.
+     *
+     * \param [in] os The output stream.
+     */
+    void Report(std::ostream& os) const;
+    /**
+     * Write the folded stacks.
+     *
+     * \param [in] os The output stream.
+     */
+    void WriteFolded(std::ostream& os) const;
+
+    /**
+     * Get the number of events invoked.
+     *
+     * \returns The number of events.
+     */
+    uint64_t GetEvents() const;
+    /**
+     * Get the readable name of an event type.
+     *
+     * \param [in] type The type of the event.
+     * \returns The demangled name, without the internals of MakeEvent().
+     */
+    static std::string GetTypeName(std::type_index type);
+
+  private:
+    /** Time spent in some events. */
+    struct Entry
+    {
+        uint64_t events = 0; //!< Number of events.
+        uint64_t ns = 0;     //!< Wall time of the events, in nanoseconds.
+    };
+
+    /**
+     * Account the time of an event.
+     *
+     * \param [in] type The type of the event.
+     * \param [in] context The context of the event.
+     * \param [in] ns The wall time of the event.
+     */
+    void Account(const std::type_info& type, uint32_t context, uint64_t ns);
+    /**
+     * Get the name of a context.
+     *
+     * \param [in] context The context.
+     * \returns The name.
+     */
+    static std::string GetContextName(uint32_t context);
+
+    /** Index of each event type in m_types. */
+    std::unordered_map<std::type_index, uint32_t> m_typeIndex;
+    /** The event types. */
+    std::vector<std::type_index> m_types;
+    /** Time per event type index and context: the index is in the high word. */
+    std::unordered_map<uint64_t, Entry> m_entries;
+    /** The type of the last event. */
+    const std::type_info* m_lastType;
+    /** The index of the type of the last event. */
+    uint32_t m_lastIndex;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-trace-recorder.h"
+
+#include "abort.h"
+#include "fatal-error.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::EventTraceRecorder and ns3::EventTraceReader implementations.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventTraceRecorder");
+
+EventTraceRecorder::EventTraceRecorder(const std::string& filename, std::size_t bufferRecords)
+    : m_buffers(BUFFERS),
+      m_records(0),
+      m_stalls(0),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this << filename << bufferRecords);
+    NS_ABORT_MSG_IF(bufferRecords == 0, "Empty event trace buffers");
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Cannot open event trace file " << filename);
+    }
+    uint32_t version = VERSION;
+    uint32_t recordSize = RECORD_SIZE;
+    m_file.write(MAGIC, sizeof(MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    m_file.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+
+    for (auto& buffer : m_buffers)
+    {
+        buffer.data.resize(bufferRecords * RECORD_SIZE);
+        buffer.size = 0;
+        m_free.push_back(&buffer);
+    }
+    m_current = m_free.front();
+    m_free.pop_front();
+    m_fill = m_current->data.data();
+    m_end = m_fill + m_current->data.size();
+
+    m_writer = std::thread(&EventTraceRecorder::Write, this);
+}
+
+EventTraceRecorder::~EventTraceRecorder()
+{
+    NS_LOG_FUNCTION(this);
+    {
+        std::unique_lock lock{m_mutex};
+        m_current->size = m_fill - m_current->data.data();
+        m_full.push_back(m_current);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_writer.join();
+    m_file.close();
+    NS_LOG_INFO(m_records << " records, " << m_stalls << " stalls");
+}
+
+void
+EventTraceRecorder::Flush()
+{
+    std::unique_lock lock{m_mutex};
+    m_current->size = m_fill - m_current->data.data();
+    m_full.push_back(m_current);
+    m_cv.notify_all();
+    if (m_free.empty())
+    {
+        m_stalls++;
+        m_cv.wait(lock, [this]() { return !m_free.empty(); });
+    }
+    m_current = m_free.front();
+    m_free.pop_front();
+    m_fill = m_current->data.data();
+    m_end = m_fill + m_current->data.size();
+}
+
+void
+EventTraceRecorder::Write()
+{
+    std::unique_lock lock{m_mutex};
+    while (true)
+    {
+        m_cv.wait(lock, [this]() { return !m_full.empty() || m_stop; });
+        if (m_full.empty())
+        {
+            break;
+        }
+        Buffer* buffer = m_full.front();
+        m_full.pop_front();
+
+        lock.unlock();
+        m_file.write(buffer->data.data(), buffer->size);
+        lock.lock();
+
+        m_free.push_back(buffer);
+        m_cv.notify_all();
+    }
+}
+
+uint64_t
+EventTraceRecorder::GetRecords() const
+{
+    return m_records;
+}
+
+uint64_t
+EventTraceRecorder::GetStalls() const
+{
+    return m_stalls;
+}
+
+EventTraceReader::EventTraceReader(const std::string& filename)
+    : m_file(filename, std::ios::binary)
+{
+    NS_LOG_FUNCTION(this << filename);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Cannot open event trace file " << filename);
+    }
+
+    char magic[sizeof(EventTraceRecorder::MAGIC)];
+    uint32_t version = 0;
+    uint32_t recordSize = 0;
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    m_file.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+    NS_ABORT_MSG_IF(!m_file || std::memcmp(magic, EventTraceRecorder::MAGIC, sizeof(magic)) != 0,
+                    filename << " is not an event trace");
+    NS_ABORT_MSG_IF(version != EventTraceRecorder::VERSION ||
+                        recordSize != EventTraceRecorder::RECORD_SIZE,
+                    filename << ": unsupported event trace version " << version);
+}
+
+bool
+EventTraceReader::Next(EventTraceRecord& record)
+{
+    char buffer[EventTraceRecorder::RECORD_SIZE];
+    if (!m_file.read(buffer, sizeof(buffer)))
+    {
+        return false;
+    }
+    record.type = static_cast<EventTraceRecord::Type>(buffer[0]);
+    std::memcpy(&record.ts, buffer + 1, sizeof(record.ts));
+    std::memcpy(&record.uid, buffer + 9, sizeof(record.uid));
+    std::memcpy(&record.context, buffer + 13, sizeof(record.context));
+    return true;
+}
+
+} // namespace ns3
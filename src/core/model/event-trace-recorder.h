@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_TRACE_RECORDER_H
+#define EVENT_TRACE_RECORDER_H
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::EventTraceRecorder and ns3::EventTraceReader declarations.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief A record of an event trace.
+ *
+ * An event trace is the sequence of operations a simulation did on its
+ * scheduler.  The time of an insertion is the time of the last executed
+ * event, so it is not stored.
+ */
+struct EventTraceRecord
+{
+    /** Operation on the scheduler. */
+    enum Type : uint8_t
+    {
+        INSERT = 0,  //!< Event inserted.
+        EXECUTE = 1, //!< Event removed as the next one, live or cancelled.
+        CANCEL = 2,  //!< Event cancelled, it stays in the scheduler.
+        REMOVE = 3,  //!< Event removed from the scheduler.
+        COMPACT = 4  //!< Cancelled events removed from the scheduler.
+    };
+
+    Type type;        //!< Operation.
+    uint64_t ts;      //!< Time stamp of the event, or current time for COMPACT.
+    uint32_t uid;     //!< Unique id of the event.
+    uint32_t context; //!< Context of the event.
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Writes an event trace to a binary file.
+ *
+ * Records are packed to 17 bytes, in host byte order, after a header
+ * holding a magic string, the format version and the record size.
+ *
+ * Records are appended to a buffer of bounded size; a full buffer is
+ * handed to a writer thread and recording goes on in a free buffer.
+ * When the writer thread falls behind and every buffer is full,
+ * recording waits for it: the memory used is bounded, the trace is
+ * never truncated.
+ */
+class EventTraceRecorder
+{
+  public:
+    /** Size of a packed record. */
+    static constexpr std::size_t RECORD_SIZE = 17;
+    /** Magic string of a trace file. */
+    static constexpr char MAGIC[8] = {'N', 'S', '3', 'E', 'V', 'T', 'R', '\0'};
+    /** Version of the trace format. */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * Open a trace file.
+     *
+     * \param [in] filename The trace file.
+     * \param [in] bufferRecords The number of records of a buffer.
+     */
+    EventTraceRecorder(const std::string& filename, std::size_t bufferRecords);
+    /** Write the pending records and close the file. */
+    ~EventTraceRecorder();
+
+    EventTraceRecorder(const EventTraceRecorder&) = delete;
+    EventTraceRecorder& operator=(const EventTraceRecorder&) = delete;
+
+    /**
+     * Record an operation.
+     *
+     * \param [in] type The operation.
+     * \param [in] ts The time stamp of the event.
+     * \param [in] uid The unique id of the event.
+     * \param [in] context The context of the event.
+     */
+    void Record(EventTraceRecord::Type type, uint64_t ts, uint32_t uid, uint32_t context)
+    {
+        if (m_fill + RECORD_SIZE > m_end)
+        {
+            Flush();
+        }
+        *m_fill = type;
+        std::memcpy(m_fill + 1, &ts, sizeof(ts));
+        std::memcpy(m_fill + 9, &uid, sizeof(uid));
+        std::memcpy(m_fill + 13, &context, sizeof(context));
+        m_fill += RECORD_SIZE;
+        m_records++;
+    }
+
+    /**
+     * Get the number of records.
+     *
+     * \returns The number of records.
+     */
+    uint64_t GetRecords() const;
+    /**
+     * Get the number of times recording waited for the writer thread.
+     *
+     * \returns The number of stalls.
+     */
+    uint64_t GetStalls() const;
+
+  private:
+    /** Hand the current buffer to the writer thread and take a free one. */
+    void Flush();
+    /** Body of the writer thread. */
+    void Write();
+
+    /** Number of buffers. */
+    static constexpr std::size_t BUFFERS = 4;
+
+    /** A buffer of records. */
+    struct Buffer
+    {
+        std::vector<char> data; //!< The records.
+        std::size_t size;       //!< Number of bytes used.
+    };
+
+    std::ofstream m_file;          //!< The trace file.
+    std::vector<Buffer> m_buffers; //!< The buffers.
+    Buffer* m_current;             //!< The buffer being filled.
+    char* m_fill;                  //!< Next record of the current buffer.
+    char* m_end;                   //!< End of the current buffer.
+    uint64_t m_records;            //!< Number of records.
+    uint64_t m_stalls;             //!< Number of waits for the writer.
+
+    std::mutex m_mutex;           //!< Protects the queues.
+    std::condition_variable m_cv; //!< Signals the queues.
+    std::deque<Buffer*> m_full;   //!< Buffers to write.
+    std::deque<Buffer*> m_free;   //!< Buffers to fill.
+    bool m_stop;                  //!< Stop the writer thread.
+    std::thread m_writer;         //!< The writer thread.
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Reads an event trace written by an EventTraceRecorder.
+ */
+class EventTraceReader
+{
+  public:
+    /**
+     * Open a trace file, aborting if it is not an event trace.
+     *
+     * \param [in] filename The trace file.
+     */
+    EventTraceReader(const std::string& filename);
+
+    /**
+     * Read the next record.
+     *
+     * \param [out] record The record.
+     * \returns \c false at the end of the trace.
+     */
+    bool Next(EventTraceRecord& record);
+
+  private:
+    std::ifstream m_file; //!< The trace file.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_TRACE_RECORDER_H */
@@ -159,6 +159,37 @@
 #define NS_LOG_CONDITION
 #endif
 
+#ifndef NS_LOG_CEILING
+/**
+ * \ingroup logging
+ *
+ * The LogLevels compiled in.
+ *
+ * The statements of the other levels are compiled out, with the
+ * evaluation of their arguments, whatever the LogComponent enables.
+ * The NS3_LOG_CEILINGS CMake option sets it per module, for instance
+ * to ns3::LOG_LEVEL_WARN for \c cybertwin=warn.
+ */
+#define NS_LOG_CEILING ns3::LOG_LEVEL_ALL
+#endif
+
+/**
+ * \ingroup logging
+ *
+ * Check whether a log level is compiled in and enabled for g_log.
+ *
+ * The test of the ceiling folds to a constant; the test of
+ * ns3::g_logEnabledLevels spares the call to LogComponent::IsEnabled()
+ * while no component logs at that level.
+ *
+ * \param [in] level The log level.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ */
+#define NS_LOG_IS_ENABLED(level)                                                                   \
+    (((level) & (NS_LOG_CEILING)) && (ns3::g_logEnabledLevels.levels & (level)) &&                 \
+     g_log.IsEnabled(level))
+
 /**
  * \ingroup logging
  *
@@ -182,7 +213,7 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(level))                                                                \
+        if (NS_LOG_IS_ENABLED(level))                                                              \
         {                                                                                          \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
@@ -205,7 +236,7 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if (NS_LOG_IS_ENABLED(ns3::LOG_FUNCTION))                                                  \
         {                                                                                          \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
@@ -239,7 +270,7 @@
     NS_LOG_CONDITION                                                                               \
     do                                                                                             \
     {                                                                                              \
-        if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
+        if (NS_LOG_IS_ENABLED(ns3::LOG_FUNCTION))                                                  \
         {                                                                                          \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
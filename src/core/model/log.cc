@@ -39,6 +39,8 @@
 namespace ns3
 {
 
+LogEnabledLevels g_logEnabledLevels = {0};
+
 /**
  * \ingroup logging
  * The Log TimePrinter.
@@ -298,12 +300,20 @@ void
 LogComponent::Enable(const enum LogLevel level)
 {
     m_levels |= (level & ~m_mask);
+    g_logEnabledLevels.levels |= m_levels & LOG_ALL;
 }
 
 void
 LogComponent::Disable(const enum LogLevel level)
 {
     m_levels &= ~level;
+
+    int32_t levels = 0;
+    for (const auto& [name, component] : *GetComponentList())
+    {
+        levels |= component->m_levels;
+    }
+    g_logEnabledLevels.levels = levels & LOG_ALL;
 }
 
 const char*
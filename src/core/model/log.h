@@ -425,6 +425,21 @@ class LogComponent
 
 }; // class LogComponent
 
+/**
+ * The LogLevels enabled in at least one LogComponent.
+ *
+ * The logging macros test it before their LogComponent: a statement at a
+ * level no component logs at only reads this mask, which is alone on its
+ * cache line so it stays in the cache of every thread.
+ */
+struct alignas(64) LogEnabledLevels
+{
+    int32_t levels; //!< The LogLevels, without the prefixes.
+};
+
+/** The LogLevels enabled in at least one LogComponent. */
+extern LogEnabledLevels g_logEnabledLevels;
+
 /**
  * Get the LogComponent registered with the given name.
  *
@@ -19,6 +19,7 @@
 
 #include "abort.h"
 #include "assert.h"
+#include "config.h"
 #include "log.h"
 #include "object.h"
 #include "singleton.h"
@@ -777,6 +778,7 @@ Names::Add(std::string name, Ptr<Object> object)
 {
     NS_LOG_FUNCTION(name << object);
     bool result = NamesPriv::Get()->Add(name, object);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result, "Names::Add(): Error adding name " << name);
 }
 
@@ -785,6 +787,7 @@ Names::Rename(std::string oldpath, std::string newname)
 {
     NS_LOG_FUNCTION(oldpath << newname);
     bool result = NamesPriv::Get()->Rename(oldpath, newname);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result, "Names::Rename(): Error renaming " << oldpath << " to " << newname);
 }
 
@@ -793,6 +796,7 @@ Names::Add(std::string path, std::string name, Ptr<Object> object)
 {
     NS_LOG_FUNCTION(path << name << object);
     bool result = NamesPriv::Get()->Add(path, name, object);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result, "Names::Add(): Error adding " << path << " " << name);
 }
 
@@ -801,6 +805,7 @@ Names::Rename(std::string path, std::string oldname, std::string newname)
 {
     NS_LOG_FUNCTION(path << oldname << newname);
     bool result = NamesPriv::Get()->Rename(path, oldname, newname);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result,
                         "Names::Rename (): Error renaming " << path << " " << oldname << " to "
                                                             << newname);
@@ -811,6 +816,7 @@ Names::Add(Ptr<Object> context, std::string name, Ptr<Object> object)
 {
     NS_LOG_FUNCTION(context << name << object);
     bool result = NamesPriv::Get()->Add(context, name, object);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result,
                         "Names::Add(): Error adding name " << name << " under context "
                                                            << &context);
@@ -821,6 +827,7 @@ Names::Rename(Ptr<Object> context, std::string oldname, std::string newname)
 {
     NS_LOG_FUNCTION(context << oldname << newname);
     bool result = NamesPriv::Get()->Rename(context, oldname, newname);
+    Config::NotifyNamespaceChange();
     NS_ABORT_MSG_UNLESS(result,
                         "Names::Rename (): Error renaming " << oldname << " to " << newname
                                                             << " under context " << &context);
@@ -844,7 +851,8 @@ void
 Names::Clear()
 {
     NS_LOG_FUNCTION_NOARGS();
-    return NamesPriv::Get()->Clear();
+    NamesPriv::Get()->Clear();
+    Config::NotifyNamespaceChange();
 }
 
 Ptr<Object>
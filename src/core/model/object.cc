@@ -22,6 +22,7 @@
 
 #include "assert.h"
 #include "attribute.h"
+#include "config.h"
 #include "log.h"
 #include "object-factory.h"
 #include "string.h"
@@ -100,6 +101,7 @@ Object::Object()
       m_getObjectCount(0)
 {
     NS_LOG_FUNCTION(this);
+    m_aggregates->cache = nullptr;
     m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
@@ -124,7 +126,13 @@ Object::~Object()
     // delete the aggregate list
     if (m_aggregates->n == 0)
     {
-        std::free(m_aggregates);
+        FreeAggregates(m_aggregates);
+    }
+    else
+    {
+        // the cache may point to this object
+        delete m_aggregates->cache;
+        m_aggregates->cache = nullptr;
     }
     m_aggregates = nullptr;
 }
@@ -136,6 +144,7 @@ Object::Object(const Object& o)
       m_aggregates((struct Aggregates*)std::malloc(sizeof(struct Aggregates))),
       m_getObjectCount(0)
 {
+    m_aggregates->cache = nullptr;
     m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
@@ -154,6 +163,20 @@ Object::DoGetObject(TypeId tid) const
     NS_ASSERT(CheckLoose());
 
     uint32_t n = m_aggregates->n;
+    LookupCache* cache = m_aggregates->cache;
+    if (cache == nullptr && n >= LOOKUP_CACHE_MIN_AGGREGATES)
+    {
+        cache = new LookupCache();
+        m_aggregates->cache = cache;
+    }
+    uint16_t uid = tid.GetUid();
+    uint32_t slot = uid & (LookupCache::SIZE - 1);
+    if (cache != nullptr && cache->uid[slot] == uid)
+    {
+        return cache->object[slot];
+    }
+
+    Object* found = nullptr;
     TypeId objectTid = Object::GetTypeId();
     for (uint32_t i = 0; i < n; i++)
     {
@@ -165,21 +188,25 @@ Object::DoGetObject(TypeId tid) const
         }
         if (cur == tid)
         {
-            // This is an attempt to 'cache' the result of this lookup.
-            // the idea is that if we perform a lookup for a TypeId on this object,
-            // we are likely to perform the same lookup later so, we make sure
-            // that the aggregate array is sorted by the number of accesses
-            // to each object.
+            // The lookups of the types which are not cached, because the
+            // cache is too small or the aggregates too few, are likely to
+            // be repeated too, so we make sure that the aggregate array
+            // is sorted by the number of accesses to each object.
 
             // first, increment the access count
             current->m_getObjectCount++;
             // then, update the sort
             UpdateSortedArray(m_aggregates, i);
-            // finally, return the match
-            return const_cast<Object*>(current);
+            found = current;
+            break;
         }
     }
-    return nullptr;
+    if (cache != nullptr)
+    {
+        cache->uid[slot] = uid;
+        cache->object[slot] = found;
+    }
+    return found;
 }
 
 void
@@ -269,6 +296,7 @@ Object::AggregateObject(Ptr<Object> o)
     uint32_t total = m_aggregates->n + other->m_aggregates->n;
     struct Aggregates* aggregates =
         (struct Aggregates*)std::malloc(sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
+    aggregates->cache = nullptr;
     aggregates->n = total;
 
     // copy our buffer to the new buffer
@@ -303,6 +331,9 @@ Object::AggregateObject(Ptr<Object> o)
         current->m_aggregates = aggregates;
     }
 
+    // The Config paths through the aggregates may resolve to other objects.
+    Config::NotifyNamespaceChange();
+
     // Finally, call NotifyNewAggregate on all the objects aggregates together.
     // We purposely use the old aggregate buffers to iterate over the objects
     // because this allows us to assume that they will not change from under
@@ -320,8 +351,16 @@ Object::AggregateObject(Ptr<Object> o)
     }
 
     // Now that we are done with them, we can free our old aggregate buffers
-    std::free(a);
-    std::free(b);
+    FreeAggregates(a);
+    FreeAggregates(b);
+}
+
+void
+Object::FreeAggregates(struct Aggregates* aggregates)
+{
+    NS_LOG_FUNCTION(aggregates);
+    delete aggregates->cache;
+    std::free(aggregates);
 }
 
 /**
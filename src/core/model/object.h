@@ -331,6 +331,24 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
 
     /**@}*/
 
+    /**
+     * The results of the lookups of DoGetObject() in some Aggregates.
+     *
+     * A direct-mapped table, indexed by the low bits of the uid of the
+     * TypeId looked up.  Lookups which found nothing are cached too, with
+     * a \c nullptr Object.  The Aggregates only change in AggregateObject(),
+     * which builds new ones, and in ~Object(), which drops the cache.
+     */
+    struct LookupCache
+    {
+        /** The number of entries, a power of two. */
+        static constexpr uint32_t SIZE = 32;
+        /** The uid of the TypeId of each entry, 0 if the entry is empty. */
+        uint16_t uid[SIZE];
+        /** The Object found for each entry. */
+        Object* object[SIZE];
+    };
+
     /**
      * The list of Objects aggregated to this one.
      *
@@ -345,12 +363,28 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      */
     struct Aggregates
     {
+        /** The results of the lookups, or \c nullptr before the first one. */
+        LookupCache* cache;
         /** The number of entries in \c buffer. */
         uint32_t n;
         /** The array of Objects. */
         Object* buffer[1];
     };
 
+    /**
+     * The smallest number of aggregates for which the lookups are cached.
+     *
+     * The lookups in a lone Object only walk its TypeId.
+     */
+    static constexpr uint32_t LOOKUP_CACHE_MIN_AGGREGATES = 2;
+
+    /**
+     * Free some Aggregates and their LookupCache.
+     *
+     * \param [in] aggregates The Aggregates.
+     */
+    static void FreeAggregates(struct Aggregates* aggregates);
+
     /**
      * Find an Object of TypeId tid in the aggregates of this Object.
      *
@@ -470,6 +504,17 @@ template <typename T>
 Ptr<T>
 Object::GetObject() const
 {
+    // The lookups of the aggregates are cached once they were done.
+    const LookupCache* cache = m_aggregates->cache;
+    if (cache != nullptr)
+    {
+        uint16_t uid = T::GetTypeId().GetUid();
+        uint32_t slot = uid & (LookupCache::SIZE - 1);
+        if (cache->uid[slot] == uid)
+        {
+            return Ptr<T>(static_cast<T*>(cache->object[slot]));
+        }
+    }
     // This is an optimization: if the cast works (which is likely),
     // things will be pretty fast.
     T* result = dynamic_cast<T*>(m_aggregates->buffer[0]);
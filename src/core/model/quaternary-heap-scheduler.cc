@@ -0,0 +1,174 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quaternary-heap-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::QuaternaryHeapScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuaternaryHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(QuaternaryHeapScheduler);
+
+TypeId
+QuaternaryHeapScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QuaternaryHeapScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<QuaternaryHeapScheduler>();
+    return tid;
+}
+
+QuaternaryHeapScheduler::QuaternaryHeapScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+QuaternaryHeapScheduler::~QuaternaryHeapScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QuaternaryHeapScheduler::SiftUp(std::size_t index, const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << index);
+    while (index > 0)
+    {
+        std::size_t parent = (index - 1) / ARITY;
+        if (!(ev.key < m_heap[parent].key))
+        {
+            break;
+        }
+        m_heap[index] = m_heap[parent];
+        index = parent;
+    }
+    m_heap[index] = ev;
+}
+
+void
+QuaternaryHeapScheduler::SiftDown(std::size_t index, const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << index);
+    std::size_t size = m_heap.size();
+    while (true)
+    {
+        std::size_t first = index * ARITY + 1;
+        if (first >= size)
+        {
+            break;
+        }
+        std::size_t last = std::min(first + ARITY, size);
+        std::size_t smallest = first;
+        for (std::size_t child = first + 1; child < last; ++child)
+        {
+            if (m_heap[child].key < m_heap[smallest].key)
+            {
+                smallest = child;
+            }
+        }
+        if (!(m_heap[smallest].key < ev.key))
+        {
+            break;
+        }
+        m_heap[index] = m_heap[smallest];
+        index = smallest;
+    }
+    m_heap[index] = ev;
+}
+
+void
+QuaternaryHeapScheduler::RemoveAt(std::size_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    Scheduler::Event last = m_heap.back();
+    m_heap.pop_back();
+    if (index == m_heap.size())
+    {
+        return;
+    }
+    if (index > 0 && last.key < m_heap[(index - 1) / ARITY].key)
+    {
+        SiftUp(index, last);
+    }
+    else
+    {
+        SiftDown(index, last);
+    }
+}
+
+void
+QuaternaryHeapScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << &ev);
+    m_heap.push_back(ev);
+    SiftUp(m_heap.size() - 1, ev);
+}
+
+bool
+QuaternaryHeapScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_heap.empty();
+}
+
+Scheduler::Event
+QuaternaryHeapScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_heap.front();
+}
+
+Scheduler::Event
+QuaternaryHeapScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Event next = m_heap.front();
+    RemoveAt(0);
+    return next;
+}
+
+void
+QuaternaryHeapScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << &ev);
+    for (std::size_t i = 0; i < m_heap.size(); i++)
+    {
+        if (ev.key.m_uid == m_heap[i].key.m_uid)
+        {
+            NS_ASSERT(m_heap[i].impl == ev.impl);
+            RemoveAt(i);
+            return;
+        }
+    }
+    NS_ASSERT(false);
+}
+
+} // namespace ns3
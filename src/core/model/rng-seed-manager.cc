@@ -24,6 +24,8 @@
 #include "log.h"
 #include "uinteger.h"
 
+#include <atomic>
+
 /**
  * \file
  * \ingroup randomvariable
@@ -40,7 +42,11 @@ NS_LOG_COMPONENT_DEFINE("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
+#ifdef NS3_MTP
+static std::atomic<uint64_t> g_nextStreamIndex = 0;
+#else
 static uint64_t g_nextStreamIndex = 0;
+#endif
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -107,8 +113,7 @@ uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
     NS_LOG_FUNCTION_NOARGS();
-    uint64_t next = g_nextStreamIndex;
-    g_nextStreamIndex++;
+    uint64_t next = g_nextStreamIndex++;
     return next;
 }
 
@@ -134,6 +134,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 24 bytes </td>
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
+ * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> QuaternaryHeapScheduler </td>
+ *      <td class="markdownTableBodyLeft"> 4-ary heap on `std::vector` </td>
+ *      <td class="markdownTableBodyLeft"> Logarithmic </td>
+ *      <td class="markdownTableBodyLeft"> Logarithmic </td>
+ *      <td class="markdownTableBodyLeft"> 24 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
  * </table>
  *
  * It is possible to change the Scheduler choice during a simulation,
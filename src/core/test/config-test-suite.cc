@@ -24,6 +24,7 @@
 #include "ns3/object-vector.h"
 #include "ns3/object.h"
 #include "ns3/pointer.h"
+#include "ns3/simulator.h"
 #include "ns3/singleton.h"
 #include "ns3/test.h"
 #include "ns3/trace-source-accessor.h"
@@ -864,6 +865,146 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test the resolution of a Config::CompiledPath and its cache.
+ */
+class CompiledPathTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    CompiledPathTestCase();
+
+    /** Destructor. */
+    ~CompiledPathTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Trace callback.
+     * \param [in] context The context of the trace source.
+     * \param [in] oldValue The previous value.
+     * \param [in] newValue The new value.
+     */
+    void Trace(std::string context, int16_t oldValue, int16_t newValue);
+
+    std::vector<std::string> m_contexts; //!< The contexts of the traces.
+};
+
+CompiledPathTestCase::CompiledPathTestCase()
+    : TestCase("Check the resolution and the cache of a Config::CompiledPath")
+{
+}
+
+void
+CompiledPathTestCase::Trace(std::string context, int16_t oldValue, int16_t newValue)
+{
+    m_contexts.push_back(context);
+}
+
+void
+CompiledPathTestCase::DoRun()
+{
+    IntegerValue iv;
+
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Config::RegisterRootNamespaceObject(root);
+    Ptr<ConfigTestObject> obj0 = CreateObject<ConfigTestObject>();
+    Ptr<ConfigTestObject> obj1 = CreateObject<ConfigTestObject>();
+    Ptr<ConfigTestObject> obj2 = CreateObject<ConfigTestObject>();
+    root->AddNodeA(obj0);
+    root->AddNodeA(obj1);
+
+    //
+    // The path resolves to the same objects as Config::LookupMatches().
+    //
+    Config::CompiledPath path("/NodesA/*/A");
+    NS_TEST_ASSERT_MSG_EQ(path.GetPath(), "/NodesA/*/A", "path not kept");
+    Config::MatchContainer expected = Config::LookupMatches("/NodesA/*");
+    Config::MatchContainer matches = path.LookupMatches();
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), expected.GetN(), "not the objects of LookupMatches");
+    for (std::size_t i = 0; i < matches.GetN(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(matches.Get(i), expected.Get(i), "object " << i);
+        NS_TEST_EXPECT_MSG_EQ(matches.GetMatchedPath(i), expected.GetMatchedPath(i), "path " << i);
+    }
+
+    path.Set(IntegerValue(-3));
+    obj0->GetAttribute("A", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), -3, "Object Attribute \"A\" not set as expected");
+    obj1->GetAttribute("A", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), -3, "Object Attribute \"A\" not set as expected");
+
+    //
+    // The objects found are reused until the namespace changes.
+    //
+    root->AddNodeA(obj2);
+    path.Set(IntegerValue(-4));
+    obj2->GetAttribute("A", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), 10, "Object Attribute \"A\" set before the notification");
+
+    uint64_t changes = Config::GetNamespaceChanges();
+    Config::NotifyNamespaceChange();
+    NS_TEST_EXPECT_MSG_EQ(Config::GetNamespaceChanges(), changes + 1, "change not counted");
+    path.Set(IntegerValue(-5));
+    obj2->GetAttribute("A", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), -5, "Object Attribute \"A\" not set as expected");
+    NS_TEST_EXPECT_MSG_EQ(path.LookupMatches().GetN(), expected.GetN() + 1, "new object missed");
+
+    //
+    // The copies share the parsed path; trace sources connect with their context.
+    //
+    Config::CompiledPath source("/NodesA/[1-2]/Source");
+    Config::CompiledPath copy = source;
+    copy.Connect(MakeCallback(&CompiledPathTestCase::Trace, this));
+    obj0->SetAttribute("Source", IntegerValue(1));
+    obj1->SetAttribute("Source", IntegerValue(1));
+    obj2->SetAttribute("Source", IntegerValue(1));
+    source.Disconnect(MakeCallback(&CompiledPathTestCase::Trace, this));
+    obj1->SetAttribute("Source", IntegerValue(2));
+    NS_TEST_ASSERT_MSG_EQ(m_contexts.size(), 2, "wrong number of traces");
+    NS_TEST_EXPECT_MSG_EQ(m_contexts[0], "/NodesA/1/Source", "wrong context");
+    NS_TEST_EXPECT_MSG_EQ(m_contexts[1], "/NodesA/2/Source", "wrong context");
+
+    //
+    // Aggregating an object changes the namespace.
+    //
+    Config::CompiledPath aggregated("/NodesA/0/$DerivedConfigObject/X");
+    NS_TEST_EXPECT_MSG_EQ(aggregated.SetFailSafe(IntegerValue(7)), false, "nothing to set yet");
+    Ptr<DerivedConfigObject> derived = CreateObject<DerivedConfigObject>();
+    obj0->AggregateObject(derived);
+    NS_TEST_EXPECT_MSG_EQ(aggregated.SetFailSafe(IntegerValue(7)), true, "aggregate not found");
+    derived->GetAttribute("X", iv);
+    NS_TEST_EXPECT_MSG_EQ(iv.Get(), 7, "Object Attribute \"X\" not set as expected");
+
+    //
+    // A change of the namespace releases the objects found.
+    //
+    Ptr<ConfigTestObject> held = CreateObject<ConfigTestObject>();
+    root->SetNodeA(held);
+    Config::CompiledPath single("/NodeA/A");
+    uint32_t references = held->GetReferenceCount();
+    single.Set(IntegerValue(-6));
+    NS_TEST_EXPECT_MSG_EQ(held->GetReferenceCount(), references + 1, "object not cached");
+    root->SetNodeA(obj0);
+    Config::NotifyNamespaceChange();
+    NS_TEST_EXPECT_MSG_EQ(held->GetReferenceCount(), references - 1, "object not released");
+
+    Config::UnregisterRootNamespaceObject(root);
+    NS_TEST_EXPECT_MSG_EQ(path.LookupMatches().GetN(), expected.GetN() - 2, "root not removed");
+
+    //
+    // Destroying the simulator disposes of the objects of the namespace.
+    //
+    Simulator::Now();
+    changes = Config::GetNamespaceChanges();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_GT(Config::GetNamespaceChanges(), changes, "destruction not counted");
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +1023,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new CompiledPathTestCase);
 }
 
 /**
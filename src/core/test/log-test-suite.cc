@@ -0,0 +1,190 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// As the NS3_LOG_CEILINGS CMake option does for a module
+#undef NS_LOG_CEILING
+#define NS_LOG_CEILING ns3::LOG_LEVEL_WARN
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <iostream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup log-tests
+ * Log ceiling and enabled levels test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup log-tests Log test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogTestSuite");
+
+/**
+ * \ingroup log-tests
+ * Check that the statements above NS_LOG_CEILING are compiled out.
+ */
+class LogCeilingTestCase : public TestCase
+{
+  public:
+    LogCeilingTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Count the evaluations of a log argument.
+     * \returns The number of evaluations so far.
+     */
+    int Evaluate();
+
+    int m_evaluations; //!< Number of evaluations.
+};
+
+LogCeilingTestCase::LogCeilingTestCase()
+    : TestCase("Check the compile-time log ceiling"),
+      m_evaluations(0)
+{
+}
+
+int
+LogCeilingTestCase::Evaluate()
+{
+    return ++m_evaluations;
+}
+
+void
+LogCeilingTestCase::DoRun()
+{
+#ifdef NS3_LOG_ENABLE
+    LogComponentEnable("LogTestSuite", LOG_LEVEL_ALL);
+    std::ostringstream output;
+    std::streambuf* clog = std::clog.rdbuf(output.rdbuf());
+
+    NS_LOG_FUNCTION(Evaluate());
+    NS_LOG_DEBUG("debug " << Evaluate());
+    NS_LOG_LOGIC("logic " << Evaluate());
+    NS_LOG_WARN("warn " << Evaluate());
+    NS_LOG_ERROR("error " << Evaluate());
+
+    std::clog.rdbuf(clog);
+    LogComponentDisable("LogTestSuite", LOG_LEVEL_ALL);
+
+    NS_TEST_EXPECT_MSG_EQ(m_evaluations, 2, "statements above the ceiling evaluated");
+    NS_TEST_EXPECT_MSG_EQ(output.str(), "warn 1\nerror 2\n", "wrong log output");
+#endif
+}
+
+/**
+ * \ingroup log-tests
+ * Check that g_logEnabledLevels has the levels of all the components.
+ */
+class LogEnabledLevelsTestCase : public TestCase
+{
+  public:
+    LogEnabledLevelsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compute the levels enabled in at least one component.
+     * \returns The levels.
+     */
+    int32_t GetEnabledLevels() const;
+};
+
+LogEnabledLevelsTestCase::LogEnabledLevelsTestCase()
+    : TestCase("Check the levels enabled in any component")
+{
+}
+
+int32_t
+LogEnabledLevelsTestCase::GetEnabledLevels() const
+{
+    int32_t levels = 0;
+    for (const auto& [name, component] : *LogComponent::GetComponentList())
+    {
+        for (int32_t level = LOG_ERROR; level <= int32_t(LOG_LOGIC); level <<= 1)
+        {
+            if (component->IsEnabled(static_cast<LogLevel>(level)))
+            {
+                levels |= level;
+            }
+        }
+    }
+    return levels;
+}
+
+void
+LogEnabledLevelsTestCase::DoRun()
+{
+    // a component enabled with LOG_ALL also sets the bits above LOG_LOGIC
+    int32_t initial = g_logEnabledLevels.levels;
+    NS_TEST_EXPECT_MSG_EQ(static_cast<int32_t>(initial & LOG_LEVEL_LOGIC),
+                          GetEnabledLevels(),
+                          "initial levels");
+
+    LogComponentEnable("LogTestSuite", LOG_LEVEL_LOGIC);
+    int32_t enabled = initial | LOG_LEVEL_LOGIC;
+    NS_TEST_EXPECT_MSG_EQ(g_logEnabledLevels.levels,
+                          enabled,
+                          "levels of the enabled component missing");
+
+    LogComponentDisable("LogTestSuite", LOG_LEVEL_LOGIC);
+    NS_TEST_EXPECT_MSG_EQ(g_logEnabledLevels.levels, initial, "levels not restored");
+    NS_TEST_EXPECT_MSG_EQ(static_cast<int32_t>(g_logEnabledLevels.levels & LOG_LEVEL_LOGIC),
+                          GetEnabledLevels(),
+                          "levels after disable");
+}
+
+/**
+ * \ingroup log-tests
+ * Log test suite
+ */
+class LogTestSuite : public TestSuite
+{
+  public:
+    LogTestSuite();
+};
+
+LogTestSuite::LogTestSuite()
+    : TestSuite("log")
+{
+    AddTestCase(new LogCeilingTestCase);
+    AddTestCase(new LogEnabledLevelsTestCase);
+}
+
+/**
+ * \ingroup log-tests
+ * LogTestSuite instance variable.
+ */
+static LogTestSuite g_logTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -464,6 +464,66 @@ AggregateObjectTestCase::DoRun()
     NS_TEST_ASSERT_MSG_NE(baseA, nullptr, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookups of GetObject() through the cache of the aggregates.
+ */
+class LookupCacheTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LookupCacheTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LookupCacheTestCase::LookupCacheTestCase()
+    : TestCase("Check the cached GetObject() lookups of an aggregation")
+{
+}
+
+void
+LookupCacheTestCase::DoRun()
+{
+    Ptr<BaseA> baseA = CreateObject<BaseA>();
+    Ptr<BaseB> baseB = CreateObject<BaseB>();
+    baseA->AggregateObject(baseB);
+
+    //
+    // Repeated lookups, found or not, give the same answer from any member
+    // of the aggregation.
+    //
+    for (int i = 0; i < 3; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(), baseB, "BaseB through baseA");
+        NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseB>(), baseB, "BaseB through baseB");
+        NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseA>(), baseA, "BaseA through baseB");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedA>(), nullptr, "no DerivedA yet");
+        NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<DerivedA>(), nullptr, "no DerivedA yet");
+    }
+
+    //
+    // Aggregating a new Object invalidates the lookups which found nothing.
+    //
+    Ptr<DerivedA> derivedA = CreateObject<DerivedA>();
+    baseB->AggregateObject(derivedA);
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedA>(), derivedA, "DerivedA through baseA");
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<DerivedA>(), derivedA, "DerivedA through baseB");
+    NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseB>(), baseB, "BaseB through derivedA");
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<BaseB>(), baseB, "BaseB after the aggregation");
+
+    //
+    // The lookups by TypeId share the cache with the typed ones.
+    //
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<Object>(DerivedA::GetTypeId()),
+                          derivedA,
+                          "DerivedA by TypeId");
+    NS_TEST_ASSERT_MSG_EQ(baseB->GetObject<Object>(DerivedB::GetTypeId()),
+                          nullptr,
+                          "no DerivedB by TypeId");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -565,6 +625,7 @@ ObjectTestSuite::ObjectTestSuite()
 {
     AddTestCase(new CreateObjectTestCase);
     AddTestCase(new AggregateObjectTestCase);
+    AddTestCase(new LookupCacheTestCase);
     AddTestCase(new ObjectFactoryTestCase);
 }
 
@@ -17,12 +17,26 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/calendar-scheduler.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/event-impl.h"
+#include "ns3/event-trace-recorder.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/quaternary-heap-scheduler.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <array>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace ns3;
 
@@ -717,6 +731,376 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the recycling of the memory of the events.
+ */
+class SimulatorEventPoolTestCase : public TestCase
+{
+  public:
+    SimulatorEventPoolTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Schedule and run a batch of small events.
+     * \param [in] n The number of events.
+     */
+    void RunBatch(uint32_t n);
+
+    uint32_t m_count; //!< Number of events executed.
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase()
+    : TestCase("Check the event pool"),
+      m_count(0)
+{
+}
+
+void
+SimulatorEventPoolTestCase::RunBatch(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Simulator::Schedule(NanoSeconds(i), [this]() { m_count++; });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+SimulatorEventPoolTestCase::DoRun()
+{
+    EventImpl::PoolStats before = EventImpl::GetPoolStats();
+    RunBatch(1000);
+    EventImpl::PoolStats first = EventImpl::GetPoolStats();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 1000, "not all events executed");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(first.allocations - before.allocations,
+                                1000,
+                                "events allocated outside of the pool accounting");
+
+    RunBatch(1000);
+    EventImpl::PoolStats second = EventImpl::GetPoolStats();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 2000, "not all events executed");
+
+    std::array<char, 512> big{};
+    Simulator::ScheduleNow([big]() { static_cast<void>(big); });
+    Simulator::Run();
+    Simulator::Destroy();
+    EventImpl::PoolStats oversized = EventImpl::GetPoolStats();
+    NS_TEST_EXPECT_MSG_EQ(oversized.heap - second.heap, 1, "large event not taken from the heap");
+
+#ifdef NS3_EVENT_POOL_ENABLE
+    NS_TEST_EXPECT_MSG_EQ(second.chunks, first.chunks, "released events not recycled");
+    NS_TEST_EXPECT_MSG_EQ(second.heap, first.heap, "small event taken from the heap");
+
+    // Events allocated by a thread and released by another one: both
+    // exit with events in their pools, which a third thread reuses
+    std::vector<EventImpl*> events;
+    std::thread maker([&events]() {
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            events.push_back(MakeEvent([]() {}));
+        }
+    });
+    maker.join();
+    std::thread releaser([&events]() {
+        for (EventImpl* event : events)
+        {
+            event->Unref();
+        }
+    });
+    releaser.join();
+    uint64_t chunks = 0;
+    std::thread user([&chunks]() {
+        MakeEvent([]() {})->Unref();
+        chunks = EventImpl::GetPoolStats().chunks;
+    });
+    user.join();
+    NS_TEST_EXPECT_MSG_EQ(chunks, 0, "events of the exited threads not recycled");
+
+    // A live thread releasing many events of another one keeps at most
+    // 1024 of them, the others are reused by a third thread
+    events.clear();
+    std::thread producer([&events]() {
+        for (uint32_t i = 0; i < 8192; ++i)
+        {
+            events.push_back(MakeEvent([]() {}));
+        }
+    });
+    producer.join();
+    std::promise<void> released;
+    std::promise<void> done;
+    std::thread consumer([&events, &released, &done]() {
+        for (EventImpl* event : events)
+        {
+            event->Unref();
+        }
+        released.set_value();
+        done.get_future().wait();
+    });
+    released.get_future().wait();
+    std::thread reuser([&chunks]() {
+        std::vector<EventImpl*> reused;
+        for (uint32_t i = 0; i < 4096; ++i)
+        {
+            reused.push_back(MakeEvent([]() {}));
+        }
+        chunks = EventImpl::GetPoolStats().chunks;
+        for (EventImpl* event : reused)
+        {
+            event->Unref();
+        }
+    });
+    reuser.join();
+    done.set_value();
+    consumer.join();
+    NS_TEST_EXPECT_MSG_EQ(chunks, 0, "events released by a live thread not recycled");
+#endif
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the accounting and the compaction of the cancelled events.
+ */
+class SimulatorCancelledEventsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] schedulerFactory The scheduler factory.
+     */
+    SimulatorCancelledEventsTestCase(ObjectFactory schedulerFactory);
+
+  private:
+    void DoRun() override;
+
+    /** Cancel most of the pending events, and check the counters. */
+    void CancelEvents();
+    /** Check that the compaction has run. */
+    void CheckCompaction();
+    /** A live event, which checks the event order. */
+    void Live();
+
+    ObjectFactory m_schedulerFactory; //!< The scheduler factory.
+    Ptr<DefaultSimulatorImpl> m_impl; //!< The simulator implementation.
+    std::vector<EventId> m_events;    //!< The events to cancel.
+    uint32_t m_count;                 //!< Number of live events executed.
+    Time m_last;                      //!< Time of the last live event.
+};
+
+SimulatorCancelledEventsTestCase::SimulatorCancelledEventsTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the compaction of the cancelled events with " +
+               schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory),
+      m_count(0)
+{
+}
+
+void
+SimulatorCancelledEventsTestCase::Live()
+{
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(Simulator::Now(), m_last, "events out of order");
+    m_last = Simulator::Now();
+    m_count++;
+}
+
+void
+SimulatorCancelledEventsTestCase::CancelEvents()
+{
+    // the last event of every ten stays live
+    for (std::size_t i = 0; i < m_events.size(); ++i)
+    {
+        if (i % 10 != 9)
+        {
+            m_events[i].Cancel();
+            m_events[i].Cancel();
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetCancelledEventCount(), 900, "cancelled events not counted");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetLiveEventCount(), 101, "live events not counted");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetCompactionCount(), 0, "compaction before the threshold");
+}
+
+void
+SimulatorCancelledEventsTestCase::CheckCompaction()
+{
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetCompactionCount(), 1, "no compaction");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetCancelledEventCount(), 0, "cancelled events left");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetLiveEventCount(), 100, "live events lost");
+}
+
+void
+SimulatorCancelledEventsTestCase::DoRun()
+{
+    m_impl = CreateObject<DefaultSimulatorImpl>();
+    m_impl->SetAttribute("CompactionMinEvents", UintegerValue(100));
+    Simulator::SetImplementation(m_impl);
+    Simulator::SetScheduler(m_schedulerFactory);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        m_events.push_back(
+            Simulator::Schedule(MicroSeconds(10 + i), &SimulatorCancelledEventsTestCase::Live, this));
+    }
+    Simulator::Schedule(MicroSeconds(1), &SimulatorCancelledEventsTestCase::CancelEvents, this);
+    Simulator::Schedule(MicroSeconds(2), &SimulatorCancelledEventsTestCase::CheckCompaction, this);
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_count, 100, "not all live events executed");
+    NS_TEST_EXPECT_MSG_EQ(m_impl->GetLiveEventCount(), 0, "live events left");
+    m_events.clear();
+    m_impl = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the recording of an event trace.
+ */
+class SimulatorEventTraceTestCase : public TestCase
+{
+  public:
+    SimulatorEventTraceTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** An event. */
+    void Nothing()
+    {
+    }
+};
+
+SimulatorEventTraceTestCase::SimulatorEventTraceTestCase()
+    : TestCase("Check the recording of an event trace")
+{
+}
+
+void
+SimulatorEventTraceTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("simulator-event-trace.evt");
+    {
+        Ptr<DefaultSimulatorImpl> impl = CreateObject<DefaultSimulatorImpl>();
+        // small buffers, so most records go through the writer thread
+        impl->SetAttribute("EventTraceBufferSize", UintegerValue(3));
+        impl->SetAttribute("EventTraceFile", StringValue(filename));
+        Simulator::SetImplementation(impl);
+
+        std::vector<EventId> events;
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            events.push_back(Simulator::Schedule(MicroSeconds(10 - i),
+                                                 &SimulatorEventTraceTestCase::Nothing,
+                                                 this));
+        }
+        events[2].Cancel();
+        Simulator::Remove(events[3]);
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+
+    EventTraceReader reader(filename);
+    EventTraceRecord record;
+    std::array<uint32_t, 5> counts{};
+    uint64_t last = 0;
+    uint32_t executed = 0;
+    while (reader.Next(record))
+    {
+        NS_TEST_ASSERT_MSG_LT(record.type, counts.size(), "invalid record");
+        counts[record.type]++;
+        if (record.type == EventTraceRecord::EXECUTE)
+        {
+            NS_TEST_EXPECT_MSG_GT_OR_EQ(record.ts, last, "events recorded out of order");
+            last = record.ts;
+            executed++;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(counts[EventTraceRecord::INSERT], 10, "insertions not recorded");
+    NS_TEST_EXPECT_MSG_EQ(counts[EventTraceRecord::CANCEL], 1, "cancellation not recorded");
+    NS_TEST_EXPECT_MSG_EQ(counts[EventTraceRecord::REMOVE], 1, "removal not recorded");
+    NS_TEST_EXPECT_MSG_EQ(executed, 9, "executions not recorded");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event profile written at the end of a run.
+ */
+class SimulatorEventProfileTestCase : public TestCase
+{
+  public:
+    SimulatorEventProfileTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** An event. */
+    void Nothing()
+    {
+    }
+
+    /** An event of another type. */
+    void Something(uint32_t)
+    {
+    }
+};
+
+SimulatorEventProfileTestCase::SimulatorEventProfileTestCase()
+    : TestCase("Check the event profile")
+{
+}
+
+void
+SimulatorEventProfileTestCase::DoRun()
+{
+    std::string prefix = CreateTempDirFilename("simulator-event-profile");
+    Ptr<DefaultSimulatorImpl> impl = CreateObject<DefaultSimulatorImpl>();
+    impl->SetAttribute("EventProfilePrefix", StringValue(prefix));
+    Simulator::SetImplementation(impl);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorEventProfileTestCase::Nothing, this);
+    }
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        Simulator::ScheduleWithContext(7,
+                                       MicroSeconds(i),
+                                       &SimulatorEventProfileTestCase::Something,
+                                       this,
+                                       i);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream report(prefix + ".txt");
+    std::string line;
+    std::getline(report, line);
+    NS_TEST_EXPECT_MSG_EQ(line.substr(0, 25), "Event profile: 5 events, ", "wrong report");
+
+    std::ifstream folded(prefix + ".folded");
+    std::vector<std::string> stacks;
+    while (std::getline(folded, line))
+    {
+        stacks.push_back(line.substr(0, line.rfind(' ')));
+    }
+    NS_TEST_ASSERT_MSG_EQ(stacks.size(), 2, "one stack per context and event type");
+    NS_TEST_EXPECT_MSG_EQ(stacks[0],
+                          "global;MakeEvent<void (SimulatorEventProfileTestCase::*)(), "
+                          "SimulatorEventProfileTestCase*>",
+                          "wrong global stack");
+    NS_TEST_EXPECT_MSG_EQ(stacks[1],
+                          "node 7;MakeEvent<void (SimulatorEventProfileTestCase::*)(unsigned "
+                          "int), SimulatorEventProfileTestCase*, unsigned int>",
+                          "wrong stack of node 7");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -740,6 +1124,15 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(QuaternaryHeapScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorEventPoolTestCase(), TestCase::QUICK);
+        factory.SetTypeId(MapScheduler::GetTypeId());
+        AddTestCase(new SimulatorCancelledEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(CalendarScheduler::GetTypeId());
+        AddTestCase(new SimulatorCancelledEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorEventTraceTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorEventProfileTestCase(), TestCase::QUICK);
     }
 };
 
@@ -293,7 +293,8 @@ class ThreadedSimulatorTestSuite : public TestSuite
         std::string schedulerTypes[] = {"ns3::ListScheduler",
                                         "ns3::HeapScheduler",
                                         "ns3::MapScheduler",
-                                        "ns3::CalendarScheduler"};
+                                        "ns3::CalendarScheduler",
+                                        "ns3::QuaternaryHeapScheduler"};
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
 
@@ -0,0 +1,370 @@
+#include "cybertwin-boot-scheduler.h"
+
+#include "ns3/cybertwin-endhost-daemon.h"
+#include "ns3/cybertwin-manager.h"
+#include "ns3/cybertwin-name-resolution-service.h"
+#include "ns3/cybertwin-node.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <iomanip>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinBootScheduler");
+NS_OBJECT_ENSURE_REGISTERED(CybertwinBootScheduler);
+
+TypeId
+CybertwinBootScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CybertwinBootScheduler")
+            .SetParent<Object>()
+            .SetGroupName("Cybertwin")
+            .AddConstructor<CybertwinBootScheduler>()
+            .AddAttribute("Jitter",
+                          "Maximum random delay of the power on of a node, once its barrier is passed",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&CybertwinBootScheduler::m_jitter),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("Barrier",
+                          "What a node waits for before its power on",
+                          EnumValue(CybertwinBootScheduler::PARENT_BARRIER),
+                          MakeEnumAccessor(&CybertwinBootScheduler::m_barrier),
+                          MakeEnumChecker(CybertwinBootScheduler::PARENT_BARRIER,
+                                          "Parent",
+                                          CybertwinBootScheduler::LAYER_BARRIER,
+                                          "Layer"));
+    return tid;
+}
+
+CybertwinBootScheduler::CybertwinBootScheduler()
+    : m_jitter(MilliSeconds(100)),
+      m_barrier(PARENT_BARRIER),
+      m_currentLayer(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_jitterRng = CreateObject<UniformRandomVariable>();
+}
+
+CybertwinBootScheduler::~CybertwinBootScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CybertwinBootScheduler::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_nodes.clear();
+    m_layers.clear();
+    m_jitterRng = nullptr;
+    Object::DoDispose();
+}
+
+int64_t
+CybertwinBootScheduler::AssignStreams(int64_t stream)
+{
+    m_jitterRng->SetStream(stream);
+    return 1;
+}
+
+void
+CybertwinBootScheduler::AddLayer(const std::string& name, const NodeContainer& nodes)
+{
+    NS_LOG_FUNCTION(this << name << nodes.GetN());
+    Layer layer;
+    layer.name = name;
+    layer.ready = 0;
+    layer.poweredOn = false;
+
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Node> node = nodes.Get(i);
+        if (!DynamicCast<CybertwinNode>(node))
+        {
+            NS_LOG_WARN("[BootScheduler] node " << node->GetId() << " is not a Cybertwin node");
+            continue;
+        }
+        if (m_nodes.find(node->GetId()) != m_nodes.end())
+        {
+            continue;
+        }
+
+        NodeState state;
+        state.node = node;
+        state.layer = m_layers.size();
+        state.pendingServices = 0;
+        state.scheduled = false;
+        state.ready = false;
+        m_nodes[node->GetId()] = state;
+        layer.nodes.push_back(node->GetId());
+    }
+
+    m_layers.push_back(layer);
+}
+
+void
+CybertwinBootScheduler::AddDependency(Ptr<Node> node, Ptr<Node> dependency)
+{
+    NS_LOG_FUNCTION(this << node->GetId() << dependency->GetId());
+    m_extraDeps[node->GetId()].insert(dependency->GetId());
+}
+
+void
+CybertwinBootScheduler::Start()
+{
+    NS_LOG_FUNCTION(this);
+
+    // resolve the dependencies of every node
+    for (auto& entry : m_nodes)
+    {
+        uint32_t id = entry.first;
+        NodeState& state = entry.second;
+
+        std::set<uint32_t> deps = m_extraDeps[id];
+        for (const auto& parent : DynamicCast<CybertwinNode>(state.node)->GetParents())
+        {
+            deps.insert(parent->GetId());
+        }
+
+        for (uint32_t dep : deps)
+        {
+            auto it = m_nodes.find(dep);
+            if (dep == id || it == m_nodes.end())
+            {
+                continue;
+            }
+            if (it->second.layer > state.layer)
+            {
+                // would never be released with layer barriers
+                NS_LOG_WARN("[BootScheduler] node " << id << " depends on node " << dep
+                                                    << " of a later layer, ignored");
+                continue;
+            }
+            state.waitingFor.insert(dep);
+            m_dependents[dep].push_back(id);
+        }
+    }
+
+    m_jitterRng->SetAttribute("Min", DoubleValue(0));
+    m_jitterRng->SetAttribute("Max", DoubleValue(m_jitter.GetSeconds()));
+
+    m_currentLayer = 0;
+    AdvanceLayers();
+    for (auto& entry : m_nodes)
+    {
+        TrySchedule(entry.first);
+    }
+}
+
+void
+CybertwinBootScheduler::PowerOnNow()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& layer : m_layers)
+    {
+        layer.poweredOn = true;
+        layer.firstPowerOn = Simulator::Now();
+        for (uint32_t id : layer.nodes)
+        {
+            NodeState& state = m_nodes[id];
+            state.scheduled = true;
+            DynamicCast<CybertwinNode>(state.node)->PowerOn();
+            state.powerOnTime = Simulator::Now();
+        }
+    }
+
+    for (auto& layer : m_layers)
+    {
+        for (uint32_t id : layer.nodes)
+        {
+            SetReady(id);
+        }
+    }
+}
+
+bool
+CybertwinBootScheduler::IsBooted() const
+{
+    for (const auto& layer : m_layers)
+    {
+        if (layer.ready < layer.nodes.size())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+CybertwinBootScheduler::TrySchedule(uint32_t id)
+{
+    NodeState& state = m_nodes[id];
+    if (state.scheduled || !state.waitingFor.empty())
+    {
+        return;
+    }
+    if (m_barrier == LAYER_BARRIER && state.layer > m_currentLayer)
+    {
+        return;
+    }
+
+    state.scheduled = true;
+    Time delay = Seconds(m_jitterRng->GetValue());
+    NS_LOG_DEBUG("[BootScheduler] node " << id << " powers on in " << delay.As(Time::MS));
+    Simulator::ScheduleWithContext(id, delay, &CybertwinBootScheduler::PowerOnNode, this, id);
+}
+
+void
+CybertwinBootScheduler::PowerOnNode(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    NodeState& state = m_nodes[id];
+    Layer& layer = m_layers[state.layer];
+
+    state.powerOnTime = Simulator::Now();
+    if (!layer.poweredOn)
+    {
+        layer.poweredOn = true;
+        layer.firstPowerOn = state.powerOnTime;
+    }
+
+    DynamicCast<CybertwinNode>(state.node)->PowerOn();
+
+    // watch the boot services installed by the power on
+    std::string context = std::to_string(id);
+    for (uint32_t i = 0; i < state.node->GetNApplications(); i++)
+    {
+        Ptr<Application> app = state.node->GetApplication(i);
+        if (DynamicCast<NameResolutionService>(app) || DynamicCast<CybertwinManager>(app))
+        {
+            app->TraceConnect("Started",
+                              context,
+                              MakeCallback(&CybertwinBootScheduler::NotifyStarted, this));
+            state.pendingServices++;
+        }
+        else if (DynamicCast<CybertwinEndHostDaemon>(app))
+        {
+            app->TraceConnect("Registered",
+                              context,
+                              MakeCallback(&CybertwinBootScheduler::NotifyRegistered, this));
+            state.pendingServices++;
+        }
+    }
+
+    if (state.pendingServices == 0)
+    {
+        SetReady(id);
+    }
+}
+
+void
+CybertwinBootScheduler::NotifyStarted(std::string context)
+{
+    ServiceReady(std::stoul(context));
+}
+
+void
+CybertwinBootScheduler::NotifyRegistered(std::string context, CYBERTWINID_t cuid, uint16_t port)
+{
+    ServiceReady(std::stoul(context));
+}
+
+void
+CybertwinBootScheduler::ServiceReady(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto it = m_nodes.find(id);
+    if (it == m_nodes.end() || it->second.ready)
+    {
+        return;
+    }
+    if (it->second.pendingServices > 0 && --it->second.pendingServices == 0)
+    {
+        SetReady(id);
+    }
+}
+
+void
+CybertwinBootScheduler::SetReady(uint32_t id)
+{
+    NodeState& state = m_nodes[id];
+    if (state.ready)
+    {
+        return;
+    }
+
+    Layer& layer = m_layers[state.layer];
+    state.ready = true;
+    state.readyTime = Simulator::Now();
+    layer.ready++;
+    layer.lastReady = state.readyTime;
+    NS_LOG_DEBUG("[BootScheduler] node " << id << " up after "
+                                         << (state.readyTime - state.powerOnTime).As(Time::MS));
+
+    if (layer.ready == layer.nodes.size())
+    {
+        NS_LOG_INFO("[BootScheduler] layer " << layer.name << " up at "
+                                             << layer.lastReady.As(Time::S) << ", time-to-ready "
+                                             << (layer.lastReady - layer.firstPowerOn).As(Time::MS));
+    }
+
+    for (uint32_t dependent : m_dependents[id])
+    {
+        m_nodes[dependent].waitingFor.erase(id);
+        TrySchedule(dependent);
+    }
+
+    if (m_barrier == LAYER_BARRIER && state.layer == m_currentLayer)
+    {
+        AdvanceLayers();
+    }
+}
+
+void
+CybertwinBootScheduler::AdvanceLayers()
+{
+    uint32_t previous = m_currentLayer;
+    while (m_currentLayer < m_layers.size() &&
+           m_layers[m_currentLayer].ready == m_layers[m_currentLayer].nodes.size())
+    {
+        m_currentLayer++;
+    }
+
+    if (m_barrier == LAYER_BARRIER && m_currentLayer != previous && m_currentLayer < m_layers.size())
+    {
+        for (uint32_t id : m_layers[m_currentLayer].nodes)
+        {
+            TrySchedule(id);
+        }
+    }
+}
+
+void
+CybertwinBootScheduler::Print(std::ostream& os) const
+{
+    os << std::left << std::setw(12) << "layer" << std::right << std::setw(8) << "nodes"
+       << std::setw(8) << "up" << std::setw(14) << "first on(s)" << std::setw(14) << "all up(s)"
+       << std::setw(18) << "time-to-ready(ms)" << std::endl;
+
+    for (const auto& layer : m_layers)
+    {
+        os << std::left << std::setw(12) << layer.name << std::right << std::setw(8)
+           << layer.nodes.size() << std::setw(8) << layer.ready;
+        if (!layer.poweredOn || layer.ready < layer.nodes.size())
+        {
+            // not up, or nothing to boot
+            os << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(18) << "-" << std::endl;
+            continue;
+        }
+        os << std::setw(14) << layer.firstPowerOn.GetSeconds() << std::setw(14)
+           << layer.lastReady.GetSeconds() << std::setw(18)
+           << (layer.lastReady - layer.firstPowerOn).GetMilliSeconds() << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,187 @@
+#ifndef CYBERTWIN_BOOT_SCHEDULER_H
+#define CYBERTWIN_BOOT_SCHEDULER_H
+
+#include "ns3/cybertwin-common.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup cybertwin
+ * \brief Staged power on of a Cybertwin network
+ *
+ * Powering on every node at the same time makes the first CNRS queries,
+ * proxy connections and registrations race the services they depend on.
+ * The scheduler powers the nodes on layer by layer instead, each node after
+ * a uniform random jitter, once its barrier is passed:
+ *
+ *   - Parent: the node waits for its parents (GetParents) and for the nodes
+ *     given with AddDependency, e.g. an edge server starts when the core
+ *     server hosting its CNRS superior is up,
+ *   - Layer: the node also waits for every node of the previous layers.
+ *
+ * A node is up once its boot services are: the CNRS has started, the
+ * CybertwinManager has started and the end host daemon is registered to
+ * its cybertwin. A node running none of them is up when powered on.
+ * Dependencies on nodes the scheduler does not manage are ignored.
+ *
+ * Print reports, per layer, the power on of the first node, the time the
+ * last node was up and the time-to-ready between both.
+ */
+class CybertwinBootScheduler : public Object
+{
+  public:
+    /// Barrier a node waits for before its power on
+    enum BarrierMode_e
+    {
+        PARENT_BARRIER, //!< parents and dependencies up
+        LAYER_BARRIER,  //!< previous layers up
+    };
+
+    static TypeId GetTypeId();
+
+    CybertwinBootScheduler();
+    ~CybertwinBootScheduler() override;
+
+    /**
+     * \brief Add the next layer to boot
+     *
+     * A node already added to a previous layer is ignored.
+     *
+     * \param name the name of the layer, for the report
+     * \param nodes the Cybertwin nodes of the layer
+     */
+    void AddLayer(const std::string& name, const NodeContainer& nodes);
+
+    /**
+     * \brief Make a node wait for another one, besides its parents
+     * \param node the node
+     * \param dependency the node that must be up first
+     */
+    void AddDependency(Ptr<Node> node, Ptr<Node> dependency);
+
+    /**
+     * \brief Schedule the staged power on of every layer
+     */
+    void Start();
+
+    /**
+     * \brief Power on every node now, without jitter or barrier
+     *
+     * Used to restore a snapshot, where the boot exchanges do not happen:
+     * the nodes are reported up at once.
+     */
+    void PowerOnNow();
+
+    /**
+     * \brief Check whether every node is up
+     */
+    bool IsBooted() const;
+
+    /**
+     * \brief Assign a fixed random variable stream number to the jitter
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Print the time-to-ready of every layer
+     * \param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Boot state of a node
+    struct NodeState
+    {
+        Ptr<Node> node;                 //!< the node
+        uint32_t layer;                 //!< index of its layer
+        std::set<uint32_t> waitingFor;  //!< dependencies not up yet, by node id
+        uint32_t pendingServices;       //!< boot services not up yet
+        bool scheduled;                 //!< power on scheduled
+        bool ready;                     //!< node up
+        Time powerOnTime;               //!< time of the power on
+        Time readyTime;                 //!< time the node was up
+    };
+
+    /// Boot state of a layer
+    struct Layer
+    {
+        std::string name;            //!< name of the layer
+        std::vector<uint32_t> nodes; //!< nodes of the layer, by id
+        uint32_t ready;              //!< nodes up
+        Time firstPowerOn;           //!< power on of the first node
+        Time lastReady;              //!< time the last node was up
+        bool poweredOn;              //!< a node was powered on
+    };
+
+    /**
+     * \brief Schedule the power on of a node if its barrier is passed
+     * \param id the node id
+     */
+    void TrySchedule(uint32_t id);
+
+    /**
+     * \brief Power on a node and watch its boot services
+     * \param id the node id
+     */
+    void PowerOnNode(uint32_t id);
+
+    /**
+     * \brief Record a node up and release the nodes waiting for it
+     * \param id the node id
+     */
+    void SetReady(uint32_t id);
+
+    /**
+     * \brief Move to the next layers once the current one is up
+     */
+    void AdvanceLayers();
+
+    /**
+     * \brief A CNRS or CybertwinManager started
+     * \param context the node id
+     */
+    void NotifyStarted(std::string context);
+
+    /**
+     * \brief An end host daemon registered
+     * \param context the node id
+     * \param cuid the cybertwin id
+     * \param port the port of the cybertwin
+     */
+    void NotifyRegistered(std::string context, CYBERTWINID_t cuid, uint16_t port);
+
+    /**
+     * \brief A boot service of a node is up
+     * \param id the node id
+     */
+    void ServiceReady(uint32_t id);
+
+    Time m_jitter;                                   //!< maximum power on jitter
+    BarrierMode_e m_barrier;                         //!< barrier of a node
+    Ptr<UniformRandomVariable> m_jitterRng;          //!< jitter of a node
+    std::vector<Layer> m_layers;                     //!< layers, in boot order
+    std::map<uint32_t, NodeState> m_nodes;           //!< managed nodes, by id
+    std::map<uint32_t, std::set<uint32_t>> m_extraDeps; //!< AddDependency, by node id
+    std::map<uint32_t, std::vector<uint32_t>> m_dependents; //!< nodes waiting for a node
+    uint32_t m_currentLayer;                         //!< first layer not up
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_BOOT_SCHEDULER_H */
@@ -37,7 +37,11 @@ CybertwinEndHostDaemon::GetTypeId()
                           "Manager port.",
                           UintegerValue(CYBERTWIN_MANAGER_PROXY_PORT),
                           MakeUintegerAccessor(&CybertwinEndHostDaemon::m_managerPort),
-                          MakeUintegerChecker<uint16_t>());
+                          MakeUintegerChecker<uint16_t>())
+            .AddTraceSource("Registered",
+                            "The host is registered to its cybertwin.",
+                            MakeTraceSourceAccessor(&CybertwinEndHostDaemon::m_registeredTrace),
+                            "ns3::CybertwinEndHostDaemon::RegisteredTracedCallback");
     return tid;
 }
 
@@ -53,8 +57,11 @@ CybertwinEndHostDaemon::StartApplication()
 
     NS_LOG_INFO("[" << m_nodeName << "][EndHostDaemon] Starting CybertwinEndHostDaemon.");
 
-    // Register to Cybertwin
-    RegisterCybertwin();
+    // Register to Cybertwin, unless restored from a snapshot
+    if (!m_isRegisteredToCybertwin)
+    {
+        RegisterCybertwin();
+    }
 }
 
 void
@@ -219,6 +226,7 @@ CybertwinEndHostDaemon::RegisterSuccessHandler(Ptr<Socket> socket, Ptr<Packet> p
     m_cybertwinId = header.GetCUID();
     m_cybertwinPort = header.GetPort();
     m_isRegisteredToCybertwin = true;
+    m_registeredTrace(m_cybertwinId, m_cybertwinPort);
 
     NS_LOG_DEBUG("[" << m_nodeName << "][EndHostDaemon] Registered to Cybertwin : " << header.GetCUID() << " at " << header.GetPort());
 }
@@ -254,4 +262,23 @@ CybertwinEndHostDaemon::IsRegisteredToCybertwin()
     return m_isRegisteredToCybertwin;
 }
 
+CYBERTWINID_t
+CybertwinEndHostDaemon::GetCybertwinId()
+{
+    return m_cybertwinId;
+}
+
+void
+CybertwinEndHostDaemon::RestoreRegistration(CYBERTWINID_t cuid, uint16_t port)
+{
+    NS_LOG_FUNCTION(this << cuid << port);
+    Ptr<CybertwinEndHost> endHost = DynamicCast<CybertwinEndHost>(GetNode());
+    endHost->SetCybertwinId(cuid);
+    endHost->SetCybertwinPort(port);
+    endHost->SetCybertwinStatus(true);
+    m_cybertwinId = cuid;
+    m_cybertwinPort = port;
+    m_isRegisteredToCybertwin = true;
+}
+
 } // namespace ns3
\ No newline at end of file
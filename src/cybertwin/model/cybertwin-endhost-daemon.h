@@ -17,11 +17,27 @@ class CybertwinEndHostDaemon : public Application
 
     static TypeId GetTypeId();
 
+    /**
+     * TracedCallback signature for the registration of the host.
+     *
+     * \param [in] cuid the cybertwin id
+     * \param [in] port the port of the cybertwin
+     */
+    typedef void (*RegisteredTracedCallback)(CYBERTWINID_t cuid, uint16_t port);
+
     Ipv4Address GetManagerAddr();
     uint16_t GetManagerPort();
     uint16_t GetCybertwinPort();
 
     bool IsRegisteredToCybertwin();
+    CYBERTWINID_t GetCybertwinId();
+
+    /**
+     * \brief Mark the host as registered without the registration exchange
+     *
+     * Used to restore a snapshot, the daemon does not contact the manager.
+     */
+    void RestoreRegistration(CYBERTWINID_t cuid, uint16_t port);
 
   private:
     void StartApplication();
@@ -58,6 +74,8 @@ class CybertwinEndHostDaemon : public Application
 
     CYBERTWINID_t m_cybertwinId;
     uint16_t m_cybertwinPort;
+
+    TracedCallback<CYBERTWINID_t, uint16_t> m_registeredTrace; //!< registered to a cybertwin
 };
     
 } // namespace ns
@@ -4,6 +4,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/simulator.h"
 #include "ns3/tcp-header.h"
+#include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
 #include <fstream>
@@ -24,7 +25,11 @@ CybertwinManager::GetTypeId()
                                           "The port on which the proxy listens",
                                           UintegerValue(CYBERTWIN_MANAGER_PROXY_PORT),
                                           MakeUintegerAccessor(&CybertwinManager::m_proxyPort),
-                                          MakeUintegerChecker<uint16_t>());
+                                          MakeUintegerChecker<uint16_t>())
+                            .AddTraceSource("Started",
+                                            "The proxy listens for hosts.",
+                                            MakeTraceSourceAccessor(&CybertwinManager::m_startedTrace),
+                                            "ns3::CybertwinManager::StartedTracedCallback");
     return tid;
 }
 
@@ -84,6 +89,7 @@ CybertwinManager::StartApplication()
     NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: CybertwinManager starts");
 
     StartProxy();
+    m_startedTrace();
 }
 
 void
@@ -214,12 +220,7 @@ CybertwinManager::HandleCybertwinRegistration(Ptr<Socket> socket,
 
         // create a new cybertwin
         NS_LOG_INFO("[" << Simulator::Now().GetSeconds() << "(s)][" << m_nodeName << "]: Create a new cybertwin " << name);
-        Ptr<Cybertwin> cybertwin = CreateObject<Cybertwin>(cuid, l_interface, g_interfaces);
-        GetNode()->AddApplication(cybertwin);
-        m_cybertwinTable[cuid] = cybertwin;
-
-        // Not started right away
-        cybertwin->SetStartTime(Simulator::Now());
+        CreateCybertwin(cuid, l_interface, g_interfaces);
 
         // set reply header
         replyHeader.SetCommand(CYBERTWIN_REGISTRATION_ACK);
@@ -235,6 +236,47 @@ CybertwinManager::HandleCybertwinRegistration(Ptr<Socket> socket,
     socket->Send(replyPacket);
 }
 
+Ptr<Cybertwin>
+CybertwinManager::CreateCybertwin(CYBERTWINID_t cuid,
+                                  CYBERTWIN_INTERFACE_t l_interface,
+                                  CYBERTWIN_INTERFACE_LIST_t g_interfaces)
+{
+    NS_LOG_FUNCTION(GetNode()->GetId() << cuid);
+    Ptr<Cybertwin> cybertwin = CreateObject<Cybertwin>(cuid, l_interface, g_interfaces);
+    GetNode()->AddApplication(cybertwin);
+    m_cybertwinTable[cuid] = cybertwin;
+
+    // the start time is a delay from the initialization AddApplication
+    // schedules now, start right away
+    cybertwin->SetStartTime(Seconds(0));
+    return cybertwin;
+}
+
+const std::unordered_map<CYBERTWINID_t, Ptr<Cybertwin>>&
+CybertwinManager::GetCybertwinTable() const
+{
+    return m_cybertwinTable;
+}
+
+void
+CybertwinManager::RestoreCybertwin(CYBERTWINID_t cuid,
+                                   CYBERTWIN_INTERFACE_t l_interface,
+                                   CYBERTWIN_INTERFACE_LIST_t g_interfaces)
+{
+    NS_LOG_FUNCTION(GetNode()->GetId() << cuid);
+    NS_ASSERT_MSG(m_cybertwinTable.find(cuid) == m_cybertwinTable.end(),
+                  "cybertwin " << cuid << " already exists");
+
+    // the ports of the restored cybertwins are never assigned again
+    m_lastAssignedPort = std::max<uint16_t>(m_lastAssignedPort, l_interface.second + 1);
+    for (const auto& itf : g_interfaces)
+    {
+        m_assignedPorts.insert(itf.second);
+        m_lastAssignedPort = std::max<uint16_t>(m_lastAssignedPort, itf.second + 1);
+    }
+    CreateCybertwin(cuid, l_interface, g_interfaces);
+}
+
 void
 CybertwinManager::HandleCybertwinDestruction(Ptr<Socket> socket,
                                                 Ptr<Packet> packet)
@@ -11,6 +11,7 @@
 #include "ns3/application.h"
 #include "ns3/callback.h"
 #include "ns3/node.h"
+#include "ns3/traced-callback.h"
 
 #include <unordered_map>
 #include <unordered_set>
@@ -23,11 +24,29 @@ class CybertwinManager : public Application
 {
   public:
     static TypeId GetTypeId();
+
+    /**
+     * TracedCallback signature for the start of the manager.
+     */
+    typedef void (*StartedTracedCallback)();
+
     CybertwinManager();
     CybertwinManager(std::vector<Ipv4Address> localIpv4AddrList,
                      std::vector<Ipv4Address> globalIpv4AddrList);
     ~CybertwinManager();
 
+    const std::unordered_map<CYBERTWINID_t, Ptr<Cybertwin>>& GetCybertwinTable() const;
+
+    /**
+     * \brief Recreate a cybertwin without the registration exchange
+     *
+     * Used to restore a snapshot, the interfaces are the ones assigned
+     * when the cybertwin was registered.
+     */
+    void RestoreCybertwin(CYBERTWINID_t cuid,
+                          CYBERTWIN_INTERFACE_t l_interface,
+                          CYBERTWIN_INTERFACE_LIST_t g_interfaces);
+
   protected:
     void DoDispose() override;
 
@@ -46,6 +65,9 @@ class CybertwinManager : public Application
     void StartProxy();
 
     void AssignInterfaces(CYBERTWIN_INTERFACE_LIST_t&);
+    Ptr<Cybertwin> CreateCybertwin(CYBERTWINID_t,
+                                   CYBERTWIN_INTERFACE_t,
+                                   CYBERTWIN_INTERFACE_LIST_t);
 
     void HandleCybertwinRegistration(Ptr<Socket>, Ptr<Packet>);
     void HandleCybertwinDestruction(Ptr<Socket>, Ptr<Packet>);
@@ -63,6 +85,8 @@ class CybertwinManager : public Application
     uint16_t m_lastAssignedPort;
 
     std::string m_nodeName;
+
+    TracedCallback<> m_startedTrace; //!< the proxy listens for hosts
 };
 
 } // namespace ns3
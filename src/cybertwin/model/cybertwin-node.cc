@@ -175,7 +175,7 @@ CybertwinNode::InstallCNRSApp()
     }
 
     this->AddApplication(cybertwinCNRSApp);
-    cybertwinCNRSApp->SetStartTime(Simulator::Now());
+    cybertwinCNRSApp->SetStartTime(Seconds(0));
     m_cybertwinCNRSApp = cybertwinCNRSApp;
 }
 
@@ -195,7 +195,7 @@ CybertwinNode::InstallCybertwinManagerApp(std::vector<Ipv4Address> localIpList,
     Ptr<CybertwinManager> cybertwinManagerApp =
         CreateObject<CybertwinManager>(localIpList, globalIpList);
     this->AddApplication(cybertwinManagerApp);
-    cybertwinManagerApp->SetStartTime(Simulator::Now());
+    cybertwinManagerApp->SetStartTime(Seconds(0));
 }
 
 void
@@ -354,7 +354,7 @@ CybertwinEndHost::PowerOn()
     Ptr<CybertwinEndHostDaemon> initd = CreateObject<CybertwinEndHostDaemon>();
     initd->SetAttribute("ManagerAddr", Ipv4AddressValue(m_upperNodeAddress));
     initd->SetAttribute("ManagerPort", UintegerValue(CYBERTWIN_MANAGER_PROXY_PORT));
-    initd->SetStartTime(Simulator::Now());
+    initd->SetStartTime(Seconds(0));
 
     this->AddApplication(initd);
 
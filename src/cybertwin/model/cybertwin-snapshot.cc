@@ -0,0 +1,351 @@
+#include "cybertwin-snapshot.h"
+
+#include "ns3/cybertwin-endhost-daemon.h"
+#include "ns3/cybertwin-manager.h"
+#include "ns3/cybertwin-name-resolution-service.h"
+#include "ns3/cybertwin-node.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinSnapshot");
+
+namespace
+{
+
+/// A gateway route: destination, mask, gateway, interface, metric
+typedef std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t> Route;
+
+/// First application of a node of the given type
+template <typename T>
+Ptr<T>
+FindApplication(Ptr<Node> node)
+{
+    for (uint32_t i = 0; i < node->GetNApplications(); i++)
+    {
+        Ptr<T> app = DynamicCast<T>(node->GetApplication(i));
+        if (app)
+        {
+            return app;
+        }
+    }
+    return nullptr;
+}
+
+nlohmann::json
+InterfaceToJson(const CYBERTWIN_INTERFACE_t& itf)
+{
+    return nlohmann::json::array({itf.first.Get(), itf.second});
+}
+
+CYBERTWIN_INTERFACE_t
+InterfaceFromJson(const nlohmann::json& j)
+{
+    return std::make_pair(Ipv4Address(j.at(0).get<uint32_t>()), j.at(1).get<uint16_t>());
+}
+
+nlohmann::json
+InterfacesToJson(const CYBERTWIN_INTERFACE_LIST_t& itfs)
+{
+    nlohmann::json j = nlohmann::json::array();
+    for (const auto& itf : itfs)
+    {
+        j.push_back(InterfaceToJson(itf));
+    }
+    return j;
+}
+
+CYBERTWIN_INTERFACE_LIST_t
+InterfacesFromJson(const nlohmann::json& j)
+{
+    CYBERTWIN_INTERFACE_LIST_t itfs;
+    for (const auto& itf : j)
+    {
+        itfs.push_back(InterfaceFromJson(itf));
+    }
+    return itfs;
+}
+
+/// Gateway routes of the static and global routing of a node
+std::vector<Route>
+GetGatewayRoutes(Ptr<Ipv4> ipv4)
+{
+    std::vector<Route> routes;
+    Ptr<Ipv4RoutingProtocol> protocol = ipv4->GetRoutingProtocol();
+
+    Ptr<Ipv4StaticRouting> staticRouting =
+        Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(protocol);
+    for (uint32_t i = 0; staticRouting && i < staticRouting->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry route = staticRouting->GetRoute(i);
+        if (route.IsGateway())
+        {
+            routes.emplace_back(route.GetDest().Get(),
+                                route.GetDestNetworkMask().Get(),
+                                route.GetGateway().Get(),
+                                route.GetInterface(),
+                                staticRouting->GetMetric(i));
+        }
+    }
+
+    Ptr<Ipv4GlobalRouting> globalRouting =
+        Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting>(protocol);
+    for (uint32_t i = 0; globalRouting && i < globalRouting->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry* route = globalRouting->GetRoute(i);
+        if (route->IsGateway())
+        {
+            routes.emplace_back(route->GetDest().Get(),
+                                route->GetDestNetworkMask().Get(),
+                                route->GetGateway().Get(),
+                                route->GetInterface(),
+                                0);
+        }
+    }
+    return routes;
+}
+
+} // namespace
+
+bool
+CybertwinSnapshot::Save(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+    nlohmann::json nodes = nlohmann::json::array();
+    uint64_t routeCount = 0;
+    uint64_t cybertwinCount = 0;
+
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<Node> node = *it;
+        nlohmann::json entry;
+        entry["id"] = node->GetId();
+
+        Ptr<CybertwinNode> cybertwinNode = DynamicCast<CybertwinNode>(node);
+        if (cybertwinNode)
+        {
+            entry["name"] = cybertwinNode->GetName();
+        }
+
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        if (ipv4)
+        {
+            nlohmann::json routes = nlohmann::json::array();
+            for (const auto& route : GetGatewayRoutes(ipv4))
+            {
+                routes.push_back({std::get<0>(route),
+                                  std::get<1>(route),
+                                  std::get<2>(route),
+                                  std::get<3>(route),
+                                  std::get<4>(route)});
+            }
+            routeCount += routes.size();
+            entry["routes"] = routes;
+        }
+
+        Ptr<NameResolutionService> cnrs = FindApplication<NameResolutionService>(node);
+        if (cnrs)
+        {
+            if (cnrs->HasPendingQueries())
+            {
+                NS_LOG_WARN("[CybertwinSnapshot] Node " << node->GetId()
+                                                        << " has pending CNRS queries");
+                return false;
+            }
+            nlohmann::json cache = nlohmann::json::array();
+            for (const auto& item : cnrs->GetCache())
+            {
+                cache.push_back({{"cuid", item.first}, {"interfaces", InterfacesToJson(item.second)}});
+            }
+            entry["cnrs"] = cache;
+        }
+
+        Ptr<CybertwinManager> manager = FindApplication<CybertwinManager>(node);
+        if (manager)
+        {
+            nlohmann::json cybertwins = nlohmann::json::array();
+            for (const auto& item : manager->GetCybertwinTable())
+            {
+                cybertwins.push_back({{"cuid", item.first},
+                                      {"local", InterfaceToJson(item.second->GetLocalInterface())},
+                                      {"global", InterfacesToJson(item.second->GetGlobalInterfaces())}});
+            }
+            cybertwinCount += cybertwins.size();
+            entry["cybertwins"] = cybertwins;
+        }
+
+        Ptr<CybertwinEndHostDaemon> daemon = FindApplication<CybertwinEndHostDaemon>(node);
+        if (daemon)
+        {
+            if (!daemon->IsRegisteredToCybertwin())
+            {
+                NS_LOG_WARN("[CybertwinSnapshot] Node " << node->GetId()
+                                                        << " is not registered to its cybertwin");
+                return false;
+            }
+            entry["registration"] = {{"cuid", daemon->GetCybertwinId()},
+                                     {"port", daemon->GetCybertwinPort()}};
+        }
+
+        nodes.push_back(entry);
+    }
+
+    nlohmann::json snapshot;
+    snapshot["version"] = VERSION;
+    snapshot["time"] = Simulator::Now().GetSeconds();
+    snapshot["nodes"] = nodes;
+
+    // write the file in one go, a reader never sees a partial snapshot
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        out << snapshot.dump();
+        if (!out)
+        {
+            NS_LOG_WARN("[CybertwinSnapshot] Cannot write " << tmp);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        NS_LOG_WARN("[CybertwinSnapshot] Cannot rename " << tmp << " to " << path);
+        return false;
+    }
+
+    NS_LOG_INFO("[CybertwinSnapshot] Saved " << nodes.size() << " nodes, " << routeCount
+                                             << " routes, " << cybertwinCount << " cybertwins at "
+                                             << Simulator::Now().GetSeconds() << "s to " << path);
+    return true;
+}
+
+Time
+CybertwinSnapshot::Restore(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+    std::ifstream in(path);
+    NS_ABORT_MSG_IF(!in, "Cannot open snapshot " << path);
+
+    nlohmann::json snapshot;
+    try
+    {
+        snapshot = nlohmann::json::parse(in);
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        NS_FATAL_ERROR("Malformed snapshot " << path << ": " << e.what());
+    }
+    NS_ABORT_MSG_IF(snapshot.value("version", 0u) != VERSION,
+                    "Snapshot " << path << " has another format version");
+
+    const nlohmann::json& nodes = snapshot.at("nodes");
+    NS_ABORT_MSG_IF(nodes.size() != NodeList::GetNNodes(),
+                    "Snapshot " << path << " has " << nodes.size() << " nodes, the network "
+                                << NodeList::GetNNodes());
+
+    uint64_t routeCount = 0;
+    uint64_t cybertwinCount = 0;
+    for (const auto& entry : nodes)
+    {
+        Ptr<Node> node = NodeList::GetNode(entry.at("id").get<uint32_t>());
+        Ptr<CybertwinNode> cybertwinNode = DynamicCast<CybertwinNode>(node);
+        NS_ABORT_MSG_IF(entry.contains("name") != bool(cybertwinNode) ||
+                            (cybertwinNode &&
+                             entry.at("name").get<std::string>() != cybertwinNode->GetName()),
+                        "Snapshot " << path << " was taken on another topology, node "
+                                    << node->GetId() << " differs");
+
+        if (entry.contains("routes"))
+        {
+            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+            NS_ABORT_MSG_IF(!ipv4, "No Ipv4 on node " << node->GetId());
+            Ptr<Ipv4StaticRouting> routing =
+                Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(ipv4->GetRoutingProtocol());
+            NS_ABORT_MSG_IF(!routing, "No static routing on node " << node->GetId());
+
+            // routes installed by the topology itself, LTE UE default routes
+            // for instance, are not added twice
+            std::vector<Route> existing = GetGatewayRoutes(ipv4);
+            std::set<Route> installed(existing.begin(), existing.end());
+            for (const auto& r : entry.at("routes"))
+            {
+                Route route(r.at(0).get<uint32_t>(),
+                            r.at(1).get<uint32_t>(),
+                            r.at(2).get<uint32_t>(),
+                            r.at(3).get<uint32_t>(),
+                            r.at(4).get<uint32_t>());
+                if (!installed.insert(route).second)
+                {
+                    continue;
+                }
+                routing->AddNetworkRouteTo(Ipv4Address(std::get<0>(route)),
+                                           Ipv4Mask(std::get<1>(route)),
+                                           Ipv4Address(std::get<2>(route)),
+                                           std::get<3>(route),
+                                           std::get<4>(route));
+                routeCount++;
+            }
+        }
+
+        if (entry.contains("cnrs"))
+        {
+            Ptr<NameResolutionService> cnrs = FindApplication<NameResolutionService>(node);
+            NS_ABORT_MSG_IF(!cnrs, "No CNRS on node " << node->GetId() << ", power it on first");
+            std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t> cache;
+            for (const auto& item : entry.at("cnrs"))
+            {
+                cache[item.at("cuid").get<CYBERTWINID_t>()] =
+                    InterfacesFromJson(item.at("interfaces"));
+            }
+            cnrs->RestoreCache(cache);
+        }
+
+        // after the CNRS cache, a restored cybertwin finds its interfaces
+        // there when it starts and reports nothing
+        if (entry.contains("cybertwins"))
+        {
+            Ptr<CybertwinManager> manager = FindApplication<CybertwinManager>(node);
+            NS_ABORT_MSG_IF(!manager,
+                            "No CybertwinManager on node " << node->GetId() << ", power it on first");
+            for (const auto& item : entry.at("cybertwins"))
+            {
+                manager->RestoreCybertwin(item.at("cuid").get<CYBERTWINID_t>(),
+                                          InterfaceFromJson(item.at("local")),
+                                          InterfacesFromJson(item.at("global")));
+                cybertwinCount++;
+            }
+        }
+
+        if (entry.contains("registration"))
+        {
+            Ptr<CybertwinEndHostDaemon> daemon = FindApplication<CybertwinEndHostDaemon>(node);
+            NS_ABORT_MSG_IF(!daemon,
+                            "No end host daemon on node " << node->GetId() << ", power it on first");
+            const nlohmann::json& registration = entry.at("registration");
+            daemon->RestoreRegistration(registration.at("cuid").get<CYBERTWINID_t>(),
+                                        registration.at("port").get<uint16_t>());
+        }
+    }
+
+    Time time = Seconds(snapshot.value("time", 0.0));
+    NS_LOG_INFO("[CybertwinSnapshot] Restored " << nodes.size() << " nodes, " << routeCount
+                                                << " routes, " << cybertwinCount
+                                                << " cybertwins taken at " << time.GetSeconds()
+                                                << "s from " << path);
+    return time;
+}
+
+} // namespace ns3
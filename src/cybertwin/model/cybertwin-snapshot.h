@@ -0,0 +1,64 @@
+#ifndef CYBERTWIN_SNAPSHOT_H
+#define CYBERTWIN_SNAPSHOT_H
+
+#include "ns3/nstime.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup cybertwin
+ * \brief Snapshot of a booted Cybertwin network
+ *
+ * Booting a Cybertwin network (routing, CNRS registration, cybertwin
+ * creation for every end host) gives the same state on every run of a
+ * sweep. Save writes that state, for every node of the NodeList:
+ *
+ *   - the gateway routes of its static and global routing,
+ *   - the cache of its CNRS,
+ *   - the cybertwins created by its CybertwinManager, with their interfaces,
+ *   - the cybertwin registered by its end host daemon.
+ *
+ * Restore installs it again on a network built from the same topology,
+ * after the nodes are powered on and before the simulation runs: the
+ * routes go into the static routing, the CNRS caches are filled, the
+ * cybertwins are recreated without the registration exchange and the end
+ * host daemons start registered. A restored run skips the routing
+ * computation and every boot exchange; nothing happens until the first
+ * application starts.
+ *
+ * Only quiescent states are supported: sockets, packets in flight and
+ * pending events are not part of the snapshot. Save refuses to write a
+ * state where an end host is not registered yet or a CNRS query is
+ * pending.
+ */
+class CybertwinSnapshot
+{
+  public:
+    /// Current format version
+    static const uint32_t VERSION = 1;
+
+    /**
+     * \brief Write the state of every node
+     * \param path the snapshot file
+     * \return false if the state is not quiescent or the file could not be written
+     */
+    static bool Save(const std::string& path);
+
+    /**
+     * \brief Install the state of a snapshot
+     *
+     * The network must be built from the topology the snapshot was taken
+     * from, a snapshot of other nodes is a fatal error.
+     *
+     * \param path the snapshot file
+     * \return the simulation time the snapshot was taken at
+     */
+    static Time Restore(const std::string& path);
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_SNAPSHOT_H */
@@ -46,6 +46,24 @@ Cybertwin::~Cybertwin()
                     << "]: Destroy Cybertwin : " << m_cybertwinId);
 }
 
+CYBERTWINID_t
+Cybertwin::GetCybertwinId() const
+{
+    return m_cybertwinId;
+}
+
+CYBERTWIN_INTERFACE_t
+Cybertwin::GetLocalInterface() const
+{
+    return m_localInterface;
+}
+
+CYBERTWIN_INTERFACE_LIST_t
+Cybertwin::GetGlobalInterfaces() const
+{
+    return m_globalInterfaces;
+}
+
 void
 Cybertwin::StartApplication()
 {
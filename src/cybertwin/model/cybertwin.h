@@ -123,6 +123,10 @@ class Cybertwin : public CybertwinApp
     static TypeId GetTypeId();
     void DoDispose() override;
 
+    CYBERTWINID_t GetCybertwinId() const;
+    CYBERTWIN_INTERFACE_t GetLocalInterface() const;
+    CYBERTWIN_INTERFACE_LIST_t GetGlobalInterfaces() const;
+
   private:
     void StartApplication() override;
     void StopApplication() override;
@@ -3,6 +3,7 @@
 #include "ns3/cybertwin-node.h"
 #include "ns3/log.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/trace-source-accessor.h"
 
 namespace ns3
 {
@@ -14,7 +15,11 @@ NameResolutionService::GetTypeId()
     static TypeId tid = TypeId("ns3::NameResolutionService")
                             .SetParent<Application>()
                             .SetGroupName("Applications")
-                            .AddConstructor<NameResolutionService>();
+                            .AddConstructor<NameResolutionService>()
+                            .AddTraceSource("Started",
+                                            "The service is up and answers queries.",
+                                            MakeTraceSourceAccessor(&NameResolutionService::m_startedTrace),
+                                            "ns3::NameResolutionService::StartedTracedCallback");
     return tid;
 }
 
@@ -54,6 +59,8 @@ NameResolutionService::StartApplication()
     LoadDatabase();
     InitSuperior();
     InitNameResolutionServer();
+
+    m_startedTrace();
 }
 
 void
@@ -557,6 +564,26 @@ NameResolutionService::InsertCybertwinInterfaceName(CYBERTWINID_t name,
     return 0;
 }
 
+const std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>&
+NameResolutionService::GetCache() const
+{
+    return itemCache;
+}
+
+void
+NameResolutionService::RestoreCache(
+    const std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>& cache)
+{
+    NS_LOG_FUNCTION(this << cache.size());
+    itemCache.insert(cache.begin(), cache.end());
+}
+
+bool
+NameResolutionService::HasPendingQueries() const
+{
+    return !m_queryCache.empty();
+}
+
 QUERY_ID_t
 NameResolutionService::GetQueryID()
 {
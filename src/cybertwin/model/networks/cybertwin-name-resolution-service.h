@@ -19,6 +19,11 @@ class NameResolutionService : public Application
     ~NameResolutionService();
     static TypeId GetTypeId();
 
+    /**
+     * TracedCallback signature for the start of the service.
+     */
+    typedef void (*StartedTracedCallback)();
+
     void SetSuperior(Ipv4Address superior);
     void DefaultGetInterfaceCallback(CYBERTWINID_t id, CYBERTWIN_INTERFACE_LIST_t ifs);
 
@@ -34,6 +39,18 @@ class NameResolutionService : public Application
                                         Callback<void, CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>);
     int32_t InsertCybertwinInterfaceName(CYBERTWINID_t name, CYBERTWIN_INTERFACE_LIST_t& interface);
 
+    const std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>& GetCache() const;
+
+    /**
+     * @brief fill the cache from a snapshot, nothing is reported to the superior
+     */
+    void RestoreCache(const std::unordered_map<CYBERTWINID_t, CYBERTWIN_INTERFACE_LIST_t>& cache);
+
+    /**
+     * @brief whether queries are waiting for an answer of the superior
+     */
+    bool HasPendingQueries() const;
+
   private:
     void StartApplication() override;
     void StopApplication() override;
@@ -83,6 +100,8 @@ class NameResolutionService : public Application
     std::string m_nodeName;
     
     bool m_isCNRSRoot;
+
+    TracedCallback<> m_startedTrace; //!< the service is up
 };
 } // namespace ns3
 
@@ -0,0 +1,446 @@
+#include "ns3/cybertwin-boot-scheduler.h"
+#include "ns3/cybertwin-name-resolution-service.h"
+#include "ns3/cybertwin-node.h"
+#include "ns3/enum.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief Cybertwin node recording its power on
+ *
+ * With a service delay, the power on installs a root CNRS starting after
+ * that delay, so the node is up once the delay has passed.
+ */
+class BootTestNode : public CybertwinNode
+{
+  public:
+    BootTestNode();
+
+    /**
+     * \brief Install a CNRS on power on, starting after a delay
+     * \param delay the start delay of the CNRS
+     */
+    void SetServiceDelay(Time delay);
+
+    void PowerOn() override;
+
+    std::vector<Time> m_powerOns; //!< times of the power on calls
+
+  private:
+    Time m_serviceDelay; //!< start delay of the CNRS, none if zero
+};
+
+BootTestNode::BootTestNode()
+    : m_serviceDelay(0)
+{
+}
+
+void
+BootTestNode::SetServiceDelay(Time delay)
+{
+    m_serviceDelay = delay;
+    SetCNRSRoot();
+    InternetStackHelper stack;
+    stack.Install(this);
+}
+
+void
+BootTestNode::PowerOn()
+{
+    m_powerOns.push_back(Simulator::Now());
+    if (m_serviceDelay.IsStrictlyPositive())
+    {
+        Ptr<NameResolutionService> cnrs = CreateObject<NameResolutionService>();
+        AddApplication(cnrs);
+        cnrs->SetStartTime(m_serviceDelay);
+    }
+}
+
+/**
+ * \brief Create a boot scheduler
+ * \param jitter the maximum power on jitter
+ * \param barrier the barrier mode
+ * \return the scheduler
+ */
+static Ptr<CybertwinBootScheduler>
+CreateBootScheduler(Time jitter, CybertwinBootScheduler::BarrierMode_e barrier)
+{
+    Ptr<CybertwinBootScheduler> scheduler = CreateObject<CybertwinBootScheduler>();
+    scheduler->SetAttribute("Jitter", TimeValue(jitter));
+    scheduler->SetAttribute("Barrier", EnumValue(barrier));
+    scheduler->AssignStreams(1);
+    return scheduler;
+}
+
+/**
+ * \brief Parse the rows of a boot report
+ * \param scheduler the scheduler
+ * \return the columns of every layer row, by layer name
+ */
+static std::map<std::string, std::vector<std::string>>
+ParseReport(Ptr<CybertwinBootScheduler> scheduler)
+{
+    std::ostringstream os;
+    scheduler->Print(os);
+
+    std::map<std::string, std::vector<std::string>> rows;
+    std::istringstream is(os.str());
+    std::string line;
+    std::getline(is, line); // header
+    while (std::getline(is, line))
+    {
+        std::istringstream columns(line);
+        std::string name;
+        std::string column;
+        columns >> name;
+        while (columns >> column)
+        {
+            rows[name].push_back(column);
+        }
+    }
+    return rows;
+}
+
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief Barriers, dependencies and readiness of the boot scheduler
+ *
+ * A core node is up 50 ms after its power on, once its CNRS has started.
+ * Its child in the next layer powers on after that, and a node given the
+ * child with AddDependency after the child. A node of the same layer
+ * without parent powers on at once with the Parent barrier and waits for
+ * the core layer with the Layer barrier. A dependency of the core on the
+ * next layer is ignored.
+ */
+class CybertwinBootBarrierTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param barrier the barrier mode
+     */
+    CybertwinBootBarrierTest(CybertwinBootScheduler::BarrierMode_e barrier);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check that the scheduler waits for the CNRS of the core
+     * \param scheduler the scheduler
+     */
+    void CheckNotBooted(Ptr<CybertwinBootScheduler> scheduler);
+
+    CybertwinBootScheduler::BarrierMode_e m_barrier; //!< barrier mode
+    bool m_bootedEarly;                              //!< booted before the core was up
+};
+
+CybertwinBootBarrierTest::CybertwinBootBarrierTest(CybertwinBootScheduler::BarrierMode_e barrier)
+    : TestCase(std::string("Cybertwin boot scheduler with the ") +
+               (barrier == CybertwinBootScheduler::PARENT_BARRIER ? "Parent" : "Layer") +
+               " barrier"),
+      m_barrier(barrier),
+      m_bootedEarly(true)
+{
+}
+
+void
+CybertwinBootBarrierTest::CheckNotBooted(Ptr<CybertwinBootScheduler> scheduler)
+{
+    m_bootedEarly = scheduler->IsBooted();
+}
+
+void
+CybertwinBootBarrierTest::DoRun()
+{
+    const Time jitter = MilliSeconds(10);
+    const Time serviceDelay = MilliSeconds(50);
+
+    Ptr<BootTestNode> core = CreateObject<BootTestNode>();
+    core->SetServiceDelay(serviceDelay);
+    Ptr<BootTestNode> child = CreateObject<BootTestNode>();
+    child->AddParent(core);
+    Ptr<BootTestNode> dependent = CreateObject<BootTestNode>();
+    Ptr<BootTestNode> standalone = CreateObject<BootTestNode>();
+
+    NodeContainer edge;
+    edge.Add(child);
+    edge.Add(dependent);
+    edge.Add(standalone);
+
+    Ptr<CybertwinBootScheduler> scheduler = CreateBootScheduler(jitter, m_barrier);
+    scheduler->AddLayer("core", NodeContainer(core));
+    scheduler->AddLayer("edge", edge);
+    scheduler->AddDependency(dependent, child);
+    scheduler->AddDependency(core, standalone);
+    scheduler->Start();
+    NS_TEST_EXPECT_MSG_EQ(scheduler->IsBooted(), false, "Booted before any power on");
+
+    Simulator::Schedule(jitter + serviceDelay / 2,
+                        &CybertwinBootBarrierTest::CheckNotBooted,
+                        this,
+                        scheduler);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsBooted(), true, "Not every node is up");
+    for (Ptr<BootTestNode> node : {core, child, dependent, standalone})
+    {
+        NS_TEST_ASSERT_MSG_EQ(node->m_powerOns.size(), 1, "Node not powered on once");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_bootedEarly, false, "Core up before its CNRS started");
+
+    Time coreUp = core->m_powerOns[0] + serviceDelay;
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(core->m_powerOns[0], jitter, "Core waited for its dependency");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(child->m_powerOns[0], coreUp, "Child powered on before its parent");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(child->m_powerOns[0], coreUp + jitter, "Child jitter too long");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(dependent->m_powerOns[0],
+                                child->m_powerOns[0],
+                                "Dependent powered on before its dependency");
+    if (m_barrier == CybertwinBootScheduler::PARENT_BARRIER)
+    {
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(standalone->m_powerOns[0],
+                                    jitter,
+                                    "Node without parent waited for the core layer");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(standalone->m_powerOns[0],
+                                    coreUp,
+                                    "Node powered on before the core layer was up");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief Power on jitter of the boot scheduler
+ *
+ * A hundred nodes without dependencies, started at 1 s, power on within
+ * the Jitter. With a 20 ms jitter, at most a quarter of them power on
+ * within the same millisecond, where all of them do without jitter.
+ */
+class CybertwinBootJitterTest : public TestCase
+{
+  public:
+    CybertwinBootJitterTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Boot the nodes
+     * \param jitter the maximum power on jitter
+     * \return the power on times, sorted
+     */
+    std::vector<Time> Boot(Time jitter);
+
+    /**
+     * \brief Count the largest number of power ons within a window
+     * \param times the power on times, sorted
+     * \param window the window
+     * \return the largest count
+     */
+    static uint32_t MaxPowerOns(const std::vector<Time>& times, Time window);
+};
+
+CybertwinBootJitterTest::CybertwinBootJitterTest()
+    : TestCase("Cybertwin boot scheduler spreads the power on of a layer over the jitter")
+{
+}
+
+std::vector<Time>
+CybertwinBootJitterTest::Boot(Time jitter)
+{
+    std::vector<Ptr<BootTestNode>> nodes;
+    NodeContainer layer;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        nodes.push_back(CreateObject<BootTestNode>());
+        layer.Add(nodes.back());
+    }
+
+    Ptr<CybertwinBootScheduler> scheduler =
+        CreateBootScheduler(jitter, CybertwinBootScheduler::PARENT_BARRIER);
+    scheduler->AddLayer("hosts", layer);
+    Simulator::Schedule(Seconds(1), &CybertwinBootScheduler::Start, scheduler);
+    Simulator::Run();
+
+    std::vector<Time> times;
+    for (const auto& node : nodes)
+    {
+        times.insert(times.end(), node->m_powerOns.begin(), node->m_powerOns.end());
+    }
+    std::sort(times.begin(), times.end());
+    Simulator::Destroy();
+    return times;
+}
+
+uint32_t
+CybertwinBootJitterTest::MaxPowerOns(const std::vector<Time>& times, Time window)
+{
+    uint32_t count = 0;
+    for (size_t first = 0, last = 0; last < times.size(); last++)
+    {
+        while (times[last] - times[first] >= window)
+        {
+            first++;
+        }
+        count = std::max<uint32_t>(count, last - first + 1);
+    }
+    return count;
+}
+
+void
+CybertwinBootJitterTest::DoRun()
+{
+    std::vector<Time> simultaneous = Boot(Seconds(0));
+    NS_TEST_ASSERT_MSG_EQ(simultaneous.size(), 100, "Node not powered on once");
+    NS_TEST_EXPECT_MSG_EQ(MaxPowerOns(simultaneous, MilliSeconds(1)),
+                          100,
+                          "Nodes without jitter not powered on together");
+
+    std::vector<Time> jittered = Boot(MilliSeconds(20));
+    NS_TEST_ASSERT_MSG_EQ(jittered.size(), 100, "Node not powered on once");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(jittered.front(), Seconds(1), "Power on before the start");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(jittered.back(),
+                                Seconds(1) + MilliSeconds(20),
+                                "Power on after the jitter");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(MaxPowerOns(jittered, MilliSeconds(1)),
+                                25,
+                                "Jitter does not spread the power on spike");
+}
+
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief PowerOnNow and the report of the boot scheduler
+ *
+ * Without jitter, a core up 50 ms after its power on at 1 s and its child
+ * are reported with their power on, up and time-to-ready times; layers not
+ * up are reported with dashes. PowerOnNow powers every node on at once,
+ * whatever its jitter and barrier, and reports them up right away.
+ */
+class CybertwinBootReportTest : public TestCase
+{
+  public:
+    CybertwinBootReportTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Power every node on now and check they are up
+     * \param scheduler the scheduler
+     */
+    void PowerOnNow(Ptr<CybertwinBootScheduler> scheduler);
+
+    bool m_bootedNow; //!< booted right after PowerOnNow
+};
+
+CybertwinBootReportTest::CybertwinBootReportTest()
+    : TestCase("Cybertwin boot scheduler report and PowerOnNow"),
+      m_bootedNow(false)
+{
+}
+
+void
+CybertwinBootReportTest::PowerOnNow(Ptr<CybertwinBootScheduler> scheduler)
+{
+    scheduler->PowerOnNow();
+    m_bootedNow = scheduler->IsBooted();
+}
+
+void
+CybertwinBootReportTest::DoRun()
+{
+    Ptr<BootTestNode> core = CreateObject<BootTestNode>();
+    core->SetServiceDelay(MilliSeconds(50));
+    Ptr<BootTestNode> child = CreateObject<BootTestNode>();
+    child->AddParent(core);
+
+    Ptr<CybertwinBootScheduler> scheduler =
+        CreateBootScheduler(Seconds(0), CybertwinBootScheduler::PARENT_BARRIER);
+    scheduler->AddLayer("core", NodeContainer(core));
+    scheduler->AddLayer("edge", NodeContainer(child));
+    scheduler->AddLayer("empty", NodeContainer());
+
+    auto rows = ParseReport(scheduler);
+    NS_TEST_EXPECT_MSG_EQ(rows["core"].size(), 5, "Wrong number of columns");
+    NS_TEST_EXPECT_MSG_EQ(rows["core"][0], "1", "Nodes of the core layer");
+    NS_TEST_EXPECT_MSG_EQ(rows["core"][1], "0", "Core layer up before the start");
+    NS_TEST_EXPECT_MSG_EQ(rows["core"][4], "-", "Core layer reported up before the start");
+
+    Simulator::Schedule(Seconds(1), &CybertwinBootScheduler::Start, scheduler);
+    Simulator::Run();
+
+    rows = ParseReport(scheduler);
+    std::vector<std::string> coreRow = {"1", "1", "1", "1.05", "50"};
+    std::vector<std::string> edgeRow = {"1", "1", "1.05", "1.05", "0"};
+    std::vector<std::string> emptyRow = {"0", "0", "-", "-", "-"};
+    NS_TEST_EXPECT_MSG_EQ((rows["core"] == coreRow), true, "Report of the core layer");
+    NS_TEST_EXPECT_MSG_EQ((rows["edge"] == edgeRow), true, "Report of the edge layer");
+    NS_TEST_EXPECT_MSG_EQ((rows["empty"] == emptyRow), true, "Report of a layer not up");
+    Simulator::Destroy();
+
+    // a snapshot restore at 2 s
+    core = CreateObject<BootTestNode>();
+    core->SetServiceDelay(MilliSeconds(50));
+    child = CreateObject<BootTestNode>();
+    child->AddParent(core);
+
+    scheduler = CreateBootScheduler(MilliSeconds(100), CybertwinBootScheduler::LAYER_BARRIER);
+    scheduler->AddLayer("core", NodeContainer(core));
+    scheduler->AddLayer("edge", NodeContainer(child));
+    Simulator::Schedule(Seconds(2), &CybertwinBootReportTest::PowerOnNow, this, scheduler);
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_bootedNow, true, "Nodes not up right after PowerOnNow");
+    NS_TEST_ASSERT_MSG_EQ(core->m_powerOns.size(), 1, "Core not powered on once");
+    NS_TEST_ASSERT_MSG_EQ(child->m_powerOns.size(), 1, "Child not powered on once");
+    NS_TEST_EXPECT_MSG_EQ(core->m_powerOns[0], Seconds(2), "Core power on delayed");
+    NS_TEST_EXPECT_MSG_EQ(child->m_powerOns[0], Seconds(2), "Child power on delayed");
+
+    rows = ParseReport(scheduler);
+    std::vector<std::string> restoredRow = {"1", "1", "2", "2", "0"};
+    NS_TEST_EXPECT_MSG_EQ((rows["core"] == restoredRow), true, "Report of the restored core");
+    NS_TEST_EXPECT_MSG_EQ((rows["edge"] == restoredRow), true, "Report of the restored edge");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief Cybertwin boot scheduler TestSuite
+ */
+class CybertwinBootSchedulerTestSuite : public TestSuite
+{
+  public:
+    CybertwinBootSchedulerTestSuite()
+        : TestSuite("cybertwin-boot-scheduler", UNIT)
+    {
+        AddTestCase(new CybertwinBootBarrierTest(CybertwinBootScheduler::PARENT_BARRIER),
+                    TestCase::QUICK);
+        AddTestCase(new CybertwinBootBarrierTest(CybertwinBootScheduler::LAYER_BARRIER),
+                    TestCase::QUICK);
+        AddTestCase(new CybertwinBootJitterTest(), TestCase::QUICK);
+        AddTestCase(new CybertwinBootReportTest(), TestCase::QUICK);
+    }
+};
+
+static CybertwinBootSchedulerTestSuite
+    g_cybertwinBootSchedulerTestSuite; //!< Static variable for test initialization
@@ -1,6 +1,15 @@
 
 // Include a header file from your module to test.
+#include "ns3/cybertwin-manager.h"
+#include "ns3/cybertwin-node.h"
+#include "ns3/cybertwin-snapshot.h"
 #include "ns3/cybertwin.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -45,6 +54,162 @@ CybertwinTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \ingroup cybertwin
+ * \ingroup tests
+ *
+ * \brief Start of the cybertwins created or restored during the simulation
+ *
+ * A cybertwin created at time t listens at its local port from t on. The
+ * snapshot of a network holding such a cybertwin, restored at another
+ * non-zero time, starts it again right away.
+ */
+class CybertwinRestoreStartTest : public TestCase
+{
+  public:
+    CybertwinRestoreStartTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Build a core server and an edge server below it, powered on
+     * \return the edge server
+     */
+    Ptr<CybertwinEdgeServer> BuildNetwork();
+
+    /**
+     * \brief Get the cybertwin manager of an edge server
+     * \param edge the edge server
+     * \return the manager
+     */
+    static Ptr<CybertwinManager> GetManager(Ptr<CybertwinEdgeServer> edge);
+
+    /**
+     * \brief Check that the local port of the cybertwin is in use
+     * \param edge the edge server of the cybertwin
+     */
+    void CheckListening(Ptr<CybertwinEdgeServer> edge);
+
+    /**
+     * \brief Restore the snapshot
+     */
+    void Restore();
+
+    std::string m_snapshot;                 //!< snapshot file
+    CYBERTWIN_INTERFACE_t m_local;          //!< local interface of the cybertwin
+    CYBERTWIN_INTERFACE_LIST_t m_global;    //!< global interfaces of the cybertwin
+    std::vector<Time> m_listening;          //!< times the local port was found in use
+    Time m_snapshotTime;                    //!< time returned by the restore
+};
+
+static const CYBERTWINID_t RESTORED_CUID = 1234; //!< cybertwin created and restored
+
+CybertwinRestoreStartTest::CybertwinRestoreStartTest()
+    : TestCase("Cybertwin created or restored during the run starts right away")
+{
+}
+
+Ptr<CybertwinEdgeServer>
+CybertwinRestoreStartTest::BuildNetwork()
+{
+    Ptr<CybertwinCoreServer> core = CreateObject<CybertwinCoreServer>();
+    core->SetName("core0");
+    core->SetLogDir(CreateTempDirFilename(""));
+    core->SetCNRSRoot();
+    Ptr<CybertwinEdgeServer> edge = CreateObject<CybertwinEdgeServer>();
+    edge->SetName("edge0");
+    edge->SetLogDir(CreateTempDirFilename(""));
+    edge->AddParent(core);
+
+    NodeContainer nodes;
+    nodes.Add(edge);
+    nodes.Add(core);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    SimpleNetDeviceHelper link;
+    link.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address;
+    address.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv4InterfaceContainer interfaces = address.Assign(link.Install(nodes));
+    edge->AddLocalIp(interfaces.GetAddress(0));
+    edge->AddGlobalIp(interfaces.GetAddress(0));
+
+    m_local = std::make_pair(interfaces.GetAddress(0), 10000);
+    m_global = {std::make_pair(interfaces.GetAddress(0), 20000)};
+
+    core->PowerOn();
+    edge->PowerOn();
+    return edge;
+}
+
+Ptr<CybertwinManager>
+CybertwinRestoreStartTest::GetManager(Ptr<CybertwinEdgeServer> edge)
+{
+    for (uint32_t i = 0; i < edge->GetNApplications(); i++)
+    {
+        Ptr<CybertwinManager> manager = DynamicCast<CybertwinManager>(edge->GetApplication(i));
+        if (manager)
+        {
+            return manager;
+        }
+    }
+    return nullptr;
+}
+
+void
+CybertwinRestoreStartTest::CheckListening(Ptr<CybertwinEdgeServer> edge)
+{
+    Ptr<Socket> socket = Socket::CreateSocket(edge, TypeId::LookupByName("ns3::TcpSocketFactory"));
+    if (socket->Bind(InetSocketAddress(m_local.first, m_local.second)) < 0)
+    {
+        m_listening.push_back(Simulator::Now());
+    }
+    socket->Close();
+}
+
+void
+CybertwinRestoreStartTest::Restore()
+{
+    m_snapshotTime = CybertwinSnapshot::Restore(m_snapshot);
+}
+
+void
+CybertwinRestoreStartTest::DoRun()
+{
+    m_snapshot = CreateTempDirFilename("snapshot.json");
+
+    // a cybertwin created at 1 s, as on the registration of its end host
+    Ptr<CybertwinEdgeServer> edge = BuildNetwork();
+    Simulator::Schedule(Seconds(1),
+                        &CybertwinManager::RestoreCybertwin,
+                        GetManager(edge),
+                        RESTORED_CUID,
+                        m_local,
+                        m_global);
+    Simulator::Schedule(Seconds(1.5), &CybertwinRestoreStartTest::CheckListening, this, edge);
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_listening.size(), 1, "Cybertwin created at 1 s not started at 1.5 s");
+    NS_TEST_ASSERT_MSG_EQ(CybertwinSnapshot::Save(m_snapshot), true, "Snapshot not saved");
+    Simulator::Destroy();
+
+    // the snapshot restored on a new network at 3 s
+    m_listening.clear();
+    edge = BuildNetwork();
+    Simulator::Schedule(Seconds(3), &CybertwinRestoreStartTest::Restore, this);
+    Simulator::Schedule(Seconds(3.5), &CybertwinRestoreStartTest::CheckListening, this, edge);
+    Simulator::Stop(Seconds(4));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_snapshotTime, Seconds(2), "Snapshot time");
+    NS_TEST_EXPECT_MSG_EQ(GetManager(edge)->GetCybertwinTable().count(RESTORED_CUID),
+                          1,
+                          "Cybertwin not restored");
+    NS_TEST_EXPECT_MSG_EQ(m_listening.size(), 1, "Cybertwin restored at 3 s not started at 3.5 s");
+    Simulator::Destroy();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -60,6 +225,7 @@ CybertwinTestSuite::CybertwinTestSuite()
 {
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new CybertwinTestCase1, TestCase::QUICK);
+    AddTestCase(new CybertwinRestoreStartTest, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
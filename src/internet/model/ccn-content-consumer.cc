@@ -1,4 +1,5 @@
 #include "ccn-content-consumer.h"
+#include "ccn-header.h"
 
 namespace ns3
 {
@@ -38,14 +39,30 @@ void
 CCNContentConsumer::SetCCNL4(Ptr<CCNL4Protocol> ccn_l4)
 {
     NS_LOG_FUNCTION(this << ccn_l4);
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->UnbindContentConsumer(this, m_content_name);
+    }
     m_ccnl4 = ccn_l4;
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->BindContentConsumer(this, m_content_name);
+    }
 }
 
 void
 CCNContentConsumer::SetContentName(std::string content_name)
 {
     NS_LOG_FUNCTION(this << content_name);
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->UnbindContentConsumer(this, m_content_name);
+    }
     m_content_name = content_name;
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->BindContentConsumer(this, m_content_name);
+    }
 }
 
 std::string
@@ -62,6 +79,13 @@ CCNContentConsumer::SetRecvCallback(Callback<void, Ptr<Packet>> callback)
     m_recvCb = callback;
 }
 
+void
+CCNContentConsumer::SetSegmentRecvCallback(Callback<void, Ptr<Packet>, const CCNHeader&> callback)
+{
+    NS_LOG_FUNCTION(this << &callback);
+    m_segmentRecvCb = callback;
+}
+
 void
 CCNContentConsumer::GetContent()
 {
@@ -72,19 +96,42 @@ CCNContentConsumer::GetContent()
     m_ccnl4->SendInterest(packet, m_content_name);
 }
 
+void
+CCNContentConsumer::GetSegment(uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << segment);
+    Ptr<Packet> packet = Create<Packet>();
+    m_ccnl4->SendInterest(packet, m_content_name, segment);
+}
+
+void
+CCNContentConsumer::GetSegment(const std::string& contentName, uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << contentName << segment);
+    Ptr<Packet> packet = Create<Packet>();
+    m_ccnl4->SendInterest(packet, contentName, segment);
+}
+
 void
 CCNContentConsumer::NotifyRecv(Ptr<Packet> packet)
 {
     NS_LOG_FUNCTION(this << packet);
-    if (m_recvCb.IsNull()) {
-        NS_LOG_WARN("No callback function set");
-        return;
-    }
 
     // remove the header
     CCNHeader ccnheader;
     packet->RemoveHeader(ccnheader);
 
+    if (ccnheader.GetSegment() != CCNHeader::NO_SEGMENT && !m_segmentRecvCb.IsNull())
+    {
+        m_segmentRecvCb(packet, ccnheader);
+        return;
+    }
+
+    if (m_recvCb.IsNull()) {
+        NS_LOG_WARN("No callback function set");
+        return;
+    }
+
     m_recvCb(packet);
 }
 
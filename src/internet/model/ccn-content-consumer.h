@@ -4,6 +4,7 @@
 #include "ns3/object.h"
 #include "ns3/node.h"
 #include "ccn-l4-protocol.h"
+#include "ccn-header.h"
 
 namespace ns3
 {
@@ -39,6 +40,12 @@ class CCNContentConsumer : public Object
          */
         void GetContent();
 
+        /**
+         * \brief Express an Interest for one segment of the content
+         * \param segment the segment number
+         */
+        void GetSegment(uint32_t segment);
+
         /**
          * \brief Set the content name
          */
@@ -54,6 +61,25 @@ class CCNContentConsumer : public Object
          */
         void SetRecvCallback(Callback<void, Ptr<Packet>> callback);
 
+        /**
+         * \brief Set Callback function to be called when a content segment is received
+         *
+         * The callback receives the payload and the CCN header of the Data,
+         * which carries the content name, the segment number, the final
+         * segment number and the hop count.
+         */
+        void SetSegmentRecvCallback(Callback<void, Ptr<Packet>, const CCNHeader&> callback);
+
+        /**
+         * \brief Express an Interest for a segment of a name below the content name
+         * \param contentName the requested name
+         * \param segment the segment number
+         *
+         * Data for names below the consumer content name are delivered to
+         * this consumer when no more specific consumer is registered.
+         */
+        void GetSegment(const std::string& contentName, uint32_t segment);
+
         /**
          * \brief Notify packet reception
          */
@@ -67,6 +93,7 @@ class CCNContentConsumer : public Object
 
         // callback functions
         Callback<void, Ptr<Packet>> m_recvCb;
+        Callback<void, Ptr<Packet>, const CCNHeader&> m_segmentRecvCb;
 };
 
 }
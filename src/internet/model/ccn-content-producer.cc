@@ -4,6 +4,9 @@
 #include "ccn-content-producer.h"
 #include "ccn-header.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 namespace ns3
 {
@@ -23,6 +26,9 @@ CCNContentProducer::GetTypeId()
 }
 
 CCNContentProducer::CCNContentProducer()
+    : m_segment_size(1024),
+      m_content_size(0),
+      m_content_loaded(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -45,7 +51,15 @@ void
 CCNContentProducer::SetCCNL4(Ptr<CCNL4Protocol> ccnl4)
 {
     NS_LOG_FUNCTION(this << ccnl4);
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->UnbindContentProducer(this, m_content_name);
+    }
     m_ccnl4 = ccnl4;
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->BindContentProducer(this, m_content_name);
+    }
 }
 
 std::string
@@ -59,7 +73,15 @@ void
 CCNContentProducer::SetContentName(std::string content_name)
 {
     NS_LOG_FUNCTION(this << content_name);
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->UnbindContentProducer(this, m_content_name);
+    }
     m_content_name = content_name;
+    if (m_ccnl4 && !m_content_name.empty())
+    {
+        m_ccnl4->BindContentProducer(this, m_content_name);
+    }
 }
 
 void
@@ -67,13 +89,105 @@ CCNContentProducer::SetContentFile(std::string content_file)
 {
     NS_LOG_FUNCTION(this << content_file);
     m_content_file = content_file;
+    m_content_loaded = false;
+}
+
+void
+CCNContentProducer::SetSegmentSize(uint32_t segment_size)
+{
+    NS_LOG_FUNCTION(this << segment_size);
+    NS_ASSERT_MSG(segment_size > 0, "Segment size must be positive");
+    m_segment_size = segment_size;
+}
+
+void
+CCNContentProducer::SetContentSize(uint64_t content_size)
+{
+    NS_LOG_FUNCTION(this << content_size);
+    m_content_size = content_size;
 }
 
 void
-CCNContentProducer::SendContentResponse(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr)
+CCNContentProducer::LoadContent()
+{
+    NS_LOG_FUNCTION(this);
+    m_content_loaded = true;
+    m_content.clear();
+
+    if (m_content_file.empty())
+    {
+        return;
+    }
+
+    std::ifstream file(m_content_file, std::ios::binary);
+    if (!file.is_open())
+    {
+        NS_LOG_DEBUG("Failed to open file " << m_content_file);
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    m_content = oss.str();
+    m_content_size = m_content.size();
+    NS_LOG_DEBUG("Loaded " << m_content_size << " bytes from " << m_content_file);
+}
+
+void
+CCNContentProducer::SendSegment(const std::string& name, uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << name << segment);
+
+    if (!m_content_loaded)
+    {
+        LoadContent();
+    }
+
+    if (m_content_size == 0)
+    {
+        NS_LOG_DEBUG("No content to serve for " << m_content_name);
+        return;
+    }
+
+    uint64_t numSegments = (m_content_size + m_segment_size - 1) / m_segment_size;
+    NS_ASSERT_MSG(numSegments < CCNHeader::NO_SEGMENT, "Content has too many segments");
+    uint32_t finalSegment = static_cast<uint32_t>(numSegments - 1);
+    if (segment > finalSegment)
+    {
+        NS_LOG_DEBUG("Segment " << segment << " beyond final segment " << finalSegment);
+        return;
+    }
+
+    uint64_t offset = static_cast<uint64_t>(segment) * m_segment_size;
+    uint32_t size = static_cast<uint32_t>(std::min<uint64_t>(m_segment_size, m_content_size - offset));
+
+    Ptr<Packet> contentPacket;
+    if (m_content.empty())
+    {
+        // synthetic content, zero-filled payload
+        contentPacket = Create<Packet>(size);
+    }
+    else
+    {
+        contentPacket = Create<Packet>((const uint8_t*)m_content.data() + offset, size);
+    }
+
+    m_ccnl4->SendData(contentPacket, name, segment, finalSegment);
+}
+
+void
+CCNContentProducer::SendContentResponse(Ptr<Packet> packet, const Address& saddr, const Address& daddr)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr);
 
+    CCNHeader ccnheader;
+    packet->PeekHeader(ccnheader);
+    if (ccnheader.GetSegment() != CCNHeader::NO_SEGMENT)
+    {
+        SendSegment(ccnheader.GetContentName(), ccnheader.GetSegment());
+        return;
+    }
+
     // read content from file and send it in the packet
     std::ifstream file(m_content_file, std::ios::binary);
 
@@ -91,7 +205,7 @@ CCNContentProducer::SendContentResponse(Ptr<Packet> packet, Ipv4Address saddr, I
         Ptr<Packet> contentPacket = Create<Packet>((uint8_t*)buffer, file.gcount());
         
         NS_LOG_DEBUG("Sending content packet");
-        m_ccnl4->SendData(contentPacket, m_content_name);
+        m_ccnl4->SendData(contentPacket, ccnheader.GetContentName());
     }
 }
 
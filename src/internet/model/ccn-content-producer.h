@@ -32,7 +32,7 @@ class CCNContentProducer : public Object
          * \brief Send Content Response
          * \param packet the packet to send
          */
-        void SendContentResponse(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr);
+        void SendContentResponse(Ptr<Packet> packet, const Address& saddr, const Address& daddr);
 
         /**
          * \brief Set the node
@@ -51,6 +51,9 @@ class CCNContentProducer : public Object
 
         /**
          * \brief Set the content name
+         *
+         * The producer serves Interests for this name and, when no more
+         * specific producer is registered, for any name below it.
          */
         void SetContentName(std::string content_name);
 
@@ -59,11 +62,41 @@ class CCNContentProducer : public Object
          */
         void SetContentFile(std::string content_file);
 
+        /**
+         * \brief Set the payload size of each Data segment
+         */
+        void SetSegmentSize(uint32_t segment_size);
+
+        /**
+         * \brief Set the size of a synthetic content
+         *
+         * When no content file is configured, segmented requests are served
+         * with zero-filled payloads covering content_size bytes.
+         */
+        void SetContentSize(uint64_t content_size);
+
     private:
+        /**
+         * \brief Answer an Interest for one segment of the content
+         * \param name the name carried by the Interest
+         * \param segment the requested segment
+         */
+        void SendSegment(const std::string& name, uint32_t segment);
+
+        /**
+         * \brief Load the content file into memory on first use
+         */
+        void LoadContent();
+
         Ptr<Node> m_node;
         std::string m_content_name;
         std::string m_content_file;
 
+        uint32_t m_segment_size;
+        uint64_t m_content_size;
+        bool m_content_loaded;
+        std::string m_content;  // cached file content
+
         Ptr<CCNL4Protocol> m_ccnl4;
 };
 
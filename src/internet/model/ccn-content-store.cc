@@ -0,0 +1,224 @@
+#include "ccn-content-store.h"
+
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CCNContentStore");
+
+NS_OBJECT_ENSURE_REGISTERED(CCNContentStore);
+
+TypeId
+CCNContentStore::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CCNContentStore")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<CCNContentStore>()
+            .AddAttribute("MaxSize",
+                          "Maximum number of cached segments, 0 disables caching",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&CCNContentStore::SetMaxSize,
+                                               &CCNContentStore::GetMaxSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Policy",
+                          "Replacement policy",
+                          EnumValue(CCNContentStore::LRU),
+                          MakeEnumAccessor(&CCNContentStore::SetPolicy,
+                                           &CCNContentStore::GetPolicy),
+                          MakeEnumChecker(CCNContentStore::LRU,
+                                          "LRU",
+                                          CCNContentStore::LFU,
+                                          "LFU",
+                                          CCNContentStore::FIFO,
+                                          "FIFO"));
+    return tid;
+}
+
+CCNContentStore::CCNContentStore()
+    : m_maxSize(0),
+      m_policy(LRU),
+      m_size(0),
+      m_hits(0),
+      m_misses(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CCNContentStore::~CCNContentStore()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CCNContentStore::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    Object::DoDispose();
+}
+
+bool
+CCNContentStore::Lookup(const std::string& name,
+                        uint32_t segment,
+                        Ptr<Packet>& payload,
+                        uint32_t& finalSegment)
+{
+    NS_LOG_FUNCTION(this << name << segment);
+
+    if (m_maxSize == 0)
+    {
+        return false;
+    }
+
+    auto it = m_index.find(CCNNameKey{name, segment});
+    if (it == m_index.end())
+    {
+        m_misses++;
+        return false;
+    }
+
+    m_hits++;
+    Position& pos = it->second;
+    payload = pos.element->payload->Copy();
+    finalSegment = pos.element->finalSegment;
+
+    if (m_policy == LRU)
+    {
+        Bucket& bucket = m_buckets[pos.frequency];
+        bucket.splice(bucket.begin(), bucket, pos.element);
+    }
+    else if (m_policy == LFU)
+    {
+        auto from = m_buckets.find(pos.frequency);
+        Bucket& to = m_buckets[pos.frequency + 1];
+        to.splice(to.begin(), from->second, pos.element);
+        if (from->second.empty())
+        {
+            m_buckets.erase(from);
+        }
+        pos.frequency++;
+    }
+
+    return true;
+}
+
+void
+CCNContentStore::Insert(const std::string& name,
+                        uint32_t segment,
+                        Ptr<const Packet> payload,
+                        uint32_t finalSegment)
+{
+    NS_LOG_FUNCTION(this << name << segment);
+
+    if (m_maxSize == 0)
+    {
+        return;
+    }
+
+    CCNNameKey key{name, segment};
+    if (m_index.find(key) != m_index.end())
+    {
+        return;
+    }
+
+    if (m_size >= m_maxSize)
+    {
+        Evict();
+    }
+
+    // new entries start in the lowest bucket, like a first use
+    Bucket& bucket = m_buckets[0];
+    bucket.push_front(Entry{key, payload, finalSegment});
+    m_index.emplace(key, Position{0, bucket.begin()});
+    m_size++;
+}
+
+void
+CCNContentStore::Evict()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_buckets.empty());
+
+    auto lowest = m_buckets.begin();
+    Bucket& bucket = lowest->second;
+    NS_LOG_DEBUG("Evicting " << bucket.back().key.name << " segment " << bucket.back().key.segment);
+    m_index.erase(bucket.back().key);
+    bucket.pop_back();
+    if (bucket.empty())
+    {
+        m_buckets.erase(lowest);
+    }
+    m_size--;
+}
+
+void
+CCNContentStore::SetMaxSize(uint32_t maxSize)
+{
+    NS_LOG_FUNCTION(this << maxSize);
+    m_maxSize = maxSize;
+    while (m_size > m_maxSize)
+    {
+        Evict();
+    }
+}
+
+uint32_t
+CCNContentStore::GetMaxSize() const
+{
+    return m_maxSize;
+}
+
+void
+CCNContentStore::SetPolicy(Policy policy)
+{
+    NS_LOG_FUNCTION(this << policy);
+    NS_ASSERT_MSG(m_size == 0, "Cannot change the policy of a non-empty content store");
+    m_policy = policy;
+}
+
+CCNContentStore::Policy
+CCNContentStore::GetPolicy() const
+{
+    return m_policy;
+}
+
+uint32_t
+CCNContentStore::GetSize() const
+{
+    return m_size;
+}
+
+uint64_t
+CCNContentStore::GetHits() const
+{
+    return m_hits;
+}
+
+uint64_t
+CCNContentStore::GetMisses() const
+{
+    return m_misses;
+}
+
+void
+CCNContentStore::ResetStatistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void
+CCNContentStore::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_index.clear();
+    m_buckets.clear();
+    m_size = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+#ifndef _CCN_CONTENT_STORE_H_
+#define _CCN_CONTENT_STORE_H_
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ccn
+ * \brief Identifies one segment of a named content
+ */
+struct CCNNameKey
+{
+    std::string name; //!< content name
+    uint32_t segment; //!< segment number
+
+    /**
+     * \brief Equality operator
+     * \param other key to compare with
+     * \return true if both keys designate the same segment
+     */
+    bool operator==(const CCNNameKey& other) const
+    {
+        return segment == other.segment && name == other.name;
+    }
+};
+
+/**
+ * \ingroup ccn
+ * \brief Hash functor for CCNNameKey
+ */
+struct CCNNameKeyHash
+{
+    /**
+     * \param key the key to hash
+     * \return the hash value
+     */
+    size_t operator()(const CCNNameKey& key) const
+    {
+        return std::hash<std::string>()(key.name) ^ (std::hash<uint32_t>()(key.segment) << 1);
+    }
+};
+
+/**
+ * \ingroup ccn
+ * \brief Bounded cache of Data segments held by a CCN node
+ *
+ * Entries are kept in per-frequency buckets ordered from least to most
+ * used. With the LRU policy a hit moves the entry to the front of its
+ * bucket, with FIFO hits do not reorder entries and with LFU a hit
+ * promotes the entry to the next frequency bucket. The victim is always
+ * the last entry of the lowest bucket, so every operation is O(1) for
+ * LRU/FIFO and O(log F) for LFU with F distinct frequencies.
+ */
+class CCNContentStore : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /// Replacement policy
+    enum Policy
+    {
+        LRU,
+        LFU,
+        FIFO
+    };
+
+    CCNContentStore();
+    ~CCNContentStore() override;
+
+    /**
+     * \brief Look up a cached segment
+     * \param name the content name
+     * \param segment the segment number
+     * \param payload receives a copy of the cached payload on hit
+     * \param finalSegment receives the final segment number on hit
+     * \return true on cache hit
+     */
+    bool Lookup(const std::string& name,
+                uint32_t segment,
+                Ptr<Packet>& payload,
+                uint32_t& finalSegment);
+
+    /**
+     * \brief Cache a segment, evicting according to the policy if full
+     * \param name the content name
+     * \param segment the segment number
+     * \param payload the Data payload, without CCN header
+     * \param finalSegment the final segment number of the content
+     */
+    void Insert(const std::string& name,
+                uint32_t segment,
+                Ptr<const Packet> payload,
+                uint32_t finalSegment);
+
+    /**
+     * \brief Set the capacity in segments, 0 disables caching
+     */
+    void SetMaxSize(uint32_t maxSize);
+
+    /**
+     * \brief Get the capacity in segments
+     */
+    uint32_t GetMaxSize() const;
+
+    /**
+     * \brief Set the replacement policy, the store must be empty
+     */
+    void SetPolicy(Policy policy);
+
+    /**
+     * \brief Get the replacement policy
+     */
+    Policy GetPolicy() const;
+
+    /**
+     * \brief Number of cached segments
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \brief Number of lookups answered from the store
+     */
+    uint64_t GetHits() const;
+
+    /**
+     * \brief Number of lookups that missed
+     */
+    uint64_t GetMisses() const;
+
+    /**
+     * \brief Reset the hit and miss counters
+     */
+    void ResetStatistics();
+
+    /**
+     * \brief Remove every cached segment
+     */
+    void Clear();
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Cached segment
+    struct Entry
+    {
+        CCNNameKey key;            //!< content name and segment
+        Ptr<const Packet> payload; //!< cached payload
+        uint32_t finalSegment;     //!< final segment of the content
+    };
+
+    typedef std::list<Entry> Bucket; //!< entries of one frequency, most recent first
+
+    /// Position of an entry
+    struct Position
+    {
+        uint64_t frequency;       //!< bucket holding the entry
+        Bucket::iterator element; //!< entry in the bucket
+    };
+
+    /**
+     * \brief Evict the entry chosen by the replacement policy
+     */
+    void Evict();
+
+    uint32_t m_maxSize;
+    Policy m_policy;
+    uint32_t m_size;
+    std::map<uint64_t, Bucket> m_buckets;
+    std::unordered_map<CCNNameKey, Position, CCNNameKeyHash> m_index;
+
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
+
+} // namespace ns3
+
+#endif /* _CCN_CONTENT_STORE_H_ */
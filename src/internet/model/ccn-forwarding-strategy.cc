@@ -0,0 +1,253 @@
+#include "ccn-forwarding-strategy.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CCNForwardingStrategy");
+
+NS_OBJECT_ENSURE_REGISTERED(CCNForwardingStrategy);
+NS_OBJECT_ENSURE_REGISTERED(CCNBestRouteStrategy);
+NS_OBJECT_ENSURE_REGISTERED(CCNMulticastStrategy);
+NS_OBJECT_ENSURE_REGISTERED(CCNAdaptiveStrategy);
+
+TypeId
+CCNForwardingStrategy::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CCNForwardingStrategy").SetParent<Object>().SetGroupName("Internet");
+    return tid;
+}
+
+CCNForwardingStrategy::CCNForwardingStrategy()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CCNForwardingStrategy::~CCNForwardingStrategy()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CCNForwardingStrategy::NotifyData(const Address& face, Time rtt)
+{
+    NS_LOG_FUNCTION(this << face << rtt);
+}
+
+void
+CCNForwardingStrategy::NotifyTimeout(const Address& face)
+{
+    NS_LOG_FUNCTION(this << face);
+}
+
+Time
+CCNForwardingStrategy::GetRetransmissionTimeout(const Address& face) const
+{
+    return Time::Max();
+}
+
+//-----------------------------------------------------------------------------
+
+TypeId
+CCNBestRouteStrategy::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::CCNBestRouteStrategy")
+                            .SetParent<CCNForwardingStrategy>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<CCNBestRouteStrategy>();
+    return tid;
+}
+
+std::vector<Address>
+CCNBestRouteStrategy::SelectFaces(const std::string& contentName,
+                                  const std::vector<CCNFibNextHop>& nextHops,
+                                  const Address& inFace)
+{
+    NS_LOG_FUNCTION(this << contentName << inFace);
+    for (const auto& nextHop : nextHops)
+    {
+        if (nextHop.face != inFace)
+        {
+            return {nextHop.face};
+        }
+    }
+    return {};
+}
+
+std::string
+CCNBestRouteStrategy::GetName() const
+{
+    return "BestRoute";
+}
+
+//-----------------------------------------------------------------------------
+
+TypeId
+CCNMulticastStrategy::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::CCNMulticastStrategy")
+                            .SetParent<CCNForwardingStrategy>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<CCNMulticastStrategy>();
+    return tid;
+}
+
+std::vector<Address>
+CCNMulticastStrategy::SelectFaces(const std::string& contentName,
+                                  const std::vector<CCNFibNextHop>& nextHops,
+                                  const Address& inFace)
+{
+    NS_LOG_FUNCTION(this << contentName << inFace);
+    std::vector<Address> faces;
+    for (const auto& nextHop : nextHops)
+    {
+        if (nextHop.face != inFace)
+        {
+            faces.push_back(nextHop.face);
+        }
+    }
+    return faces;
+}
+
+std::string
+CCNMulticastStrategy::GetName() const
+{
+    return "Multicast";
+}
+
+//-----------------------------------------------------------------------------
+
+TypeId
+CCNAdaptiveStrategy::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CCNAdaptiveStrategy")
+            .SetParent<CCNForwardingStrategy>()
+            .SetGroupName("Internet")
+            .AddConstructor<CCNAdaptiveStrategy>()
+            .AddAttribute("Gain",
+                          "EWMA gain applied to RTT samples",
+                          DoubleValue(0.125),
+                          MakeDoubleAccessor(&CCNAdaptiveStrategy::m_gain),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("InitialRtt",
+                          "RTT assumed for faces not measured yet",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&CCNAdaptiveStrategy::m_initialRtt),
+                          MakeTimeChecker())
+            .AddAttribute("TimeoutPenalty",
+                          "Factor applied to the SRTT of a face that timed out",
+                          DoubleValue(2.0),
+                          MakeDoubleAccessor(&CCNAdaptiveStrategy::m_timeoutPenalty),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("MaxRtt",
+                          "Upper bound of the SRTT, keeps penalized faces probed",
+                          TimeValue(Seconds(10)),
+                          MakeTimeAccessor(&CCNAdaptiveStrategy::m_maxRtt),
+                          MakeTimeChecker());
+    return tid;
+}
+
+CCNAdaptiveStrategy::CCNAdaptiveStrategy()
+{
+    NS_LOG_FUNCTION(this);
+    m_random = CreateObject<UniformRandomVariable>();
+}
+
+CCNAdaptiveStrategy::~CCNAdaptiveStrategy()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+int64_t
+CCNAdaptiveStrategy::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_random->SetStream(stream);
+    return 1;
+}
+
+Time
+CCNAdaptiveStrategy::GetSrtt(const Address& face) const
+{
+    auto it = m_srtt.find(face);
+    return it != m_srtt.end() ? Seconds(it->second) : m_initialRtt;
+}
+
+std::vector<Address>
+CCNAdaptiveStrategy::SelectFaces(const std::string& contentName,
+                                 const std::vector<CCNFibNextHop>& nextHops,
+                                 const Address& inFace)
+{
+    NS_LOG_FUNCTION(this << contentName << inFace);
+
+    std::vector<std::pair<Address, double>> weights;
+    double total = 0.0;
+    for (const auto& nextHop : nextHops)
+    {
+        if (nextHop.face == inFace)
+        {
+            continue;
+        }
+        double srtt = std::max(GetSrtt(nextHop.face).GetSeconds(), 1e-6);
+        weights.emplace_back(nextHop.face, 1.0 / srtt);
+        total += 1.0 / srtt;
+    }
+
+    if (weights.empty())
+    {
+        return {};
+    }
+
+    double u = m_random->GetValue(0.0, total);
+    for (const auto& weight : weights)
+    {
+        if (u < weight.second)
+        {
+            return {weight.first};
+        }
+        u -= weight.second;
+    }
+    return {weights.back().first};
+}
+
+void
+CCNAdaptiveStrategy::NotifyData(const Address& face, Time rtt)
+{
+    NS_LOG_FUNCTION(this << face << rtt);
+    auto it = m_srtt.find(face);
+    if (it == m_srtt.end())
+    {
+        m_srtt[face] = rtt.GetSeconds();
+        return;
+    }
+    it->second += m_gain * (rtt.GetSeconds() - it->second);
+}
+
+void
+CCNAdaptiveStrategy::NotifyTimeout(const Address& face)
+{
+    NS_LOG_FUNCTION(this << face);
+    double srtt = GetSrtt(face).GetSeconds() * m_timeoutPenalty;
+    m_srtt[face] = std::min(srtt, m_maxRtt.GetSeconds());
+    NS_LOG_DEBUG("Face " << face << " timed out, SRTT now " << m_srtt[face] << " s");
+}
+
+Time
+CCNAdaptiveStrategy::GetRetransmissionTimeout(const Address& face) const
+{
+    return 2 * GetSrtt(face);
+}
+
+std::string
+CCNAdaptiveStrategy::GetName() const
+{
+    return "Adaptive";
+}
+
+} // namespace ns3
@@ -0,0 +1,191 @@
+#ifndef _CCN_FORWARDING_STRATEGY_H_
+#define _CCN_FORWARDING_STRATEGY_H_
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ccn
+ * \brief Next hop of a CCN forwarding table entry
+ */
+struct CCNFibNextHop
+{
+    Address face;  //!< IPv4 or IPv6 address of the neighbor
+    uint32_t cost; //!< routing cost, lower is better
+};
+
+/**
+ * \ingroup ccn
+ * \brief Decides which faces an Interest is forwarded to
+ *
+ * A strategy is attached to a name prefix of a CCNL4Protocol. For every
+ * Interest that cannot be answered locally the protocol hands it the FIB
+ * next hops of the name, sorted by cost, and forwards the Interest to the
+ * faces returned. The protocol reports the RTT of every Data received in
+ * answer to a forwarded Interest and the faces that failed to answer
+ * before the Interest was retransmitted.
+ */
+class CCNForwardingStrategy : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CCNForwardingStrategy();
+    ~CCNForwardingStrategy() override;
+
+    /**
+     * \brief Select the faces an Interest is forwarded to
+     * \param contentName the requested name
+     * \param nextHops the FIB next hops, sorted by cost
+     * \param inFace the face the Interest was received from
+     * \return the faces to forward to, empty to drop the Interest
+     */
+    virtual std::vector<Address> SelectFaces(const std::string& contentName,
+                                             const std::vector<CCNFibNextHop>& nextHops,
+                                             const Address& inFace) = 0;
+
+    /**
+     * \brief A face answered a forwarded Interest
+     * \param face the upstream face
+     * \param rtt the time between forwarding the Interest and the Data
+     */
+    virtual void NotifyData(const Address& face, Time rtt);
+
+    /**
+     * \brief A face did not answer a forwarded Interest in time
+     * \param face the upstream face
+     */
+    virtual void NotifyTimeout(const Address& face);
+
+    /**
+     * \brief Time a face is given to answer a forwarded Interest
+     *
+     * A retransmitted Interest is forwarded again, and the faces notified
+     * with NotifyTimeout(), only once their Interest is older than this
+     * or than the PIT lifetime.
+     *
+     * \param face the upstream face
+     * \return the timeout, Time::Max() to rely on the PIT lifetime only
+     */
+    virtual Time GetRetransmissionTimeout(const Address& face) const;
+
+    /**
+     * \brief Get the name of the strategy
+     */
+    virtual std::string GetName() const = 0;
+};
+
+/**
+ * \ingroup ccn
+ * \brief Forward to the lowest cost next hop only
+ */
+class CCNBestRouteStrategy : public CCNForwardingStrategy
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    std::vector<Address> SelectFaces(const std::string& contentName,
+                                     const std::vector<CCNFibNextHop>& nextHops,
+                                     const Address& inFace) override;
+    std::string GetName() const override;
+};
+
+/**
+ * \ingroup ccn
+ * \brief Forward to every next hop
+ */
+class CCNMulticastStrategy : public CCNForwardingStrategy
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    std::vector<Address> SelectFaces(const std::string& contentName,
+                                     const std::vector<CCNFibNextHop>& nextHops,
+                                     const Address& inFace) override;
+    std::string GetName() const override;
+};
+
+/**
+ * \ingroup ccn
+ * \brief Spread Interests over the next hops according to measured RTT
+ *
+ * Each face keeps a smoothed RTT updated from the Data it returns. An
+ * Interest goes to a single face drawn with probability proportional to
+ * 1/SRTT, so parallel paths share the load in proportion to their speed.
+ * Queueing on a congested path raises its SRTT and shifts traffic away,
+ * and a timeout multiplies the SRTT of the face by TimeoutPenalty. A face
+ * is given twice its SRTT to answer before a retransmission counts as a
+ * timeout.
+ * Faces not measured yet start at InitialRtt.
+ */
+class CCNAdaptiveStrategy : public CCNForwardingStrategy
+{
+  public:
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CCNAdaptiveStrategy();
+    ~CCNAdaptiveStrategy() override;
+
+    std::vector<Address> SelectFaces(const std::string& contentName,
+                                     const std::vector<CCNFibNextHop>& nextHops,
+                                     const Address& inFace) override;
+    void NotifyData(const Address& face, Time rtt) override;
+    void NotifyTimeout(const Address& face) override;
+    Time GetRetransmissionTimeout(const Address& face) const override;
+    std::string GetName() const override;
+
+    /**
+     * \brief Get the smoothed RTT of a face
+     * \param face the face
+     * \return the SRTT, InitialRtt if the face has not been measured
+     */
+    Time GetSrtt(const Address& face) const;
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  private:
+    double m_gain;           //!< EWMA gain of the SRTT
+    Time m_initialRtt;       //!< SRTT of unmeasured faces
+    double m_timeoutPenalty; //!< SRTT factor applied on timeout
+    Time m_maxRtt;           //!< upper bound of the SRTT
+
+    std::map<Address, double> m_srtt;    //!< SRTT per face, in seconds
+    Ptr<UniformRandomVariable> m_random; //!< face selection
+};
+
+} // namespace ns3
+
+#endif /* _CCN_FORWARDING_STRATEGY_H_ */
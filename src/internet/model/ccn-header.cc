@@ -6,6 +6,10 @@ NS_OBJECT_ENSURE_REGISTERED(CCNHeader);
 
 CCNHeader::CCNHeader()
     : m_content_name(""),
+      m_type(INTEREST),
+      m_segment(NO_SEGMENT),
+      m_finalSegment(NO_SEGMENT),
+      m_hopCount(0),
       m_selector(0),
       m_nonce(0)
 {
@@ -42,6 +46,42 @@ CCNHeader::GetMessageType() const
     return m_type;
 }
 
+void
+CCNHeader::SetSegment(uint32_t segment)
+{
+    m_segment = segment;
+}
+
+uint32_t
+CCNHeader::GetSegment() const
+{
+    return m_segment;
+}
+
+void
+CCNHeader::SetFinalSegment(uint32_t finalSegment)
+{
+    m_finalSegment = finalSegment;
+}
+
+uint32_t
+CCNHeader::GetFinalSegment() const
+{
+    return m_finalSegment;
+}
+
+void
+CCNHeader::SetHopCount(uint8_t hopCount)
+{
+    m_hopCount = hopCount;
+}
+
+uint8_t
+CCNHeader::GetHopCount() const
+{
+    return m_hopCount;
+}
+
 TypeId
 CCNHeader::GetTypeId()
 {
@@ -71,14 +111,19 @@ CCNHeader::Print(std::ostream& os) const
         os << "Type: Data" << std::endl;
     }
     os << "Content Name: " << m_content_name << std::endl;
+    if (m_segment != NO_SEGMENT)
+    {
+        os << "Segment: " << m_segment << "/" << m_finalSegment << std::endl;
+    }
+    os << "Hops: " << (uint32_t)m_hopCount << std::endl;
     os << "-------------------------" << std::endl;
 }
 
 uint32_t
 CCNHeader::GetSerializedSize() const
 {
-    // content name + packet type
-    return m_name_length + m_type_length;
+    // content name + packet type + segment numbers + hop count
+    return m_name_length + m_type_length + m_segment_length + m_hop_length;
 }
 
 void
@@ -98,20 +143,34 @@ CCNHeader::Serialize(Buffer::Iterator start) const
     }
 
     start.WriteU8(m_type);
+    start.WriteHtonU32(m_segment);
+    start.WriteHtonU32(m_finalSegment);
+    start.WriteU8(m_hopCount);
 }
 
 uint32_t
 CCNHeader::Deserialize(Buffer::Iterator start)
 {
     // deserialize the content name and the packet type
+    m_content_name.clear();
     for (uint32_t i = 0; i < m_name_length; i++)
     {
         m_content_name += start.ReadU8();
     }
 
+    // names shorter than the field are padded with null characters
+    std::string::size_type end = m_content_name.find('\0');
+    if (end != std::string::npos)
+    {
+        m_content_name.erase(end);
+    }
+
     m_type = start.ReadU8();
+    m_segment = start.ReadNtohU32();
+    m_finalSegment = start.ReadNtohU32();
+    m_hopCount = start.ReadU8();
 
-    return m_name_length + m_type_length;
+    return GetSerializedSize();
 }
 
 
@@ -26,6 +26,14 @@ class CCNHeader : public Header
 
         static const uint32_t m_name_length = 20;
         static const uint32_t m_type_length = 1;
+        static const uint32_t m_segment_length = 8;
+        static const uint32_t m_hop_length = 1;
+
+        /**
+         * Segment number carried by Interests/Data that address a whole
+         * content object rather than one of its segments.
+         */
+        static const uint32_t NO_SEGMENT = 0xFFFFFFFF;
 
         enum MessageType
         {
@@ -55,6 +63,40 @@ class CCNHeader : public Header
          */
         std::string GetContentName() const;
 
+        /**
+         * \brief Set the segment number
+         * \param segment the segment number, or NO_SEGMENT for the whole content
+         */
+        void SetSegment(uint32_t segment);
+
+        /**
+         * \brief Get the segment number
+         */
+        uint32_t GetSegment() const;
+
+        /**
+         * \brief Set the number of the last segment of the content (Data only)
+         */
+        void SetFinalSegment(uint32_t finalSegment);
+
+        /**
+         * \brief Get the number of the last segment of the content
+         */
+        uint32_t GetFinalSegment() const;
+
+        /**
+         * \brief Set the hop count
+         *
+         * Interests count the CCN hops they traversed; Data carry the hop
+         * count of the Interest at the node that satisfied it.
+         */
+        void SetHopCount(uint8_t hopCount);
+
+        /**
+         * \brief Get the hop count
+         */
+        uint8_t GetHopCount() const;
+
         static TypeId GetTypeId();
         TypeId GetInstanceTypeId() const override;
         void Print(std::ostream& os) const override;
@@ -65,6 +107,9 @@ class CCNHeader : public Header
     private:
         std::string m_content_name;
         uint8_t m_type;     // 0: Interest, 1: Data
+        uint32_t m_segment;         // segment number, NO_SEGMENT if unsegmented
+        uint32_t m_finalSegment;    // last segment number of the content
+        uint8_t m_hopCount;         // CCN hops traversed by the Interest
         uint16_t m_selector;
         uint16_t m_nonce;
 };
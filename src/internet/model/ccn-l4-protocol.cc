@@ -21,6 +21,9 @@
 #include "ccn-header.h"
 
 #include "ipv4-l3-protocol.h"
+#include "ipv6-l3-protocol.h"
+#include "ipv6-route.h"
+#include "ipv6-routing-protocol.h"
 
 #include "ns3/assert.h"
 #include "ns3/boolean.h"
@@ -29,6 +32,11 @@
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
 
 namespace ns3
 {
@@ -46,13 +54,66 @@ CCNL4Protocol::GetTypeId()
     static TypeId tid = TypeId("ns3::CCNL4Protocol")
                             .SetParent<IpL4Protocol>()
                             .SetGroupName("Internet")
-                            .AddConstructor<CCNL4Protocol>();
+                            .AddConstructor<CCNL4Protocol>()
+                            .AddAttribute("HopByHop",
+                                          "Process Interests and Data at every CCN hop",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&CCNL4Protocol::m_hopByHop),
+                                          MakeBooleanChecker())
+                            .AddAttribute("PitLifetime",
+                                          "Lifetime of pending Interest table entries",
+                                          TimeValue(Seconds(1.0)),
+                                          MakeTimeAccessor(&CCNL4Protocol::m_pitLifetime),
+                                          MakeTimeChecker())
+                            .AddAttribute("ContentStore",
+                                          "The content store caching Data in hop-by-hop mode",
+                                          PointerValue(),
+                                          MakePointerAccessor(&CCNL4Protocol::m_contentStore),
+                                          MakePointerChecker<CCNContentStore>())
+                            .AddAttribute("DefaultStrategy",
+                                          "Forwarding strategy of names without a prefix strategy",
+                                          PointerValue(),
+                                          MakePointerAccessor(&CCNL4Protocol::m_defaultStrategy),
+                                          MakePointerChecker<CCNForwardingStrategy>())
+                            .AddAttribute("MaxHops",
+                                          "Interests that travelled this many hops are dropped",
+                                          UintegerValue(32),
+                                          MakeUintegerAccessor(&CCNL4Protocol::m_maxHops),
+                                          MakeUintegerChecker<uint8_t>(1));
     return tid;
 }
 
+/*
+ * Find the entry of a name table matching the longest prefix of a content
+ * name, trying the whole name first and then every '/' boundary.
+ */
+template <typename Table>
+static typename Table::const_iterator
+LongestPrefixMatch(const Table& table, const std::string& contentName)
+{
+    if (table.empty())
+    {
+        return table.end();
+    }
+
+    auto it = table.find(contentName);
+    std::string::size_type end = contentName.rfind('/');
+    while (it == table.end() && end != std::string::npos && end != 0)
+    {
+        it = table.find(contentName.substr(0, end));
+        end = contentName.rfind('/', end - 1);
+    }
+    return it;
+}
+
 CCNL4Protocol::CCNL4Protocol()
+    : m_hopByHop(false),
+      m_pitInsertions(0),
+      m_maxHops(32)
 {
     NS_LOG_FUNCTION(this);
+    m_contentStore = CreateObject<CCNContentStore>();
+    m_defaultStrategy = CreateObject<CCNBestRouteStrategy>();
 }
 
 CCNL4Protocol::~CCNL4Protocol()
@@ -78,6 +139,7 @@ CCNL4Protocol::NotifyNewAggregate()
     Ptr<Node> node = this->GetObject<Node>();
     NS_ASSERT_MSG(node, "Node not found");
     Ptr<Ipv4> ipv4 = this->GetObject<Ipv4>();
+    Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
 
     if (!m_node)
     {
@@ -94,6 +156,11 @@ CCNL4Protocol::NotifyNewAggregate()
         ipv4->Insert(this);
         this->SetDownTarget(MakeCallback(&Ipv4::Send, ipv4));
     }
+    if (ipv6 && m_downTarget6.IsNull())
+    {
+        ipv6->Insert(this);
+        this->SetDownTarget6(MakeCallback(&Ipv6::Send, ipv6));
+    }
 
     IpL4Protocol::NotifyNewAggregate();
 }
@@ -119,8 +186,22 @@ CCNL4Protocol::DoDispose()
         (*it)->Dispose();
     }
 
+    m_contentConsumers.clear();
+    m_contentProducers.clear();
+    m_consumerTable.clear();
+    m_producerTable.clear();
+    m_pit.clear();
+    m_fib.clear();
+    m_strategyTable.clear();
+    m_defaultStrategy = nullptr;
+    if (m_contentStore)
+    {
+        m_contentStore->Dispose();
+        m_contentStore = nullptr;
+    }
     m_node = nullptr;
     m_downTarget.Nullify();
+    m_downTarget6.Nullify();
     IpL4Protocol::DoDispose();
 }
 
@@ -161,12 +242,26 @@ CCNL4Protocol::Receive(Ptr<Packet> packet, const Ipv4Header& header, Ptr<Ipv4Int
     {
         // received a content request
         NS_LOG_DEBUG("Received a content request");
-        HandleInterestPacket(packet, header.GetSource(), header.GetDestination());
+        if (m_hopByHop)
+        {
+            ProcessInterest(packet, header.GetSource());
+        }
+        else
+        {
+            HandleInterestPacket(packet, header.GetSource(), header.GetDestination());
+        }
     }
     else if (ccnheader.GetMessageType() == CCNHeader::DATA)
     {
         NS_LOG_DEBUG("Received a content response");
-        HandleDataPacket(packet, header.GetSource(), header.GetDestination());
+        if (m_hopByHop)
+        {
+            ProcessData(packet, header.GetSource());
+        }
+        else
+        {
+            HandleDataPacket(packet, header.GetSource(), header.GetDestination());
+        }
     }
     else
     {
@@ -180,7 +275,39 @@ enum IpL4Protocol::RxStatus
 CCNL4Protocol::Receive(Ptr<Packet> packet, const Ipv6Header& header, Ptr<Ipv6Interface> incomingInterface)
 {
     NS_LOG_FUNCTION(this << packet << header);
-    NS_LOG_DEBUG("Not implemented");
+
+    CCNHeader ccnheader;
+    packet->PeekHeader(ccnheader);
+
+    if (ccnheader.GetMessageType() == CCNHeader::INTEREST)
+    {
+        NS_LOG_DEBUG("Received a content request");
+        if (m_hopByHop)
+        {
+            ProcessInterest(packet, header.GetSource());
+        }
+        else
+        {
+            HandleInterestPacket(packet, header.GetSource(), header.GetDestination());
+        }
+    }
+    else if (ccnheader.GetMessageType() == CCNHeader::DATA)
+    {
+        NS_LOG_DEBUG("Received a content response");
+        if (m_hopByHop)
+        {
+            ProcessData(packet, header.GetSource());
+        }
+        else
+        {
+            HandleDataPacket(packet, header.GetSource(), header.GetDestination());
+        }
+    }
+    else
+    {
+        NS_LOG_DEBUG("Unknown message type");
+    }
+
     return IpL4Protocol::RX_OK;
 }
 
@@ -205,6 +332,25 @@ CCNL4Protocol::Send(Ptr<Packet> packet,
     m_downTarget(packet, saddr, daddr, PROT_NUMBER, route);
 }
 
+void
+CCNL4Protocol::Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr)
+{
+    NS_LOG_FUNCTION(this << packet << saddr << daddr);
+
+    m_downTarget6(packet, saddr, daddr, PROT_NUMBER, nullptr);
+}
+
+void
+CCNL4Protocol::Send(Ptr<Packet> packet,
+                    Ipv6Address saddr,
+                    Ipv6Address daddr,
+                    Ptr<Ipv6Route> route)
+{
+    NS_LOG_FUNCTION(this << packet << saddr << daddr << route);
+
+    m_downTarget6(packet, saddr, daddr, PROT_NUMBER, route);
+}
+
 void
 CCNL4Protocol::SetDownTarget(IpL4Protocol::DownTargetCallback callback)
 {
@@ -216,7 +362,7 @@ void
 CCNL4Protocol::SetDownTarget6(IpL4Protocol::DownTargetCallback6 callback)
 {
     NS_LOG_FUNCTION(this);
-    NS_LOG_DEBUG("Not implemented");
+    m_downTarget6 = callback;
 }
 
 IpL4Protocol::DownTargetCallback
@@ -228,9 +374,7 @@ CCNL4Protocol::GetDownTarget() const
 IpL4Protocol::DownTargetCallback6
 CCNL4Protocol::GetDownTarget6() const
 {
-    NS_LOG_FUNCTION(this);
-    NS_LOG_DEBUG("Not implemented");
-    return IpL4Protocol::DownTargetCallback6();
+    return m_downTarget6;
 }
 
 Ptr<CCNContentConsumer>
@@ -257,6 +401,126 @@ CCNL4Protocol::CreateContentProducer()
     return producer;
 }
 
+void
+CCNL4Protocol::BindContentConsumer(Ptr<CCNContentConsumer> consumer, const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << consumer << contentName);
+    m_consumerTable[contentName].push_back(consumer);
+}
+
+void
+CCNL4Protocol::UnbindContentConsumer(Ptr<CCNContentConsumer> consumer,
+                                     const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << consumer << contentName);
+    auto it = m_consumerTable.find(contentName);
+    if (it == m_consumerTable.end())
+    {
+        return;
+    }
+
+    std::vector<Ptr<CCNContentConsumer>>& consumers = it->second;
+    consumers.erase(std::remove(consumers.begin(), consumers.end(), consumer), consumers.end());
+    if (consumers.empty())
+    {
+        m_consumerTable.erase(it);
+    }
+}
+
+void
+CCNL4Protocol::BindContentProducer(Ptr<CCNContentProducer> producer, const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << producer << contentName);
+    auto it = m_producerTable.find(contentName);
+    if (it != m_producerTable.end() && it->second != producer)
+    {
+        NS_LOG_WARN("Replacing the producer registered for " << contentName);
+    }
+    m_producerTable[contentName] = producer;
+}
+
+void
+CCNL4Protocol::UnbindContentProducer(Ptr<CCNContentProducer> producer,
+                                     const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << producer << contentName);
+    auto it = m_producerTable.find(contentName);
+    if (it != m_producerTable.end() && it->second == producer)
+    {
+        m_producerTable.erase(it);
+    }
+}
+
+Ptr<CCNContentProducer>
+CCNL4Protocol::LookupContentProducer(const std::string& contentName) const
+{
+    NS_LOG_FUNCTION(this << contentName);
+    auto it = LongestPrefixMatch(m_producerTable, contentName);
+    return it != m_producerTable.end() ? it->second : nullptr;
+}
+
+Ptr<CCNContentStore>
+CCNL4Protocol::GetContentStore() const
+{
+    return m_contentStore;
+}
+
+void
+CCNL4Protocol::AddFibNextHop(const std::string& prefix, const Address& nextHop, uint32_t cost)
+{
+    NS_LOG_FUNCTION(this << prefix << nextHop << cost);
+    RemoveFibNextHop(prefix, nextHop);
+    std::vector<CCNFibNextHop>& nextHops = m_fib[prefix];
+    auto pos = std::upper_bound(nextHops.begin(),
+                                nextHops.end(),
+                                cost,
+                                [](uint32_t c, const CCNFibNextHop& n) { return c < n.cost; });
+    nextHops.insert(pos, CCNFibNextHop{nextHop, cost});
+}
+
+void
+CCNL4Protocol::RemoveFibNextHop(const std::string& prefix, const Address& nextHop)
+{
+    NS_LOG_FUNCTION(this << prefix << nextHop);
+    auto it = m_fib.find(prefix);
+    if (it == m_fib.end())
+    {
+        return;
+    }
+
+    std::vector<CCNFibNextHop>& nextHops = it->second;
+    nextHops.erase(std::remove_if(nextHops.begin(),
+                                  nextHops.end(),
+                                  [&nextHop](const CCNFibNextHop& n) { return n.face == nextHop; }),
+                   nextHops.end());
+    if (nextHops.empty())
+    {
+        m_fib.erase(it);
+    }
+}
+
+void
+CCNL4Protocol::SetForwardingStrategy(const std::string& prefix,
+                                     Ptr<CCNForwardingStrategy> strategy)
+{
+    NS_LOG_FUNCTION(this << prefix << strategy);
+    if (strategy)
+    {
+        m_strategyTable[prefix] = strategy;
+    }
+    else
+    {
+        m_strategyTable.erase(prefix);
+    }
+}
+
+Ptr<CCNForwardingStrategy>
+CCNL4Protocol::GetForwardingStrategy(const std::string& contentName) const
+{
+    auto it = LongestPrefixMatch(m_strategyTable, contentName);
+    return it != m_strategyTable.end() ? it->second : m_defaultStrategy;
+}
+
 void
 CCNL4Protocol::AddContentPrefixToHostAddress(std::vector<std::pair<std::string, Ipv4Address>> contentPrefixToHostAddress)
 {
@@ -274,14 +538,21 @@ CCNL4Protocol::AddContentPrefixToHostAddress(std::string contentPrefix, Ipv4Addr
     m_contentPrefixToHostAddress[contentPrefix] = hostAddress;
 }
 
-Ipv4Address
+void
+CCNL4Protocol::AddContentPrefixToHostAddress(std::string contentPrefix, Ipv6Address hostAddress)
+{
+    NS_LOG_FUNCTION(this << contentPrefix << hostAddress);
+    m_contentPrefixToHostAddress[contentPrefix] = hostAddress;
+}
+
+Address
 CCNL4Protocol::GetHostAddressFromContentName(std::string contentName)
 {
     NS_LOG_FUNCTION(this << contentName);
     // parse the content name
     // the content name is in the format /L1Name/L2Name/.../LxName/HostAddress
     // we need to extract the host address comply with the longest prefix match
-    Ipv4Address hostAddress;
+    Address hostAddress;
 
     // start with layer 1 until to whole content name
     std::string prefix = "";
@@ -308,65 +579,93 @@ CCNL4Protocol::GetHostAddressFromContentName(std::string contentName)
 void
 CCNL4Protocol::SendInterest(Ptr<Packet> packet, std::string contentName)
 {
-    NS_LOG_FUNCTION(this << packet << contentName);
+    SendInterest(packet, contentName, CCNHeader::NO_SEGMENT);
+}
+
+void
+CCNL4Protocol::SendInterest(Ptr<Packet> packet, std::string contentName, uint32_t segment)
+{
+    NS_LOG_FUNCTION(this << packet << contentName << segment);
 
     // create a new header
     CCNHeader ccnheader;
     ccnheader.SetMessageType(CCNHeader::INTEREST);
     ccnheader.SetContentName(contentName);
+    ccnheader.SetSegment(segment);
 
     // add the header to the packet
     packet->AddHeader(ccnheader);
 
+    if (m_hopByHop)
+    {
+        ProcessInterest(packet, LocalFace());
+        return;
+    }
+
     // get destination address
-    Ipv4Address destAddress = GetHostAddressFromContentName(contentName);
-    if (destAddress == Ipv4Address::GetZero())
+    Address destAddress = GetHostAddressFromContentName(contentName);
+    if (destAddress.IsInvalid())
     {
         NS_LOG_DEBUG("No host address found for content name " << contentName);
         return;
     }
 
-    // get this node's address
-    Ipv4Address sourceAddress = m_node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
-
     NS_LOG_DEBUG("Sending interest packet to " << destAddress);
 
     // send the packet
-    Send(packet, sourceAddress, destAddress);
+    SendToHost(packet, destAddress);
 }
 
 void
 CCNL4Protocol::SendData(Ptr<Packet> packet, std::string contentName)
 {
-    NS_LOG_FUNCTION(this << packet << contentName);
+    SendData(packet, contentName, CCNHeader::NO_SEGMENT, CCNHeader::NO_SEGMENT);
+}
+
+void
+CCNL4Protocol::SendData(Ptr<Packet> packet,
+                        std::string contentName,
+                        uint32_t segment,
+                        uint32_t finalSegment)
+{
+    NS_LOG_FUNCTION(this << packet << contentName << segment << finalSegment);
 
     // create a new header
     CCNHeader ccnheader;
     ccnheader.SetMessageType(CCNHeader::DATA);
     ccnheader.SetContentName(contentName);
+    ccnheader.SetSegment(segment);
+    ccnheader.SetFinalSegment(finalSegment);
+
+    if (m_hopByHop)
+    {
+        // the Data reports the distance the Interest travelled
+        auto it = m_pit.find(CCNNameKey{contentName, segment});
+        ccnheader.SetHopCount(it != m_pit.end() ? it->second.hopCount : 0);
+        packet->AddHeader(ccnheader);
+        ProcessData(packet, LocalFace());
+        return;
+    }
 
     // add the header to the packet
     packet->AddHeader(ccnheader);
 
     // get destination address from pending interest table
-    Ipv4Address destAddress = m_pendingInterestTable[contentName];
-    if (destAddress == Ipv4Address::GetZero())
+    auto pending = m_pendingInterestTable.find(contentName);
+    if (pending == m_pendingInterestTable.end())
     {
         NS_LOG_DEBUG("No pending interest found for content name " << contentName);
         return;
     }
 
-    // get this node's address
-    Ipv4Address sourceAddress = m_node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
-
-    NS_LOG_DEBUG("Sending data packet to " << destAddress);
+    NS_LOG_DEBUG("Sending data packet to " << pending->second);
 
     // send the packet
-    Send(packet, sourceAddress, destAddress);
+    SendToHost(packet, pending->second);
 }
 
 void
-CCNL4Protocol::HandleInterestPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr)
+CCNL4Protocol::HandleInterestPacket(Ptr<Packet> packet, const Address& saddr, const Address& daddr)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr);
     // handle the interest packet
@@ -380,32 +679,26 @@ CCNL4Protocol::HandleInterestPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4A
 
     // get the content name
     std::string contentName = ccnheader.GetContentName();
-    // remove all null characters from the content names
-    contentName.erase(contentName.find('\0'));
 
     // insert into pending interest table
     m_pendingInterestTable[contentName] = saddr;
 
     // find the content producer
-    for (auto it = m_contentProducers.begin(); it != m_contentProducers.end(); ++it)
+    Ptr<CCNContentProducer> producer = LookupContentProducer(contentName);
+    if (producer)
     {
-        std::string producerName = (*it)->GetContentName();
-
-        if (producerName == contentName)
-        {
-            // found the content producer
-            // forward the interest packet to the producer
-            NS_LOG_INFO("Found content producer for content name " << contentName);
-            (*it)->SendContentResponse(packet, saddr, daddr);
-            return;
-        }
+        // found the content producer
+        // forward the interest packet to the producer
+        NS_LOG_INFO("Found content producer for content name " << contentName);
+        producer->SendContentResponse(packet, saddr, daddr);
+        return;
     }
 
     NS_LOG_DEBUG("No content producer found for content name " << contentName);
 }
 
 void
-CCNL4Protocol::HandleDataPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr)
+CCNL4Protocol::HandleDataPacket(Ptr<Packet> packet, const Address& saddr, const Address& daddr)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr);
     // handle the data packet
@@ -417,19 +710,408 @@ CCNL4Protocol::HandleDataPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Addre
 
     // get the content name
     std::string contentName = ccnheader.GetContentName();
-    // remove all null characters from the content names
-    contentName.erase(contentName.find('\0'));
 
-    // find the content consumer
-    for (auto it = m_contentConsumers.begin(); it != m_contentConsumers.end(); ++it)
+    DeliverToConsumers(packet, contentName);
+}
+
+void
+CCNL4Protocol::DeliverToConsumers(Ptr<Packet> packet, const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << packet << contentName);
+
+    // find the content consumers
+    auto it = LongestPrefixMatch(m_consumerTable, contentName);
+    if (it == m_consumerTable.end())
     {
-        if ((*it)->GetContentName() == contentName)
+        NS_LOG_DEBUG("No content consumer found for content name " << contentName);
+        return;
+    }
+
+    // forward the data packet to every consumer awaiting it, the
+    // consumers strip the header so each one gets its own copy
+    const std::vector<Ptr<CCNContentConsumer>>& consumers = it->second;
+    if (consumers.size() == 1)
+    {
+        consumers.front()->NotifyRecv(packet);
+        return;
+    }
+
+    std::vector<Ptr<CCNContentConsumer>> awaiting = consumers;
+    for (const auto& consumer : awaiting)
+    {
+        consumer->NotifyRecv(packet->Copy());
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+//        Hop-by-hop forwarding
+//
+//-----------------------------------------------------------------------------
+
+Address
+CCNL4Protocol::LocalFace()
+{
+    return Ipv4Address::GetLoopback();
+}
+
+bool
+CCNL4Protocol::IsLocalAddress(const Address& address) const
+{
+    if (Ipv4Address::IsMatchingType(address))
+    {
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+        return ipv4 && ipv4->GetInterfaceForAddress(Ipv4Address::ConvertFrom(address)) >= 0;
+    }
+    Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6>();
+    return ipv6 && ipv6->GetInterfaceForAddress(Ipv6Address::ConvertFrom(address)) >= 0;
+}
+
+Ptr<Ipv4Route>
+CCNL4Protocol::RouteTo(Ipv4Address destination) const
+{
+    Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4 && ipv4->GetRoutingProtocol(), "No IPv4 routing on node");
+
+    Ipv4Header header;
+    header.SetDestination(destination);
+    header.SetProtocol(PROT_NUMBER);
+    Socket::SocketErrno errno_;
+    return ipv4->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, errno_);
+}
+
+Ptr<Ipv6Route>
+CCNL4Protocol::RouteTo(Ipv6Address destination) const
+{
+    Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6>();
+    NS_ASSERT_MSG(ipv6 && ipv6->GetRoutingProtocol(), "No IPv6 routing on node");
+
+    Ipv6Header header;
+    header.SetDestination(destination);
+    header.SetNextHeader(PROT_NUMBER);
+    Socket::SocketErrno errno_;
+    return ipv6->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, errno_);
+}
+
+void
+CCNL4Protocol::SendToHost(Ptr<Packet> packet, const Address& host)
+{
+    NS_LOG_FUNCTION(this << packet << host);
+
+    if (Ipv6Address::IsMatchingType(host))
+    {
+        Ipv6Address destination = Ipv6Address::ConvertFrom(host);
+        Ptr<Ipv6Route> route = RouteTo(destination);
+        if (!route)
+        {
+            NS_LOG_DEBUG("No route to host " << destination);
+            return;
+        }
+        Send(packet, route->GetSource(), destination, route);
+        return;
+    }
+
+    // get this node's address
+    Ipv4Address sourceAddress = m_node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+    Send(packet, sourceAddress, Ipv4Address::ConvertFrom(host));
+}
+
+void
+CCNL4Protocol::SendToFace(Ptr<Packet> packet, const Address& face)
+{
+    NS_LOG_FUNCTION(this << packet << face);
+
+    if (face == LocalFace())
+    {
+        CCNHeader ccnheader;
+        packet->PeekHeader(ccnheader);
+        DeliverToConsumers(packet, ccnheader.GetContentName());
+        return;
+    }
+
+    if (Ipv6Address::IsMatchingType(face))
+    {
+        Ipv6Address face6 = Ipv6Address::ConvertFrom(face);
+        Ptr<Ipv6Route> route = RouteTo(face6);
+        if (!route)
         {
-            // found the content consumer
-            // forward the data packet to the consumer
-            (*it)->NotifyRecv(packet);
+            NS_LOG_DEBUG("No route to face " << face6);
             return;
         }
+        Send(packet, route->GetSource(), face6, route);
+        return;
+    }
+
+    Ipv4Address face4 = Ipv4Address::ConvertFrom(face);
+    Ptr<Ipv4Route> route = RouteTo(face4);
+    if (!route)
+    {
+        NS_LOG_DEBUG("No route to face " << face4);
+        return;
+    }
+    Send(packet, route->GetSource(), face4, route);
+}
+
+void
+CCNL4Protocol::ProcessInterest(Ptr<Packet> packet, const Address& from)
+{
+    NS_LOG_FUNCTION(this << packet << from);
+
+    CCNHeader ccnheader;
+    packet->PeekHeader(ccnheader);
+    std::string contentName = ccnheader.GetContentName();
+    uint32_t segment = ccnheader.GetSegment();
+
+    // answer from the content store
+    Ptr<Packet> payload;
+    uint32_t finalSegment;
+    if (segment != CCNHeader::NO_SEGMENT &&
+        m_contentStore->Lookup(contentName, segment, payload, finalSegment))
+    {
+        NS_LOG_DEBUG("Content store hit for " << contentName << " segment " << segment);
+        CCNHeader dataHeader;
+        dataHeader.SetMessageType(CCNHeader::DATA);
+        dataHeader.SetContentName(contentName);
+        dataHeader.SetSegment(segment);
+        dataHeader.SetFinalSegment(finalSegment);
+        dataHeader.SetHopCount(ccnheader.GetHopCount());
+        payload->AddHeader(dataHeader);
+        SendToFace(payload, from);
+        return;
+    }
+
+    // record the Interest in the PIT, aggregating concurrent requests
+    Time now = Simulator::Now();
+    CCNNameKey key{contentName, segment};
+    auto it = m_pit.find(key);
+    if (it != m_pit.end() && it->second.expiry > now)
+    {
+        PitEntry& entry = it->second;
+        if (std::find(entry.faces.begin(), entry.faces.end(), from) == entry.faces.end())
+        {
+            NS_LOG_DEBUG("Aggregating Interest for " << contentName << " segment " << segment);
+            entry.faces.push_back(from);
+            entry.expiry = now + m_pitLifetime;
+            return;
+        }
+
+        // a retransmission from a face already waiting: only the upstream
+        // faces whose Interest outlived its timeout failed, the Interest
+        // is aggregated while any other one may still answer
+        Ptr<CCNForwardingStrategy> strategy = GetForwardingStrategy(contentName);
+        std::vector<std::pair<Address, Time>> pending;
+        for (const auto& out : entry.outFaces)
+        {
+            if (now - out.second >= std::min(m_pitLifetime,
+                                              strategy->GetRetransmissionTimeout(out.first)))
+            {
+                strategy->NotifyTimeout(out.first);
+            }
+            else
+            {
+                pending.push_back(out);
+            }
+        }
+        bool expired = pending.size() < entry.outFaces.size();
+        entry.outFaces.swap(pending);
+        entry.expiry = now + m_pitLifetime;
+        if (!expired && !entry.outFaces.empty())
+        {
+            NS_LOG_DEBUG("Aggregating retransmitted Interest for " << contentName << " segment "
+                                                                    << segment);
+            return;
+        }
+        entry.hopCount = ccnheader.GetHopCount();
+    }
+    else if (it != m_pit.end())
+    {
+        // an expired entry: the upstream faces did not answer in time
+        PitEntry& entry = it->second;
+        Ptr<CCNForwardingStrategy> strategy = GetForwardingStrategy(contentName);
+        for (const auto& out : entry.outFaces)
+        {
+            strategy->NotifyTimeout(out.first);
+        }
+        entry.faces.assign(1, from);
+        entry.outFaces.clear();
+        entry.expiry = now + m_pitLifetime;
+        entry.hopCount = ccnheader.GetHopCount();
+    }
+    else
+    {
+        if (++m_pitInsertions >= 4096)
+        {
+            PurgePit();
+        }
+        it = m_pit.emplace(key, PitEntry{{from}, now + m_pitLifetime, ccnheader.GetHopCount(), {}})
+                 .first;
+    }
+
+    // answer from a local producer
+    Ptr<CCNContentProducer> producer = LookupContentProducer(contentName);
+    if (producer)
+    {
+        NS_LOG_INFO("Found content producer for content name " << contentName);
+        producer->SendContentResponse(packet, from, Address());
+        return;
+    }
+
+    ForwardInterest(packet, from, it->second);
+}
+
+std::vector<CCNFibNextHop>
+CCNL4Protocol::LookupNextHops(const std::string& contentName)
+{
+    NS_LOG_FUNCTION(this << contentName);
+
+    auto fib = LongestPrefixMatch(m_fib, contentName);
+    if (fib != m_fib.end())
+    {
+        return fib->second;
+    }
+
+    Address hostAddress = GetHostAddressFromContentName(contentName);
+    if (hostAddress.IsInvalid())
+    {
+        NS_LOG_DEBUG("No host address found for content name " << contentName);
+        return {};
+    }
+
+    if (IsLocalAddress(hostAddress))
+    {
+        NS_LOG_DEBUG("No local producer for content name " << contentName);
+        return {};
+    }
+
+    // the next CCN hop is the IP next hop towards the prefix owner
+    if (Ipv6Address::IsMatchingType(hostAddress))
+    {
+        Ipv6Address host6 = Ipv6Address::ConvertFrom(hostAddress);
+        Ptr<Ipv6Route> route = RouteTo(host6);
+        if (!route)
+        {
+            NS_LOG_DEBUG("No route towards " << host6);
+            return {};
+        }
+
+        // a link-local gateway cannot be addressed without its interface
+        Ipv6Address gateway = route->GetGateway();
+        bool usable = !gateway.IsAny() && !gateway.IsLinkLocal();
+        return {CCNFibNextHop{usable ? Address(gateway) : hostAddress, 0}};
+    }
+
+    Ipv4Address host4 = Ipv4Address::ConvertFrom(hostAddress);
+    Ptr<Ipv4Route> route = RouteTo(host4);
+    if (!route)
+    {
+        NS_LOG_DEBUG("No route towards " << host4);
+        return {};
+    }
+
+    Ipv4Address nextHop = route->GetGateway();
+    if (nextHop == Ipv4Address::GetAny())
+    {
+        nextHop = host4;
+    }
+    return {CCNFibNextHop{nextHop, 0}};
+}
+
+void
+CCNL4Protocol::ForwardInterest(Ptr<Packet> packet, const Address& inFace, PitEntry& entry)
+{
+    NS_LOG_FUNCTION(this << packet << inFace);
+
+    CCNHeader ccnheader;
+    packet->RemoveHeader(ccnheader);
+    std::string contentName = ccnheader.GetContentName();
+
+    if (ccnheader.GetHopCount() >= m_maxHops)
+    {
+        NS_LOG_DEBUG("Dropping interest for " << contentName << " after "
+                                              << +ccnheader.GetHopCount() << " hops");
+        return;
+    }
+
+    std::vector<Address> faces =
+        GetForwardingStrategy(contentName)->SelectFaces(contentName,
+                                                        LookupNextHops(contentName),
+                                                        inFace);
+    if (faces.empty())
+    {
+        NS_LOG_DEBUG("No next hop for content name " << contentName);
+        return;
+    }
+
+    ccnheader.SetHopCount(ccnheader.GetHopCount() + 1);
+    packet->AddHeader(ccnheader);
+
+    Time now = Simulator::Now();
+    for (const auto& face : faces)
+    {
+        NS_LOG_DEBUG("Forwarding interest for " << contentName << " to " << face);
+        entry.outFaces.emplace_back(face, now);
+        SendToFace(faces.size() == 1 ? packet : packet->Copy(), face);
+    }
+}
+
+void
+CCNL4Protocol::ProcessData(Ptr<Packet> packet, const Address& from)
+{
+    NS_LOG_FUNCTION(this << packet << from);
+
+    CCNHeader ccnheader;
+    packet->PeekHeader(ccnheader);
+    std::string contentName = ccnheader.GetContentName();
+    uint32_t segment = ccnheader.GetSegment();
+
+    // cache segments received from the network, unsegmented content is
+    // streamed in several Data packets and cannot be cached
+    if (segment != CCNHeader::NO_SEGMENT && from != LocalFace())
+    {
+        Ptr<Packet> payload = packet->Copy();
+        CCNHeader removed;
+        payload->RemoveHeader(removed);
+        m_contentStore->Insert(contentName, segment, payload, ccnheader.GetFinalSegment());
+    }
+
+    auto it = m_pit.find(CCNNameKey{contentName, segment});
+    if (it == m_pit.end())
+    {
+        NS_LOG_DEBUG("Unsolicited data for " << contentName << " segment " << segment);
+        return;
+    }
+
+    // feed the RTT of the upstream face back to the strategy
+    for (const auto& out : it->second.outFaces)
+    {
+        if (out.first == from)
+        {
+            GetForwardingStrategy(contentName)->NotifyData(from, Simulator::Now() - out.second);
+            break;
+        }
+    }
+
+    std::vector<Address> faces = it->second.faces;
+    if (segment != CCNHeader::NO_SEGMENT)
+    {
+        m_pit.erase(it);
+    }
+
+    for (const auto& face : faces)
+    {
+        SendToFace(packet->Copy(), face);
+    }
+}
+
+void
+CCNL4Protocol::PurgePit()
+{
+    NS_LOG_FUNCTION(this);
+    m_pitInsertions = 0;
+    Time now = Simulator::Now();
+    for (auto it = m_pit.begin(); it != m_pit.end();)
+    {
+        it = (it->second.expiry <= now) ? m_pit.erase(it) : std::next(it);
     }
 }
 
@@ -23,7 +23,13 @@
 #include "ip-l4-protocol.h"
 #include "ccn-content-producer.h"
 #include "ccn-content-consumer.h"
+#include "ccn-content-store.h"
+#include "ccn-forwarding-strategy.h"
 
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
 
@@ -35,6 +41,8 @@ namespace ns3
 {
 
 class Node;
+class Ipv4Route;
+class Ipv6Route;
 class CCNContentConsumer;
 class CCNContentProducer;
 
@@ -52,6 +60,24 @@ class CCNContentProducer;
 /**
  * \ingroup CCN
  * \brief Implementation of the CCN L4 protocol
+ *
+ * By default Interests are unicast end to end to the host owning the
+ * content prefix and Data are returned to the Interest source. With the
+ * HopByHop attribute set, every CCN node on the IP path processes the
+ * packets: Interests are answered from the local content store or a local
+ * producer, aggregated in the pending Interest table, or forwarded to the
+ * IP next hop towards the prefix owner; Data follow the PIT entries back
+ * and are cached on the way.
+ *
+ * In hop-by-hop mode the faces an Interest is forwarded to are chosen by
+ * the forwarding strategy of the longest matching name prefix among the
+ * FIB next hops of the name. Names without FIB entry use the IP next hop
+ * towards the prefix owner as their only next hop.
+ *
+ * Host addresses and faces are either IPv4 or IPv6 addresses, CCN runs over
+ * whichever network layer is installed on the node. IPv6 routes whose
+ * gateway is link-local cannot address a CCN neighbor, names without FIB
+ * entry are then sent straight to the prefix owner.
  */
 class CCNL4Protocol : public IpL4Protocol
 {
@@ -118,6 +144,16 @@ class CCNL4Protocol : public IpL4Protocol
               Ipv4Address daddr,
               Ptr<Ipv4Route> route);
 
+    /**
+     * Send a packet to the network over IPv6
+     */
+    void Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr);
+
+    /**
+     * Send a packet to the network over IPv6 along a given route
+     */
+    void Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, Ptr<Ipv6Route> route);
+
     /**
      * Set node associated with this stack
      * \param node the node
@@ -133,6 +169,11 @@ class CCNL4Protocol : public IpL4Protocol
      */
     void AddContentPrefixToHostAddress(std::string contentPrefix, Ipv4Address hostAddress);
 
+    /**
+     * \brief Add a content prefix to IPv6 host address mapping
+     */
+    void AddContentPrefixToHostAddress(std::string contentPrefix, Ipv6Address hostAddress);
+
     /**
      * \brief Create a new content consumer
      */
@@ -143,33 +184,124 @@ class CCNL4Protocol : public IpL4Protocol
      */
     Ptr<CCNContentProducer> CreateContentProducer();
 
+    /**
+     * \brief Register a consumer waiting for Data of a content name
+     * \param consumer the content consumer
+     * \param contentName the content name
+     *
+     * Several consumers may wait for the same name, a received Data packet
+     * is delivered to all of them.
+     */
+    void BindContentConsumer(Ptr<CCNContentConsumer> consumer, const std::string& contentName);
+
+    /**
+     * \brief Remove a consumer from the dispatch table of a content name
+     */
+    void UnbindContentConsumer(Ptr<CCNContentConsumer> consumer, const std::string& contentName);
+
+    /**
+     * \brief Register the producer serving a content name or name prefix
+     * \param producer the content producer
+     * \param contentName the served content name or prefix
+     */
+    void BindContentProducer(Ptr<CCNContentProducer> producer, const std::string& contentName);
+
+    /**
+     * \brief Remove a producer from the dispatch table
+     */
+    void UnbindContentProducer(Ptr<CCNContentProducer> producer, const std::string& contentName);
+
+    /**
+     * \brief Find the producer serving a content name
+     * \param contentName the requested content name
+     * \return the producer registered for the longest matching prefix, or nullptr
+     */
+    Ptr<CCNContentProducer> LookupContentProducer(const std::string& contentName) const;
+
+    /**
+     * \brief Get the content store of this node
+     */
+    Ptr<CCNContentStore> GetContentStore() const;
+
+    /**
+     * \brief Add a next hop to the FIB entry of a name prefix
+     * \param prefix the name prefix
+     * \param nextHop the IPv4 or IPv6 address of the neighbor
+     * \param cost the routing cost, lower is preferred
+     *
+     * Adding a next hop already present updates its cost.
+     */
+    void AddFibNextHop(const std::string& prefix, const Address& nextHop, uint32_t cost);
+
+    /**
+     * \brief Remove a next hop from the FIB entry of a name prefix
+     */
+    void RemoveFibNextHop(const std::string& prefix, const Address& nextHop);
+
+    /**
+     * \brief Attach a forwarding strategy to a name prefix
+     * \param prefix the name prefix
+     * \param strategy the strategy, used for every name below the prefix
+     *        without a more specific strategy
+     */
+    void SetForwardingStrategy(const std::string& prefix, Ptr<CCNForwardingStrategy> strategy);
+
+    /**
+     * \brief Find the forwarding strategy of a content name
+     * \param contentName the content name
+     * \return the strategy of the longest matching prefix, or the default strategy
+     */
+    Ptr<CCNForwardingStrategy> GetForwardingStrategy(const std::string& contentName) const;
+
     /**
      * \brief Parse the content name and return the host address
      * \param contentName the content name
-     * 
+     * \return the IPv4 or IPv6 address of the prefix owner, an invalid
+     *         Address if no prefix matches
+     *
      * ContentName format: /L1Name/L2Name/.../LxName/HostAddress
      */
-    Ipv4Address GetHostAddressFromContentName(std::string contentName);
+    Address GetHostAddressFromContentName(std::string contentName);
 
     /**
      * \brief Send Interest packet
      */
     void SendInterest(Ptr<Packet> packet, std::string contentName);
 
+    /**
+     * \brief Send Interest packet for one segment of a content
+     * \param packet the packet to send
+     * \param contentName the content name
+     * \param segment the requested segment number
+     */
+    void SendInterest(Ptr<Packet> packet, std::string contentName, uint32_t segment);
+
     /**
      * \brief Send Data packet
      */
     void SendData(Ptr<Packet> packet, std::string contentName);
 
+    /**
+     * \brief Send Data packet carrying one segment of a content
+     * \param packet the packet to send
+     * \param contentName the content name
+     * \param segment the segment number carried by the packet
+     * \param finalSegment the last segment number of the content
+     */
+    void SendData(Ptr<Packet> packet,
+                  std::string contentName,
+                  uint32_t segment,
+                  uint32_t finalSegment);
+
     /**
      * \brief Handle received Interest packet
      */
-    void HandleInterestPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr);
+    void HandleInterestPacket(Ptr<Packet> packet, const Address& saddr, const Address& daddr);
 
     /**
      * \brief Handle received Data packet
      */
-    void HandleDataPacket(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr);
+    void HandleDataPacket(Ptr<Packet> packet, const Address& saddr, const Address& daddr);
 
   protected:
     void DoDispose() override;
@@ -181,17 +313,119 @@ class CCNL4Protocol : public IpL4Protocol
     void NotifyNewAggregate() override;
 
   private:
+    /// Pending Interest table entry of the hop-by-hop mode
+    struct PitEntry
+    {
+        std::vector<Address> faces; //!< downstream faces awaiting the Data
+        Time expiry;                //!< entry lifetime end
+        uint8_t hopCount;           //!< hop count of the Interest on arrival
+        std::vector<std::pair<Address, Time>> outFaces; //!< upstream faces and send times
+    };
+
+    /**
+     * \brief Face standing for the applications of this node
+     */
+    static Address LocalFace();
+
+    /**
+     * \brief Hop-by-hop processing of an Interest
+     * \param packet the Interest, with its CCN header
+     * \param from the face the Interest was received from
+     */
+    void ProcessInterest(Ptr<Packet> packet, const Address& from);
+
+    /**
+     * \brief Forward an Interest to the faces chosen by its strategy
+     * \param packet the Interest, with its CCN header
+     * \param inFace the face the Interest was received from
+     * \param entry the PIT entry of the Interest
+     */
+    void ForwardInterest(Ptr<Packet> packet, const Address& inFace, PitEntry& entry);
+
+    /**
+     * \brief Get the next hops of a content name
+     * \return the FIB next hops of the longest matching prefix, or the IP
+     *         next hop towards the prefix owner
+     */
+    std::vector<CCNFibNextHop> LookupNextHops(const std::string& contentName);
+
+    /**
+     * \brief Hop-by-hop processing of a Data packet
+     * \param packet the Data, with its CCN header
+     * \param from the face the Data was received from
+     */
+    void ProcessData(Ptr<Packet> packet, const Address& from);
+
+    /**
+     * \brief Send a CCN packet to a neighbor or to the local applications
+     */
+    void SendToFace(Ptr<Packet> packet, const Address& face);
+
+    /**
+     * \brief Send a CCN packet end to end to a host
+     */
+    void SendToHost(Ptr<Packet> packet, const Address& host);
+
+    /**
+     * \brief Check whether an address belongs to this node
+     */
+    bool IsLocalAddress(const Address& address) const;
+
+    /**
+     * \brief Deliver a Data packet to the local consumers awaiting its name
+     */
+    void DeliverToConsumers(Ptr<Packet> packet, const std::string& contentName);
+
+    /**
+     * \brief Look up the IPv4 route towards a destination
+     * \return the route, or nullptr if the destination is unreachable
+     */
+    Ptr<Ipv4Route> RouteTo(Ipv4Address destination) const;
+
+    /**
+     * \brief Look up the IPv6 route towards a destination
+     * \return the route, or nullptr if the destination is unreachable
+     */
+    Ptr<Ipv6Route> RouteTo(Ipv6Address destination) const;
+
+    /**
+     * \brief Drop expired PIT entries
+     */
+    void PurgePit();
+
     Ptr<Node> m_node;                //!< the node this stack is associated with
     std::vector<Ptr<CCNContentConsumer>> m_contentConsumers; //!< the content consumers
     std::vector<Ptr<CCNContentProducer>> m_contentProducers; //!< the content producers
 
+    // content name to consumers awaiting Data for it
+    std::unordered_map<std::string, std::vector<Ptr<CCNContentConsumer>>> m_consumerTable;
+
+    // content name or prefix to the producer serving it
+    std::unordered_map<std::string, Ptr<CCNContentProducer>> m_producerTable;
+
     IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
+    IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
 
     // content prefix to host address mapping
-    std::unordered_map<std::string, Ipv4Address> m_contentPrefixToHostAddress;
+    std::unordered_map<std::string, Address> m_contentPrefixToHostAddress;
 
     // pending Interest table
-    std::unordered_map<std::string, Ipv4Address> m_pendingInterestTable;
+    std::unordered_map<std::string, Address> m_pendingInterestTable;
+
+    // hop-by-hop forwarding
+    bool m_hopByHop;                   //!< process packets at every CCN hop
+    Time m_pitLifetime;                //!< lifetime of hop-by-hop PIT entries
+    Ptr<CCNContentStore> m_contentStore; //!< cached Data segments
+    std::unordered_map<CCNNameKey, PitEntry, CCNNameKeyHash> m_pit; //!< hop-by-hop PIT
+    uint32_t m_pitInsertions;          //!< insertions since the last PIT purge
+    uint8_t m_maxHops;                 //!< Interests travelling further are dropped
+
+    // forwarding information base, sorted by cost
+    std::unordered_map<std::string, std::vector<CCNFibNextHop>> m_fib;
+
+    // name prefix to forwarding strategy
+    std::unordered_map<std::string, Ptr<CCNForwardingStrategy>> m_strategyTable;
+    Ptr<CCNForwardingStrategy> m_defaultStrategy; //!< strategy of unmatched names
 };
 
 } // namespace ns3
@@ -0,0 +1,234 @@
+#include "ns3/ccn-content-store.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("CCNContentStoreTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Victims of the LRU, LFU and FIFO replacement policies
+ */
+class CCNContentStorePolicyTest : public TestCase
+{
+  public:
+    CCNContentStorePolicyTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Fill a store of 3 segments, hit some of them and insert one more
+     * \param policy the replacement policy
+     * \param hits names looked up between the fill and the last insertion
+     * \return the name evicted by the last insertion
+     */
+    std::string Evicted(CCNContentStore::Policy policy, const std::vector<std::string>& hits);
+};
+
+CCNContentStorePolicyTest::CCNContentStorePolicyTest()
+    : TestCase("CCN content store replacement policies")
+{
+}
+
+std::string
+CCNContentStorePolicyTest::Evicted(CCNContentStore::Policy policy,
+                                   const std::vector<std::string>& hits)
+{
+    Ptr<CCNContentStore> store = CreateObject<CCNContentStore>();
+    store->SetPolicy(policy);
+    store->SetMaxSize(3);
+
+    Ptr<Packet> payload;
+    uint32_t finalSegment;
+    for (const auto& name : {"a", "b", "c"})
+    {
+        store->Insert(name, 0, Create<Packet>(10), 0);
+    }
+    for (const auto& name : hits)
+    {
+        NS_TEST_EXPECT_MSG_EQ(store->Lookup(name, 0, payload, finalSegment),
+                              true,
+                              "Cached segment " << name << " missed");
+    }
+    store->Insert("d", 0, Create<Packet>(10), 0);
+    NS_TEST_EXPECT_MSG_EQ(store->GetSize(), 3, "Store over capacity");
+
+    std::string evicted;
+    for (const auto& name : {"a", "b", "c", "d"})
+    {
+        if (!store->Lookup(name, 0, payload, finalSegment))
+        {
+            NS_TEST_EXPECT_MSG_EQ(evicted, "", "More than one segment evicted");
+            evicted = name;
+        }
+    }
+    store->Dispose();
+    return evicted;
+}
+
+void
+CCNContentStorePolicyTest::DoRun()
+{
+    // a was used last but inserted first
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::LRU, {"a"}), "b", "LRU");
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::LFU, {"a"}), "b", "LFU");
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::FIFO, {"a"}), "a", "FIFO");
+
+    // a is the most frequently used but the least recently used,
+    // b and c tie on frequency and c was used last
+    std::vector<std::string> hits{"a", "a", "b", "c"};
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::LRU, hits), "a", "LRU");
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::LFU, hits), "b", "LFU");
+    NS_TEST_EXPECT_MSG_EQ(Evicted(CCNContentStore::FIFO, hits), "a", "FIFO");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Hit ratio of the content store under a Zipf request stream
+ *
+ * A cache of C objects in front of a catalog of N objects requested with
+ * Zipf popularity. LFU keeps the C - 1 most popular objects and cycles the
+ * misses through its last entry, so its hit ratio lies between the
+ * popularity mass of the C - 1 and of the C most popular objects, the
+ * ideal of a static cache. LRU and FIFO, which also keep unpopular objects
+ * for a while, stay below it.
+ */
+class CCNContentStoreZipfTest : public TestCase
+{
+  public:
+    CCNContentStoreZipfTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Serve the request stream from a store, caching every miss
+     * \param policy the replacement policy
+     * \param capacity the store capacity, in objects
+     * \return the hit ratio
+     */
+    double HitRatio(CCNContentStore::Policy policy, uint32_t capacity);
+
+    /// Object ranks requested, drawn once for every store
+    std::vector<uint32_t> m_requests;
+};
+
+static const uint32_t CATALOG = 100;     //!< objects in the catalog
+static const double ALPHA = 1.0;         //!< Zipf exponent
+static const uint32_t REQUESTS = 20000;  //!< requests of the stream
+
+CCNContentStoreZipfTest::CCNContentStoreZipfTest()
+    : TestCase("CCN content store under a Zipf workload")
+{
+}
+
+double
+CCNContentStoreZipfTest::HitRatio(CCNContentStore::Policy policy, uint32_t capacity)
+{
+    Ptr<CCNContentStore> store = CreateObject<CCNContentStore>();
+    store->SetPolicy(policy);
+    store->SetMaxSize(capacity);
+
+    Ptr<Packet> payload;
+    uint32_t finalSegment;
+    for (uint32_t rank : m_requests)
+    {
+        std::string name = "P/c/" + std::to_string(rank);
+        if (!store->Lookup(name, 0, payload, finalSegment))
+        {
+            store->Insert(name, 0, Create<Packet>(10), 0);
+        }
+    }
+
+    // a disabled store does not count its lookups
+    NS_TEST_EXPECT_MSG_EQ(store->GetHits() + store->GetMisses(),
+                          (capacity > 0 ? m_requests.size() : 0),
+                          "Every request is a hit or a miss");
+    NS_TEST_EXPECT_MSG_EQ(store->GetSize(),
+                          std::min(capacity, CATALOG),
+                          "The store should be full");
+    double ratio = static_cast<double>(store->GetHits()) / m_requests.size();
+    store->Dispose();
+    return ratio;
+}
+
+void
+CCNContentStoreZipfTest::DoRun()
+{
+    Ptr<ZipfRandomVariable> zipf = CreateObject<ZipfRandomVariable>();
+    zipf->SetAttribute("N", IntegerValue(CATALOG));
+    zipf->SetAttribute("Alpha", DoubleValue(ALPHA));
+    zipf->SetStream(1);
+
+    std::set<uint32_t> distinct;
+    for (uint32_t i = 0; i < REQUESTS; i++)
+    {
+        m_requests.push_back(zipf->GetInteger());
+        distinct.insert(m_requests.back());
+    }
+
+    // a store holding the whole catalog only misses the first requests
+    double compulsory = 1.0 - static_cast<double>(distinct.size()) / REQUESTS;
+    NS_TEST_EXPECT_MSG_EQ_TOL(HitRatio(CCNContentStore::LRU, CATALOG),
+                              compulsory,
+                              1e-9,
+                              "Catalog-sized store");
+    NS_TEST_EXPECT_MSG_EQ(HitRatio(CCNContentStore::LFU, 0), 0, "Disabled store");
+
+    const uint32_t capacity = 10;
+    double popular = 0;
+    double stable = 0;
+    double total = 0;
+    for (uint32_t k = 1; k <= CATALOG; k++)
+    {
+        double p = 1.0 / std::pow(k, ALPHA);
+        total += p;
+        popular += k <= capacity ? p : 0;
+        stable += k < capacity ? p : 0;
+    }
+    double ideal = popular / total;
+    stable /= total;
+
+    double lru = HitRatio(CCNContentStore::LRU, capacity);
+    double lfu = HitRatio(CCNContentStore::LFU, capacity);
+    double fifo = HitRatio(CCNContentStore::FIFO, capacity);
+    NS_LOG_INFO("Hit ratio with " << capacity << " of " << CATALOG << " objects: ideal " << ideal
+                                  << ", LRU " << lru << ", LFU " << lfu << ", FIFO " << fifo);
+
+    NS_TEST_EXPECT_MSG_LT(lfu, ideal, "LFU cannot beat a static cache");
+    NS_TEST_EXPECT_MSG_GT(lfu, stable - 0.05, "LFU should keep the most popular objects");
+    NS_TEST_EXPECT_MSG_LT(lru, lfu, "LRU should not beat LFU on a static popularity");
+    NS_TEST_EXPECT_MSG_LT(fifo, lru, "Hits do not refresh FIFO entries");
+    NS_TEST_EXPECT_MSG_GT(fifo, ideal / 2, "FIFO should still serve the popular objects");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief CCN content store TestSuite
+ */
+class CCNContentStoreTestSuite : public TestSuite
+{
+  public:
+    CCNContentStoreTestSuite()
+        : TestSuite("ccn-content-store", UNIT)
+    {
+        AddTestCase(new CCNContentStorePolicyTest(), TestCase::QUICK);
+        AddTestCase(new CCNContentStoreZipfTest(), TestCase::QUICK);
+    }
+};
+
+static CCNContentStoreTestSuite g_ccnContentStoreTestSuite; //!< Static variable for test initialization
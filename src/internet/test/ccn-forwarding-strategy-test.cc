@@ -0,0 +1,465 @@
+#include "ns3/boolean.h"
+#include "ns3/ccn-content-consumer.h"
+#include "ns3/ccn-content-producer.h"
+#include "ns3/ccn-forwarding-strategy.h"
+#include "ns3/ccn-header.h"
+#include "ns3/ccn-l4-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Faces selected by the CCN forwarding strategies
+ *
+ * BestRoute takes the lowest cost next hop other than the incoming face,
+ * Multicast every next hop but the incoming face. Adaptive sends most
+ * Interests to the face with the lower SRTT, and moves away from a face
+ * after timeouts.
+ */
+class CCNStrategySelectionTest : public TestCase
+{
+  public:
+    CCNStrategySelectionTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Share of the Interests the adaptive strategy sends to a face
+     * \param strategy the strategy
+     * \param nextHops the next hops
+     * \param face the face
+     * \return the share of 10000 selections
+     */
+    static double Share(Ptr<CCNAdaptiveStrategy> strategy,
+                        const std::vector<CCNFibNextHop>& nextHops,
+                        const Address& face);
+};
+
+CCNStrategySelectionTest::CCNStrategySelectionTest()
+    : TestCase("CCN forwarding strategies select the expected faces")
+{
+}
+
+double
+CCNStrategySelectionTest::Share(Ptr<CCNAdaptiveStrategy> strategy,
+                                const std::vector<CCNFibNextHop>& nextHops,
+                                const Address& face)
+{
+    uint32_t selected = 0;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        std::vector<Address> faces = strategy->SelectFaces("P/x", nextHops, Address());
+        if (faces.size() == 1 && faces[0] == face)
+        {
+            selected++;
+        }
+    }
+    return selected / 10000.0;
+}
+
+void
+CCNStrategySelectionTest::DoRun()
+{
+    Address a = Ipv4Address("10.0.0.1");
+    Address b = Ipv4Address("10.0.0.2");
+    Address c = Ipv4Address("10.0.0.3");
+    // sorted by cost, as the FIB hands them
+    std::vector<CCNFibNextHop> nextHops = {{a, 1}, {b, 5}, {c, 10}};
+
+    Ptr<CCNBestRouteStrategy> bestRoute = CreateObject<CCNBestRouteStrategy>();
+    std::vector<Address> faces = bestRoute->SelectFaces("P/x", nextHops, c);
+    NS_TEST_ASSERT_MSG_EQ(faces.size(), 1, "BestRoute forwards to one face");
+    NS_TEST_EXPECT_MSG_EQ(faces[0], a, "BestRoute should take the lowest cost");
+    faces = bestRoute->SelectFaces("P/x", nextHops, a);
+    NS_TEST_ASSERT_MSG_EQ(faces.size(), 1, "BestRoute forwards to one face");
+    NS_TEST_EXPECT_MSG_EQ(faces[0], b, "BestRoute should skip the incoming face");
+    NS_TEST_EXPECT_MSG_EQ(bestRoute->GetRetransmissionTimeout(a),
+                          Time::Max(),
+                          "BestRoute relies on the PIT lifetime");
+
+    Ptr<CCNMulticastStrategy> multicast = CreateObject<CCNMulticastStrategy>();
+    faces = multicast->SelectFaces("P/x", nextHops, b);
+    NS_TEST_ASSERT_MSG_EQ(faces.size(), 2, "Multicast forwards to the other faces");
+    NS_TEST_EXPECT_MSG_EQ(faces[0], a, "Multicast face");
+    NS_TEST_EXPECT_MSG_EQ(faces[1], c, "Multicast face");
+    NS_TEST_EXPECT_MSG_EQ(multicast->SelectFaces("P/x", {{a, 1}}, a).size(),
+                          0,
+                          "Multicast should not send back to the incoming face");
+
+    Ptr<CCNAdaptiveStrategy> adaptive = CreateObject<CCNAdaptiveStrategy>();
+    adaptive->AssignStreams(1);
+    std::vector<CCNFibNextHop> pair = {{a, 1}, {b, 1}};
+    NS_TEST_EXPECT_MSG_EQ_TOL(Share(adaptive, pair, a), 0.5, 0.02, "Unmeasured faces share");
+    NS_TEST_EXPECT_MSG_EQ(adaptive->SelectFaces("P/x", pair, a).at(0),
+                          b,
+                          "Adaptive should skip the incoming face");
+
+    // weights 1/SRTT: 1/10 ms against 1/40 ms
+    adaptive->NotifyData(a, MilliSeconds(10));
+    adaptive->NotifyData(b, MilliSeconds(40));
+    NS_TEST_EXPECT_MSG_EQ(adaptive->GetSrtt(a), MilliSeconds(10), "First sample is the SRTT");
+    NS_TEST_EXPECT_MSG_EQ(adaptive->GetRetransmissionTimeout(a),
+                          MilliSeconds(20),
+                          "A face is given twice its SRTT");
+    NS_TEST_EXPECT_MSG_EQ_TOL(Share(adaptive, pair, a), 0.8, 0.02, "Lower SRTT preferred");
+
+    // each timeout doubles the SRTT: 80 ms against 40 ms
+    adaptive->NotifyTimeout(a);
+    adaptive->NotifyTimeout(a);
+    adaptive->NotifyTimeout(a);
+    NS_TEST_EXPECT_MSG_EQ(adaptive->GetSrtt(a), MilliSeconds(80), "Timeouts penalize the SRTT");
+    NS_TEST_EXPECT_MSG_EQ_TOL(Share(adaptive, pair, a), 1.0 / 3, 0.02, "Timed out face avoided");
+
+    // new samples bring the face back
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        adaptive->NotifyData(a, MilliSeconds(10));
+    }
+    NS_TEST_EXPECT_MSG_GT(Share(adaptive, pair, a), 0.75, "Recovered face preferred again");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Hop-by-hop CCN forwarding through the FIB
+ *
+ * A consumer linked to two neighbors, both producing "P/a/x". The FIB of
+ * the consumer sends "P" to the first neighbor and "P/a" to the second:
+ * "P/a/x" must be fetched from the second one, "P/b" from the first. On
+ * a line, the MaxHops attribute drops the Interests that would need more
+ * hops to reach the producer.
+ */
+class CCNFibForwardingTest : public TestCase
+{
+  public:
+    CCNFibForwardingTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Segment receive callback
+     * \param packet the payload
+     * \param header the CCN header
+     */
+    void RecvSegment(Ptr<Packet> packet, const CCNHeader& header);
+
+    /**
+     * \brief Fetch a segment over a line of nodes
+     * \param maxHops the MaxHops attribute of every node
+     * \return whether the Data came back
+     */
+    bool FetchOverLine(uint8_t maxHops);
+
+    std::map<std::string, uint32_t> m_sizes; //!< payload size per name received
+};
+
+CCNFibForwardingTest::CCNFibForwardingTest()
+    : TestCase("CCN FIB longest prefix match and MaxHops")
+{
+}
+
+void
+CCNFibForwardingTest::RecvSegment(Ptr<Packet> packet, const CCNHeader& header)
+{
+    m_sizes[header.GetContentName()] = packet->GetSize();
+}
+
+bool
+CCNFibForwardingTest::FetchOverLine(uint8_t maxHops)
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net1 = helper.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    NetDeviceContainer net2 = helper.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<CCNL4Protocol> ccnl4 = nodes.Get(i)->GetObject<CCNL4Protocol>();
+        ccnl4->SetAttribute("HopByHop", BooleanValue(true));
+        ccnl4->SetAttribute("MaxHops", UintegerValue(maxHops));
+    }
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer if1 = address.Assign(net1);
+    address.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer if2 = address.Assign(net2);
+
+    nodes.Get(0)->GetObject<CCNL4Protocol>()->AddFibNextHop("P", if1.GetAddress(1), 0);
+    nodes.Get(1)->GetObject<CCNL4Protocol>()->AddFibNextHop("P", if2.GetAddress(1), 0);
+
+    Ptr<CCNContentProducer> producer =
+        nodes.Get(2)->GetObject<CCNL4Protocol>()->CreateContentProducer();
+    producer->SetContentName("P/line");
+    producer->SetContentSize(100);
+
+    Ptr<CCNContentConsumer> consumer =
+        nodes.Get(0)->GetObject<CCNL4Protocol>()->CreateContentConsumer();
+    consumer->SetContentName("P");
+    consumer->SetSegmentRecvCallback(MakeCallback(&CCNFibForwardingTest::RecvSegment, this));
+
+    void (CCNContentConsumer::*getSegment)(const std::string&, uint32_t) =
+        &CCNContentConsumer::GetSegment;
+    Simulator::Schedule(Seconds(1), getSegment, consumer, "P/line", 0);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    bool received = m_sizes.count("P/line");
+    m_sizes.clear();
+    return received;
+}
+
+void
+CCNFibForwardingTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    Ptr<Node> consumerNode = nodes.Get(0);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net1 = helper.Install(NodeContainer(consumerNode, nodes.Get(1)));
+    NetDeviceContainer net2 = helper.Install(NodeContainer(consumerNode, nodes.Get(2)));
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        nodes.Get(i)->GetObject<CCNL4Protocol>()->SetAttribute("HopByHop", BooleanValue(true));
+    }
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer if1 = address.Assign(net1);
+    address.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer if2 = address.Assign(net2);
+
+    Ptr<CCNL4Protocol> ccnl4 = consumerNode->GetObject<CCNL4Protocol>();
+    ccnl4->AddFibNextHop("P", if1.GetAddress(1), 0);
+    ccnl4->AddFibNextHop("P/a", if2.GetAddress(1), 0);
+
+    // the payload size tells which neighbor answered
+    struct
+    {
+        uint32_t node;
+        std::string name;
+        uint32_t size;
+    } contents[] = {{1, "P/a/x", 100}, {1, "P/b", 300}, {2, "P/a/x", 200}};
+    for (const auto& content : contents)
+    {
+        Ptr<CCNContentProducer> producer =
+            nodes.Get(content.node)->GetObject<CCNL4Protocol>()->CreateContentProducer();
+        producer->SetContentName(content.name);
+        producer->SetContentSize(content.size);
+    }
+
+    Ptr<CCNContentConsumer> consumer = ccnl4->CreateContentConsumer();
+    consumer->SetContentName("P");
+    consumer->SetSegmentRecvCallback(MakeCallback(&CCNFibForwardingTest::RecvSegment, this));
+
+    void (CCNContentConsumer::*getSegment)(const std::string&, uint32_t) =
+        &CCNContentConsumer::GetSegment;
+    Simulator::Schedule(Seconds(1), getSegment, consumer, "P/a/x", 0);
+    Simulator::Schedule(Seconds(1), getSegment, consumer, "P/b", 0);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_sizes.size(), 2, "Both Interests should be satisfied");
+    NS_TEST_EXPECT_MSG_EQ(m_sizes["P/a/x"], 200, "P/a/x should follow the longest prefix");
+    NS_TEST_EXPECT_MSG_EQ(m_sizes["P/b"], 300, "P/b should follow the shorter prefix");
+    m_sizes.clear();
+
+    // the producer is two hops away
+    NS_TEST_EXPECT_MSG_EQ(FetchOverLine(1), false, "The router should drop the Interest");
+    NS_TEST_EXPECT_MSG_EQ(FetchOverLine(2), true, "Two hops should be allowed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Strategy recording the feedback of the protocol
+ */
+class CCNRecordingStrategy : public CCNBestRouteStrategy
+{
+  public:
+    /**
+     * Constructor
+     * \param timeout the retransmission timeout of every face
+     */
+    CCNRecordingStrategy(Time timeout)
+        : m_timeout(timeout),
+          m_timeouts(0)
+    {
+    }
+
+    void NotifyData(const Address& face, Time rtt) override
+    {
+        m_rtts.push_back(rtt);
+    }
+
+    void NotifyTimeout(const Address& face) override
+    {
+        m_timeouts++;
+    }
+
+    Time GetRetransmissionTimeout(const Address& face) const override
+    {
+        return m_timeout;
+    }
+
+    Time m_timeout;           //!< retransmission timeout
+    std::vector<Time> m_rtts; //!< RTTs reported
+    uint32_t m_timeouts;      //!< timeouts reported
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Interests retransmitted by a face already waiting
+ *
+ * A consumer asks twice for a segment 100 ms away. A retransmission
+ * before the upstream face timed out is aggregated: the face is not
+ * penalized and the RTT is measured from the first Interest. After the
+ * timeout the face is notified and the Interest is forwarded again.
+ */
+class CCNRetransmissionTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param timeout the retransmission timeout of the upstream face
+     * \param gap the time between the two Interests
+     */
+    CCNRetransmissionTest(Time timeout, Time gap);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Segment receive callback
+     * \param packet the payload
+     * \param header the CCN header
+     */
+    void RecvSegment(Ptr<Packet> packet, const CCNHeader& header);
+
+    Time m_timeout;      //!< retransmission timeout of the upstream face
+    Time m_gap;          //!< time between the two Interests
+    uint32_t m_received; //!< Data received by the consumer
+};
+
+CCNRetransmissionTest::CCNRetransmissionTest(Time timeout, Time gap)
+    : TestCase(timeout > gap ? "CCN retransmission before the timeout is aggregated"
+                             : "CCN retransmission after the timeout is forwarded"),
+      m_timeout(timeout),
+      m_gap(gap),
+      m_received(0)
+{
+}
+
+void
+CCNRetransmissionTest::RecvSegment(Ptr<Packet> packet, const CCNHeader& header)
+{
+    m_received++;
+}
+
+void
+CCNRetransmissionTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(50)));
+    NetDeviceContainer devices = helper.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        nodes.Get(i)->GetObject<CCNL4Protocol>()->SetAttribute("HopByHop", BooleanValue(true));
+    }
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    Ptr<CCNRecordingStrategy> strategy = CreateObject<CCNRecordingStrategy>(m_timeout);
+    Ptr<CCNL4Protocol> ccnl4 = nodes.Get(0)->GetObject<CCNL4Protocol>();
+    ccnl4->AddFibNextHop("P", interfaces.GetAddress(1), 0);
+    ccnl4->SetForwardingStrategy("P", strategy);
+
+    Ptr<CCNContentProducer> producer =
+        nodes.Get(1)->GetObject<CCNL4Protocol>()->CreateContentProducer();
+    producer->SetContentName("P/content");
+    producer->SetContentSize(100);
+
+    Ptr<CCNContentConsumer> consumer = ccnl4->CreateContentConsumer();
+    consumer->SetContentName("P/content");
+    consumer->SetSegmentRecvCallback(MakeCallback(&CCNRetransmissionTest::RecvSegment, this));
+
+    void (CCNContentConsumer::*getSegment)(uint32_t) = &CCNContentConsumer::GetSegment;
+    Simulator::Schedule(Seconds(1), getSegment, consumer, 0);
+    Simulator::Schedule(Seconds(1) + m_gap, getSegment, consumer, 0);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, 1, "The Data should be delivered once");
+    NS_TEST_ASSERT_MSG_EQ(strategy->m_rtts.size(), 1, "One RTT should be reported");
+    if (m_timeout > m_gap)
+    {
+        NS_TEST_EXPECT_MSG_EQ(strategy->m_timeouts, 0, "The face should not be penalized");
+        NS_TEST_EXPECT_MSG_EQ(strategy->m_rtts[0],
+                              MilliSeconds(100),
+                              "The RTT should be measured from the first Interest");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(strategy->m_timeouts, 1, "The face should time out");
+        NS_TEST_EXPECT_MSG_EQ(strategy->m_rtts[0],
+                              MilliSeconds(100) - m_gap,
+                              "The RTT should be measured from the forwarded retransmission");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief CCN forwarding strategy TestSuite
+ */
+class CCNForwardingStrategyTestSuite : public TestSuite
+{
+  public:
+    CCNForwardingStrategyTestSuite()
+        : TestSuite("ccn-forwarding-strategy", UNIT)
+    {
+        AddTestCase(new CCNStrategySelectionTest(), TestCase::QUICK);
+        AddTestCase(new CCNFibForwardingTest(), TestCase::QUICK);
+        AddTestCase(new CCNRetransmissionTest(Seconds(1), MilliSeconds(10)), TestCase::QUICK);
+        AddTestCase(new CCNRetransmissionTest(MilliSeconds(20), MilliSeconds(50)),
+                    TestCase::QUICK);
+    }
+};
+
+static CCNForwardingStrategyTestSuite
+    g_ccnForwardingStrategyTestSuite; //!< Static variable for test initialization
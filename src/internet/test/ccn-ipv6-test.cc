@@ -0,0 +1,289 @@
+#include "ns3/boolean.h"
+#include "ns3/ccn-content-consumer.h"
+#include "ns3/ccn-content-producer.h"
+#include "ns3/ccn-content-store.h"
+#include "ns3/ccn-header.h"
+#include "ns3/ccn-l4-protocol.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <chrono>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("CCNIpv6Test");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Fetch a segmented content end to end over IPv4 and IPv6
+ *
+ * Both network layers must deliver every segment. The per-packet cost of
+ * the two paths is compared in simulator events, which is deterministic,
+ * and reported in wall-clock time.
+ */
+class CCNIpv6EndToEndTest : public TestCase
+{
+  public:
+    CCNIpv6EndToEndTest();
+
+  private:
+    void DoRun() override;
+
+    /// Cost of one fetch
+    struct FetchResult
+    {
+        uint32_t received; //!< segments received
+        uint64_t events;   //!< simulator events executed
+        double wallTime;   //!< wall-clock time of the run, in seconds
+    };
+
+    /**
+     * \brief Fetch the content over one network layer
+     * \param ipv6 use IPv6 instead of IPv4
+     * \return the fetch result
+     */
+    FetchResult Fetch(bool ipv6);
+
+    /**
+     * \brief Segment receive callback
+     * \param packet the payload
+     * \param header the CCN header
+     */
+    void RecvSegment(Ptr<Packet> packet, const CCNHeader& header);
+
+    uint32_t m_received; //!< segments received in the current fetch
+};
+
+static const uint32_t SEGMENTS = 200; //!< segments fetched per run
+
+CCNIpv6EndToEndTest::CCNIpv6EndToEndTest()
+    : TestCase("CCN end to end fetch over IPv4 and IPv6")
+{
+}
+
+void
+CCNIpv6EndToEndTest::RecvSegment(Ptr<Packet> packet, const CCNHeader& header)
+{
+    m_received++;
+}
+
+CCNIpv6EndToEndTest::FetchResult
+CCNIpv6EndToEndTest::Fetch(bool ipv6)
+{
+    m_received = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices = helper.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.SetIpv4StackInstall(!ipv6);
+    stack.SetIpv6StackInstall(ipv6);
+    stack.Install(nodes);
+
+    Address producerAddress;
+    if (ipv6)
+    {
+        nodes.Get(0)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+        nodes.Get(1)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+        Ipv6AddressHelper address;
+        address.SetBase(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+        Ipv6InterfaceContainer interfaces = address.Assign(devices);
+        producerAddress = interfaces.GetAddress(1, 1);
+    }
+    else
+    {
+        Ipv4AddressHelper address;
+        address.SetBase("10.1.1.0", "255.255.255.0");
+        Ipv4InterfaceContainer interfaces = address.Assign(devices);
+        producerAddress = interfaces.GetAddress(1);
+    }
+
+    Ptr<CCNL4Protocol> consumerL4 = nodes.Get(0)->GetObject<CCNL4Protocol>();
+    Ptr<CCNL4Protocol> producerL4 = nodes.Get(1)->GetObject<CCNL4Protocol>();
+
+    if (ipv6)
+    {
+        consumerL4->AddContentPrefixToHostAddress("P", Ipv6Address::ConvertFrom(producerAddress));
+    }
+    else
+    {
+        consumerL4->AddContentPrefixToHostAddress("P", Ipv4Address::ConvertFrom(producerAddress));
+    }
+
+    Ptr<CCNContentProducer> producer = producerL4->CreateContentProducer();
+    producer->SetContentName("P/content");
+    producer->SetSegmentSize(512);
+    producer->SetContentSize(512 * SEGMENTS);
+
+    Ptr<CCNContentConsumer> consumer = consumerL4->CreateContentConsumer();
+    consumer->SetContentName("P/content");
+    consumer->SetSegmentRecvCallback(MakeCallback(&CCNIpv6EndToEndTest::RecvSegment, this));
+
+    void (CCNContentConsumer::*getSegment)(uint32_t) = &CCNContentConsumer::GetSegment;
+    for (uint32_t segment = 0; segment < SEGMENTS; segment++)
+    {
+        Simulator::Schedule(MilliSeconds(10 * segment + 1), getSegment, consumer, segment);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto stop = std::chrono::steady_clock::now();
+
+    FetchResult result{m_received,
+                       Simulator::GetEventCount(),
+                       std::chrono::duration<double>(stop - start).count()};
+    Simulator::Destroy();
+    return result;
+}
+
+void
+CCNIpv6EndToEndTest::DoRun()
+{
+    FetchResult v4 = Fetch(false);
+    FetchResult v6 = Fetch(true);
+
+    NS_TEST_ASSERT_MSG_EQ(v4.received, SEGMENTS, "IPv4 fetch incomplete");
+    NS_TEST_ASSERT_MSG_EQ(v6.received, SEGMENTS, "IPv6 fetch incomplete");
+
+    double v4PerPacket = static_cast<double>(v4.events) / (2 * SEGMENTS);
+    double v6PerPacket = static_cast<double>(v6.events) / (2 * SEGMENTS);
+    NS_LOG_INFO("Per CCN packet: IPv4 " << v4PerPacket << " events, "
+                                        << v4.wallTime * 1e6 / (2 * SEGMENTS) << " us; IPv6 "
+                                        << v6PerPacket << " events, "
+                                        << v6.wallTime * 1e6 / (2 * SEGMENTS) << " us");
+
+    // neighbor discovery adds a few events, the data path must not
+    NS_TEST_ASSERT_MSG_LT(v6PerPacket,
+                          v4PerPacket * 1.5,
+                          "IPv6 path costs much more events per packet than IPv4");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Hop-by-hop fetch over IPv6 FIB next hops
+ *
+ * A consumer, a router and a producer on a line. Only the router caches
+ * the Data, so a second request for the same segment is answered one hop
+ * away.
+ */
+class CCNIpv6HopByHopTest : public TestCase
+{
+  public:
+    CCNIpv6HopByHopTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Segment receive callback
+     * \param packet the payload
+     * \param header the CCN header
+     */
+    void RecvSegment(Ptr<Packet> packet, const CCNHeader& header);
+
+    std::vector<uint32_t> m_hops; //!< hop count of the received Data
+};
+
+CCNIpv6HopByHopTest::CCNIpv6HopByHopTest()
+    : TestCase("CCN hop-by-hop forwarding over IPv6 FIB next hops")
+{
+}
+
+void
+CCNIpv6HopByHopTest::RecvSegment(Ptr<Packet> packet, const CCNHeader& header)
+{
+    m_hops.push_back(header.GetHopCount());
+}
+
+void
+CCNIpv6HopByHopTest::DoRun()
+{
+    Ptr<Node> consumerNode = CreateObject<Node>();
+    Ptr<Node> router = CreateObject<Node>();
+    Ptr<Node> producerNode = CreateObject<Node>();
+    NodeContainer nodes(consumerNode, router, producerNode);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net1 = helper.Install(NodeContainer(consumerNode, router));
+    NetDeviceContainer net2 = helper.Install(NodeContainer(router, producerNode));
+
+    InternetStackHelper stack;
+    stack.SetIpv4StackInstall(false);
+    stack.Install(nodes);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        nodes.Get(i)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+        Ptr<CCNL4Protocol> ccnl4 = nodes.Get(i)->GetObject<CCNL4Protocol>();
+        ccnl4->SetAttribute("HopByHop", BooleanValue(true));
+        // only the router caches, the consumer would answer itself
+        ccnl4->GetContentStore()->SetMaxSize(nodes.Get(i) == router ? 16 : 0);
+    }
+
+    Ipv6AddressHelper address;
+    address.SetBase(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer if1 = address.Assign(net1);
+    address.SetBase(Ipv6Address("2001:2::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer if2 = address.Assign(net2);
+
+    // the FIB next hops are the neighbors, no IP forwarding is involved
+    consumerNode->GetObject<CCNL4Protocol>()->AddFibNextHop("P", if1.GetAddress(1, 1), 0);
+    router->GetObject<CCNL4Protocol>()->AddFibNextHop("P", if2.GetAddress(1, 1), 0);
+
+    Ptr<CCNContentProducer> producer =
+        producerNode->GetObject<CCNL4Protocol>()->CreateContentProducer();
+    producer->SetContentName("P/content");
+    producer->SetContentSize(1024);
+
+    Ptr<CCNContentConsumer> consumer =
+        consumerNode->GetObject<CCNL4Protocol>()->CreateContentConsumer();
+    consumer->SetContentName("P/content");
+    consumer->SetSegmentRecvCallback(MakeCallback(&CCNIpv6HopByHopTest::RecvSegment, this));
+
+    void (CCNContentConsumer::*getSegment)(uint32_t) = &CCNContentConsumer::GetSegment;
+    Simulator::Schedule(Seconds(1), getSegment, consumer, 0);
+    Simulator::Schedule(Seconds(2), getSegment, consumer, 0);
+    Simulator::Run();
+
+    Ptr<CCNContentStore> cache = router->GetObject<CCNL4Protocol>()->GetContentStore();
+    NS_TEST_ASSERT_MSG_EQ(m_hops.size(), 2, "Both Interests should be satisfied");
+    NS_TEST_EXPECT_MSG_EQ(m_hops[0], 2, "First Data should come from the producer");
+    NS_TEST_EXPECT_MSG_EQ(m_hops[1], 1, "Second Data should come from the router cache");
+    NS_TEST_EXPECT_MSG_EQ(cache->GetHits(), 1, "Router cache should have been hit once");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief CCN over IPv6 TestSuite
+ */
+class CCNIpv6TestSuite : public TestSuite
+{
+  public:
+    CCNIpv6TestSuite()
+        : TestSuite("ccn-ipv6", UNIT)
+    {
+        AddTestCase(new CCNIpv6EndToEndTest(), TestCase::QUICK);
+        AddTestCase(new CCNIpv6HopByHopTest(), TestCase::QUICK);
+    }
+};
+
+static CCNIpv6TestSuite g_ccnIpv6TestSuite; //!< Static variable for test initialization
@@ -0,0 +1,210 @@
+#include "ns3/ccn-content-consumer.h"
+#include "ns3/ccn-content-producer.h"
+#include "ns3/ccn-header.h"
+#include "ns3/ccn-l4-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Register, look up and unregister CCN content producers
+ *
+ * Producers are found by the longest registered prefix of the requested
+ * name, matched on whole name components.
+ */
+class CCNProducerDispatchTest : public TestCase
+{
+  public:
+    CCNProducerDispatchTest();
+
+  private:
+    void DoRun() override;
+};
+
+CCNProducerDispatchTest::CCNProducerDispatchTest()
+    : TestCase("CCN producer dispatch table")
+{
+}
+
+void
+CCNProducerDispatchTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper stack;
+    stack.Install(node);
+    Ptr<CCNL4Protocol> ccnl4 = node->GetObject<CCNL4Protocol>();
+
+    Ptr<CCNContentProducer> p1 = ccnl4->CreateContentProducer();
+    Ptr<CCNContentProducer> p2 = ccnl4->CreateContentProducer();
+
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"),
+                          nullptr,
+                          "No producer is registered yet");
+
+    p1->SetContentName("P");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P"), p1, "Exact name");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"), p1, "Name below the prefix");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("Q/video/1"), nullptr, "Unknown prefix");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("PP/video/1"),
+                          nullptr,
+                          "Prefixes match whole name components");
+
+    p2->SetContentName("P/video");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"),
+                          p2,
+                          "The longest prefix wins");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/audio/1"), p1, "Shorter prefix");
+
+    // renaming a producer moves its entry
+    p2->SetContentName("P/audio");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"), p1, "Old name unbound");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/audio/1"), p2, "New name bound");
+
+    // only the registered producer may remove an entry
+    ccnl4->UnbindContentProducer(p2, "P");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"),
+                          p1,
+                          "Unbinding another producer must not remove the entry");
+
+    ccnl4->UnbindContentProducer(p1, "P");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/video/1"), nullptr, "Entry removed");
+    NS_TEST_EXPECT_MSG_EQ(ccnl4->LookupContentProducer("P/audio/1"), p2, "Other entry kept");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Register, deliver to and unregister CCN content consumers
+ *
+ * A Data packet is delivered to every consumer of the longest matching
+ * name, each one receiving its own copy.
+ */
+class CCNConsumerDispatchTest : public TestCase
+{
+  public:
+    CCNConsumerDispatchTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Deliver a Data packet to the consumers
+     * \param ccnl4 the CCN stack
+     * \param name the content name of the Data
+     */
+    void Deliver(Ptr<CCNL4Protocol> ccnl4, const std::string& name);
+
+    /**
+     * \brief Segment receive callback
+     * \param consumer index of the receiving consumer
+     * \param packet the payload
+     * \param header the CCN header
+     */
+    void RecvSegment(uint32_t consumer, Ptr<Packet> packet, const CCNHeader& header);
+
+    uint32_t m_received[3]; //!< Data received by each consumer
+};
+
+static const uint32_t PAYLOAD_SIZE = 100; //!< payload of the delivered Data
+
+CCNConsumerDispatchTest::CCNConsumerDispatchTest()
+    : TestCase("CCN consumer dispatch table")
+{
+}
+
+void
+CCNConsumerDispatchTest::Deliver(Ptr<CCNL4Protocol> ccnl4, const std::string& name)
+{
+    CCNHeader header;
+    header.SetMessageType(CCNHeader::DATA);
+    header.SetContentName(name);
+    header.SetSegment(0);
+    header.SetFinalSegment(0);
+    Ptr<Packet> packet = Create<Packet>(PAYLOAD_SIZE);
+    packet->AddHeader(header);
+    ccnl4->HandleDataPacket(packet, Address(), Address());
+}
+
+void
+CCNConsumerDispatchTest::RecvSegment(uint32_t consumer,
+                                     Ptr<Packet> packet,
+                                     const CCNHeader& header)
+{
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), PAYLOAD_SIZE, "Consumer got a stripped copy");
+    m_received[consumer]++;
+}
+
+void
+CCNConsumerDispatchTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper stack;
+    stack.Install(node);
+    Ptr<CCNL4Protocol> ccnl4 = node->GetObject<CCNL4Protocol>();
+
+    const char* names[] = {"P/content", "P/content", "P"};
+    Ptr<CCNContentConsumer> consumers[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        m_received[i] = 0;
+        consumers[i] = ccnl4->CreateContentConsumer();
+        consumers[i]->SetContentName(names[i]);
+        consumers[i]->SetSegmentRecvCallback(
+            MakeCallback(&CCNConsumerDispatchTest::RecvSegment, this).Bind(i));
+    }
+
+    Deliver(ccnl4, "P/content");
+    NS_TEST_EXPECT_MSG_EQ(m_received[0], 1, "First consumer of the name");
+    NS_TEST_EXPECT_MSG_EQ(m_received[1], 1, "Second consumer of the name");
+    NS_TEST_EXPECT_MSG_EQ(m_received[2], 0, "Consumer of a shorter prefix");
+
+    Deliver(ccnl4, "P/other");
+    NS_TEST_EXPECT_MSG_EQ(m_received[2], 1, "Only the prefix matches");
+    NS_TEST_EXPECT_MSG_EQ(m_received[0] + m_received[1], 2, "Other name not delivered");
+
+    Deliver(ccnl4, "Q/content");
+    NS_TEST_EXPECT_MSG_EQ(m_received[0] + m_received[1] + m_received[2],
+                          3,
+                          "Unknown name not delivered");
+
+    ccnl4->UnbindContentConsumer(consumers[0], "P/content");
+    Deliver(ccnl4, "P/content");
+    NS_TEST_EXPECT_MSG_EQ(m_received[0], 1, "Unbound consumer");
+    NS_TEST_EXPECT_MSG_EQ(m_received[1], 2, "Remaining consumer of the name");
+
+    // the last consumer of a name leaves, the prefix takes over
+    ccnl4->UnbindContentConsumer(consumers[1], "P/content");
+    Deliver(ccnl4, "P/content");
+    NS_TEST_EXPECT_MSG_EQ(m_received[1], 2, "Unbound consumer");
+    NS_TEST_EXPECT_MSG_EQ(m_received[2], 2, "Consumer of the prefix");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief CCN L4 protocol TestSuite
+ */
+class CCNL4ProtocolTestSuite : public TestSuite
+{
+  public:
+    CCNL4ProtocolTestSuite()
+        : TestSuite("ccn-l4-protocol", UNIT)
+    {
+        AddTestCase(new CCNProducerDispatchTest(), TestCase::QUICK);
+        AddTestCase(new CCNConsumerDispatchTest(), TestCase::QUICK);
+    }
+};
+
+static CCNL4ProtocolTestSuite g_ccnL4ProtocolTestSuite; //!< Static variable for test initialization
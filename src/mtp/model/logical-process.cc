@@ -0,0 +1,260 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::LogicalProcess.
+ */
+
+#include "logical-process.h"
+
+#include "ns3/assert.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LogicalProcess");
+
+LogicalProcess::LogicalProcess(uint32_t id, Ptr<Scheduler> events)
+    : m_id(id),
+      m_events(events),
+      m_uid(EventId::UID::VALID),
+      m_currentUid(EventId::UID::INVALID),
+      m_currentTs(0),
+      m_currentContext(Simulator::NO_CONTEXT),
+      m_eventCount(0),
+      m_unscheduledEvents(0),
+      m_sequence(0),
+      m_mailbox(nullptr)
+{
+    NS_LOG_FUNCTION(this << id);
+}
+
+LogicalProcess::~LogicalProcess()
+{
+    NS_LOG_FUNCTION(this);
+    Receive();
+    while (!m_events->IsEmpty())
+    {
+        Scheduler::Event next = m_events->RemoveNext();
+        next.impl->Unref();
+    }
+}
+
+uint32_t
+LogicalProcess::GetId() const
+{
+    return m_id;
+}
+
+void
+LogicalProcess::DoInsert(Scheduler::Event& ev)
+{
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
+EventId
+LogicalProcess::Insert(uint64_t ts, uint32_t context, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << ts << context << event);
+    NS_ASSERT(ts >= m_currentTs);
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    DoInsert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+LogicalProcess::Send(uint64_t ts,
+                     uint32_t context,
+                     EventImpl* event,
+                     uint32_t sender,
+                     uint64_t sequence)
+{
+    NS_LOG_FUNCTION(this << ts << context << event << sender << sequence);
+    auto message = new Message{{event, {ts, EventId::UID::INVALID, context}}, sender, sequence};
+    message->next = m_mailbox.load(std::memory_order_relaxed);
+    while (!m_mailbox.compare_exchange_weak(message->next,
+                                            message,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed))
+    {
+    }
+}
+
+void
+LogicalProcess::Receive()
+{
+    Message* message = m_mailbox.exchange(nullptr, std::memory_order_acquire);
+    if (message == nullptr)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    for (; message != nullptr; message = message->next)
+    {
+        m_received.push_back(message);
+    }
+    std::sort(m_received.begin(), m_received.end(), [](const Message* a, const Message* b) {
+        return std::tie(a->ev.key.m_ts, a->sender, a->sequence) <
+               std::tie(b->ev.key.m_ts, b->sender, b->sequence);
+    });
+    for (Message* received : m_received)
+    {
+        DoInsert(received->ev);
+        delete received;
+    }
+    m_received.clear();
+}
+
+uint64_t
+LogicalProcess::GetNextTs() const
+{
+    if (m_events->IsEmpty())
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return m_events->PeekNext().key.m_ts;
+}
+
+bool
+LogicalProcess::IsEmpty() const
+{
+    return m_events->IsEmpty();
+}
+
+void
+LogicalProcess::ProcessOneEvent()
+{
+    Scheduler::Event next = m_events->RemoveNext();
+
+    NS_ASSERT(next.key.m_ts >= m_currentTs);
+    m_unscheduledEvents--;
+    m_eventCount++;
+
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+    m_currentTs = next.key.m_ts;
+    m_currentContext = next.key.m_context;
+    m_currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+LogicalProcess::Remove(const EventId& id)
+{
+    NS_LOG_FUNCTION(this << id.GetUid());
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    m_events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    m_unscheduledEvents--;
+}
+
+bool
+LogicalProcess::IsExpired(const EventId& id) const
+{
+    return id.PeekEventImpl() == nullptr || id.GetTs() < m_currentTs ||
+           (id.GetTs() == m_currentTs && id.GetUid() <= m_currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+void
+LogicalProcess::TakeEvents(std::vector<Scheduler::Event>& events)
+{
+    NS_LOG_FUNCTION(this);
+    Receive();
+    while (!m_events->IsEmpty())
+    {
+        events.push_back(m_events->RemoveNext());
+        m_unscheduledEvents--;
+    }
+}
+
+void
+LogicalProcess::Adopt(const Scheduler::Event& ev)
+{
+    NS_ASSERT(ev.key.m_ts >= m_currentTs);
+    m_uid = std::max(m_uid, ev.key.m_uid + 1);
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
+void
+LogicalProcess::SetScheduler(Ptr<Scheduler> events)
+{
+    NS_LOG_FUNCTION(this << events);
+    while (!m_events->IsEmpty())
+    {
+        events->Insert(m_events->RemoveNext());
+    }
+    m_events = events;
+}
+
+uint64_t
+LogicalProcess::GetCurrentTs() const
+{
+    return m_currentTs;
+}
+
+void
+LogicalProcess::SetCurrentTs(uint64_t ts)
+{
+    NS_ASSERT(ts <= GetNextTs());
+    m_currentTs = ts;
+}
+
+uint32_t
+LogicalProcess::GetContext() const
+{
+    return m_currentContext;
+}
+
+uint64_t
+LogicalProcess::GetEventCount() const
+{
+    return m_eventCount;
+}
+
+uint64_t
+LogicalProcess::NextSequence()
+{
+    return m_sequence++;
+}
+
+} // namespace ns3
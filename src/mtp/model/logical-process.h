@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::LogicalProcess.
+ */
+
+#ifndef NS3_LOGICAL_PROCESS_H
+#define NS3_LOGICAL_PROCESS_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ *
+ * \brief A partition of the nodes, with its own event list and clock.
+ *
+ * A logical process is only ever run by one thread at a time: its events
+ * are executed in time order by that thread, which is the only one to
+ * touch its scheduler and its clock.  Other logical processes hand it
+ * events through its mailbox, a lock-free stack they push to while it
+ * runs; it empties the mailbox into its scheduler between two windows.
+ */
+class LogicalProcess
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] id The index of the logical process.
+     * \param [in] events The event list.
+     */
+    LogicalProcess(uint32_t id, Ptr<Scheduler> events);
+    /** Destructor, releasing the pending events. */
+    ~LogicalProcess();
+
+    LogicalProcess(const LogicalProcess&) = delete;
+    LogicalProcess& operator=(const LogicalProcess&) = delete;
+
+    /**
+     * Get the index of this logical process.
+     *
+     * \returns The index.
+     */
+    uint32_t GetId() const;
+
+    /**
+     * Insert an event, from the thread running this logical process.
+     *
+     * \param [in] ts The time stamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event.
+     * \returns The id of the event.
+     */
+    EventId Insert(uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Hand an event to this logical process, from the thread running
+     * another one.
+     *
+     * The event enters the event list at the next call to Receive(),
+     * after the events received before it from the same sender.
+     *
+     * \param [in] ts The time stamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event.
+     * \param [in] sender The index of the sending logical process.
+     * \param [in] sequence The number of events sent before by the sender.
+     */
+    void Send(uint64_t ts, uint32_t context, EventImpl* event, uint32_t sender, uint64_t sequence);
+    /**
+     * Move the events of the mailbox to the event list.
+     *
+     * Events are inserted in the order of their time stamp, sender and
+     * sequence number, whatever the order the senders pushed them in,
+     * so a run does not depend on thread timing.
+     */
+    void Receive();
+
+    /**
+     * Get the time stamp of the next event.
+     *
+     * \returns The time stamp, or the largest time stamp when empty.
+     */
+    uint64_t GetNextTs() const;
+    /**
+     * Check whether the event list is empty.
+     *
+     * \returns \c true if there is no event left.
+     */
+    bool IsEmpty() const;
+    /** Remove the next event from the event list and execute it. */
+    void ProcessOneEvent();
+
+    /**
+     * Remove an event from the event list.
+     *
+     * \param [in] id The event.
+     */
+    void Remove(const EventId& id);
+    /**
+     * Check whether an event has run or was cancelled.
+     *
+     * \param [in] id The event.
+     * \returns \c true if the event will not run.
+     */
+    bool IsExpired(const EventId& id) const;
+
+    /**
+     * Move all the pending events out of this logical process.
+     *
+     * \param [out] events The events are appended here.
+     */
+    void TakeEvents(std::vector<Scheduler::Event>& events);
+    /**
+     * Insert an event which keeps its key, moved from another logical
+     * process.
+     *
+     * \param [in] ev The event.
+     */
+    void Adopt(const Scheduler::Event& ev);
+    /**
+     * Replace the event list, keeping the pending events.
+     *
+     * \param [in] events The new event list.
+     */
+    void SetScheduler(Ptr<Scheduler> events);
+
+    /**
+     * Get the current time.
+     *
+     * \returns The time stamp of the last executed event.
+     */
+    uint64_t GetCurrentTs() const;
+    /**
+     * Set the clock, with no event pending before it.
+     *
+     * \param [in] ts The time stamp.
+     */
+    void SetCurrentTs(uint64_t ts);
+    /**
+     * Get the current context.
+     *
+     * \returns The context of the last executed event.
+     */
+    uint32_t GetContext() const;
+    /**
+     * Get the number of events executed.
+     *
+     * \returns The number of events.
+     */
+    uint64_t GetEventCount() const;
+    /**
+     * Get the next sequence number of the events sent to other logical
+     * processes.
+     *
+     * \returns The sequence number.
+     */
+    uint64_t NextSequence();
+
+  private:
+    /** An event in a mailbox. */
+    struct Message
+    {
+        Scheduler::Event ev; //!< The event, without its uid.
+        uint32_t sender;     //!< Index of the sending logical process.
+        uint64_t sequence;   //!< Order of the event among the ones of the sender.
+        Message* next;       //!< The message pushed before.
+    };
+
+    /**
+     * Insert an event, giving it a uid.
+     *
+     * \param [in,out] ev The event.
+     */
+    void DoInsert(Scheduler::Event& ev);
+
+    uint32_t m_id;             //!< Index of this logical process.
+    Ptr<Scheduler> m_events;   //!< The event list.
+    uint32_t m_uid;            //!< Next event unique id.
+    uint32_t m_currentUid;     //!< Unique id of the current event.
+    uint64_t m_currentTs;      //!< Time stamp of the current event.
+    uint32_t m_currentContext; //!< Context of the current event.
+    uint64_t m_eventCount;     //!< Number of events executed.
+    int m_unscheduledEvents;   //!< Number of events in the event list.
+    uint64_t m_sequence;       //!< Number of events sent to other logical processes.
+
+    /** Messages pushed by the other threads, on a cache line of their own. */
+    alignas(64) std::atomic<Message*> m_mailbox;
+    /** Messages popped from the mailbox, reused by Receive(). */
+    alignas(64) std::vector<Message*> m_received;
+};
+
+} // namespace ns3
+
+#endif /* NS3_LOGICAL_PROCESS_H */
@@ -0,0 +1,70 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MtpInterface.
+ */
+
+#include "mtp-interface.h"
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MtpInterface");
+
+MultithreadedSimulatorImpl* MtpInterface::g_impl = nullptr;
+
+void
+MtpInterface::Enable(uint32_t threads)
+{
+    NS_LOG_FUNCTION(threads);
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(threads));
+}
+
+bool
+MtpInterface::IsEnabled()
+{
+    return g_impl != nullptr;
+}
+
+Ptr<Packet>
+MtpInterface::CopyPacket(Ptr<const Packet> packet, uint32_t context)
+{
+    if (g_impl == nullptr || !g_impl->IsRemote(context))
+    {
+        return packet->Copy();
+    }
+    NS_LOG_FUNCTION(packet << context);
+    thread_local std::vector<uint8_t> buffer;
+    buffer.resize(packet->GetSerializedSize());
+    packet->Serialize(buffer.data(), buffer.size());
+    return Create<Packet>(buffer.data(), buffer.size(), true);
+}
+
+} // namespace ns3
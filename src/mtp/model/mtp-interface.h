@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MtpInterface.
+ */
+
+#ifndef NS3_MTP_INTERFACE_H
+#define NS3_MTP_INTERFACE_H
+
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+
+namespace ns3
+{
+/**
+ * \defgroup mtp Multithreaded Parallel Simulation
+ */
+
+class MultithreadedSimulatorImpl;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Entry points of the multithreaded parallel simulation.
+ */
+class MtpInterface
+{
+  public:
+    /**
+     * Select the MultithreadedSimulatorImpl.
+     *
+     * Equivalent to passing
+     * `--SimulatorImplementationType=ns3::MultithreadedSimulatorImpl`
+     * on the command line; to be called before any event is scheduled.
+     *
+     * \param [in] threads The largest number of threads, or zero for the
+     *             number of hardware threads.
+     */
+    static void Enable(uint32_t threads = 0);
+    /**
+     * Check whether a MultithreadedSimulatorImpl has partitioned the nodes.
+     *
+     * \returns \c true if the nodes run in logical processes.
+     */
+    static bool IsEnabled();
+    /**
+     * Copy a packet sent to a node.
+     *
+     * A copy shares its buffer, tags and metadata with the original until
+     * one of them is modified, and the reference counts of that shared
+     * data are not atomic: when the node is run by another thread than
+     * the current event, the copy is a deep one.
+     *
+     * \param [in] packet The packet.
+     * \param [in] context The node receiving the copy.
+     * \returns The copy.
+     */
+    static Ptr<Packet> CopyPacket(Ptr<const Packet> packet, uint32_t context);
+
+  private:
+    friend class MultithreadedSimulatorImpl;
+
+    /** The simulator implementation which partitioned the nodes. */
+    static MultithreadedSimulatorImpl* g_impl;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MTP_INTERFACE_H */
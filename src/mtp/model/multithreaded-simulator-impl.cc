@@ -0,0 +1,645 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "logical-process.h"
+#include "mtp-interface.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+namespace
+{
+
+/**
+ * \ingroup mtp
+ * The logical process run by the current thread, or \c nullptr outside
+ * of MultithreadedSimulatorImpl::Run(), for the global one.
+ */
+thread_local LogicalProcess* g_current = nullptr;
+
+/** Time stamp standing for an infinite time. */
+constexpr uint64_t MAX_TS = 0x7fffffffffffffffULL;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "Largest number of logical processes, each run by a thread. "
+                          "Zero for the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MinLookahead",
+                          "Smallest delay of a point-to-point link which may separate two "
+                          "logical processes. Zero for the largest delay of the links.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&MultithreadedSimulatorImpl::m_minLookahead),
+                          MakeTimeChecker(Seconds(0)));
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_schedulerFactory.SetTypeId("ns3::MapScheduler");
+    m_lps.emplace_back(new LogicalProcess(0, m_schedulerFactory.Create<Scheduler>()));
+    m_partitioned = false;
+    m_maxThreads = 0;
+    m_lookahead = MAX_TS;
+    m_windowEnd = 0;
+    m_windows = 0;
+    m_parallel = false;
+    m_stop = false;
+    m_stopTs = MAX_TS;
+    m_exit = false;
+    m_threads = 1;
+    m_arrived = 0;
+    m_barrier = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    if (MtpInterface::g_impl == this)
+    {
+        MtpInterface::g_impl = nullptr;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_lps.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+    if (MtpInterface::g_impl == this)
+    {
+        MtpInterface::g_impl = nullptr;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+    m_partitioned = true;
+    MtpInterface::g_impl = this;
+
+    uint32_t nodes = NodeList::GetNNodes();
+    std::vector<uint32_t> parent(nodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t node) {
+        while (parent[node] != node)
+        {
+            parent[node] = parent[parent[node]];
+            node = parent[node];
+        }
+        return node;
+    };
+    auto join = [&parent, &find](uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        parent[std::max(a, b)] = std::min(a, b);
+    };
+
+    // Only point-to-point links have their state split by direction, so
+    // only they may join two threads; their delay is the lookahead.
+    struct Link
+    {
+        uint32_t a;  //!< Node at one end.
+        uint32_t b;  //!< Node at the other end.
+        Time delay; //!< Delay of the link.
+    };
+
+    std::vector<Link> links;
+    Time largest;
+    for (auto i = ChannelList::Begin(); i != ChannelList::End(); ++i)
+    {
+        Ptr<Channel> channel = *i;
+        std::size_t n = channel->GetNDevices();
+        TimeValue delay;
+        bool pointToPoint = n == 2 && channel->GetAttributeFailSafe("Delay", delay) &&
+                            delay.Get().IsStrictlyPositive();
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            pointToPoint = pointToPoint && channel->GetDevice(j)->IsPointToPoint();
+        }
+        if (pointToPoint)
+        {
+            links.push_back({channel->GetDevice(0)->GetNode()->GetId(),
+                             channel->GetDevice(1)->GetNode()->GetId(),
+                             delay.Get()});
+            largest = Max(largest, delay.Get());
+            continue;
+        }
+        for (std::size_t j = 1; j < n; ++j)
+        {
+            join(channel->GetDevice(0)->GetNode()->GetId(),
+                 channel->GetDevice(j)->GetNode()->GetId());
+        }
+    }
+    Time threshold = m_minLookahead.IsStrictlyPositive() ? m_minLookahead : largest;
+    for (const auto& link : links)
+    {
+        if (link.delay < threshold)
+        {
+            join(link.a, link.b);
+        }
+    }
+
+    // Balance the groups of nodes over the logical processes, largest first
+    std::map<uint32_t, std::vector<uint32_t>> groups;
+    for (uint32_t node = 0; node < nodes; ++node)
+    {
+        groups[find(node)].push_back(node);
+    }
+    std::vector<const std::vector<uint32_t>*> sorted;
+    for (const auto& group : groups)
+    {
+        sorted.push_back(&group.second);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+        return a->size() > b->size();
+    });
+    uint32_t threads = m_maxThreads > 0 ? m_maxThreads : std::thread::hardware_concurrency();
+    uint32_t count = std::max<std::size_t>(1, std::min<std::size_t>(threads, groups.size()));
+    std::vector<std::size_t> load(count, 0);
+    m_nodeLps.assign(nodes, 0);
+    for (const auto* group : sorted)
+    {
+        std::size_t lightest = std::min_element(load.begin(), load.end()) - load.begin();
+        for (uint32_t node : *group)
+        {
+            m_nodeLps[node] = lightest + 1;
+        }
+        load[lightest] += group->size();
+    }
+
+    uint64_t now = m_lps[0]->GetCurrentTs();
+    for (uint32_t i = 1; i <= count; ++i)
+    {
+        m_lps.emplace_back(new LogicalProcess(i, m_schedulerFactory.Create<Scheduler>()));
+        m_lps.back()->SetCurrentTs(now);
+    }
+
+    m_lookahead = MAX_TS;
+    for (const auto& link : links)
+    {
+        if (m_nodeLps[link.a] != m_nodeLps[link.b])
+        {
+            m_lookahead = std::min<uint64_t>(m_lookahead, link.delay.GetTimeStep());
+        }
+    }
+
+    // The events of the nodes scheduled so far leave the global logical process
+    std::vector<Scheduler::Event> events;
+    m_lps[0]->TakeEvents(events);
+    for (const auto& ev : events)
+    {
+        GetOwner(ev.key.m_context)->Adopt(ev);
+    }
+
+    NS_LOG_INFO(nodes << " nodes in " << groups.size() << " groups, " << count
+                      << " logical processes, lookahead " << GetLookahead());
+}
+
+void
+MultithreadedSimulatorImpl::Synchronize()
+{
+    if (m_threads <= 1)
+    {
+        return;
+    }
+    uint32_t barrier = m_barrier.load(std::memory_order_acquire);
+    if (m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threads)
+    {
+        m_arrived.store(0, std::memory_order_relaxed);
+        m_barrier.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    // Windows are short: spin first, then leave the core to the threads
+    // still running theirs.
+    for (uint32_t spins = 0; m_barrier.load(std::memory_order_acquire) == barrier; ++spins)
+    {
+        if (spins >= 1000)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(LogicalProcess* lp)
+{
+    while (lp->GetNextTs() < m_windowEnd)
+    {
+        lp->ProcessOneEvent();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Work(LogicalProcess* lp)
+{
+    g_current = lp;
+    while (true)
+    {
+        Synchronize();
+        if (m_exit)
+        {
+            break;
+        }
+        ProcessWindow(lp);
+        Synchronize();
+        lp->Receive();
+        Synchronize();
+    }
+    g_current = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_partitioned)
+    {
+        Partition();
+    }
+    m_stop = false;
+    m_exit = false;
+    m_threads = m_lps.size() - 1;
+
+    LogicalProcess* global = m_lps[0].get();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 2; i < m_lps.size(); ++i)
+    {
+        threads.emplace_back(&MultithreadedSimulatorImpl::Work, this, m_lps[i].get());
+    }
+
+    while (!m_stop)
+    {
+        uint64_t next = MAX_TS;
+        for (std::size_t i = 1; i < m_lps.size(); ++i)
+        {
+            next = std::min(next, m_lps[i]->GetNextTs());
+        }
+        uint64_t globalNext = global->GetNextTs();
+        uint64_t stopTs = m_stopTs;
+        if (std::min(next, globalNext) >= stopTs)
+        {
+            if (stopTs != MAX_TS)
+            {
+                global->SetCurrentTs(stopTs);
+                m_stopTs = MAX_TS;
+            }
+            break;
+        }
+
+        // Global events run alone, before the node events of the same time
+        if (globalNext <= next)
+        {
+            g_current = global;
+            global->ProcessOneEvent();
+            continue;
+        }
+
+        m_windowEnd = std::min({globalNext, stopTs, next + std::min(m_lookahead, MAX_TS - next)});
+        m_windows++;
+        m_parallel = true;
+        Synchronize();
+        g_current = m_lps[1].get();
+        ProcessWindow(m_lps[1].get());
+        Synchronize();
+        global->Receive();
+        m_lps[1]->Receive();
+        Synchronize();
+        m_parallel = false;
+    }
+
+    m_exit = true;
+    Synchronize();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    g_current = nullptr;
+
+    // Simulator::Now() from the main thread is the time the run ended at
+    uint64_t now = global->GetCurrentTs();
+    for (std::size_t i = 1; i < m_lps.size(); ++i)
+    {
+        now = std::max(now, m_lps[i]->GetCurrentTs());
+    }
+    global->SetCurrentTs(std::min(now, global->GetNextTs()));
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetCurrent() const
+{
+    return g_current != nullptr ? g_current : m_lps[0].get();
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetOwner(uint32_t context) const
+{
+    if (context < m_nodeLps.size())
+    {
+        return m_lps[m_nodeLps[context]].get();
+    }
+    return m_lps[0].get();
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetEventOwner(const EventId& id) const
+{
+    LogicalProcess* owner = GetOwner(id.GetContext());
+    NS_ABORT_MSG_IF(m_parallel && owner != GetCurrent(),
+                    "Event " << id.GetUid() << " of context " << id.GetContext()
+                             << " belongs to the thread of another logical process");
+    return owner;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    for (const auto& lp : m_lps)
+    {
+        if (!lp->IsEmpty())
+        {
+            return m_stop;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    uint64_t ts = GetCurrent()->GetCurrentTs() + delay.GetTimeStep();
+    uint64_t stopTs = m_stopTs.load(std::memory_order_relaxed);
+    while (ts < stopTs &&
+           !m_stopTs.compare_exchange_weak(stopTs, ts, std::memory_order_relaxed))
+    {
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    LogicalProcess* lp = GetCurrent();
+
+    Time tAbsolute = delay + TimeStep(lp->GetCurrentTs());
+    NS_ASSERT_MSG(tAbsolute >= TimeStep(lp->GetCurrentTs()), "Negative delay " << delay);
+    return lp->Insert(tAbsolute.GetTimeStep(), lp->GetContext(), event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+    LogicalProcess* current = GetCurrent();
+    LogicalProcess* owner = GetOwner(context);
+    uint64_t ts = current->GetCurrentTs() + delay.GetTimeStep();
+
+    // Between windows the other threads wait: no need for the mailbox
+    if (owner == current || !m_parallel)
+    {
+        owner->Insert(ts, context, event);
+        return;
+    }
+    NS_ABORT_MSG_IF(ts < m_windowEnd,
+                    "Event for node " << context << " at " << TimeStep(ts)
+                                      << " is within the lookahead of logical process "
+                                      << current->GetId() << " (" << GetLookahead()
+                                      << "): nodes of different logical processes must "
+                                         "only interact through their links");
+    owner->Send(ts, context, event, current->GetId(), current->NextSequence());
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+    EventId id(Ptr<EventImpl>(event, false), GetCurrent()->GetCurrentTs(), 0xffffffff, 2);
+    std::unique_lock lock{m_destroyMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    return TimeStep(GetCurrent()->GetCurrentTs());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    return TimeStep(id.GetTs() - GetCurrent()->GetCurrentTs());
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    GetEventOwner(id)->Remove(id);
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyMutex};
+        return std::find(m_destroyEvents.begin(), m_destroyEvents.end(), id) ==
+               m_destroyEvents.end();
+    }
+    return GetEventOwner(id)->IsExpired(id);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(MAX_TS);
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (const auto& lp : m_lps)
+    {
+        lp->SetScheduler(m_schedulerFactory.Create<Scheduler>());
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrent()->GetContext();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& lp : m_lps)
+    {
+        count += lp->GetEventCount();
+    }
+    return count;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcessCount() const
+{
+    return m_lps.size() - 1;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcess(uint32_t context) const
+{
+    return GetOwner(context)->GetId();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return TimeStep(m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount() const
+{
+    return m_windows;
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemote(uint32_t context) const
+{
+    return m_partitioned && GetOwner(context) != GetCurrent();
+}
+
+} // namespace ns3
@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+class LogicalProcess;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Conservative parallel simulation on the threads of one process.
+ *
+ * At the first Run(), the nodes are partitioned into logical processes:
+ * the ends of every link which is not a point-to-point link with a delay
+ * of at least MinLookahead are kept together, and the resulting groups
+ * are balanced over at most MaxThreads logical processes.  Each logical
+ * process has its own event list and clock and is run by its own thread.
+ *
+ * The simulation advances by windows.  A window starts at the time of the
+ * earliest pending event and lasts the lookahead, the smallest delay of
+ * the links between two logical processes: an event executed in a window
+ * can only schedule an event for another logical process after the end
+ * of the window, so the logical processes run the window in parallel.
+ * Such events go through the lock-free mailbox of their destination and
+ * enter its event list when the window is over.
+ *
+ * Events with no node context, and the ones of the nodes created after
+ * the first Run(), belong to a global logical process.  Its events run
+ * alone, between windows, so they may touch any node.
+ *
+ * As with the DistributedSimulatorImpl, nodes must only interact through
+ * their links, and an event may not be scheduled for a node of another
+ * logical process sooner than the lookahead; this is checked.
+ *
+ * Requires a build with NS3_MTP, which makes the reference counts atomic
+ * and the packet free lists local to a thread.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Default constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Get the number of logical processes running nodes, known after the
+     * first Run().
+     *
+     * \returns The number of logical processes, and of threads.
+     */
+    uint32_t GetLogicalProcessCount() const;
+    /**
+     * Get the logical process of a context.
+     *
+     * \param [in] context The context, a node id.
+     * \returns The index of the logical process, from 1, or 0 for the
+     *          global logical process.
+     */
+    uint32_t GetLogicalProcess(uint32_t context) const;
+    /**
+     * Get the lookahead, known after the first Run().
+     *
+     * \returns The smallest delay between two logical processes.
+     */
+    Time GetLookahead() const;
+    /**
+     * Get the number of windows run in parallel.
+     *
+     * \returns The number of windows.
+     */
+    uint64_t GetWindowCount() const;
+    /**
+     * Check whether the events of a context run in another thread than
+     * the current event.
+     *
+     * \param [in] context The context.
+     * \returns \c true if the context belongs to another logical process
+     *          and the logical processes are running in parallel.
+     */
+    bool IsRemote(uint32_t context) const;
+
+  private:
+    // Inherited from Object
+    void DoDispose() override;
+
+    /** Partition the nodes into logical processes and compute the lookahead. */
+    void Partition();
+    /**
+     * Body of the thread running a logical process.
+     *
+     * \param [in] lp The logical process.
+     */
+    void Work(LogicalProcess* lp);
+    /**
+     * Run the events of a logical process before the end of the window.
+     *
+     * \param [in] lp The logical process.
+     */
+    void ProcessWindow(LogicalProcess* lp);
+    /** Wait for all the threads to reach this point. */
+    void Synchronize();
+
+    /**
+     * Get the logical process of the current thread.
+     *
+     * \returns The logical process.
+     */
+    LogicalProcess* GetCurrent() const;
+    /**
+     * Get the logical process holding the events of a context.
+     *
+     * \param [in] context The context.
+     * \returns The logical process.
+     */
+    LogicalProcess* GetOwner(uint32_t context) const;
+    /**
+     * Get the logical process of an event, checking that the current
+     * thread may access it.
+     *
+     * \param [in] id The event.
+     * \returns The logical process.
+     */
+    LogicalProcess* GetEventOwner(const EventId& id) const;
+
+    /** Container type for the events to run at Simulator::Destroy(). */
+    typedef std::list<EventId> DestroyEvents;
+
+    /** The events to run at Simulator::Destroy(). */
+    DestroyEvents m_destroyEvents;
+    /** Protects m_destroyEvents. */
+    mutable std::mutex m_destroyMutex;
+
+    /** The logical processes, the global one first. */
+    std::vector<std::unique_ptr<LogicalProcess>> m_lps;
+    /** Index of the logical process of each node, at the partition. */
+    std::vector<uint32_t> m_nodeLps;
+    /** Whether the nodes have been partitioned. */
+    bool m_partitioned;
+    /** The scheduler factory. */
+    ObjectFactory m_schedulerFactory;
+
+    uint32_t m_maxThreads; //!< Largest number of logical processes.
+    Time m_minLookahead;   //!< Smallest delay of a link between logical processes.
+    uint64_t m_lookahead;  //!< Window size.
+    uint64_t m_windowEnd;  //!< End of the current window.
+    uint64_t m_windows;    //!< Number of windows run.
+    bool m_parallel;       //!< Whether the logical processes run in parallel.
+
+    std::atomic<bool> m_stop;       //!< Stop at the end of the window.
+    std::atomic<uint64_t> m_stopTs; //!< Run no event at or after this time.
+    bool m_exit;                    //!< Make the worker threads exit.
+
+    uint32_t m_threads;                //!< Number of threads taking part in a window.
+    std::atomic<uint32_t> m_arrived;   //!< Threads waiting at the barrier.
+    std::atomic<uint32_t> m_barrier;   //!< Number of barriers passed.
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,296 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/default-simulator-impl.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded parallel simulation tests
+ */
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Build two lines of three nodes, joined by a slow core link:
+ *
+ *     0 --1ms-- 1 --1ms-- 2 ==10ms== 3 --1ms-- 4 --1ms-- 5
+ */
+void
+BuildTopology()
+{
+    NodeContainer nodes;
+    nodes.Create(6);
+
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    for (uint32_t i = 0; i + 1 < nodes.GetN(); ++i)
+    {
+        helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(i == 2 ? 10 : 1)));
+        helper.Install(NodeContainer(nodes.Get(i), nodes.Get(i + 1)));
+    }
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check the partition of the nodes into logical processes.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+  public:
+    MtpPartitionTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Partition the topology.
+     *
+     * \param [in] threads The largest number of logical processes.
+     * \returns The simulator, after the partition.
+     */
+    Ptr<MultithreadedSimulatorImpl> Partition(uint32_t threads);
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase()
+    : TestCase("Partition the nodes along the point-to-point links")
+{
+}
+
+Ptr<MultithreadedSimulatorImpl>
+MtpPartitionTestCase::Partition(uint32_t threads)
+{
+    Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl>();
+    impl->SetAttribute("MaxThreads", UintegerValue(threads));
+    Simulator::SetImplementation(impl);
+    BuildTopology();
+    Simulator::Run();
+    return impl;
+}
+
+void
+MtpPartitionTestCase::DoRun()
+{
+    Ptr<MultithreadedSimulatorImpl> impl = Partition(2);
+    NS_TEST_ASSERT_MSG_EQ(impl->GetLogicalProcessCount(), 2, "two logical processes");
+    for (uint32_t node = 1; node < 3; ++node)
+    {
+        NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcess(node),
+                              impl->GetLogicalProcess(0),
+                              "node " << node << " is on the side of node 0");
+        NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcess(node + 3),
+                              impl->GetLogicalProcess(3),
+                              "node " << node + 3 << " is on the side of node 3");
+    }
+    NS_TEST_EXPECT_MSG_NE(impl->GetLogicalProcess(0),
+                          impl->GetLogicalProcess(3),
+                          "the core link separates the logical processes");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcess(Simulator::NO_CONTEXT),
+                          0,
+                          "events with no context are global");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(10), "lookahead of the core link");
+    Simulator::Destroy();
+
+    impl = Partition(1);
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcessCount(), 1, "one logical process");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLogicalProcess(0),
+                          impl->GetLogicalProcess(5),
+                          "all the nodes together");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check that tokens passed between the nodes run the same events as with
+ * the DefaultSimulatorImpl.
+ *
+ * The events only log themselves, in the log of their node: the test
+ * macros are not safe to use from the threads of the logical processes.
+ */
+class MtpEventsTestCase : public TestCase
+{
+  public:
+    MtpEventsTestCase();
+
+  private:
+    /** An executed event: time, context and token. */
+    typedef std::tuple<int64_t, uint32_t, uint32_t> Entry;
+
+    void DoRun() override;
+    /**
+     * Run the tokens.
+     *
+     * \param [in] impl The simulator implementation.
+     */
+    void RunTokens(Ptr<SimulatorImpl> impl);
+    /**
+     * Log a token and pass it to a neighbour.
+     *
+     * \param [in] node The node holding the token.
+     * \param [in] token The token.
+     * \param [in] forward Whether the token goes towards the higher node ids.
+     */
+    void Hop(uint32_t node, uint32_t token, bool forward);
+    /**
+     * Log a token, scheduled within a node.
+     *
+     * \param [in] node The node holding the token.
+     * \param [in] token The token.
+     */
+    void Local(uint32_t node, uint32_t token);
+    /** Count the events run so far, with no node context. */
+    void Snapshot();
+
+    std::vector<std::vector<Entry>> m_logs; //!< Events executed by each node.
+    uint32_t m_snapshot;                    //!< Events counted by Snapshot().
+};
+
+MtpEventsTestCase::MtpEventsTestCase()
+    : TestCase("Run the same events as the DefaultSimulatorImpl")
+{
+}
+
+void
+MtpEventsTestCase::Hop(uint32_t node, uint32_t token, bool forward)
+{
+    m_logs[node].emplace_back(Simulator::Now().GetTimeStep(), Simulator::GetContext(), token);
+    Simulator::Schedule(MicroSeconds(500), &MtpEventsTestCase::Local, this, node, token);
+
+    if ((forward && node + 1 == m_logs.size()) || (!forward && node == 0))
+    {
+        forward = !forward;
+    }
+    uint32_t next = forward ? node + 1 : node - 1;
+    Time delay = MilliSeconds(std::min(node, next) == 2 ? 10 : 1);
+    Simulator::ScheduleWithContext(next,
+                                   delay,
+                                   &MtpEventsTestCase::Hop,
+                                   this,
+                                   next,
+                                   token,
+                                   forward);
+}
+
+void
+MtpEventsTestCase::Local(uint32_t node, uint32_t token)
+{
+    m_logs[node].emplace_back(Simulator::Now().GetTimeStep(),
+                              Simulator::GetContext(),
+                              token + 1000);
+}
+
+void
+MtpEventsTestCase::Snapshot()
+{
+    m_snapshot = 0;
+    for (const auto& log : m_logs)
+    {
+        m_snapshot += log.size();
+    }
+}
+
+void
+MtpEventsTestCase::RunTokens(Ptr<SimulatorImpl> impl)
+{
+    Simulator::SetImplementation(impl);
+    BuildTopology();
+    m_logs.assign(6, {});
+    m_snapshot = 0;
+    for (uint32_t node = 0; node < m_logs.size(); ++node)
+    {
+        Simulator::ScheduleWithContext(node,
+                                       MicroSeconds(250 * node),
+                                       &MtpEventsTestCase::Hop,
+                                       this,
+                                       node,
+                                       node,
+                                       node % 2 == 0);
+    }
+    Simulator::Schedule(MicroSeconds(25100), &MtpEventsTestCase::Snapshot, this);
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MilliSeconds(100), "stopped at the stop time");
+    for (auto& log : m_logs)
+    {
+        std::sort(log.begin(), log.end());
+    }
+}
+
+void
+MtpEventsTestCase::DoRun()
+{
+    RunTokens(CreateObject<DefaultSimulatorImpl>());
+    std::vector<std::vector<Entry>> expected = m_logs;
+    uint32_t snapshot = m_snapshot;
+    NS_TEST_ASSERT_MSG_GT(snapshot, 0, "tokens passed before the snapshot");
+    Simulator::Destroy();
+
+    Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl>();
+    impl->SetAttribute("MaxThreads", UintegerValue(2));
+    RunTokens(impl);
+    NS_TEST_EXPECT_MSG_GT(impl->GetWindowCount(), 0, "windows run in parallel");
+    NS_TEST_EXPECT_MSG_EQ(m_snapshot, snapshot, "global event between the windows");
+    for (uint32_t node = 0; node < m_logs.size(); ++node)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_logs[node].size(),
+                              expected[node].size(),
+                              "events of node " << node);
+        NS_TEST_EXPECT_MSG_EQ((m_logs[node] == expected[node]), true, "events of node " << node);
+    }
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite();
+};
+
+MtpTestSuite::MtpTestSuite()
+    : TestSuite("mtp", UNIT)
+{
+    AddTestCase(new MtpPartitionTestCase(), TestCase::QUICK);
+    AddTestCase(new MtpEventsTestCase(), TestCase::QUICK);
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
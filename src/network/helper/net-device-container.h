@@ -196,6 +196,16 @@ class NetDeviceContainer
      */
     void Add(std::string deviceName);
 
+    /**
+     * \brief Reserve room for a number of devices
+     *
+     * Avoids reallocations when a large number of devices is added one at
+     * a time.
+     *
+     * \param n The total number of devices the container will hold.
+     */
+    void Reserve(uint32_t n);
+
   private:
     std::vector<Ptr<NetDevice>> m_devices; //!< NetDevices smart pointers
 };
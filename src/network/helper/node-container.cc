@@ -120,6 +120,12 @@ NodeContainer::Add(std::string nodeName)
     m_nodes.push_back(node);
 }
 
+void
+NodeContainer::Reserve(uint32_t n)
+{
+    m_nodes.reserve(n);
+}
+
 bool
 NodeContainer::Contains(uint32_t id) const
 {
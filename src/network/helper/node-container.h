@@ -269,6 +269,16 @@ class NodeContainer
      */
     bool Contains(uint32_t id) const;
 
+    /**
+     * \brief Reserve room for a number of nodes
+     *
+     * Avoids reallocations when a large number of nodes is added one at
+     * a time.
+     *
+     * \param n The total number of nodes the container will hold.
+     */
+    void Reserve(uint32_t n);
+
   private:
     std::vector<Ptr<Node>> m_nodes; //!< Nodes smart pointers
 };
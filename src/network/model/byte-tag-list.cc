@@ -24,7 +24,10 @@
 #include <limits>
 #include <vector>
 
+// The threads of the MultithreadedSimulatorImpl do not share a free list
+#ifndef NS3_MTP
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
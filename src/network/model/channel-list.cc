@@ -169,6 +169,7 @@ ChannelListPriv::DoDispose()
         *i = nullptr;
     }
     m_channels.erase(m_channels.begin(), m_channels.end());
+    Config::NotifyNamespaceChange();
     Object::DoDispose();
 }
 
@@ -178,6 +179,7 @@ ChannelListPriv::Add(Ptr<Channel> channel)
     NS_LOG_FUNCTION(this << channel);
     uint32_t index = m_channels.size();
     m_channels.push_back(channel);
+    Config::NotifyNamespaceChange();
     return index;
 }
 
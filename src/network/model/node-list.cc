@@ -172,6 +172,7 @@ NodeListPriv::DoDispose()
         *i = nullptr;
     }
     m_nodes.erase(m_nodes.begin(), m_nodes.end());
+    Config::NotifyNamespaceChange();
     Object::DoDispose();
 }
 
@@ -182,6 +183,7 @@ NodeListPriv::Add(Ptr<Node> node)
     uint32_t index = m_nodes.size();
     m_nodes.push_back(node);
     Simulator::ScheduleWithContext(index, TimeStep(0), &Node::Initialize, node);
+    Config::NotifyNamespaceChange();
     return index;
 }
 
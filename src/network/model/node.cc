@@ -26,6 +26,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/boolean.h"
+#include "ns3/config.h"
 #include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/object-vector.h"
@@ -145,6 +146,7 @@ Node::AddDevice(Ptr<NetDevice> device)
     device->SetReceiveCallback(MakeCallback(&Node::NonPromiscReceiveFromDevice, this));
     Simulator::ScheduleWithContext(GetId(), Seconds(0.0), &NetDevice::Initialize, device);
     NotifyDeviceAdded(device);
+    Config::NotifyNamespaceChange();
     return index;
 }
 
@@ -173,6 +175,7 @@ Node::AddApplication(Ptr<Application> application)
     m_applications.push_back(application);
     application->SetNode(this);
     Simulator::ScheduleWithContext(GetId(), Seconds(0.0), &Application::Initialize, application);
+    Config::NotifyNamespaceChange();
     return index;
 }
 
@@ -670,7 +670,11 @@ class PacketMetadata
      */
     static void Deallocate(struct PacketMetadata::Data* data);
 
+#ifdef NS3_MTP
+    static thread_local DataFreeList m_freeList; //!< the metadata data storage
+#else
     static DataFreeList m_freeList; //!< the metadata data storage
+#endif
     static bool m_enable;           //!< Enable the packet metadata
     static bool m_enableChecking;   //!< Enable the packet metadata checking
 
@@ -679,10 +683,17 @@ class PacketMetadata
      * m_enable is false; used to detect enabling of metadata in the
      * middle of a simulation, which isn't allowed.
      */
+#ifdef NS3_MTP
+    static thread_local bool m_metadataSkipped;
+
+    static thread_local uint32_t m_maxSize;  //!< maximum metadata size
+    static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
     static bool m_metadataSkipped;
 
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
     struct Data* m_data; //!< Metadata storage
     /*
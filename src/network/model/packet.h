@@ -36,6 +36,10 @@
 
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -797,7 +801,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -0,0 +1,118 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "point-to-point-bundle-channel.h"
+
+#include "point-to-point-bundle-net-device.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#ifdef NS3_MTP
+#include "ns3/mtp-interface.h"
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointBundleChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(PointToPointBundleChannel);
+
+TypeId
+PointToPointBundleChannel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PointToPointBundleChannel")
+            .SetParent<Channel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<PointToPointBundleChannel>()
+            .AddAttribute("Delay",
+                          "Propagation delay of the member links",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&PointToPointBundleChannel::m_delay),
+                          MakeTimeChecker());
+    return tid;
+}
+
+PointToPointBundleChannel::PointToPointBundleChannel()
+    : Channel(),
+      m_delay(Seconds(0)),
+      m_nDevices(0)
+{
+    NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+PointToPointBundleChannel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices[0] = nullptr;
+    m_devices[1] = nullptr;
+    Channel::DoDispose();
+}
+
+void
+PointToPointBundleChannel::Attach(Ptr<PointToPointBundleNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ASSERT_MSG(m_nDevices < 2, "Only two devices permitted");
+    NS_ASSERT(device);
+    m_devices[m_nDevices++] = device;
+}
+
+void
+PointToPointBundleChannel::TransmitStart(Ptr<const Packet> p,
+                                         Ptr<PointToPointBundleNetDevice> src,
+                                         Time txTime)
+{
+    NS_LOG_FUNCTION(this << p << src);
+    NS_ASSERT(m_nDevices == 2);
+
+    Ptr<PointToPointBundleNetDevice> dst = src == m_devices[0] ? m_devices[1] : m_devices[0];
+    uint32_t dstNode = dst->GetNode()->GetId();
+#ifdef NS3_MTP
+    Ptr<Packet> copy = MtpInterface::CopyPacket(p, dstNode);
+#else
+    Ptr<Packet> copy = p->Copy();
+#endif
+    Simulator::ScheduleWithContext(dstNode,
+                                   txTime + m_delay,
+                                   &PointToPointBundleNetDevice::Receive,
+                                   dst,
+                                   copy);
+}
+
+std::size_t
+PointToPointBundleChannel::GetNDevices() const
+{
+    return m_nDevices;
+}
+
+Ptr<NetDevice>
+PointToPointBundleChannel::GetDevice(std::size_t i) const
+{
+    NS_ASSERT(i < 2);
+    return m_devices[i];
+}
+
+Time
+PointToPointBundleChannel::GetDelay() const
+{
+    return m_delay;
+}
+
+} // namespace ns3
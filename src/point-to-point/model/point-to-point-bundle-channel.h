@@ -0,0 +1,83 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POINT_TO_POINT_BUNDLE_CHANNEL_H
+#define POINT_TO_POINT_BUNDLE_CHANNEL_H
+
+#include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3
+{
+
+class PointToPointBundleNetDevice;
+class Packet;
+
+/**
+ * \ingroup point-to-point
+ * \brief Channel of a bundle of parallel point-to-point links
+ *
+ * Connects two PointToPointBundleNetDevice. The member links of the bundle
+ * share the propagation delay of the channel; the devices serialize the
+ * packets of every member, the channel only delivers them to the peer.
+ */
+class PointToPointBundleChannel : public Channel
+{
+  public:
+    /**
+     * \brief Get the TypeId
+     *
+     * \return The TypeId for this class
+     */
+    static TypeId GetTypeId();
+
+    PointToPointBundleChannel();
+
+    /**
+     * \brief Attach a device to this channel
+     * \param device the device, at most two are attached
+     */
+    void Attach(Ptr<PointToPointBundleNetDevice> device);
+
+    /**
+     * \brief Transmit a packet to the peer of a device
+     * \param p the packet
+     * \param src the transmitting device
+     * \param txTime the serialization time of the packet on its member
+     */
+    void TransmitStart(Ptr<const Packet> p, Ptr<PointToPointBundleNetDevice> src, Time txTime);
+
+    std::size_t GetNDevices() const override;
+    Ptr<NetDevice> GetDevice(std::size_t i) const override;
+
+    /**
+     * \brief Get the propagation delay of the channel
+     * \returns the delay
+     */
+    Time GetDelay() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Time m_delay;                                   //!< propagation delay
+    Ptr<PointToPointBundleNetDevice> m_devices[2]; //!< attached devices
+    std::size_t m_nDevices;                         //!< number of attached devices
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_BUNDLE_CHANNEL_H */
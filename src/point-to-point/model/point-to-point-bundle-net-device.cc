@@ -0,0 +1,499 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "point-to-point-bundle-net-device.h"
+
+#include "point-to-point-bundle-channel.h"
+#include "ppp-header.h"
+
+#include "ns3/hash.h"
+#include "ns3/log.h"
+#include "ns3/mac48-address.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointBundleNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED(PointToPointBundleNetDevice);
+
+namespace
+{
+
+/// IPv4 in the PPP and Ethernet protocol numbers
+const uint16_t PPP_IPV4 = 0x0021;
+const uint16_t PPP_IPV6 = 0x0057;
+const uint16_t ETHER_IPV4 = 0x0800;
+const uint16_t ETHER_IPV6 = 0x86DD;
+
+} // namespace
+
+TypeId
+PointToPointBundleNetDevice::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PointToPointBundleNetDevice")
+            .SetParent<NetDevice>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<PointToPointBundleNetDevice>()
+            .AddAttribute("Mtu",
+                          "The MAC-level Maximum Transmission Unit",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&PointToPointBundleNetDevice::SetMtu,
+                                               &PointToPointBundleNetDevice::GetMtu),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("Address",
+                          "The MAC address of this device.",
+                          Mac48AddressValue(Mac48Address("ff:ff:ff:ff:ff:ff")),
+                          MakeMac48AddressAccessor(&PointToPointBundleNetDevice::m_address),
+                          MakeMac48AddressChecker())
+            .AddAttribute("DataRate",
+                          "The data rate of every member link",
+                          DataRateValue(DataRate("32768b/s")),
+                          MakeDataRateAccessor(&PointToPointBundleNetDevice::m_bps),
+                          MakeDataRateChecker())
+            .AddAttribute("InterframeGap",
+                          "The time to wait between packet transmissions of a member",
+                          TimeValue(Seconds(0.0)),
+                          MakeTimeAccessor(&PointToPointBundleNetDevice::m_tInterframeGap),
+                          MakeTimeChecker())
+            .AddAttribute("Members",
+                          "The number of member links",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PointToPointBundleNetDevice::SetNMembers,
+                                               &PointToPointBundleNetDevice::GetNMembers),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxPackets",
+                          "The number of packets a member queues",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&PointToPointBundleNetDevice::m_maxPackets),
+                          MakeUintegerChecker<uint32_t>())
+            .AddTraceSource("MacTx",
+                            "Trace source indicating a packet has arrived "
+                            "for transmission by this device",
+                            MakeTraceSourceAccessor(&PointToPointBundleNetDevice::m_macTxTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("MacTxDrop",
+                            "Trace source indicating a packet has been dropped "
+                            "by the device because the queue of its member was full",
+                            MakeTraceSourceAccessor(&PointToPointBundleNetDevice::m_macTxDropTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("MacRx",
+                            "A packet has been received by this device, "
+                            "has been passed up from the physical layer "
+                            "and is being forwarded up the local protocol stack.",
+                            MakeTraceSourceAccessor(&PointToPointBundleNetDevice::m_macRxTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+PointToPointBundleNetDevice::PointToPointBundleNetDevice()
+    : m_channel(nullptr),
+      m_node(nullptr),
+      m_ifIndex(0),
+      m_mtu(1500),
+      m_linkUp(false),
+      m_bps(DataRate("32768b/s")),
+      m_tInterframeGap(Seconds(0)),
+      m_nMembers(1),
+      m_maxPackets(100),
+      m_members(1, Member{{}, false, 0})
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PointToPointBundleNetDevice::~PointToPointBundleNetDevice()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PointToPointBundleNetDevice::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_node = nullptr;
+    m_channel = nullptr;
+    m_members.clear();
+    m_rxCallback = MakeNullCallback<bool,
+                                    Ptr<NetDevice>,
+                                    Ptr<const Packet>,
+                                    uint16_t,
+                                    const Address&>();
+    m_promiscCallback = MakeNullCallback<bool,
+                                         Ptr<NetDevice>,
+                                         Ptr<const Packet>,
+                                         uint16_t,
+                                         const Address&,
+                                         const Address&,
+                                         enum PacketType>();
+    NetDevice::DoDispose();
+}
+
+bool
+PointToPointBundleNetDevice::Attach(Ptr<PointToPointBundleChannel> ch)
+{
+    NS_LOG_FUNCTION(this << &ch);
+    m_channel = ch;
+    m_channel->Attach(this);
+
+    // as PointToPointNetDevice, the device is up once attached
+    m_linkUp = true;
+    m_linkChangeCallbacks();
+    return true;
+}
+
+void
+PointToPointBundleNetDevice::SetNMembers(uint32_t members)
+{
+    NS_LOG_FUNCTION(this << members);
+    for (uint32_t i = members; i < m_members.size(); i++)
+    {
+        NS_ASSERT_MSG(!m_members[i].busy && m_members[i].queue.empty(),
+                      "Removing member " << i << " while it sends packets");
+    }
+    m_nMembers = members;
+    m_members.resize(m_nMembers, Member{{}, false, 0});
+}
+
+uint32_t
+PointToPointBundleNetDevice::GetNMembers() const
+{
+    return m_nMembers;
+}
+
+uint64_t
+PointToPointBundleNetDevice::GetMemberTxPackets(uint32_t member) const
+{
+    NS_ASSERT(member < m_members.size());
+    return m_members[member].txPackets;
+}
+
+// The member is a function of the flow only, so every packet of a flow is
+// sent on the same member without keeping any per-flow state.
+uint32_t
+PointToPointBundleNetDevice::SelectMember(Ptr<const Packet> p, uint16_t protocolNumber) const
+{
+    if (m_nMembers == 1)
+    {
+        return 0;
+    }
+
+    // protocol, addresses and ports of an IPv4 packet, the ports follow
+    // the options (at most 40 bytes). For IPv6 the next header, addresses,
+    // flow label and the ports following the fixed header.
+    uint8_t key[40] = {0};
+    uint32_t keySize = 0;
+    uint8_t header[64];
+    uint32_t copied = 0;
+    if (protocolNumber == ETHER_IPV4 || protocolNumber == ETHER_IPV6)
+    {
+        copied = p->CopyData(header, sizeof(header));
+    }
+    if (protocolNumber == ETHER_IPV4 && copied >= 20)
+    {
+        uint32_t ihl = (header[0] & 0x0f) * 4;
+        uint8_t protocol = header[9];
+        key[0] = protocol;
+        std::memcpy(key + 1, header + 12, 8);
+        keySize = 9;
+
+        // only the first fragment holds the ports, fragments hash on the
+        // addresses so that they all take the same member
+        bool fragment = (header[6] & 0x3f) != 0 || header[7] != 0;
+        if ((protocol == 6 || protocol == 17) && !fragment && ihl >= 20 && copied >= ihl + 4)
+        {
+            std::memcpy(key + 9, header + ihl, 4);
+            keySize = 13;
+        }
+    }
+    else if (protocolNumber == ETHER_IPV6 && copied >= 40)
+    {
+        uint8_t nextHeader = header[6];
+        key[0] = nextHeader;
+        std::memcpy(key + 1, header + 8, 32);
+        key[33] = header[1] & 0x0f;
+        key[34] = header[2];
+        key[35] = header[3];
+        keySize = 36;
+
+        // behind extension headers, the flow label tells the flows apart
+        if ((nextHeader == 6 || nextHeader == 17) && copied >= 44)
+        {
+            std::memcpy(key + 36, header + 40, 4);
+            keySize = 40;
+        }
+    }
+    else
+    {
+        key[0] = protocolNumber >> 8;
+        key[1] = protocolNumber & 0xff;
+        keySize = 2;
+    }
+
+    return Hash32(reinterpret_cast<const char*>(key), keySize) % m_nMembers;
+}
+
+bool
+PointToPointBundleNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
+
+    if (!IsLinkUp())
+    {
+        m_macTxDropTrace(packet);
+        return false;
+    }
+
+    uint32_t member = SelectMember(packet, protocolNumber);
+
+    PppHeader ppp;
+    NS_ASSERT_MSG(protocolNumber == ETHER_IPV4 || protocolNumber == ETHER_IPV6,
+                  "PPP Protocol number not defined!");
+    ppp.SetProtocol(protocolNumber == ETHER_IPV4 ? PPP_IPV4 : PPP_IPV6);
+    packet->AddHeader(ppp);
+
+    m_macTxTrace(packet);
+
+    Member& m = m_members[member];
+    if (!m.busy)
+    {
+        TransmitStart(member, packet);
+        return true;
+    }
+    if (m.queue.size() >= m_maxPackets)
+    {
+        NS_LOG_LOGIC("Member " << member << " queue full, dropping " << packet->GetUid());
+        m_macTxDropTrace(packet);
+        return false;
+    }
+    m.queue.push_back(packet);
+    return true;
+}
+
+bool
+PointToPointBundleNetDevice::SendFrom(Ptr<Packet> packet,
+                                      const Address& source,
+                                      const Address& dest,
+                                      uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << source << dest << protocolNumber);
+    return false;
+}
+
+void
+PointToPointBundleNetDevice::TransmitStart(uint32_t member, Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << member << p);
+    Member& m = m_members[member];
+    NS_ASSERT(!m.busy);
+    m.busy = true;
+    m.txPackets++;
+
+    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
+    Simulator::Schedule(txTime + m_tInterframeGap,
+                        &PointToPointBundleNetDevice::TransmitComplete,
+                        this,
+                        member);
+    m_channel->TransmitStart(p, this, txTime);
+}
+
+void
+PointToPointBundleNetDevice::TransmitComplete(uint32_t member)
+{
+    NS_LOG_FUNCTION(this << member);
+    Member& m = m_members[member];
+    m.busy = false;
+    if (!m.queue.empty())
+    {
+        Ptr<Packet> p = m.queue.front();
+        m.queue.pop_front();
+        TransmitStart(member, p);
+    }
+}
+
+void
+PointToPointBundleNetDevice::Receive(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    Ptr<Packet> originalPacket = packet->Copy();
+
+    PppHeader ppp;
+    packet->RemoveHeader(ppp);
+    uint16_t protocol = ppp.GetProtocol() == PPP_IPV4 ? ETHER_IPV4 : ETHER_IPV6;
+
+    if (!m_promiscCallback.IsNull())
+    {
+        m_promiscCallback(this, packet, protocol, GetRemote(), GetAddress(), NetDevice::PACKET_HOST);
+    }
+
+    m_macRxTrace(originalPacket);
+    m_rxCallback(this, packet, protocol, GetRemote());
+}
+
+Address
+PointToPointBundleNetDevice::GetRemote() const
+{
+    NS_ASSERT(m_channel->GetNDevices() == 2);
+    for (std::size_t i = 0; i < m_channel->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> tmp = m_channel->GetDevice(i);
+        if (tmp != this)
+        {
+            return tmp->GetAddress();
+        }
+    }
+    NS_ASSERT(false);
+    return Address();
+}
+
+void
+PointToPointBundleNetDevice::SetIfIndex(const uint32_t index)
+{
+    m_ifIndex = index;
+}
+
+uint32_t
+PointToPointBundleNetDevice::GetIfIndex() const
+{
+    return m_ifIndex;
+}
+
+Ptr<Channel>
+PointToPointBundleNetDevice::GetChannel() const
+{
+    return m_channel;
+}
+
+void
+PointToPointBundleNetDevice::SetAddress(Address address)
+{
+    m_address = Mac48Address::ConvertFrom(address);
+}
+
+Address
+PointToPointBundleNetDevice::GetAddress() const
+{
+    return m_address;
+}
+
+bool
+PointToPointBundleNetDevice::SetMtu(uint16_t mtu)
+{
+    m_mtu = mtu;
+    return true;
+}
+
+uint16_t
+PointToPointBundleNetDevice::GetMtu() const
+{
+    return m_mtu;
+}
+
+bool
+PointToPointBundleNetDevice::IsLinkUp() const
+{
+    return m_linkUp;
+}
+
+void
+PointToPointBundleNetDevice::AddLinkChangeCallback(Callback<void> callback)
+{
+    m_linkChangeCallbacks.ConnectWithoutContext(callback);
+}
+
+bool
+PointToPointBundleNetDevice::IsBroadcast() const
+{
+    return true;
+}
+
+Address
+PointToPointBundleNetDevice::GetBroadcast() const
+{
+    return Mac48Address("ff:ff:ff:ff:ff:ff");
+}
+
+bool
+PointToPointBundleNetDevice::IsMulticast() const
+{
+    return true;
+}
+
+Address
+PointToPointBundleNetDevice::GetMulticast(Ipv4Address multicastGroup) const
+{
+    return Mac48Address("01:00:5e:00:00:00");
+}
+
+Address
+PointToPointBundleNetDevice::GetMulticast(Ipv6Address addr) const
+{
+    return Mac48Address("33:33:00:00:00:00");
+}
+
+bool
+PointToPointBundleNetDevice::IsPointToPoint() const
+{
+    return true;
+}
+
+bool
+PointToPointBundleNetDevice::IsBridge() const
+{
+    return false;
+}
+
+Ptr<Node>
+PointToPointBundleNetDevice::GetNode() const
+{
+    return m_node;
+}
+
+void
+PointToPointBundleNetDevice::SetNode(Ptr<Node> node)
+{
+    m_node = node;
+}
+
+bool
+PointToPointBundleNetDevice::NeedsArp() const
+{
+    return false;
+}
+
+void
+PointToPointBundleNetDevice::SetReceiveCallback(NetDevice::ReceiveCallback cb)
+{
+    m_rxCallback = cb;
+}
+
+void
+PointToPointBundleNetDevice::SetPromiscReceiveCallback(NetDevice::PromiscReceiveCallback cb)
+{
+    m_promiscCallback = cb;
+}
+
+bool
+PointToPointBundleNetDevice::SupportsSendFrom() const
+{
+    return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POINT_TO_POINT_BUNDLE_NET_DEVICE_H
+#define POINT_TO_POINT_BUNDLE_NET_DEVICE_H
+
+#include "ns3/address.h"
+#include "ns3/callback.h"
+#include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+class PointToPointBundleChannel;
+
+/**
+ * \ingroup point-to-point
+ * \brief A bundle of parallel point-to-point links behind one interface
+ *
+ * Models a link aggregation group (LAG) or an ECMP bundle of N member
+ * links of the same data rate with a single device per side: one
+ * interface, one address and no queue disc per member. Each member
+ * serializes its own packets from its own FIFO, so a busy member never
+ * delays the others, and a packet costs the same events as on a single
+ * PointToPointNetDevice.
+ *
+ * The member of a packet is selected by hashing its flow: the addresses,
+ * protocol and ports of an IPv4 packet. Every packet of a flow takes the
+ * same member, as on a real LAG, and is never reordered. Packets of other
+ * protocols hash on their protocol number only.
+ */
+class PointToPointBundleNetDevice : public NetDevice
+{
+  public:
+    /**
+     * \brief Get the TypeId
+     *
+     * \return The TypeId for this class
+     */
+    static TypeId GetTypeId();
+
+    PointToPointBundleNetDevice();
+    ~PointToPointBundleNetDevice() override;
+
+    PointToPointBundleNetDevice(const PointToPointBundleNetDevice&) = delete;
+    PointToPointBundleNetDevice& operator=(const PointToPointBundleNetDevice&) = delete;
+
+    /**
+     * \brief Attach the device to a channel
+     * \param ch the channel
+     * \return true
+     */
+    bool Attach(Ptr<PointToPointBundleChannel> ch);
+
+    /**
+     * \brief Receive a packet from the peer
+     * \param p the packet, with its PPP header
+     */
+    void Receive(Ptr<Packet> p);
+
+    /**
+     * \brief Set the number of member links
+     *
+     * The members removed must be idle.
+     *
+     * \param members the number of members
+     */
+    void SetNMembers(uint32_t members);
+
+    /**
+     * \brief Get the number of member links
+     * \return the number of members
+     */
+    uint32_t GetNMembers() const;
+
+    /**
+     * \brief Get the member carrying a packet
+     * \param p the packet, without PPP header
+     * \param protocolNumber the protocol number of the packet
+     * \return the member index
+     */
+    uint32_t SelectMember(Ptr<const Packet> p, uint16_t protocolNumber) const;
+
+    /**
+     * \brief Get the number of packets sent on a member
+     * \param member the member index
+     * \return the number of packets
+     */
+    uint64_t GetMemberTxPackets(uint32_t member) const;
+
+    // inherited from NetDevice base class.
+    void SetIfIndex(const uint32_t index) override;
+    uint32_t GetIfIndex() const override;
+    Ptr<Channel> GetChannel() const override;
+    void SetAddress(Address address) override;
+    Address GetAddress() const override;
+    bool SetMtu(const uint16_t mtu) override;
+    uint16_t GetMtu() const override;
+    bool IsLinkUp() const override;
+    void AddLinkChangeCallback(Callback<void> callback) override;
+    bool IsBroadcast() const override;
+    Address GetBroadcast() const override;
+    bool IsMulticast() const override;
+    Address GetMulticast(Ipv4Address multicastGroup) const override;
+    Address GetMulticast(Ipv6Address addr) const override;
+    bool IsPointToPoint() const override;
+    bool IsBridge() const override;
+    bool Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) override;
+    bool SendFrom(Ptr<Packet> packet,
+                  const Address& source,
+                  const Address& dest,
+                  uint16_t protocolNumber) override;
+    Ptr<Node> GetNode() const override;
+    void SetNode(Ptr<Node> node) override;
+    bool NeedsArp() const override;
+    void SetReceiveCallback(NetDevice::ReceiveCallback cb) override;
+    void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
+    bool SupportsSendFrom() const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A member link
+    struct Member
+    {
+        std::deque<Ptr<Packet>> queue; //!< packets waiting for the member
+        bool busy;                     //!< a packet is being serialized
+        uint64_t txPackets;            //!< packets sent
+    };
+
+    /**
+     * \brief Start the serialization of a packet on a member
+     * \param member the member index
+     * \param p the packet
+     */
+    void TransmitStart(uint32_t member, Ptr<Packet> p);
+
+    /**
+     * \brief End of the serialization of a packet on a member
+     * \param member the member index
+     */
+    void TransmitComplete(uint32_t member);
+
+    /**
+     * \brief Get the address of the peer device
+     * \return the address
+     */
+    Address GetRemote() const;
+
+    Ptr<PointToPointBundleChannel> m_channel; //!< attached channel
+    Ptr<Node> m_node;                         //!< node of the device
+    Mac48Address m_address;                   //!< address of the device
+    uint32_t m_ifIndex;                       //!< interface index
+    uint16_t m_mtu;                           //!< MTU
+    bool m_linkUp;                            //!< attached to a channel
+    DataRate m_bps;                           //!< data rate of a member
+    Time m_tInterframeGap;                    //!< gap between two packets of a member
+    uint32_t m_nMembers;                      //!< number of members
+    uint32_t m_maxPackets;                    //!< queue size of a member
+    std::vector<Member> m_members;            //!< member links
+
+    NetDevice::ReceiveCallback m_rxCallback;            //!< receive callback
+    NetDevice::PromiscReceiveCallback m_promiscCallback; //!< promiscuous receive callback
+    TracedCallback<> m_linkChangeCallbacks;             //!< link change callbacks
+
+    TracedCallback<Ptr<const Packet>> m_macTxTrace;     //!< packet accepted for transmission
+    TracedCallback<Ptr<const Packet>> m_macTxDropTrace; //!< packet dropped, member queue full
+    TracedCallback<Ptr<const Packet>> m_macRxTrace;     //!< packet received
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_BUNDLE_NET_DEVICE_H */
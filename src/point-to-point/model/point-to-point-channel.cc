@@ -24,6 +24,10 @@
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
+#ifdef NS3_MTP
+#include "ns3/mtp-interface.h"
+#endif
+
 namespace ns3
 {
 
@@ -95,12 +99,18 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
     NS_ASSERT(m_link[1].m_state != INITIALIZING);
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
-
-    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
+    uint32_t dstNode = m_link[wire].m_dst->GetNode()->GetId();
+
+#ifdef NS3_MTP
+    Ptr<Packet> copy = MtpInterface::CopyPacket(p, dstNode);
+#else
+    Ptr<Packet> copy = p->Copy();
+#endif
+    Simulator::ScheduleWithContext(dstNode,
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
                                    m_link[wire].m_dst,
-                                   p->Copy());
+                                   copy);
 
     // Call the tx anim callback on the net device
     m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
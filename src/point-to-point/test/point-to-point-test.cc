@@ -19,11 +19,17 @@
 
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/point-to-point-bundle-channel.h"
+#include "ns3/point-to-point-bundle-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
+#include <functional>
+#include <set>
 #include <string>
 
 using namespace ns3;
@@ -139,6 +145,208 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test class for the PointToPointBundleNetDevice
+ *
+ * Sends several IPv4 flows over a bundle of four members and checks that
+ * every packet arrives, that a flow keeps its member and that the IPv4 and
+ * IPv6 flows are spread over the members, also once the number of members
+ * changed.
+ */
+class PointToPointBundleTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBundleTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Build a UDP over IPv4 packet
+     *
+     * Only the fields the member selection reads are filled in.
+     *
+     * \param srcPort the source port of the flow
+     * \return the packet
+     */
+    static Ptr<Packet> CreateUdpPacket(uint16_t srcPort);
+
+    /**
+     * \brief Build a UDP over IPv6 packet
+     *
+     * Only the fields the member selection reads are filled in.
+     *
+     * \param srcPort the source port of the flow
+     * \param flowLabel the flow label
+     * \return the packet
+     */
+    static Ptr<Packet> CreateUdp6Packet(uint16_t srcPort, uint32_t flowLabel);
+
+    /**
+     * \brief Check the member selection of a set of flows
+     * \param dev the device
+     * \param protocol the protocol number of the flows
+     * \param create the flow packets, by flow index
+     */
+    void CheckSpread(Ptr<PointToPointBundleNetDevice> dev,
+                     uint16_t protocol,
+                     std::function<Ptr<Packet>(uint16_t)> create);
+
+    /**
+     * \brief Callback counting the received packets
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return true
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    uint32_t m_received; //!< received packets
+};
+
+PointToPointBundleTest::PointToPointBundleTest()
+    : TestCase("PointToPointBundle"),
+      m_received(0)
+{
+}
+
+Ptr<Packet>
+PointToPointBundleTest::CreateUdpPacket(uint16_t srcPort)
+{
+    uint8_t buffer[100] = {0};
+    buffer[0] = 0x45; // version 4, 20 bytes header
+    buffer[9] = 17;   // UDP
+    buffer[12] = 10;  // 10.0.0.1 -> 10.0.0.2
+    buffer[15] = 1;
+    buffer[16] = 10;
+    buffer[19] = 2;
+    buffer[20] = srcPort >> 8;
+    buffer[21] = srcPort & 0xff;
+    buffer[23] = 9; // discard
+    return Create<Packet>(buffer, sizeof(buffer));
+}
+
+Ptr<Packet>
+PointToPointBundleTest::CreateUdp6Packet(uint16_t srcPort, uint32_t flowLabel)
+{
+    uint8_t buffer[100] = {0};
+    buffer[0] = 0x60; // version 6
+    buffer[1] = (flowLabel >> 16) & 0x0f;
+    buffer[2] = (flowLabel >> 8) & 0xff;
+    buffer[3] = flowLabel & 0xff;
+    buffer[6] = 17;   // UDP
+    buffer[8] = 0x20; // 2001::1 -> 2001::2
+    buffer[9] = 0x01;
+    buffer[23] = 1;
+    buffer[24] = 0x20;
+    buffer[25] = 0x01;
+    buffer[39] = 2;
+    buffer[40] = srcPort >> 8;
+    buffer[41] = srcPort & 0xff;
+    buffer[43] = 9; // discard
+    return Create<Packet>(buffer, sizeof(buffer));
+}
+
+void
+PointToPointBundleTest::CheckSpread(Ptr<PointToPointBundleNetDevice> dev,
+                                    uint16_t protocol,
+                                    std::function<Ptr<Packet>(uint16_t)> create)
+{
+    // the member of a flow does not depend on its packets
+    std::set<uint32_t> used;
+    for (uint16_t flow = 0; flow < 64; flow++)
+    {
+        uint32_t member = dev->SelectMember(create(flow), protocol);
+        NS_TEST_EXPECT_MSG_LT(member, dev->GetNMembers(), "member out of range");
+        NS_TEST_EXPECT_MSG_EQ(dev->SelectMember(create(flow), protocol),
+                              member,
+                              "a flow changed member");
+        used.insert(member);
+    }
+    NS_TEST_EXPECT_MSG_GT(used.size(), 1, "the flows all hash to one member");
+}
+
+bool
+PointToPointBundleTest::RxPacket(Ptr<NetDevice> dev,
+                                 Ptr<const Packet> pkt,
+                                 uint16_t mode,
+                                 const Address& sender)
+{
+    m_received++;
+    return true;
+}
+
+void
+PointToPointBundleTest::DoRun()
+{
+    const uint32_t members = 4;
+    const uint32_t flows = 64;
+
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointBundleNetDevice> devA = CreateObject<PointToPointBundleNetDevice>();
+    Ptr<PointToPointBundleNetDevice> devB = CreateObject<PointToPointBundleNetDevice>();
+    Ptr<PointToPointBundleChannel> channel = CreateObject<PointToPointBundleChannel>();
+    channel->SetAttribute("Delay", StringValue("1ms"));
+
+    for (auto dev : {devA, devB})
+    {
+        dev->SetAttribute("Members", UintegerValue(members));
+        dev->SetAttribute("DataRate", StringValue("10Mbps"));
+        dev->SetAddress(Mac48Address::Allocate());
+        dev->Attach(channel);
+    }
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+    devB->SetReceiveCallback(MakeCallback(&PointToPointBundleTest::RxPacket, this));
+
+    CheckSpread(devA, 0x800, [](uint16_t flow) { return CreateUdpPacket(1000 + flow); });
+    CheckSpread(devA, 0x86DD, [](uint16_t flow) { return CreateUdp6Packet(1000 + flow, 0); });
+    CheckSpread(devA, 0x86DD, [](uint16_t flow) { return CreateUdp6Packet(1000, flow); });
+
+    for (uint16_t port = 0; port < flows; port++)
+    {
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            Simulator::Schedule(Seconds(1.0),
+                                &PointToPointBundleNetDevice::Send,
+                                devA,
+                                CreateUdpPacket(1000 + port),
+                                devB->GetAddress(),
+                                0x800);
+        }
+    }
+
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, 2 * flows, "packets lost in the bundle");
+    uint64_t sent = 0;
+    for (uint32_t member = 0; member < members; member++)
+    {
+        sent += devA->GetMemberTxPackets(member);
+    }
+    NS_TEST_EXPECT_MSG_EQ(sent, 2 * flows, "packets not accounted to a member");
+
+    // the idle bundle grows and shrinks
+    devA->SetAttribute("Members", UintegerValue(members + 2));
+    NS_TEST_EXPECT_MSG_EQ(devA->GetMemberTxPackets(members + 1), 0, "added member used");
+    CheckSpread(devA, 0x800, [](uint16_t flow) { return CreateUdpPacket(1000 + flow); });
+    devA->SetAttribute("Members", UintegerValue(2));
+    NS_TEST_EXPECT_MSG_EQ(devA->GetNMembers(), 2, "members not removed");
+    CheckSpread(devA, 0x86DD, [](uint16_t flow) { return CreateUdp6Packet(1000 + flow, 0); });
+
+    Simulator::Destroy();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +363,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointBundleTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
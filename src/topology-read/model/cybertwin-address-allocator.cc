@@ -0,0 +1,190 @@
+#include "cybertwin-address-allocator.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinAddressAllocator");
+
+CybertwinAddressAllocator::CybertwinAddressAllocator()
+    : m_allocated(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+CybertwinAddressAllocator::Parse(const std::string& network,
+                                 uint32_t& base,
+                                 uint32_t& prefixLength)
+{
+    std::size_t slash = network.find('/');
+    if (slash == std::string::npos)
+    {
+        return false;
+    }
+
+    unsigned int a;
+    unsigned int b;
+    unsigned int c;
+    unsigned int d;
+    char tail;
+    if (std::sscanf(network.substr(0, slash).c_str(), "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) !=
+            4 ||
+        a > 255 || b > 255 || c > 255 || d > 255)
+    {
+        return false;
+    }
+    base = (a << 24) | (b << 16) | (c << 8) | d;
+
+    try
+    {
+        prefixLength = std::stoul(network.substr(slash + 1));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    if (prefixLength > 32)
+    {
+        return false;
+    }
+
+    // clear the host part, 10.1.2.3/16 is 10.1.0.0/16
+    base &= prefixLength ? 0xFFFFFFFF << (32 - prefixLength) : 0;
+    return true;
+}
+
+uint32_t
+CybertwinAddressAllocator::PrefixLengthForHosts(uint32_t hosts)
+{
+    // network and broadcast addresses are not usable
+    uint64_t needed = static_cast<uint64_t>(hosts) + 2;
+    uint32_t prefixLength = 32;
+    while (prefixLength > 0 && (uint64_t(1) << (32 - prefixLength)) < needed)
+    {
+        prefixLength--;
+    }
+    return std::min<uint32_t>(prefixLength, 30);
+}
+
+bool
+CybertwinAddressAllocator::Overlap(uint32_t first, uint32_t last, uint32_t& overlapLast) const
+{
+    // the ranges are disjoint, only the last one starting at or before
+    // 'last' can reach into [first, last]
+    auto it = m_used.upper_bound(last);
+    if (it == m_used.begin())
+    {
+        return false;
+    }
+    --it;
+    if (it->second < first)
+    {
+        return false;
+    }
+    overlapLast = it->second;
+    return true;
+}
+
+bool
+CybertwinAddressAllocator::Insert(uint32_t first, uint32_t last)
+{
+    uint32_t overlapLast;
+    bool clean = !Overlap(first, last, overlapLast);
+
+    // coalesce every range overlapping or adjacent to [first, last]
+    uint64_t lo = first;
+    uint64_t hi = last;
+    auto it = m_used.upper_bound(last == 0xFFFFFFFF ? last : last + 1);
+    while (it != m_used.begin())
+    {
+        auto prev = std::prev(it);
+        if (static_cast<uint64_t>(prev->second) + 1 < lo)
+        {
+            break;
+        }
+        lo = std::min<uint64_t>(lo, prev->first);
+        hi = std::max<uint64_t>(hi, prev->second);
+        it = m_used.erase(prev);
+    }
+    m_used[static_cast<uint32_t>(lo)] = static_cast<uint32_t>(hi);
+    return clean;
+}
+
+bool
+CybertwinAddressAllocator::Reserve(const std::string& network)
+{
+    NS_LOG_FUNCTION(this << network);
+    uint32_t base;
+    uint32_t prefixLength;
+    if (!Parse(network, base, prefixLength))
+    {
+        NS_LOG_WARN("Malformed network " << network << ", not reserved");
+        return true;
+    }
+    uint32_t last = base | (prefixLength ? ~(0xFFFFFFFF << (32 - prefixLength)) : 0xFFFFFFFF);
+    return Insert(base, last);
+}
+
+uint32_t
+CybertwinAddressAllocator::AddPool(const std::string& network)
+{
+    NS_LOG_FUNCTION(this << network);
+    uint32_t base;
+    uint32_t prefixLength;
+    if (!Parse(network, base, prefixLength))
+    {
+        NS_FATAL_ERROR("Malformed address pool " << network);
+    }
+    Pool pool;
+    pool.cursor = base;
+    pool.end = static_cast<uint64_t>(base) + (uint64_t(1) << (32 - prefixLength));
+    m_pools.push_back(pool);
+    return m_pools.size() - 1;
+}
+
+std::string
+CybertwinAddressAllocator::Allocate(uint32_t pool, uint32_t prefixLength)
+{
+    NS_LOG_FUNCTION(this << pool << prefixLength);
+    NS_ASSERT(pool < m_pools.size());
+    NS_ASSERT(prefixLength > 0 && prefixLength <= 32);
+
+    Pool& p = m_pools[pool];
+    uint64_t size = uint64_t(1) << (32 - prefixLength);
+    uint64_t candidate = (p.cursor + size - 1) & ~(size - 1);
+    while (candidate + size <= p.end)
+    {
+        uint32_t first = static_cast<uint32_t>(candidate);
+        uint32_t last = static_cast<uint32_t>(candidate + size - 1);
+        uint32_t overlapLast;
+        if (!Overlap(first, last, overlapLast))
+        {
+            Insert(first, last);
+            p.cursor = candidate + size;
+            m_allocated++;
+            std::ostringstream oss;
+            oss << Ipv4Address(first) << "/" << prefixLength;
+            NS_LOG_DEBUG("Allocated " << oss.str());
+            return oss.str();
+        }
+        // skip the used range, then realign
+        candidate = (static_cast<uint64_t>(overlapLast) + 1 + size - 1) & ~(size - 1);
+    }
+
+    NS_FATAL_ERROR("Address pool " << pool << " exhausted allocating a /" << prefixLength);
+    return "";
+}
+
+uint32_t
+CybertwinAddressAllocator::GetAllocated() const
+{
+    return m_allocated;
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+#ifndef CYBERTWIN_ADDRESS_ALLOCATOR_H
+#define CYBERTWIN_ADDRESS_ALLOCATOR_H
+
+#include "ns3/ipv4-address.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup topology
+ * \brief Collision-free IPv4 subnet allocation for generated topologies
+ *
+ * Networks written explicitly in the topology file are reserved first.
+ * Subnets are then carved out of one or more pools with an aligned bump
+ * pointer that skips every reserved or already allocated range, so a
+ * generated link never shares a subnet with another link, whichever pool
+ * it was drawn from.
+ *
+ * Networks are written in the "a.b.c.d/len" notation used by the topology
+ * file.
+ */
+class CybertwinAddressAllocator
+{
+  public:
+    CybertwinAddressAllocator();
+
+    /**
+     * \brief Reserve a network so that it is never allocated
+     * \param network the network, "a.b.c.d/len"
+     * \return false if it overlaps a network reserved or allocated before
+     */
+    bool Reserve(const std::string& network);
+
+    /**
+     * \brief Add a pool subnets are allocated from
+     * \param network the pool, "a.b.c.d/len"
+     * \return the pool index
+     */
+    uint32_t AddPool(const std::string& network);
+
+    /**
+     * \brief Allocate a free subnet from a pool
+     * \param pool the pool index
+     * \param prefixLength the prefix length of the subnet
+     * \return the subnet, "a.b.c.d/len"
+     */
+    std::string Allocate(uint32_t pool, uint32_t prefixLength);
+
+    /**
+     * \brief Get the longest prefix holding a number of hosts
+     * \param hosts the number of host addresses
+     * \return the prefix length, at most 30
+     */
+    static uint32_t PrefixLengthForHosts(uint32_t hosts);
+
+    /**
+     * \brief Parse a network
+     * \param network the network, "a.b.c.d/len"
+     * \param base the network address
+     * \param prefixLength the prefix length
+     * \return false if the network is malformed
+     */
+    static bool Parse(const std::string& network, uint32_t& base, uint32_t& prefixLength);
+
+    /**
+     * \brief Get the number of subnets allocated so far
+     */
+    uint32_t GetAllocated() const;
+
+  private:
+    /**
+     * \brief Insert a range, coalescing it with the ranges it touches
+     * \param first first address of the range
+     * \param last last address of the range
+     * \return false if the range overlapped an existing one
+     */
+    bool Insert(uint32_t first, uint32_t last);
+
+    /**
+     * \brief Find a range overlapping [first, last]
+     * \param first first address of the range
+     * \param last last address of the range
+     * \param overlapLast set to the last address of the overlapping range
+     * \return true if a used range overlaps
+     */
+    bool Overlap(uint32_t first, uint32_t last, uint32_t& overlapLast) const;
+
+    /// A pool subnets are carved from
+    struct Pool
+    {
+        uint64_t cursor; //!< next candidate address
+        uint64_t end;    //!< one past the last address
+    };
+
+    std::map<uint32_t, uint32_t> m_used; //!< disjoint used ranges, first -> last
+    std::vector<Pool> m_pools;           //!< allocation pools
+    uint32_t m_allocated;                //!< number of subnets allocated
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_ADDRESS_ALLOCATOR_H */
@@ -0,0 +1,412 @@
+#include "cybertwin-hierarchical-routing.h"
+
+#include "ns3/channel.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinHierarchicalRouting");
+
+namespace
+{
+
+/// Network mask of a prefix length
+uint32_t
+MaskOf(uint32_t prefixLength)
+{
+    return prefixLength ? 0xFFFFFFFF << (32 - prefixLength) : 0;
+}
+
+} // namespace
+
+CybertwinHierarchicalRouting::CybertwinHierarchicalRouting()
+    : m_routes(0)
+{
+}
+
+void
+CybertwinHierarchicalRouting::AddCoreNode(Ptr<Node> node)
+{
+    m_core.push_back(node);
+}
+
+void
+CybertwinHierarchicalRouting::AddEdgeNode(Ptr<Node> node)
+{
+    m_edge.push_back(node);
+}
+
+void
+CybertwinHierarchicalRouting::AddAccessCluster(Ptr<Node> router,
+                                               Ptr<Node> gateway,
+                                               const NodeContainer& hosts)
+{
+    m_clusters.push_back({router, gateway, hosts});
+}
+
+uint64_t
+CybertwinHierarchicalRouting::GetRouteCount() const
+{
+    return m_routes;
+}
+
+std::vector<CybertwinHierarchicalRouting::Prefix>
+CybertwinHierarchicalRouting::Summarize(std::vector<Prefix> prefixes)
+{
+    for (auto& p : prefixes)
+    {
+        p.first &= MaskOf(p.second);
+    }
+    // a covering prefix sorts before the prefixes it covers
+    std::sort(prefixes.begin(), prefixes.end());
+    prefixes.erase(std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+
+    std::vector<Prefix> result;
+    for (const auto& p : prefixes)
+    {
+        if (!result.empty() && result.back().second <= p.second &&
+            (p.first & MaskOf(result.back().second)) == result.back().first)
+        {
+            continue;
+        }
+        result.push_back(p);
+
+        // merge the two last prefixes while they are siblings
+        while (result.size() >= 2)
+        {
+            const Prefix& a = result[result.size() - 2];
+            const Prefix& b = result.back();
+            if (a.second != b.second || a.second == 0)
+            {
+                break;
+            }
+            uint32_t bit = 1u << (32 - a.second);
+            if ((a.first & bit) || (a.first | bit) != b.first)
+            {
+                break;
+            }
+            Prefix parent(a.first, a.second - 1);
+            result.pop_back();
+            result.back() = parent;
+        }
+    }
+    return result;
+}
+
+std::vector<CybertwinHierarchicalRouting::Adjacency>
+CybertwinHierarchicalRouting::GetAdjacencies(Ptr<Node> node) const
+{
+    std::vector<Adjacency> adjacencies;
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t d = 0; d < node->GetNDevices(); d++)
+    {
+        Ptr<NetDevice> device = node->GetDevice(d);
+        Ptr<Channel> channel = device->GetChannel();
+        if (!channel || channel->GetNDevices() != 2)
+        {
+            continue;
+        }
+        Ptr<NetDevice> peerDevice =
+            channel->GetDevice(0) == device ? channel->GetDevice(1) : channel->GetDevice(0);
+        Ptr<Ipv4> peerIpv4 = peerDevice->GetNode()->GetObject<Ipv4>();
+        if (!peerIpv4)
+        {
+            continue;
+        }
+        int32_t interface = ipv4->GetInterfaceForDevice(device);
+        int32_t peerInterface = peerIpv4->GetInterfaceForDevice(peerDevice);
+        if (interface < 0 || peerInterface < 0 || ipv4->GetNAddresses(interface) == 0 ||
+            peerIpv4->GetNAddresses(peerInterface) == 0)
+        {
+            continue;
+        }
+
+        Ipv4InterfaceAddress local = ipv4->GetAddress(interface, 0);
+        Adjacency adjacency;
+        adjacency.peer = peerDevice->GetNode();
+        adjacency.interface = interface;
+        adjacency.peerInterface = peerInterface;
+        adjacency.localAddress = local.GetLocal();
+        adjacency.nextHop = peerIpv4->GetAddress(peerInterface, 0).GetLocal();
+        adjacency.network = Prefix(local.GetLocal().Get() & local.GetMask().Get(),
+                                   local.GetMask().GetPrefixLength());
+        adjacencies.push_back(adjacency);
+    }
+    return adjacencies;
+}
+
+Ptr<Ipv4StaticRouting>
+CybertwinHierarchicalRouting::GetStaticRouting(Ptr<Node> node) const
+{
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4, "No Ipv4 on node " << node->GetId());
+    Ptr<Ipv4StaticRouting> routing =
+        Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(ipv4->GetRoutingProtocol());
+    NS_ASSERT_MSG(routing, "No Ipv4StaticRouting on node " << node->GetId());
+    return routing;
+}
+
+std::vector<CybertwinHierarchicalRouting::Prefix>
+CybertwinHierarchicalRouting::GetNetworks(Ptr<Node> node) const
+{
+    std::vector<Prefix> networks;
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+    {
+        for (uint32_t a = 0; a < ipv4->GetNAddresses(i); a++)
+        {
+            Ipv4InterfaceAddress address = ipv4->GetAddress(i, a);
+            if (address.GetLocal().IsLocalhost())
+            {
+                continue;
+            }
+            networks.emplace_back(address.GetLocal().Get() & address.GetMask().Get(),
+                                  address.GetMask().GetPrefixLength());
+        }
+    }
+    return networks;
+}
+
+// Stubs: hosts point to their router, the router to its gateway, and the
+// gateway routes the cluster networks back to the router
+void
+CybertwinHierarchicalRouting::PopulateAccess()
+{
+    for (const auto& cluster : m_clusters)
+    {
+        Ptr<Ipv4> routerIpv4 = cluster.router->GetObject<Ipv4>();
+        if (!routerIpv4)
+        {
+            continue;
+        }
+
+        bool linked = false;
+        for (const auto& adjacency : GetAdjacencies(cluster.router))
+        {
+            if (adjacency.peer != cluster.gateway)
+            {
+                continue;
+            }
+            GetStaticRouting(cluster.router)->SetDefaultRoute(adjacency.nextHop, adjacency.interface);
+            m_routes++;
+
+            // the gateway link is connected at the edge, the other networks
+            // of the router are routed to it
+            Ptr<Ipv4StaticRouting> edgeRouting = GetStaticRouting(cluster.gateway);
+            std::vector<Prefix>& below = m_below[cluster.gateway->GetId()];
+            below.push_back(adjacency.network);
+            for (const auto& network : GetNetworks(cluster.router))
+            {
+                if (network == adjacency.network)
+                {
+                    continue;
+                }
+                edgeRouting->AddNetworkRouteTo(Ipv4Address(network.first),
+                                               Ipv4Mask(MaskOf(network.second)),
+                                               adjacency.localAddress,
+                                               adjacency.peerInterface);
+                below.push_back(network);
+                m_routes++;
+            }
+            linked = true;
+            break;
+        }
+        if (!linked)
+        {
+            NS_LOG_WARN("Cluster router " << cluster.router->GetId()
+                                          << " has no link to its gateway");
+        }
+
+        for (uint32_t h = 0; h < cluster.hosts.GetN(); h++)
+        {
+            Ptr<Node> host = cluster.hosts.Get(h);
+            Ptr<Ipv4> ipv4 = host->GetObject<Ipv4>();
+            if (host == cluster.router || !ipv4)
+            {
+                continue;
+            }
+
+            // hosts configured by their own access technology keep their
+            // default route, LTE UEs for instance
+            Ptr<Ipv4StaticRouting> routing = GetStaticRouting(host);
+            bool hasDefault = false;
+            for (uint32_t r = 0; r < routing->GetNRoutes(); r++)
+            {
+                Ipv4RoutingTableEntry route = routing->GetRoute(r);
+                hasDefault |= route.IsDefault();
+            }
+            if (hasDefault)
+            {
+                continue;
+            }
+
+            // the router address on the subnet shared with the host
+            for (uint32_t i = 0; i < ipv4->GetNInterfaces() && !hasDefault; i++)
+            {
+                for (uint32_t a = 0; a < ipv4->GetNAddresses(i) && !hasDefault; a++)
+                {
+                    Ipv4InterfaceAddress address = ipv4->GetAddress(i, a);
+                    if (address.GetLocal().IsLocalhost())
+                    {
+                        continue;
+                    }
+                    for (uint32_t ri = 0; ri < routerIpv4->GetNInterfaces() && !hasDefault; ri++)
+                    {
+                        for (uint32_t ra = 0; ra < routerIpv4->GetNAddresses(ri); ra++)
+                        {
+                            Ipv4Address routerAddress = routerIpv4->GetAddress(ri, ra).GetLocal();
+                            if (address.GetMask().IsMatch(address.GetLocal(), routerAddress) &&
+                                routerAddress != address.GetLocal())
+                            {
+                                routing->SetDefaultRoute(routerAddress, i);
+                                m_routes++;
+                                hasDefault = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Edge servers reach everything outside their clusters through a core parent
+void
+CybertwinHierarchicalRouting::PopulateEdge()
+{
+    std::unordered_set<Ptr<Node>> core(m_core.begin(), m_core.end());
+    for (const auto& edge : m_edge)
+    {
+        for (const auto& adjacency : GetAdjacencies(edge))
+        {
+            if (core.count(adjacency.peer))
+            {
+                GetStaticRouting(edge)->SetDefaultRoute(adjacency.nextHop, adjacency.interface);
+                m_routes++;
+                break;
+            }
+        }
+    }
+}
+
+// BFS from every core server over the core graph. Edge servers are reached
+// but not expanded, they never carry transit traffic.
+void
+CybertwinHierarchicalRouting::PopulateCore()
+{
+    std::unordered_set<Ptr<Node>> edge(m_edge.begin(), m_edge.end());
+    std::unordered_set<Ptr<Node>> core(m_core.begin(), m_core.end());
+
+    // adjacencies inside the core/edge graph, and the prefixes attached to
+    // every node of it
+    std::unordered_map<Ptr<Node>, std::vector<Adjacency>> graph;
+    std::unordered_map<Ptr<Node>, std::vector<Prefix>> attached;
+    for (const auto& nodes : {m_core, m_edge})
+    {
+        for (const auto& node : nodes)
+        {
+            std::vector<Prefix>& prefixes = attached[node];
+            for (const auto& adjacency : GetAdjacencies(node))
+            {
+                if (core.count(adjacency.peer) || edge.count(adjacency.peer))
+                {
+                    graph[node].push_back(adjacency);
+                    prefixes.push_back(adjacency.network);
+                }
+            }
+        }
+    }
+    uint64_t below = 0;
+    uint64_t summarized = 0;
+    for (const auto& node : m_edge)
+    {
+        auto it = m_below.find(node->GetId());
+        if (it != m_below.end())
+        {
+            std::vector<Prefix> prefixes = Summarize(it->second);
+            below += it->second.size();
+            summarized += prefixes.size();
+            attached[node].insert(attached[node].end(), prefixes.begin(), prefixes.end());
+        }
+    }
+    NS_LOG_INFO("[CybertwinHierarchicalRouting] " << below << " access prefixes summarized into "
+                                                  << summarized);
+
+    for (const auto& source : m_core)
+    {
+        Ptr<Ipv4StaticRouting> routing = GetStaticRouting(source);
+        std::set<Prefix> installed;
+        for (const auto& network : GetNetworks(source))
+        {
+            installed.insert(network);
+        }
+
+        std::unordered_map<Ptr<Node>, const Adjacency*> firstHop;
+        std::deque<Ptr<Node>> queue;
+        firstHop[source] = nullptr;
+        queue.push_back(source);
+        while (!queue.empty())
+        {
+            Ptr<Node> node = queue.front();
+            queue.pop_front();
+
+            const Adjacency* hop = firstHop[node];
+            if (hop)
+            {
+                for (const auto& prefix : attached[node])
+                {
+                    if (installed.insert(prefix).second)
+                    {
+                        routing->AddNetworkRouteTo(Ipv4Address(prefix.first),
+                                                   Ipv4Mask(MaskOf(prefix.second)),
+                                                   hop->nextHop,
+                                                   hop->interface);
+                        m_routes++;
+                    }
+                }
+            }
+
+            if (node != source && edge.count(node))
+            {
+                continue;
+            }
+            for (const auto& adjacency : graph[node])
+            {
+                if (firstHop.find(adjacency.peer) == firstHop.end())
+                {
+                    firstHop[adjacency.peer] = hop ? hop : &adjacency;
+                    queue.push_back(adjacency.peer);
+                }
+            }
+        }
+    }
+}
+
+void
+CybertwinHierarchicalRouting::Populate()
+{
+    NS_LOG_FUNCTION(this);
+    m_routes = 0;
+    m_below.clear();
+    PopulateAccess();
+    PopulateEdge();
+    PopulateCore();
+    NS_LOG_INFO("[CybertwinHierarchicalRouting] " << m_core.size() << " core, " << m_edge.size()
+                                                  << " edge servers, " << m_clusters.size()
+                                                  << " clusters: " << m_routes << " routes");
+}
+
+} // namespace ns3
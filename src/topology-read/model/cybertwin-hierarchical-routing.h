@@ -0,0 +1,136 @@
+#ifndef CYBERTWIN_HIERARCHICAL_ROUTING_H
+#define CYBERTWIN_HIERARCHICAL_ROUTING_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+
+#include <map>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4StaticRouting;
+
+/**
+ * \ingroup topology
+ * \brief Static route computation exploiting the Cybertwin layering
+ *
+ * Ipv4GlobalRoutingHelper::PopulateRoutingTables runs an SPF from every
+ * router of the simulation and installs a route to every network on every
+ * router. In a Cybertwin network most routers are stubs with a single
+ * upstream, so the routes are computed per layer instead:
+ *
+ *   - end hosts take a default route to the router of their cluster, and
+ *     the router a default route to its edge gateway,
+ *   - an edge server routes the networks of its clusters to their routers
+ *     and takes a default route to its first core parent,
+ *   - the networks below an edge server are summarized into the fewest
+ *     exact covering prefixes, and a BFS over the core graph (edge servers
+ *     are leaves, never transit) gives every core server the first hop to
+ *     every core link, edge uplink and summarized access prefix.
+ *
+ * Routes go into the Ipv4StaticRouting instance of each node, which must be
+ * part of its routing protocol (the InternetStackHelper default).
+ */
+class CybertwinHierarchicalRouting
+{
+  public:
+    /// A prefix, network address and length
+    typedef std::pair<uint32_t, uint32_t> Prefix;
+
+    CybertwinHierarchicalRouting();
+
+    /**
+     * \brief Add a core server
+     * \param node the node
+     */
+    void AddCoreNode(Ptr<Node> node);
+
+    /**
+     * \brief Add an edge server
+     * \param node the node
+     */
+    void AddEdgeNode(Ptr<Node> node);
+
+    /**
+     * \brief Add an end cluster
+     * \param router the node of the cluster connected to the gateway
+     * \param gateway the edge server of the cluster
+     * \param hosts the hosts of the cluster
+     */
+    void AddAccessCluster(Ptr<Node> router, Ptr<Node> gateway, const NodeContainer& hosts);
+
+    /**
+     * \brief Compute and install the routes of every node added
+     */
+    void Populate();
+
+    /**
+     * \brief Get the number of routes installed by Populate
+     */
+    uint64_t GetRouteCount() const;
+
+    /**
+     * \brief Summarize prefixes into the fewest exact covering prefixes
+     *
+     * Two sibling prefixes are merged into their parent, repeatedly.
+     * The result covers exactly the addresses of the input.
+     *
+     * \param prefixes the prefixes
+     * \return the summarized prefixes
+     */
+    static std::vector<Prefix> Summarize(std::vector<Prefix> prefixes);
+
+  private:
+    /// A point-to-point neighbor
+    struct Adjacency
+    {
+        Ptr<Node> peer;           //!< the neighbor
+        uint32_t interface;       //!< local interface towards the neighbor
+        uint32_t peerInterface;   //!< interface of the neighbor on the link
+        Ipv4Address localAddress; //!< local address on the link
+        Ipv4Address nextHop;      //!< address of the neighbor on the link
+        Prefix network;           //!< network of the link
+    };
+
+    /// An end cluster
+    struct Cluster
+    {
+        Ptr<Node> router;   //!< router of the cluster
+        Ptr<Node> gateway;  //!< edge server of the cluster
+        NodeContainer hosts; //!< hosts of the cluster
+    };
+
+    /**
+     * \brief Get the point-to-point neighbors of a node
+     */
+    std::vector<Adjacency> GetAdjacencies(Ptr<Node> node) const;
+
+    /**
+     * \brief Get the static routing of a node
+     */
+    Ptr<Ipv4StaticRouting> GetStaticRouting(Ptr<Node> node) const;
+
+    /**
+     * \brief Get the networks of the interfaces of a node
+     */
+    std::vector<Prefix> GetNetworks(Ptr<Node> node) const;
+
+    void PopulateAccess();
+    void PopulateEdge();
+    void PopulateCore();
+
+    std::vector<Ptr<Node>> m_core;            //!< core servers
+    std::vector<Ptr<Node>> m_edge;            //!< edge servers
+    std::vector<Cluster> m_clusters;          //!< end clusters
+    std::map<uint32_t, std::vector<Prefix>> m_below; //!< prefixes below an edge, by node id
+    uint64_t m_routes;                        //!< routes installed
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_HIERARCHICAL_ROUTING_H */
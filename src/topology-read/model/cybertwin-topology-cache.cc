@@ -0,0 +1,433 @@
+#include "cybertwin-topology-cache.h"
+
+#include "ns3/log.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinTopologyCache");
+
+static const char CACHE_MAGIC[8] = {'C', 'T', 'T', 'O', 'P', 'O', '\0', '\0'};
+
+/// File header, all offsets are relative to the start of the file
+struct CybertwinTopologyCache::Header
+{
+    char magic[8];          //!< CACHE_MAGIC
+    uint32_t version;       //!< format version
+    uint32_t headerSize;    //!< sizeof(Header), guards against layout changes
+    uint64_t hash;          //!< hash of the source files
+    uint64_t fileSize;      //!< size of the whole file
+    uint32_t nodeCount[3];  //!< nodes per layer, stored core first
+    uint32_t linkCount;     //!< link and gateway records
+    uint32_t appCount;      //!< application records
+    uint32_t targetCount;   //!< application target records
+    uint32_t cnrsNode;      //!< string offset of the CNRS central node
+    uint32_t stringsSize;   //!< size of the string table
+    uint64_t nodesOffset;   //!< offset of the node records
+    uint64_t linksOffset;   //!< offset of the link records
+    uint64_t appsOffset;    //!< offset of the application records
+    uint64_t targetsOffset; //!< offset of the target records
+    uint64_t stringsOffset; //!< offset of the string table
+};
+
+/// A core or edge server, or an end cluster
+struct CybertwinTopologyCache::NodeRecord
+{
+    uint32_t name;          //!< string offset
+    uint32_t type;          //!< NodeType_e
+    double position[3];     //!< position in NetAnim
+    int32_t numNodes;       //!< hosts of an end cluster
+    uint32_t networkType;   //!< string offset
+    uint32_t localNetwork;  //!< string offset
+    uint32_t firstLink;     //!< first link record
+    uint32_t linkCount;     //!< number of links
+    uint32_t gatewayCount;  //!< number of gateways, stored after the links
+};
+
+/// A point-to-point link or gateway, with its resolved network
+struct CybertwinTopologyCache::LinkRecord
+{
+    uint32_t target;   //!< string offset
+    uint32_t dataRate; //!< string offset
+    uint32_t delay;    //!< string offset
+    uint32_t network;  //!< string offset
+    uint32_t members;  //!< member links of a bundle, 1 for a gateway
+};
+
+/// An enabled application and its parameters
+struct CybertwinTopologyCache::AppRecord
+{
+    uint32_t name;        //!< string offset
+    uint32_t parameters;  //!< string offset of the parameters, as YAML
+    uint32_t firstTarget; //!< first target record
+    uint32_t targetCount; //!< number of target nodes
+};
+
+namespace
+{
+
+/// Collect strings once, records refer to them by offset
+class StringTable
+{
+  public:
+    uint32_t Add(const std::string& s)
+    {
+        auto it = m_offsets.find(s);
+        if (it != m_offsets.end())
+        {
+            return it->second;
+        }
+        uint32_t offset = m_data.size();
+        m_data.insert(m_data.end(), s.begin(), s.end());
+        m_data.push_back('\0');
+        m_offsets.emplace(s, offset);
+        return offset;
+    }
+
+    const std::vector<char>& Data() const
+    {
+        return m_data;
+    }
+
+  private:
+    std::vector<char> m_data;
+    std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+/// Round up to the alignment of the records
+uint64_t
+Align(uint64_t offset)
+{
+    return (offset + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+CybertwinTopologyCache::CybertwinTopologyCache()
+    : m_base(nullptr),
+      m_size(0)
+{
+}
+
+CybertwinTopologyCache::~CybertwinTopologyCache()
+{
+    Close();
+}
+
+uint64_t
+CybertwinTopologyCache::Hash(const std::vector<std::string>& files, const std::string& salt)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    mix(salt.data(), salt.size());
+    std::vector<char> buffer(1 << 16);
+    for (const auto& file : files)
+    {
+        // the separator keeps "ab"+"c" apart from "a"+"bc"
+        mix("\0", 1);
+        FILE* f = std::fopen(file.c_str(), "rb");
+        if (!f)
+        {
+            continue;
+        }
+        std::size_t n;
+        while ((n = std::fread(buffer.data(), 1, buffer.size(), f)) > 0)
+        {
+            mix(buffer.data(), n);
+        }
+        std::fclose(f);
+    }
+    return hash;
+}
+
+bool
+CybertwinTopologyCache::Write(const std::string& path,
+                              uint64_t hash,
+                              const std::vector<NodeInfo_t*> (&layers)[3],
+                              const std::vector<ApplicationInfo_t>& apps,
+                              const std::string& cnrsNode)
+{
+    NS_LOG_FUNCTION(path << hash);
+
+    StringTable strings;
+    std::vector<NodeRecord> nodes;
+    std::vector<LinkRecord> links;
+    std::vector<AppRecord> appRecords;
+    std::vector<uint32_t> targets;
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+
+    for (uint32_t layer = 0; layer < 3; layer++)
+    {
+        header.nodeCount[layer] = layers[layer].size();
+        for (const NodeInfo_t* info : layers[layer])
+        {
+            NodeRecord node;
+            std::memset(&node, 0, sizeof(node));
+            node.name = strings.Add(info->name);
+            node.type = info->type;
+            node.position[0] = info->position.x;
+            node.position[1] = info->position.y;
+            node.position[2] = info->position.z;
+            node.numNodes = info->num_nodes;
+            node.networkType = strings.Add(info->network_type);
+            node.localNetwork = strings.Add(info->local_network);
+            node.firstLink = links.size();
+            node.linkCount = info->links.size();
+            node.gatewayCount = info->gateways.size();
+            for (const auto& l : info->links)
+            {
+                links.push_back({strings.Add(l.target),
+                                 strings.Add(l.data_rate),
+                                 strings.Add(l.delay),
+                                 strings.Add(l.network),
+                                 l.members});
+            }
+            for (const auto& g : info->gateways)
+            {
+                links.push_back({strings.Add(g.name),
+                                 strings.Add(g.data_rate),
+                                 strings.Add(g.delay),
+                                 strings.Add(g.network),
+                                 1});
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    for (const auto& app : apps)
+    {
+        AppRecord record;
+        record.name = strings.Add(app.appName);
+        record.parameters = strings.Add(app.parameters);
+        record.firstTarget = targets.size();
+        record.targetCount = app.targetNodes.size();
+        for (const auto& target : app.targetNodes)
+        {
+            targets.push_back(strings.Add(target));
+        }
+        appRecords.push_back(record);
+    }
+
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.hash = hash;
+    header.linkCount = links.size();
+    header.appCount = appRecords.size();
+    header.targetCount = targets.size();
+    header.cnrsNode = strings.Add(cnrsNode);
+    header.stringsSize = strings.Data().size();
+    header.nodesOffset = Align(sizeof(Header));
+    header.linksOffset = Align(header.nodesOffset + nodes.size() * sizeof(NodeRecord));
+    header.appsOffset = Align(header.linksOffset + links.size() * sizeof(LinkRecord));
+    header.targetsOffset = Align(header.appsOffset + appRecords.size() * sizeof(AppRecord));
+    header.stringsOffset = Align(header.targetsOffset + targets.size() * sizeof(uint32_t));
+    header.fileSize = header.stringsOffset + header.stringsSize;
+
+    std::vector<uint8_t> image(header.fileSize, 0);
+    auto put = [&image](uint64_t offset, const void* data, std::size_t size) {
+        if (size)
+        {
+            std::memcpy(image.data() + offset, data, size);
+        }
+    };
+    put(0, &header, sizeof(header));
+    put(header.nodesOffset, nodes.data(), nodes.size() * sizeof(NodeRecord));
+    put(header.linksOffset, links.data(), links.size() * sizeof(LinkRecord));
+    put(header.appsOffset, appRecords.data(), appRecords.size() * sizeof(AppRecord));
+    put(header.targetsOffset, targets.data(), targets.size() * sizeof(uint32_t));
+    put(header.stringsOffset, strings.Data().data(), header.stringsSize);
+
+    // write aside and rename, so that a concurrent run never maps a
+    // partially written file
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f)
+    {
+        NS_LOG_WARN("Cannot write topology cache " << tmp);
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        NS_LOG_WARN("Cannot write topology cache " << path);
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    NS_LOG_INFO("[CybertwinTopologyCache] Wrote " << path << ": " << nodes.size() << " nodes, "
+                                                  << links.size() << " links, " << image.size()
+                                                  << " bytes");
+    return true;
+}
+
+bool
+CybertwinTopologyCache::Open(const std::string& path, uint64_t hash)
+{
+    NS_LOG_FUNCTION(this << path << hash);
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header))
+    {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+    m_base = static_cast<const uint8_t*>(map);
+    m_size = st.st_size;
+
+    const Header* header = reinterpret_cast<const Header*>(m_base);
+    const char* reason = nullptr;
+    if (std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+    {
+        reason = "not a topology cache";
+    }
+    else if (header->version != VERSION || header->headerSize != sizeof(Header))
+    {
+        reason = "format version differs";
+    }
+    else if (header->hash != hash)
+    {
+        reason = "sources changed";
+    }
+    else if (header->fileSize != m_size ||
+             header->stringsOffset + header->stringsSize > m_size ||
+             (header->stringsSize && m_base[m_size - 1] != '\0'))
+    {
+        reason = "truncated";
+    }
+
+    if (reason)
+    {
+        NS_LOG_INFO("[CybertwinTopologyCache] Ignoring " << path << ": " << reason);
+        Close();
+        return false;
+    }
+
+    NS_LOG_INFO("[CybertwinTopologyCache] Mapped " << path << ", " << m_size << " bytes");
+    return true;
+}
+
+void
+CybertwinTopologyCache::Close()
+{
+    if (m_base)
+    {
+        munmap(const_cast<uint8_t*>(m_base), m_size);
+        m_base = nullptr;
+        m_size = 0;
+    }
+}
+
+const char*
+CybertwinTopologyCache::String(uint32_t offset) const
+{
+    const Header* header = reinterpret_cast<const Header*>(m_base);
+    NS_ASSERT(offset < header->stringsSize);
+    return reinterpret_cast<const char*>(m_base + header->stringsOffset + offset);
+}
+
+uint32_t
+CybertwinTopologyCache::GetNodeCount(Layer layer) const
+{
+    NS_ASSERT(m_base);
+    return reinterpret_cast<const Header*>(m_base)->nodeCount[layer];
+}
+
+NodeInfo_t*
+CybertwinTopologyCache::CreateNodeInfo(Layer layer, uint32_t index) const
+{
+    NS_ASSERT(m_base);
+    const Header* header = reinterpret_cast<const Header*>(m_base);
+    NS_ASSERT(index < header->nodeCount[layer]);
+    for (uint32_t l = 0; l < layer; l++)
+    {
+        index += header->nodeCount[l];
+    }
+
+    const NodeRecord* node =
+        reinterpret_cast<const NodeRecord*>(m_base + header->nodesOffset) + index;
+    const LinkRecord* links = reinterpret_cast<const LinkRecord*>(m_base + header->linksOffset);
+
+    NodeInfo_t* info = new NodeInfo_t();
+    info->name = String(node->name);
+    info->type = static_cast<NodeType_e>(node->type);
+    info->position = Vector(node->position[0], node->position[1], node->position[2]);
+    info->num_nodes = node->numNodes;
+    info->network_type = String(node->networkType);
+    info->local_network = String(node->localNetwork);
+
+    info->links.reserve(node->linkCount);
+    for (uint32_t i = 0; i < node->linkCount; i++)
+    {
+        const LinkRecord& l = links[node->firstLink + i];
+        info->links.push_back(
+            {String(l.target), String(l.dataRate), String(l.delay), String(l.network), l.members});
+    }
+    info->gateways.reserve(node->gatewayCount);
+    for (uint32_t i = 0; i < node->gatewayCount; i++)
+    {
+        const LinkRecord& g = links[node->firstLink + node->linkCount + i];
+        info->gateways.push_back(
+            {String(g.target), String(g.dataRate), String(g.delay), String(g.network)});
+    }
+    return info;
+}
+
+std::vector<ApplicationInfo_t>
+CybertwinTopologyCache::GetApplications() const
+{
+    NS_ASSERT(m_base);
+    const Header* header = reinterpret_cast<const Header*>(m_base);
+    const AppRecord* apps = reinterpret_cast<const AppRecord*>(m_base + header->appsOffset);
+    const uint32_t* targets = reinterpret_cast<const uint32_t*>(m_base + header->targetsOffset);
+
+    std::vector<ApplicationInfo_t> result(header->appCount);
+    for (uint32_t i = 0; i < header->appCount; i++)
+    {
+        result[i].appName = String(apps[i].name);
+        result[i].parameters = String(apps[i].parameters);
+        for (uint32_t t = 0; t < apps[i].targetCount; t++)
+        {
+            result[i].targetNodes.push_back(String(targets[apps[i].firstTarget + t]));
+        }
+    }
+    return result;
+}
+
+std::string
+CybertwinTopologyCache::GetCnrsNode() const
+{
+    NS_ASSERT(m_base);
+    return String(reinterpret_cast<const Header*>(m_base)->cnrsNode);
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+#ifndef CYBERTWIN_TOPOLOGY_CACHE_H
+#define CYBERTWIN_TOPOLOGY_CACHE_H
+
+#include "cybertwin-topology-reader.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup topology
+ * \brief Compiled form of a Cybertwin topology and application file
+ *
+ * Parsing the YAML files, expanding the templates and allocating the auto
+ * networks gives the same result on every run of a parameter sweep. The
+ * reader can store that result, the resolved NodeInfo_t graph and the
+ * application bindings, in a flat binary file and load it back instead of
+ * the YAML files.
+ *
+ * The file is a header followed by fixed-size node, link, application and
+ * target records and a string table; records refer to strings and to other
+ * records by offset and index only. It is mapped with a single mmap and
+ * read in place, without any parsing. The header carries a format version
+ * and a hash of the source files contents; a file written by another
+ * version or from other sources is rejected and rebuilt.
+ */
+class CybertwinTopologyCache
+{
+  public:
+    /// Layer of a cached node
+    enum Layer
+    {
+        CORE = 0,
+        EDGE = 1,
+        ACCESS = 2,
+    };
+
+    /// Current format version, bump when a record layout changes
+    static const uint32_t VERSION = 2;
+
+    CybertwinTopologyCache();
+    ~CybertwinTopologyCache();
+
+    CybertwinTopologyCache(const CybertwinTopologyCache&) = delete;
+    CybertwinTopologyCache& operator=(const CybertwinTopologyCache&) = delete;
+
+    /**
+     * \brief Hash the content of the source files
+     * \param files the files, missing files hash as empty
+     * \param salt settings which change the compiled result
+     * \return the 64 bit FNV-1a hash
+     */
+    static uint64_t Hash(const std::vector<std::string>& files, const std::string& salt);
+
+    /**
+     * \brief Write a compiled topology
+     * \param path the cache file
+     * \param hash the source hash
+     * \param layers the core, edge and access nodes
+     * \param apps the application bindings
+     * \param cnrsNode the name of the CNRS central node
+     * \return false if the file could not be written
+     */
+    static bool Write(const std::string& path,
+                      uint64_t hash,
+                      const std::vector<NodeInfo_t*> (&layers)[3],
+                      const std::vector<ApplicationInfo_t>& apps,
+                      const std::string& cnrsNode);
+
+    /**
+     * \brief Map a compiled topology
+     * \param path the cache file
+     * \param hash the expected source hash
+     * \return false if the file is missing, stale or malformed
+     */
+    bool Open(const std::string& path, uint64_t hash);
+
+    /**
+     * \brief Unmap the file
+     */
+    void Close();
+
+    /**
+     * \brief Get the number of nodes of a layer
+     */
+    uint32_t GetNodeCount(Layer layer) const;
+
+    /**
+     * \brief Create the node information of a cached node
+     * \param layer the layer
+     * \param index the index of the node in the layer
+     * \return the node information, owned by the caller
+     */
+    NodeInfo_t* CreateNodeInfo(Layer layer, uint32_t index) const;
+
+    /**
+     * \brief Get the application bindings
+     */
+    std::vector<ApplicationInfo_t> GetApplications() const;
+
+    /**
+     * \brief Get the name of the CNRS central node
+     */
+    std::string GetCnrsNode() const;
+
+  private:
+    struct Header;
+    struct NodeRecord;
+    struct LinkRecord;
+    struct AppRecord;
+
+    /**
+     * \brief Get a string of the string table
+     */
+    const char* String(uint32_t offset) const;
+
+    const uint8_t* m_base; //!< start of the mapping
+    std::size_t m_size;    //!< size of the mapping
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_TOPOLOGY_CACHE_H */
@@ -0,0 +1,376 @@
+#include "cybertwin-topology-generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinTopologyGenerator");
+
+namespace
+{
+
+/// Read an optional key of a template entry
+template <typename T>
+T
+Get(const YAML::Node& spec, const char* key, const T& def)
+{
+    return spec[key] ? spec[key].as<T>() : def;
+}
+
+} // namespace
+
+CybertwinTopologyGenerator::CybertwinTopologyGenerator(const NodeSink& sink,
+                                                       NodeType_e replicaType)
+    : m_sink(sink),
+      m_replicaType(replicaType),
+      m_members(1),
+      m_spacing(10.0)
+{
+}
+
+uint32_t
+CybertwinTopologyGenerator::Expand(const YAML::Node& spec, const std::vector<NodeInfo_t*>& parents)
+{
+    NS_ASSERT_MSG(spec["kind"], "Template without kind");
+    std::string kind = spec["kind"].as<std::string>();
+
+    m_prefix = Get<std::string>(spec, "prefix", kind);
+    m_dataRate = Get<std::string>(spec, "data_rate", "1Gbps");
+    m_delay = Get<std::string>(spec, "delay", "1ms");
+    m_members = Get<uint32_t>(spec, "members", 1);
+    m_spacing = Get<double>(spec, "spacing", 10.0);
+    m_origin = Vector(0, 0, 0);
+    if (spec["origin"])
+    {
+        m_origin = Vector(spec["origin"][0].as<double>(),
+                          spec["origin"][1].as<double>(),
+                          spec["origin"][2].as<double>());
+    }
+    m_rng.seed(Get<uint32_t>(spec, "seed", 1));
+
+    NS_LOG_INFO("[CybertwinTopologyGenerator][" << __func__ << "] Expanding " << kind
+                                                << " template " << m_prefix);
+    uint32_t count = 0;
+    if (kind == "fat_tree")
+    {
+        count = FatTree(spec);
+    }
+    else if (kind == "kary_tree")
+    {
+        count = KaryTree(spec);
+    }
+    else if (kind == "waxman")
+    {
+        count = Waxman(spec);
+    }
+    else if (kind == "barabasi_albert")
+    {
+        count = BarabasiAlbert(spec);
+    }
+    else if (kind == "replicate")
+    {
+        count = Replicate(spec, parents);
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown topology template: " << kind);
+    }
+    NS_LOG_INFO("[CybertwinTopologyGenerator][" << __func__ << "] " << m_prefix << ": " << count
+                                                << " nodes");
+    return count;
+}
+
+NodeInfo_t*
+CybertwinTopologyGenerator::NewServer(const std::string& name, const Vector& position) const
+{
+    NodeInfo_t* nodeInfo = new NodeInfo_t();
+    nodeInfo->name = name;
+    nodeInfo->type = NodeType_e::HOST_SERVER;
+    nodeInfo->position = position;
+    nodeInfo->num_nodes = 0;
+    return nodeInfo;
+}
+
+void
+CybertwinTopologyGenerator::Connect(NodeInfo_t* node, const std::string& target) const
+{
+    Link_t link;
+    link.target = target;
+    link.data_rate = m_dataRate;
+    link.delay = m_delay;
+    link.network = "auto";
+    link.members = m_members;
+    node->links.push_back(link);
+}
+
+Vector
+CybertwinTopologyGenerator::GridPosition(uint32_t row, uint32_t column) const
+{
+    return Vector(m_origin.x + column * m_spacing, m_origin.y + row * m_spacing, m_origin.z);
+}
+
+// k-ary fat-tree: core switch i*(k/2)+j is connected to aggregation
+// switch i of every pod, every top-of-rack switch to all the aggregation
+// switches of its pod
+uint32_t
+CybertwinTopologyGenerator::FatTree(const YAML::Node& spec)
+{
+    uint32_t k = Get<uint32_t>(spec, "k", 4);
+    NS_ABORT_MSG_IF(k < 2 || k % 2, "fat_tree k must be even, got " << k);
+    uint32_t half = k / 2;
+    uint32_t count = 0;
+
+    for (uint32_t c = 0; c < half * half; c++)
+    {
+        m_sink(NewServer(m_prefix + "_core" + std::to_string(c), GridPosition(0, c * 2)));
+        count++;
+    }
+
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        for (uint32_t a = 0; a < half; a++)
+        {
+            std::string name = m_prefix + "_agg" + std::to_string(pod) + "_" + std::to_string(a);
+            NodeInfo_t* agg = NewServer(name, GridPosition(1, pod * half + a));
+            for (uint32_t j = 0; j < half; j++)
+            {
+                Connect(agg, m_prefix + "_core" + std::to_string(a * half + j));
+            }
+            m_sink(agg);
+            count++;
+        }
+        for (uint32_t t = 0; t < half; t++)
+        {
+            std::string name = m_prefix + "_tor" + std::to_string(pod) + "_" + std::to_string(t);
+            NodeInfo_t* tor = NewServer(name, GridPosition(2, pod * half + t));
+            for (uint32_t a = 0; a < half; a++)
+            {
+                Connect(tor, m_prefix + "_agg" + std::to_string(pod) + "_" + std::to_string(a));
+            }
+            m_sink(tor);
+            count++;
+        }
+    }
+    return count;
+}
+
+// complete k-ary tree in breadth-first order, node i hangs off (i-1)/k
+uint32_t
+CybertwinTopologyGenerator::KaryTree(const YAML::Node& spec)
+{
+    uint32_t k = Get<uint32_t>(spec, "k", 2);
+    uint32_t depth = Get<uint32_t>(spec, "depth", 3);
+    NS_ABORT_MSG_IF(k < 1 || depth < 1, "kary_tree needs k >= 1 and depth >= 1");
+
+    uint32_t count = 0;
+    uint64_t levelSize = 1;
+    for (uint32_t level = 0; level < depth; level++)
+    {
+        for (uint64_t column = 0; column < levelSize; column++)
+        {
+            NodeInfo_t* node =
+                NewServer(m_prefix + std::to_string(count), GridPosition(level, column));
+            if (count > 0)
+            {
+                Connect(node, m_prefix + std::to_string((count - 1) / k));
+            }
+            m_sink(node);
+            count++;
+        }
+        levelSize *= k;
+    }
+    return count;
+}
+
+// Waxman graph. Node i is only tested against the nodes emitted before it,
+// which covers every pair once. A node left without a link is attached to
+// its nearest predecessor so that the graph stays connected.
+uint32_t
+CybertwinTopologyGenerator::Waxman(const YAML::Node& spec)
+{
+    uint32_t n = Get<uint32_t>(spec, "count", 16);
+    double alpha = Get<double>(spec, "alpha", 0.4);
+    double beta = Get<double>(spec, "beta", 0.1);
+    double size = Get<double>(spec, "size", 100.0);
+    double scale = alpha * size * std::sqrt(2.0);
+
+    std::uniform_real_distribution<double> coordinate(0.0, size);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::pair<double, double>> position;
+    position.reserve(n);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double x = coordinate(m_rng);
+        double y = coordinate(m_rng);
+        NodeInfo_t* node = NewServer(m_prefix + std::to_string(i),
+                                     Vector(m_origin.x + x, m_origin.y + y, m_origin.z));
+
+        uint32_t nearest = 0;
+        double nearestDistance = std::numeric_limits<double>::max();
+        for (uint32_t j = 0; j < i; j++)
+        {
+            double d = std::hypot(x - position[j].first, y - position[j].second);
+            if (uniform(m_rng) < beta * std::exp(-d / scale))
+            {
+                Connect(node, m_prefix + std::to_string(j));
+            }
+            if (d < nearestDistance)
+            {
+                nearestDistance = d;
+                nearest = j;
+            }
+        }
+        if (i > 0 && node->links.empty())
+        {
+            Connect(node, m_prefix + std::to_string(nearest));
+        }
+
+        position.emplace_back(x, y);
+        m_sink(node);
+    }
+    return n;
+}
+
+// Barabasi-Albert graph. Every link endpoint is appended to a list, drawing
+// uniformly from it picks a node with probability proportional to its degree.
+uint32_t
+CybertwinTopologyGenerator::BarabasiAlbert(const YAML::Node& spec)
+{
+    uint32_t n = Get<uint32_t>(spec, "count", 16);
+    uint32_t m = Get<uint32_t>(spec, "m", 2);
+    NS_ABORT_MSG_IF(m < 1, "barabasi_albert needs m >= 1");
+
+    uint32_t columns = std::max<uint32_t>(1, std::ceil(std::sqrt(n)));
+    std::vector<uint32_t> endpoints;
+    endpoints.reserve(2 * static_cast<std::size_t>(n) * m);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        NodeInfo_t* node =
+            NewServer(m_prefix + std::to_string(i), GridPosition(i / columns, i % columns));
+
+        std::vector<uint32_t> targets;
+        if (i <= m)
+        {
+            // the first nodes form a clique
+            for (uint32_t j = 0; j < i; j++)
+            {
+                targets.push_back(j);
+            }
+        }
+        else
+        {
+            std::uniform_int_distribution<std::size_t> pick(0, endpoints.size() - 1);
+            while (targets.size() < m)
+            {
+                uint32_t j = endpoints[pick(m_rng)];
+                if (std::find(targets.begin(), targets.end(), j) == targets.end())
+                {
+                    targets.push_back(j);
+                }
+            }
+        }
+
+        for (uint32_t j : targets)
+        {
+            Connect(node, m_prefix + std::to_string(j));
+            endpoints.push_back(i);
+            endpoints.push_back(j);
+        }
+        m_sink(node);
+    }
+    return n;
+}
+
+// count replicas per matching parent. Edge layer replicas are host servers
+// linked to their parents, access layer replicas are end clusters with one
+// parent as gateway.
+uint32_t
+CybertwinTopologyGenerator::Replicate(const YAML::Node& spec,
+                                      const std::vector<NodeInfo_t*>& parents)
+{
+    uint32_t perParent = Get<uint32_t>(spec, "count", 1);
+    uint32_t uplinks = Get<uint32_t>(spec, "uplinks", 1);
+    std::string attachTo = Get<std::string>(spec, "attach_to", "");
+
+    std::vector<NodeInfo_t*> matching;
+    for (auto parent : parents)
+    {
+        if (parent->name.compare(0, attachTo.size(), attachTo) == 0)
+        {
+            matching.push_back(parent);
+        }
+    }
+    NS_ABORT_MSG_IF(matching.empty(),
+                    "replicate " << m_prefix << ": no parent matches '" << attachTo << "'");
+    // the reader attaches an end cluster to its first gateway only
+    if (m_replicaType == NodeType_e::END_CLUSTER && uplinks > 1)
+    {
+        NS_FATAL_ERROR("replicate " << m_prefix << ": end clusters have a single gateway, "
+                                    << "uplinks must be 1");
+    }
+    uplinks = std::min<uint32_t>(std::max<uint32_t>(uplinks, 1), matching.size());
+
+    // end cluster settings, network_type may be a list cycled over replicas
+    int32_t numNodes = Get<int32_t>(spec, "num_nodes", 4);
+    std::vector<std::string> networkTypes;
+    if (spec["network_type"] && spec["network_type"].IsSequence())
+    {
+        for (const auto& t : spec["network_type"])
+        {
+            networkTypes.push_back(t.as<std::string>());
+        }
+    }
+    else
+    {
+        networkTypes.push_back(Get<std::string>(spec, "network_type", "csma"));
+    }
+
+    uint32_t count = 0;
+    for (uint32_t p = 0; p < matching.size(); p++)
+    {
+        for (uint32_t r = 0; r < perParent; r++)
+        {
+            std::string name = m_prefix + std::to_string(count);
+            Vector pos = matching[p]->position;
+            pos.x += (r - (perParent - 1) / 2.0) * m_spacing / std::max<uint32_t>(perParent, 1);
+            pos.y += m_spacing;
+
+            NodeInfo_t* node = NewServer(name, pos);
+            if (m_replicaType == NodeType_e::END_CLUSTER)
+            {
+                node->type = NodeType_e::END_CLUSTER;
+                node->num_nodes = numNodes;
+                node->network_type = networkTypes[count % networkTypes.size()];
+                node->local_network = "auto";
+            }
+
+            for (uint32_t u = 0; u < uplinks; u++)
+            {
+                const std::string& target = matching[(p + u) % matching.size()]->name;
+                if (node->type == NodeType_e::END_CLUSTER)
+                {
+                    Gateway_t gateway;
+                    gateway.name = target;
+                    gateway.data_rate = m_dataRate;
+                    gateway.delay = m_delay;
+                    gateway.network = "auto";
+                    node->gateways.push_back(gateway);
+                }
+                else
+                {
+                    Connect(node, target);
+                }
+            }
+            m_sink(node);
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,112 @@
+#ifndef CYBERTWIN_TOPOLOGY_GENERATOR_H
+#define CYBERTWIN_TOPOLOGY_GENERATOR_H
+
+#include "cybertwin-topology-reader.h"
+
+#include <functional>
+#include <random>
+
+namespace ns3
+{
+
+/**
+ * \ingroup topology
+ * \brief Expand the template constructs of a Cybertwin topology file
+ *
+ * A layer of the topology file may hold a `generate` list next to its
+ * `nodes` list. Every entry names a template `kind`:
+ *
+ *   - fat_tree: k-ary fat-tree switching fabric, (k/2)^2 core, k*k/2
+ *     aggregation and k*k/2 top-of-rack nodes named
+ *     <prefix>_core<i>, <prefix>_agg<pod>_<i> and <prefix>_tor<pod>_<i>
+ *   - kary_tree: complete k-ary tree of the given depth
+ *   - waxman: Waxman random graph of count nodes placed uniformly in a
+ *     size x size square, an edge is drawn with probability
+ *     beta * exp(-d / (alpha * L))
+ *   - barabasi_albert: preferential attachment graph of count nodes, each
+ *     new node attaching to m existing ones
+ *   - replicate: count nodes per parent of the previous layer whose name
+ *     starts with attach_to, each connected to uplinks consecutive parents.
+ *     In the access layer the replicas are end clusters of num_nodes hosts
+ *     with a single gateway, uplinks must be 1.
+ *
+ * Nodes are handed to the sink one at a time, with their links to nodes
+ * emitted before them already filled in, so that no intermediate YAML
+ * tree or node list is built. Every generated network is "auto", the
+ * reader allocates it when the link or cluster is built.
+ *
+ * Random templates draw from their own generator seeded by the `seed` key,
+ * so a topology file always expands to the same graph.
+ */
+class CybertwinTopologyGenerator
+{
+  public:
+    /// Receive an expanded node
+    typedef std::function<void(NodeInfo_t*)> NodeSink;
+
+    /**
+     * \brief Constructor
+     * \param sink called for every expanded node
+     * \param replicaType node type of the replicate template
+     */
+    CybertwinTopologyGenerator(const NodeSink& sink,
+                               NodeType_e replicaType = NodeType_e::HOST_SERVER);
+
+    /**
+     * \brief Expand a template
+     * \param spec the template entry
+     * \param parents the nodes of the layer above, used by replicate
+     * \return the number of nodes emitted
+     */
+    uint32_t Expand(const YAML::Node& spec, const std::vector<NodeInfo_t*>& parents);
+
+  private:
+    /// \brief Expand a fat_tree template \param spec the template \return the node count
+    uint32_t FatTree(const YAML::Node& spec);
+    /// \brief Expand a kary_tree template \param spec the template \return the node count
+    uint32_t KaryTree(const YAML::Node& spec);
+    /// \brief Expand a waxman template \param spec the template \return the node count
+    uint32_t Waxman(const YAML::Node& spec);
+    /// \brief Expand a barabasi_albert template \param spec the template \return the node count
+    uint32_t BarabasiAlbert(const YAML::Node& spec);
+    /**
+     * \brief Expand a replicate template
+     * \param spec the template
+     * \param parents the nodes of the layer above
+     * \return the node count
+     */
+    uint32_t Replicate(const YAML::Node& spec, const std::vector<NodeInfo_t*>& parents);
+
+    /**
+     * \brief Create a host server node
+     * \param name the node name
+     * \param position the node position
+     */
+    NodeInfo_t* NewServer(const std::string& name, const Vector& position) const;
+
+    /**
+     * \brief Append a link to a node
+     * \param node the source node
+     * \param target the target node name
+     */
+    void Connect(NodeInfo_t* node, const std::string& target) const;
+
+    /**
+     * \brief Position of the node at a row and column of the layout grid
+     */
+    Vector GridPosition(uint32_t row, uint32_t column) const;
+
+    NodeSink m_sink;          //!< expanded node receiver
+    NodeType_e m_replicaType; //!< node type of the replicate template
+    std::string m_prefix;     //!< name prefix of the current template
+    std::string m_dataRate;   //!< link data rate of the current template
+    std::string m_delay;      //!< link delay of the current template
+    uint32_t m_members;       //!< member links of the links of the current template
+    Vector m_origin;          //!< layout origin of the current template
+    double m_spacing;         //!< layout spacing of the current template
+    std::mt19937 m_rng;       //!< random graph generator
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_TOPOLOGY_GENERATOR_H */
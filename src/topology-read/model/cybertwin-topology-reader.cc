@@ -1,5 +1,17 @@
 #include "cybertwin-topology-reader.h"
 
+#include "cybertwin-hierarchical-routing.h"
+#include "cybertwin-topology-cache.h"
+#include "cybertwin-topology-generator.h"
+#include "cybertwin-topology-validator.h"
+
+#include "ns3/point-to-point-bundle-channel.h"
+#include "ns3/point-to-point-bundle-net-device.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+
+#include <chrono>
+
 namespace ns3
 {
 
@@ -13,11 +25,35 @@ CybertwinTopologyReader::GetTypeId()
     static TypeId tid = TypeId("ns3::CybertwinTopologyReader")
                             .SetParent<TopologyReader>()
                             .SetGroupName("TopologyReader")
-                            .AddConstructor<CybertwinTopologyReader>();
+                            .AddConstructor<CybertwinTopologyReader>()
+                            .AddAttribute("AutoLinkNetwork",
+                                          "Pool of the point-to-point networks set to auto",
+                                          StringValue("100.64.0.0/10"),
+                                          MakeStringAccessor(&CybertwinTopologyReader::m_autoLinkNetwork),
+                                          MakeStringChecker())
+                            .AddAttribute("AutoClusterNetwork",
+                                          "Pool of the end cluster networks set to auto",
+                                          StringValue("172.16.0.0/12"),
+                                          MakeStringAccessor(&CybertwinTopologyReader::m_autoClusterNetwork),
+                                          MakeStringChecker())
+                            .AddAttribute("CacheFile",
+                                          "Compiled topology cache, rebuilt when the topology or "
+                                          "application file changes. Empty to disable",
+                                          StringValue(""),
+                                          MakeStringAccessor(&CybertwinTopologyReader::m_cacheFile),
+                                          MakeStringChecker())
+                            .AddAttribute("Validate",
+                                          "Check the parsed topology before building it, "
+                                          "an invalid topology is a fatal error",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&CybertwinTopologyReader::m_validate),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 CybertwinTopologyReader::CybertwinTopologyReader()
+    : m_layerLinkPool{0, 0, 0},
+      m_clusterPool(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -66,12 +102,10 @@ CybertwinTopologyReader::CreateCloudNodeInfo(const YAML::Node& node)
     nodeInfo->name = node["name"].as<std::string>();
     nodeInfo->type = GetNodeType(node["type"].as<std::string>());
     nodeInfo->links = ParseLinks(node["connections"]);
+    nodeInfo->num_nodes = 0;
     nodeInfo->position = Vector(node["position"][0].as<double>(),
                                 node["position"][1].as<double>(),
                                 node["position"][2].as<double>());
-
-    // insert to the node info map
-    m_nodeInfoMap[nodeInfo->name] = nodeInfo;
     return nodeInfo;
 }
 
@@ -82,18 +116,27 @@ CybertwinTopologyReader::CreateEndClusterNodeInfo(const YAML::Node& node)
     nodeInfo->name = node["name"].as<std::string>();
     nodeInfo->type = GetNodeType(node["type"].as<std::string>());
     nodeInfo->num_nodes = node["num_nodes"].as<int>();
-    nodeInfo->local_network = node["local_network"].as<std::string>();
+    nodeInfo->local_network =
+        node["local_network"] ? node["local_network"].as<std::string>() : "auto";
     nodeInfo->network_type = node["network_type"].as<std::string>();
     nodeInfo->gateways = ParseGateways(node["gateways"]);
     nodeInfo->position = Vector(node["position"][0].as<double>(),
                                 node["position"][1].as<double>(),
                                 node["position"][2].as<double>());
-
-    // insert to the node info map
-    m_nodeInfoMap[nodeInfo->name] = nodeInfo;
     return nodeInfo;
 }
 
+// insert to the node info map, names must be unique across explicit and
+// generated nodes
+void
+CybertwinTopologyReader::RegisterNodeInfo(NodeInfo_t* nodeInfo)
+{
+    if (!m_nodeInfoMap.emplace(nodeInfo->name, nodeInfo).second)
+    {
+        NS_FATAL_ERROR("Duplicate node name: " << nodeInfo->name);
+    }
+}
+
 //-----------------------------------------------------------------------------
 //
 //        Parse the topology configuration file
@@ -110,6 +153,7 @@ CybertwinTopologyReader::CreateEndClusterNodeInfo(const YAML::Node& node)
 // 1. nodes
 // 2. links
 // 3. gateways
+// 4. generate
 //
 // The nodes section contains the following information:
 // 1. name
@@ -121,6 +165,16 @@ CybertwinTopologyReader::CreateEndClusterNodeInfo(const YAML::Node& node)
 // 2. data_rate
 // 3. delay
 // 4. network
+// 5. members (optional): a bundle of parallel links of data_rate each,
+//    built as one PointToPointBundleNetDevice per side
+//
+// The generate section lists templates (fat_tree, kary_tree, waxman,
+// barabasi_albert, replicate) expanded by CybertwinTopologyGenerator into
+// nodes of the layer, see cybertwin-topology-generator.h.
+//
+// A network which is omitted or set to "auto" is allocated from the
+// AutoLinkNetwork (links) or AutoClusterNetwork (end clusters) pool,
+// skipping every network written explicitly in the file.
 //
 //-----------------------------------------------------------------------------
 
@@ -132,174 +186,359 @@ CybertwinTopologyReader::ParseCoreCloud(const YAML::Node& coreCloudConfig)
 {
     // parse core cloud
     NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Parsing core cloud...");
-    NS_ASSERT(coreCloudConfig["nodes"]);
-    Ptr<CybertwinCoreServer> coreServerSrc = nullptr;
-    Ptr<CybertwinCoreServer> coreServerDst = nullptr;
+    NS_ASSERT(coreCloudConfig["nodes"] || coreCloudConfig["generate"]);
 
-    // Here we go through all the nodes in the core cloud, create
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating core cloud nodes...");
     for (const auto& node : coreCloudConfig["nodes"])
     {
-        // Parse node information and create the Cybertwin core server
-        NodeInfo_t* nodeInfo = CreateCloudNodeInfo(node);
-        m_coreNodesList.push_back(nodeInfo);
+        AddCoreNode(CreateCloudNodeInfo(node));
+    }
 
-        // create nodes
-        Ptr<Node> n = CreateObject<CybertwinCoreServer>();
-        nodeInfo->node = n;
-        m_nodes.Add(n);
-        m_coreNodes.Add(n);
-        m_nodeName2Ptr[nodeInfo->name] = n;
+    CybertwinTopologyGenerator generator(
+        [this](NodeInfo_t* nodeInfo) { AddCoreNode(nodeInfo); });
+    for (const auto& spec : coreCloudConfig["generate"])
+    {
+        generator.Expand(spec, {});
+    }
+}
 
-        // configure the Cybertiwn core server
-        coreServerSrc = DynamicCast<CybertwinCoreServer>(n);
-        coreServerSrc->SetName(nodeInfo->name);
+// Parse the Edge Cloud Layer
+// The edge cloud layer contains the edge servers
+// The edge servers are connected to the core cloud nodes using point-to-point links
+void
+CybertwinTopologyReader::ParseEdgeCloud(const YAML::Node& edgeCloudConfig)
+{
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Parsing edge cloud...");
 
-        // Install Internet stack on the node
-        InternetStackHelper stack;
-        stack.Install(n);
+    for (const auto& node : edgeCloudConfig["nodes"])
+    {
+        AddEdgeNode(CreateCloudNodeInfo(node));
+    }
 
-        // Set constant position for the core cloud nodes
-        Vector pos = nodeInfo->position;
-        AnimationInterface::SetConstantPosition(n, pos.x, pos.y, pos.z);
+    CybertwinTopologyGenerator generator(
+        [this](NodeInfo_t* nodeInfo) { AddEdgeNode(nodeInfo); });
+    for (const auto& spec : edgeCloudConfig["generate"])
+    {
+        generator.Expand(spec, m_coreNodesList);
     }
+}
 
-    // create links between the core cloud nodes
-    // Here we go through all the nodes and create point-to-point links
-    // between the core cloud nodes
-    // We set the first core cloud node as the Central Name Resolution Service (CNRS)
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating links between core cloud nodes...");
-    for (auto nodeInfo : m_coreNodesList)
+// Parse the Access Network Layer
+// The access network layer contains the end hosts (IoT devices)
+// These devices are connected to the edge servers using point-to-point links
+// The end hosts are connected to the edge servers using CSMA or WiFi
+void
+CybertwinTopologyReader::ParseAccessNetwork(const YAML::Node& accessLayerConfig)
+{
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Parsing access network...");
+    for (const auto& node : accessLayerConfig["nodes"])
     {
-        // get target
-        std::string nodeName = nodeInfo->name;
+        AddAccessCluster(CreateEndClusterNodeInfo(node));
+    }
 
-        // go through all the links and create point-to-point network
-        // between the core cloud nodes
-        for (auto link : nodeInfo->links)
-        {
-            std::string target = link.target;
-            std::string data_rate = link.data_rate;
-            std::string delay = link.delay;
+    // replicas of the access layer are end clusters
+    CybertwinTopologyGenerator generator(
+        [this](NodeInfo_t* nodeInfo) { AddAccessCluster(nodeInfo); },
+        NodeType_e::END_CLUSTER);
+    for (const auto& spec : accessLayerConfig["generate"])
+    {
+        generator.Expand(spec, m_edgeNodesList);
+    }
+}
 
-            coreServerSrc = DynamicCast<CybertwinCoreServer>(nodeInfo->node);
-            coreServerDst = DynamicCast<CybertwinCoreServer>(m_nodeInfoMap[target]->node);
+// The Add* functions only record the node description. The objects of a
+// layer are created in bulk by the Build* functions once the whole layer
+// is known.
+void
+CybertwinTopologyReader::AddCoreNode(NodeInfo_t* nodeInfo)
+{
+    RegisterNodeInfo(nodeInfo);
+    m_coreNodesList.push_back(nodeInfo);
+}
 
-            if (m_nodeInfoMap.find(target) == m_nodeInfoMap.end())
-            {
-                NS_LOG_ERROR("[CybertwinTopologyReader][" << __func__ << "] Node not found: " << target);
-                continue;
-            }
+void
+CybertwinTopologyReader::AddEdgeNode(NodeInfo_t* nodeInfo)
+{
+    RegisterNodeInfo(nodeInfo);
+    m_edgeNodesList.push_back(nodeInfo);
+}
 
-            if (m_links.find(nodeName + target) != m_links.end() ||
-                m_links.find(target + nodeName) != m_links.end())
-            {
-                NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Link already exists: " << nodeName << " " << target);
-                continue;
-            }
+void
+CybertwinTopologyReader::AddAccessCluster(NodeInfo_t* nodeInfo)
+{
+    RegisterNodeInfo(nodeInfo);
+    m_endNodesList.push_back(nodeInfo);
+}
+
+//-----------------------------------------------------------------------------
+//        Batched layer construction
+//-----------------------------------------------------------------------------
+//
+// A layer is built in three steps:
+// 1. the servers of the layer are created and get the Internet stack from
+//    a single helper,
+// 2. the point-to-point links are planned: auto networks are allocated
+//    from the pool of the layer, then the interface addresses of every
+//    link are derived,
+// 3. devices and channels are created and addressed in one pass, reusing
+//    one PointToPointHelper per distinct data rate and delay.
+//
+// The whole construction is serial: Node and Channel constructors register
+// with NodeList and ChannelList, and MAC addresses come from a global
+// counter.
+//
+//-----------------------------------------------------------------------------
 
-            Ipv4InterfaceContainer interfaces =
-                CreateP2PLink(coreServerSrc, coreServerDst, data_rate, delay, link.network);
+template <typename T>
+void
+CybertwinTopologyReader::CreateServers(const std::vector<NodeInfo_t*>& nodeInfos,
+                                       NodeContainer& layerNodes)
+{
+    NodeContainer created;
+    created.Reserve(nodeInfos.size());
+    m_nodes.Reserve(m_nodes.GetN() + nodeInfos.size());
+    layerNodes.Reserve(layerNodes.GetN() + nodeInfos.size());
+    m_nodeName2Ptr.reserve(m_nodeName2Ptr.size() + nodeInfos.size());
+
+    for (auto nodeInfo : nodeInfos)
+    {
+        Ptr<T> server = CreateObject<T>();
+        server->SetName(nodeInfo->name);
+        nodeInfo->node = server;
+        created.Add(server);
+        m_nodeName2Ptr[nodeInfo->name] = server;
+
+        // Set constant position for the cloud nodes
+        Vector pos = nodeInfo->position;
+        AnimationInterface::SetConstantPosition(server, pos.x, pos.y, pos.z);
+    }
 
-            // configure core server, add global IP address and parent node
-            // the m_links set is used to keep track of the links and avoid
-            // creating duplicate links and loops
-            coreServerSrc->AddGlobalIp(interfaces.GetAddress(0));
-            coreServerDst->AddGlobalIp(interfaces.GetAddress(1));
+    // Install Internet stack on the nodes
+    m_stack.Install(created);
+    m_nodes.Add(created);
+    layerNodes.Add(created);
+}
 
-            m_links.insert(nodeName + target);
-            m_links.insert(target + nodeName);
+// Derive the interface addresses of the links
+void
+CybertwinTopologyReader::PlanP2PLinks(std::vector<P2PLinkPlan>& plans)
+{
+    for (auto& plan : plans)
+    {
+        uint32_t base;
+        uint32_t prefixLength;
+        plan.valid = CybertwinAddressAllocator::Parse(*plan.network, base, prefixLength) &&
+                     prefixLength <= 30;
+        if (plan.valid)
+        {
+            plan.address[0] = Ipv4Address(base + 1);
+            plan.address[1] = Ipv4Address(base + 2);
+            plan.mask = Ipv4Mask(prefixLength ? 0xFFFFFFFF << (32 - prefixLength) : 0);
         }
     }
 }
 
-// Parse the Edge Cloud Layer
-// The edge cloud layer contains the edge servers
-// The edge servers are connected to the core cloud nodes using point-to-point links
 void
-CybertwinTopologyReader::ParseEdgeCloud(const YAML::Node& edgeCloudConfig)
+CybertwinTopologyReader::BuildP2PLinks(std::vector<P2PLinkPlan>& plans,
+                                       uint32_t pool,
+                                       NetDeviceContainer& layerDevices)
 {
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Parsing edge cloud...");
-    Ptr<CybertwinEdgeServer> edgeServer = nullptr;
+    NS_LOG_FUNCTION(this << plans.size() << pool);
 
-    // Here we go through all the nodes in the edge cloud, create
-    // the Cybertwin edge server and connect the edge servers to
-    // the core cloud nodes
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating edge cloud nodes...");
-    for (const auto& node : edgeCloudConfig["nodes"])
+    // allocation order decides the addresses, keep it sequential
+    for (auto& plan : plans)
     {
-        // Parse node information and create the Cybertwin edge server
-        NodeInfo_t* nodeInfo = CreateCloudNodeInfo(node);
-        m_edgeNodesList.push_back(nodeInfo);
-
-        // create nodes
-        Ptr<Node> n = CreateObject<CybertwinEdgeServer>();
-        nodeInfo->node = n;
-        m_nodes.Add(n);
-        m_edgeNodes.Add(n);
-        m_nodeName2Ptr[nodeInfo->name] = n;
+        ResolveNetwork(*plan.network, pool, 2);
+    }
 
-        // configure the Cybertiwn edge server
-        edgeServer = DynamicCast<CybertwinEdgeServer>(n);
-        edgeServer->SetName(nodeInfo->name);
+    PlanP2PLinks(plans);
 
-        // Install Internet stack on the node
-        InternetStackHelper stack;
-        stack.Install(n);
+    layerDevices.Reserve(layerDevices.GetN() + 2 * plans.size());
+    m_devices.Reserve(m_devices.GetN() + 2 * plans.size());
+    std::map<std::pair<std::string, std::string>, PointToPointHelper> helpers;
+    TrafficControlHelper tch = TrafficControlHelper::Default();
 
-        // Set constant position for the edge cloud nodes
-        Vector pos = nodeInfo->position;
-        AnimationInterface::SetConstantPosition(n, pos.x, pos.y, pos.z);
+    for (auto& plan : plans)
+    {
+        NS_ABORT_MSG_IF(!plan.valid, "Invalid point-to-point network " << *plan.network);
 
-        // connect to the core cloud nodes
-        for (auto link : nodeInfo->links)
+        NetDeviceContainer devices;
+        if (plan.members > 1)
         {
-            Ipv4InterfaceContainer interfaces;
-            std::string target = link.target;
-            std::string data_rate = link.data_rate;
-            std::string delay = link.delay;
+            devices = InstallBundle(plan);
+        }
+        else
+        {
+            auto key = std::make_pair(*plan.dataRate, *plan.delay);
+            auto it = helpers.find(key);
+            if (it == helpers.end())
+            {
+                it = helpers.emplace(key, PointToPointHelper()).first;
+                it->second.SetDeviceAttribute("DataRate", StringValue(*plan.dataRate));
+                it->second.SetChannelAttribute("Delay", StringValue(*plan.delay));
+            }
+            devices = it->second.Install(plan.nodes[0], plan.nodes[1]);
+        }
+        layerDevices.Add(devices);
+        m_devices.Add(devices);
+
+        // the equivalent of Ipv4AddressHelper::Assign, without registering
+        // every address with the global Ipv4AddressGenerator, which scans
+        // its whole list on each insertion. Networks are collision-free
+        // by construction.
+        for (uint32_t side = 0; side < 2; side++)
+        {
+            Ptr<NetDevice> device = devices.Get(side);
+            Ptr<Ipv4> ipv4 = plan.nodes[side]->GetObject<Ipv4>();
+            NS_ASSERT_MSG(ipv4, "No Ipv4 on node " << plan.nodes[side]->GetId());
+            int32_t interface = ipv4->GetInterfaceForDevice(device);
+            if (interface == -1)
+            {
+                interface = ipv4->AddInterface(device);
+            }
+            ipv4->AddAddress(interface, Ipv4InterfaceAddress(plan.address[side], plan.mask));
+            ipv4->SetMetric(interface, 1);
+            ipv4->SetUp(interface);
+            plan.interfaces.Add(ipv4, interface);
+
+            // the members of a bundle queue their own packets
+            Ptr<TrafficControlLayer> tc = plan.nodes[side]->GetObject<TrafficControlLayer>();
+            if (plan.members == 1 && tc && !tc->GetRootQueueDiscOnDevice(device))
+            {
+                tch.Install(device);
+            }
+        }
+    }
+}
+
+// A bundle of plan.members parallel links, one device per side
+NetDeviceContainer
+CybertwinTopologyReader::InstallBundle(const P2PLinkPlan& plan)
+{
+    Ptr<PointToPointBundleChannel> channel = CreateObject<PointToPointBundleChannel>();
+    channel->SetAttribute("Delay", StringValue(*plan.delay));
+
+    NetDeviceContainer devices;
+    for (uint32_t side = 0; side < 2; side++)
+    {
+        Ptr<PointToPointBundleNetDevice> device = CreateObject<PointToPointBundleNetDevice>();
+        device->SetAttribute("DataRate", StringValue(*plan.dataRate));
+        device->SetAttribute("Members", UintegerValue(plan.members));
+        device->SetAddress(Mac48Address::Allocate());
+        plan.nodes[side]->AddDevice(device);
+        device->Attach(channel);
+        devices.Add(device);
+    }
+    return devices;
+}
 
-            if (m_nodeInfoMap.find(target) == m_nodeInfoMap.end())
+void
+CybertwinTopologyReader::BuildCoreLayer()
+{
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating " << m_coreNodesList.size()
+                                             << " core cloud nodes...");
+    CreateServers<CybertwinCoreServer>(m_coreNodesList, m_coreNodes);
+
+    // the m_links set is used to keep track of the links and avoid
+    // creating duplicate links and loops
+    std::vector<P2PLinkPlan> plans;
+    for (auto nodeInfo : m_coreNodesList)
+    {
+        for (auto& link : nodeInfo->links)
+        {
+            auto target = m_nodeInfoMap.find(link.target);
+            if (target == m_nodeInfoMap.end() || !target->second->node)
+            {
+                NS_LOG_ERROR("[CybertwinTopologyReader][" << __func__ << "] Node not found: " << link.target);
+                continue;
+            }
+            if (!m_links.insert(nodeInfo->name + link.target).second ||
+                !m_links.insert(link.target + nodeInfo->name).second)
             {
-                NS_LOG_ERROR("Node not found: " << target);
+                NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Link already exists: " << nodeInfo->name << " " << link.target);
                 continue;
             }
+            plans.push_back(P2PLinkPlan(nodeInfo->node, target->second->node, link));
+        }
+    }
+
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating " << plans.size()
+                                             << " links between core cloud nodes...");
+    BuildP2PLinks(plans, m_layerLinkPool[0], m_coreDevices);
 
-            interfaces = CreateP2PLink(nodeInfo->node,
-                                       m_nodeInfoMap[target]->node,
-                                       data_rate,
-                                       delay,
-                                       link.network);
-
-            // Configure edge server
-            edgeServer->AddParent(m_nodeInfoMap[target]->node);
-            edgeServer->SetAttribute("UpperNodeAddress",
-                                     Ipv4AddressValue(interfaces.GetAddress(1)));
-            edgeServer->AddGlobalIp(interfaces.GetAddress(0));
+    // configure core server, add global IP address
+    for (const auto& plan : plans)
+    {
+        DynamicCast<CybertwinCoreServer>(plan.nodes[0])->AddGlobalIp(plan.interfaces.GetAddress(0));
+        DynamicCast<CybertwinCoreServer>(plan.nodes[1])->AddGlobalIp(plan.interfaces.GetAddress(1));
+    }
+}
+
+void
+CybertwinTopologyReader::BuildEdgeLayer()
+{
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating " << m_edgeNodesList.size()
+                                             << " edge cloud nodes...");
+    CreateServers<CybertwinEdgeServer>(m_edgeNodesList, m_edgeNodes);
+
+    // connect to the core cloud nodes
+    std::vector<P2PLinkPlan> plans;
+    for (auto nodeInfo : m_edgeNodesList)
+    {
+        for (auto& link : nodeInfo->links)
+        {
+            auto target = m_nodeInfoMap.find(link.target);
+            if (target == m_nodeInfoMap.end() || !target->second->node)
+            {
+                NS_LOG_ERROR("Node not found: " << link.target);
+                continue;
+            }
+            plans.push_back(P2PLinkPlan(nodeInfo->node, target->second->node, link));
         }
     }
+
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating " << plans.size()
+                                             << " edge uplinks...");
+    BuildP2PLinks(plans, m_layerLinkPool[1], m_edgeDevices);
+
+    // Configure edge server
+    for (const auto& plan : plans)
+    {
+        Ptr<CybertwinEdgeServer> edgeServer = DynamicCast<CybertwinEdgeServer>(plan.nodes[0]);
+        edgeServer->AddParent(plan.nodes[1]);
+        edgeServer->SetAttribute("UpperNodeAddress", Ipv4AddressValue(plan.interfaces.GetAddress(1)));
+        edgeServer->AddGlobalIp(plan.interfaces.GetAddress(0));
+    }
 }
 
-// Parse the Access Network Layer
-// The access network layer contains the end hosts (IoT devices)
-// These devices are connected to the edge servers using point-to-point links
-// The end hosts are connected to the edge servers using CSMA or WiFi
 void
-CybertwinTopologyReader::ParseAccessNetwork(const YAML::Node& accessLayerConfig)
+CybertwinTopologyReader::BuildAccessLayer()
 {
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Parsing access network...");
-    for (const auto& node : accessLayerConfig["nodes"])
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating "
+                                             << m_endNodesList.size() << " end clusters...");
+    uint64_t hosts = 0;
+    for (auto nodeInfo : m_endNodesList)
+    {
+        hosts += nodeInfo->num_nodes;
+    }
+    m_nodes.Reserve(m_nodes.GetN() + hosts + m_endNodesList.size());
+    m_endNodes.Reserve(m_endNodes.GetN() + hosts);
+    m_endhostNodes.Reserve(m_endhostNodes.GetN() + hosts);
+
+    // clusters are heterogeneous, they are built one at a time
+    std::vector<P2PLinkPlan> plans;
+    std::vector<NodeContainer> clusters;
+    plans.reserve(m_endNodesList.size());
+    clusters.reserve(m_endNodesList.size());
+    for (auto nodeInfo : m_endNodesList)
     {
-        // print node
-        NodeInfo_t* nodeInfo = CreateEndClusterNodeInfo(node);
-        m_nodeInfoMap[nodeInfo->name] = nodeInfo;
+        // the router shares the local network with the end hosts
+        ResolveNetwork(nodeInfo->local_network, m_clusterPool, nodeInfo->num_nodes + 1);
 
         // Create different access network according to the network type
         // The router is the gateway to the edge cloud
         Ptr<Node> router = nullptr;
-        Ptr<Node> gateway = nullptr;
         NodeContainer endNodes;
-        std::string netType = node["network_type"].as<std::string>();
+        const std::string& netType = nodeInfo->network_type;
         if (netType == "csma")
         {
             NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating CSMA network...");
@@ -322,33 +561,133 @@ CybertwinTopologyReader::ParseAccessNetwork(const YAML::Node& accessLayerConfig)
         }
         else
         {
-            NS_LOG_ERROR("Unknown network type: " << netType);
+            NS_FATAL_ERROR("Unknown network type: " << netType);
         }
 
         // TODO: add multiple gateways support
         // connect end cluster to the edge cloud
         // currently we only support one gateway
         NS_ASSERT(nodeInfo->gateways.size() > 0);
-        NS_LOG_WARN("[CybertwinTopologyReader][" << __func__ << "] Multiple gateways are not supported yet...");
-        NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Connecting end cluster to the edge cloud...");
-        gateway = m_nodeInfoMap[nodeInfo->gateways[0].name]->node;
-        Ipv4InterfaceContainer interfaces = CreateP2PLink(router,
-                                                          gateway,
-                                                          nodeInfo->gateways[0].data_rate,
-                                                          nodeInfo->gateways[0].delay,
-                                                          nodeInfo->gateways[0].network);
+        if (nodeInfo->gateways.size() > 1)
+        {
+            NS_LOG_WARN("[CybertwinTopologyReader][" << __func__ << "] Multiple gateways are not supported yet...");
+        }
+        auto gateway = m_nodeInfoMap.find(nodeInfo->gateways[0].name);
+        NS_ABORT_MSG_IF(gateway == m_nodeInfoMap.end() || !gateway->second->node,
+                        "Gateway not found: " << nodeInfo->gateways[0].name);
+        plans.push_back(P2PLinkPlan(router, gateway->second->node, nodeInfo->gateways[0]));
+        clusters.push_back(endNodes);
+        nodeInfo->node = router;
+        nodeInfo->nodes = endNodes;
+    }
+
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Connecting " << plans.size()
+                                             << " end clusters to the edge cloud...");
+    BuildP2PLinks(plans, m_layerLinkPool[2], m_endDevices);
+
+    for (std::size_t c = 0; c < plans.size(); c++)
+    {
+        const P2PLinkPlan& plan = plans[c];
+        Ptr<Node> gateway = plan.nodes[1];
 
         // configure the end cluster
-        for (int i = 0; i < nodeInfo->num_nodes; i++)
+        for (uint32_t i = 0; i < clusters[c].GetN(); i++)
         {
-            Ptr<CybertwinEndHost> endHost = DynamicCast<CybertwinEndHost>(endNodes.Get(i));
+            Ptr<CybertwinEndHost> endHost = DynamicCast<CybertwinEndHost>(clusters[c].Get(i));
             endHost->AddParent(gateway);
-            endHost->SetAttribute("UpperNodeAddress", Ipv4AddressValue(interfaces.GetAddress(1)));
+            endHost->SetAttribute("UpperNodeAddress", Ipv4AddressValue(plan.interfaces.GetAddress(1)));
         }
 
         // configure the gateway
         Ptr<CybertwinEdgeServer> edgeServer = DynamicCast<CybertwinEdgeServer>(gateway);
-        edgeServer->AddGlobalIp(interfaces.GetAddress(1));
+        edgeServer->AddGlobalIp(plan.interfaces.GetAddress(1));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//        Automatic addressing
+//-----------------------------------------------------------------------------
+
+// Reserve every network written in the file before anything is allocated,
+// so that auto networks never collide with explicit ones whatever the
+// order of the layers
+void
+CybertwinTopologyReader::ReserveExplicitNetworks(const YAML::Node& cybertwinNetwork)
+{
+    NS_LOG_FUNCTION(this);
+    auto reserve = [this](const YAML::Node& network) {
+        if (!network)
+        {
+            return;
+        }
+        std::string value = network.as<std::string>();
+        if (value != "auto" && !m_addressAllocator.Reserve(value))
+        {
+            NS_LOG_WARN("[CybertwinTopologyReader] Network " << value
+                                                             << " overlaps another network");
+        }
+    };
+
+    for (const char* layer : {"core_layer", "edge_layer", "access_layer"})
+    {
+        if (!cybertwinNetwork[layer])
+        {
+            continue;
+        }
+        for (const auto& node : cybertwinNetwork[layer]["nodes"])
+        {
+            for (const auto& link : node["connections"])
+            {
+                reserve(link["network"]);
+            }
+            for (const auto& gateway : node["gateways"])
+            {
+                reserve(gateway["network"]);
+            }
+            reserve(node["local_network"]);
+        }
+    }
+
+    CreateAddressPools();
+}
+
+// The link pool is split in one pool per layer, so that the links of a
+// layer get contiguous networks
+void
+CybertwinTopologyReader::CreateAddressPools()
+{
+    uint32_t base;
+    uint32_t prefixLength;
+    if (!CybertwinAddressAllocator::Parse(m_autoLinkNetwork, base, prefixLength))
+    {
+        NS_FATAL_ERROR("Malformed AutoLinkNetwork " << m_autoLinkNetwork);
+    }
+    if (prefixLength <= 28)
+    {
+        for (uint32_t layer = 0; layer < 3; layer++)
+        {
+            Ipv4Address layerBase(base + (layer << (32 - prefixLength - 2)));
+            std::ostringstream pool;
+            pool << layerBase << "/" << prefixLength + 2;
+            m_layerLinkPool[layer] = m_addressAllocator.AddPool(pool.str());
+        }
+    }
+    else
+    {
+        uint32_t pool = m_addressAllocator.AddPool(m_autoLinkNetwork);
+        std::fill(m_layerLinkPool, m_layerLinkPool + 3, pool);
+    }
+    m_clusterPool = m_addressAllocator.AddPool(m_autoClusterNetwork);
+}
+
+void
+CybertwinTopologyReader::ResolveNetwork(std::string& network, uint32_t pool, uint32_t hosts)
+{
+    if (network.empty() || network == "auto")
+    {
+        network = m_addressAllocator.Allocate(
+            pool,
+            CybertwinAddressAllocator::PrefixLengthForHosts(hosts));
     }
 }
 
@@ -360,9 +699,10 @@ CybertwinTopologyReader::ParseLinks(const YAML::Node& linksNode)
     {
         Link_t linkInfo;
         linkInfo.target = link["target"].as<std::string>();
-        linkInfo.network = link["network"].as<std::string>();
+        linkInfo.network = link["network"] ? link["network"].as<std::string>() : "auto";
         linkInfo.data_rate = link["data_rate"].as<std::string>();
         linkInfo.delay = link["delay"].as<std::string>();
+        linkInfo.members = link["members"] ? link["members"].as<uint32_t>() : 1;
         links.push_back(linkInfo);
     }
     return links;
@@ -376,7 +716,7 @@ CybertwinTopologyReader::ParseGateways(const YAML::Node& gateways)
     {
         Gateway_t gatewayInfo;
         gatewayInfo.name = gateway["target"].as<std::string>();
-        gatewayInfo.network = gateway["network"].as<std::string>();
+        gatewayInfo.network = gateway["network"] ? gateway["network"].as<std::string>() : "auto";
         gatewayInfo.data_rate = gateway["data_rate"].as<std::string>();
         gatewayInfo.delay = gateway["delay"].as<std::string>();
         gatewaysList.push_back(gatewayInfo);
@@ -384,27 +724,6 @@ CybertwinTopologyReader::ParseGateways(const YAML::Node& gateways)
     return gatewaysList;
 }
 
-Ipv4InterfaceContainer
-CybertwinTopologyReader::CreateP2PLink(Ptr<Node> sourceNode,
-                                       Ptr<Node> targetNode,
-                                       std::string& data_rate,
-                                       std::string& delay,
-                                       std::string& network)
-{
-    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] Creating point-to-point link...");
-    PointToPointHelper p2p;
-    p2p.SetDeviceAttribute("DataRate", StringValue(data_rate));
-    p2p.SetChannelAttribute("Delay", StringValue(delay));
-
-    NetDeviceContainer devices = p2p.Install(sourceNode, targetNode);
-    m_coreDevices.Add(devices);
-
-    // assign IP addresses
-    Ipv4InterfaceContainer interfaces = AssignIPAddresses(devices, network);
-
-    return interfaces;
-}
-
 /**
  * Create a CSMA network
  *
@@ -449,8 +768,7 @@ CybertwinTopologyReader::CreateCsmaNetwork(NodeInfo* csma, Ptr<Node>& leader)
     devices = csmaHelper.Install(nodes);
 
     // Install Internet stack on the node
-    InternetStackHelper stack;
-    stack.Install(nodes);
+    m_stack.Install(nodes);
 
     // assign IP addresses
     Ipv4InterfaceContainer interfaces = AssignIPAddresses(devices, csma->local_network);
@@ -545,8 +863,7 @@ CybertwinTopologyReader::CreateWifiNetwork(NodeInfo* wifi, Ptr<Node>& leader)
     mobility.Install(apNode);
 
     // Install Internet stack on the node
-    InternetStackHelper stack;
-    stack.Install(allNodes);
+    m_stack.Install(allNodes);
 
     // Assign IP addresses
     NetDeviceContainer devices = apDevices.Get(0);
@@ -607,8 +924,7 @@ CybertwinTopologyReader::CreateLteNetwork(NodeInfo* lte, Ptr<Node>& leader)
     NetDeviceContainer ueLteDevs = m_lteHelper->InstallUeDevice(ueNodes);
 
     // Install the IP stack on the UEs
-    InternetStackHelper internet;
-    internet.Install(ueNodes);
+    m_stack.Install(ueNodes);
 
     // Assign IP address to UEs
     Ipv4InterfaceContainer ueIpIfaces = m_epcHelper->AssignUeIpv4Address(ueLteDevs);
@@ -673,8 +989,7 @@ CybertwinTopologyReader::CreateUanNetwork(NodeInfo* uan, Ptr<Node>& leader)
     AcousticModemEnergyModelHelper acousticModemEnergyModelHelper;
     acousticModemEnergyModelHelper.Install(netDevices, energySources);
 
-    InternetStackHelper internetStackHelper;
-    internetStackHelper.Install(allNodes);
+    m_stack.Install(allNodes);
            
     // Assign IP addresses
     Ipv4InterfaceContainer interfaces = AssignIPAddresses(netDevices, uan->local_network);
@@ -743,6 +1058,34 @@ CybertwinTopologyReader::ShowNetworkTopology()
     }
 }
 
+// Routes of the layers built by Read, see CybertwinHierarchicalRouting
+void
+CybertwinTopologyReader::PopulateHierarchicalRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    auto start = std::chrono::steady_clock::now();
+
+    CybertwinHierarchicalRouting routing;
+    for (auto nodeInfo : m_coreNodesList)
+    {
+        routing.AddCoreNode(nodeInfo->node);
+    }
+    for (auto nodeInfo : m_edgeNodesList)
+    {
+        routing.AddEdgeNode(nodeInfo->node);
+    }
+    for (auto nodeInfo : m_endNodesList)
+    {
+        auto gateway = m_nodeInfoMap.find(nodeInfo->gateways[0].name);
+        routing.AddAccessCluster(nodeInfo->node, gateway->second->node, nodeInfo->nodes);
+    }
+    routing.Populate();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    NS_LOG_INFO("[CybertwinTopologyReader][" << __func__ << "] " << routing.GetRouteCount()
+                                             << " routes in " << elapsed.count() << " s");
+}
+
 NodeContainer
 CybertwinTopologyReader::GetCoreCloudNodes()
 {
@@ -783,11 +1126,10 @@ CybertwinTopologyReader::GetStaNodes()
 // Currently we need to manually set the centralized 
 // node at the core cloud
 void
-CybertwinTopologyReader::ConfigCNRS(const YAML::Node& cnrsConfig)
+CybertwinTopologyReader::ConfigCNRS(const std::string& centralNode)
 {
-    NS_LOG_FUNCTION(this);
-    NS_ASSERT(cnrsConfig["central_node"]);
-    std::string centralNode = cnrsConfig["central_node"].as<std::string>();
+    NS_LOG_FUNCTION(this << centralNode);
+    m_cnrsNodeName = centralNode;
     Ptr<Node> node = GetNodeByName(centralNode);
     Ptr<CybertwinCoreServer> coreServer = DynamicCast<CybertwinCoreServer>(node);
     // Set this node as the root of CNRS
@@ -814,6 +1156,22 @@ NodeContainer
 CybertwinTopologyReader::Read()
 {
     NS_LOG_FUNCTION(this);
+
+    // the compiled topology depends on the sources and on the address pools
+    uint64_t hash = 0;
+    if (!m_cacheFile.empty())
+    {
+        hash = CybertwinTopologyCache::Hash({GetFileName(), m_appFils},
+                                            m_autoLinkNetwork + " " + m_autoClusterNetwork);
+        CybertwinTopologyCache cache;
+        if (cache.Open(m_cacheFile, hash))
+        {
+            NS_LOG_INFO("[CybertwinTopologyReader][Read] Reading compiled topology " << m_cacheFile);
+            ReadFromCache(cache);
+            return m_nodes;
+        }
+    }
+
     YAML::Node topology_yaml = YAML::LoadFile(GetFileName());
     NS_LOG_INFO("[CybertwinTopologyReader][Read] Reading topology configuration file " << GetFileName());
 
@@ -822,15 +1180,47 @@ CybertwinTopologyReader::Read()
     const YAML::Node& cybertwin_network = topology_yaml["cybertwin_network"];
     NS_ASSERT(cybertwin_network["core_layer"] || cybertwin_network["edge_layer"] ||
               cybertwin_network["access_layer"]);
+    ReserveExplicitNetworks(cybertwin_network);
 
     // parse core, edge and end layers
     ParseCoreCloud(cybertwin_network["core_layer"]);
     ParseEdgeCloud(cybertwin_network["edge_layer"]);
     ParseAccessNetwork(cybertwin_network["access_layer"]);
 
-    // config CNRS
     NS_ASSERT(cybertwin_network["cnrs"]);
-    ConfigCNRS(cybertwin_network["cnrs"]);
+    NS_ASSERT(cybertwin_network["cnrs"]["central_node"]);
+    std::string cnrsRoot = cybertwin_network["cnrs"]["central_node"].as<std::string>();
+    if (m_validate)
+    {
+        ValidateTopology(cnrsRoot);
+    }
+
+    // build the layers, each one links to the previous ones
+    BuildCoreLayer();
+    BuildEdgeLayer();
+    BuildAccessLayer();
+
+    // config CNRS
+    ConfigCNRS(cnrsRoot);
+
+    NS_LOG_INFO("[CybertwinTopologyReader][Read] " << m_nodes.GetN() << " nodes, "
+                                                   << m_addressAllocator.GetAllocated()
+                                                   << " networks allocated");
+
+    // the node lists now hold the resolved networks, store them with the
+    // application bindings for the next runs
+    if (!m_cacheFile.empty())
+    {
+        if (!m_appFils.empty() && m_applications.empty())
+        {
+            LoadApplications();
+        }
+        CybertwinTopologyCache::Write(m_cacheFile,
+                                      hash,
+                                      {m_coreNodesList, m_edgeNodesList, m_endNodesList},
+                                      m_applications,
+                                      m_cnrsNodeName);
+    }
 
     // Output Nodes
     //ShowNetworkTopology();
@@ -838,6 +1228,68 @@ CybertwinTopologyReader::Read()
     return m_nodes;
 }
 
+// Check the parsed topology before any ns-3 object is created, a broken
+// topology fails in a few milliseconds instead of during the construction
+// or the run
+void
+CybertwinTopologyReader::ValidateTopology(const std::string& cnrsRoot)
+{
+    NS_LOG_FUNCTION(this);
+    auto start = std::chrono::steady_clock::now();
+
+    CybertwinTopologyValidator validator(m_coreNodesList, m_edgeNodesList, m_endNodesList);
+    validator.SetCnrsRoot(cnrsRoot);
+    if (!m_appFils.empty())
+    {
+        LoadApplications();
+        validator.SetApplications(m_applications);
+    }
+    bool valid = validator.Validate();
+
+    std::ostringstream report;
+    validator.Print(report);
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    NS_LOG_INFO("[CybertwinTopologyReader][ValidateTopology] " << report.str() << "Validated in "
+                                                               << elapsed << " s");
+    if (!valid)
+    {
+        NS_FATAL_ERROR("Invalid topology " << GetFileName() << "\n" << report.str());
+    }
+}
+
+// Build the network from a compiled topology. Every network is resolved
+// already, the nodes go through the same construction as parsed ones.
+void
+CybertwinTopologyReader::ReadFromCache(const CybertwinTopologyCache& cache)
+{
+    NS_LOG_FUNCTION(this);
+    CreateAddressPools();
+
+    for (uint32_t i = 0; i < cache.GetNodeCount(CybertwinTopologyCache::CORE); i++)
+    {
+        AddCoreNode(cache.CreateNodeInfo(CybertwinTopologyCache::CORE, i));
+    }
+    BuildCoreLayer();
+
+    for (uint32_t i = 0; i < cache.GetNodeCount(CybertwinTopologyCache::EDGE); i++)
+    {
+        AddEdgeNode(cache.CreateNodeInfo(CybertwinTopologyCache::EDGE, i));
+    }
+    BuildEdgeLayer();
+
+    for (uint32_t i = 0; i < cache.GetNodeCount(CybertwinTopologyCache::ACCESS); i++)
+    {
+        AddAccessCluster(cache.CreateNodeInfo(CybertwinTopologyCache::ACCESS, i));
+    }
+    BuildAccessLayer();
+
+    ConfigCNRS(cache.GetCnrsNode());
+    m_applications = cache.GetApplications();
+
+    NS_LOG_INFO("[CybertwinTopologyReader][ReadFromCache] " << m_nodes.GetN() << " nodes");
+}
+
 // Install applications
 void
 CybertwinTopologyReader::SetAppFiles(const std::string& files)
@@ -846,7 +1298,7 @@ CybertwinTopologyReader::SetAppFiles(const std::string& files)
 }
 
 void
-CybertwinTopologyReader::InstallApplications()
+CybertwinTopologyReader::LoadApplications()
 {
     NS_LOG_FUNCTION(this);
 
@@ -869,17 +1321,16 @@ CybertwinTopologyReader::InstallApplications()
     // read applications from the application file
     NS_ASSERT(app_yaml["applications"]);
     const YAML::Node& applications = app_yaml["applications"];
-    NS_LOG_INFO("[CybertwinTopologyReader][InstallApplications] Installing applications...");
+    m_applications.clear();
 
     for (const auto& app : applications)
     {
         std::string appName = app["name"].as<std::string>();
-        std::string appType = app["type"].as<std::string>();
         bool enabled = app["enabled"].as<bool>();
 
         if (!enabled)
         {
-            NS_LOG_INFO("[CybertwinTopologyReader][InstallApplications] Application " << appName << " is disabled");
+            NS_LOG_INFO("[CybertwinTopologyReader][LoadApplications] Application " << appName << " is disabled");
             continue;
         }
 
@@ -895,18 +1346,11 @@ CybertwinTopologyReader::InstallApplications()
         //      - start-delay: 0
         //        cybertwin-id: 1000
         //        cybertwin-port: 1000
-        std::vector<std::string> nodes;
+        ApplicationInfo_t appInfo;
+        appInfo.appName = appName;
         for (const auto& node : app["target_nodes"])
         {
-            nodes.push_back(node.as<std::string>());
-        }
-
-        // install the application on the nodes
-        NodeContainer targetNodes;
-        for (const auto& nodeName : nodes)
-        {
-            Ptr<Node> node = GetNodeByName(nodeName);
-            targetNodes.Add(node);
+            appInfo.targetNodes.push_back(node.as<std::string>());
         }
 
         YAML::Node newParams;
@@ -919,10 +1363,37 @@ CybertwinTopologyReader::InstallApplications()
                 newParams[key] = value;
             }
         }
+        appInfo.parameters = YAML::Dump(newParams);
+
+        m_applications.push_back(appInfo);
+    }
+}
+
+void
+CybertwinTopologyReader::InstallApplications()
+{
+    NS_LOG_FUNCTION(this);
+
+    // the bindings come from the compiled topology when it was used
+    if (m_applications.empty())
+    {
+        LoadApplications();
+    }
+    NS_LOG_INFO("[CybertwinTopologyReader][InstallApplications] Installing applications...");
+
+    for (const auto& app : m_applications)
+    {
+        // install the application on the nodes
+        NodeContainer targetNodes;
+        for (const auto& nodeName : app.targetNodes)
+        {
+            Ptr<Node> node = GetNodeByName(nodeName);
+            targetNodes.Add(node);
+        }
 
         CybertwinAppHelper appHelper;
-        appHelper.InstallApplications(appName, newParams, targetNodes);
+        appHelper.InstallApplications(app.appName, YAML::Load(app.parameters), targetNodes);
     }
 }
 
-} // namespace ns3
\ No newline at end of file
+} // namespace ns3
@@ -10,7 +10,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ssid.h"
 #include "ns3/yans-wifi-helper.h"
-#include "ns3/topology-read-module.h"
+#include "ns3/topology-reader.h"
 #include "ns3/netanim-module.h"
 #include "ns3/uan-module.h"
 #include "ns3/lte-module.h"
@@ -25,6 +25,8 @@
 
 #include "ns3/cybertwin-app-helper.h"
 
+#include "cybertwin-address-allocator.h"
+
 // using yaml-cpp
 #include "yaml-cpp/yaml.h"
 
@@ -51,9 +53,10 @@ typedef enum NodeType
 typedef struct Link
 {
     std::string target;
-    std::string data_rate;
+    std::string data_rate;      // data rate of one member
     std::string delay;
     std::string network;
+    uint32_t members = 1;       // member links of a bundle
 } Link_t;
 
 typedef struct Gateway
@@ -88,8 +91,11 @@ typedef struct ApplicationInfo
 {
     std::string appName;
     std::vector<std::string> targetNodes;
+    std::string parameters;     // merged parameters, as YAML
 } ApplicationInfo_t;
 
+class CybertwinTopologyCache;
+
 class CybertwinTopologyReader : public TopologyReader
 {
   public:
@@ -106,6 +112,14 @@ class CybertwinTopologyReader : public TopologyReader
     //----------------------------------------------------------
     NodeContainer Read() override;
 
+    /**
+     * \brief Install the static routes of the network built by Read
+     *
+     * Replaces Ipv4GlobalRoutingHelper::PopulateRoutingTables, routes are
+     * computed per layer by CybertwinHierarchicalRouting.
+     */
+    void PopulateHierarchicalRoutes();
+
     NodeInfo_t* CreateCloudNodeInfo(const YAML::Node &node);
     NodeInfo_t* CreateEndClusterNodeInfo(const YAML::Node &node);
     
@@ -132,8 +146,50 @@ class CybertwinTopologyReader : public TopologyReader
     std::vector<Link_t> ParseLinks(const YAML::Node &connections);
     std::vector<Gateway_t> ParseGateways(const YAML::Node &gateways);
 
-    Ipv4InterfaceContainer CreateP2PLink(Ptr<Node> sourceNode, Ptr<Node> targetNode, std::string &data_rate, std::string &delay, std::string &network);
-    
+    // a point-to-point link of a layer being built
+    struct P2PLinkPlan
+    {
+        template <typename Spec>
+        P2PLinkPlan(Ptr<Node> source, Ptr<Node> target, Spec &spec)
+            : nodes{source, target},
+              dataRate(&spec.data_rate),
+              delay(&spec.delay),
+              network(&spec.network),
+              members(Members(spec)),
+              valid(false)
+        {
+        }
+
+        static uint32_t Members(const Link_t &link)
+        {
+            return link.members;
+        }
+
+        static uint32_t Members(const Gateway_t &)
+        {
+            return 1;
+        }
+
+        Ptr<Node> nodes[2];
+        const std::string *dataRate;
+        const std::string *delay;
+        std::string *network;       // resolved in place
+        uint32_t members;           // bundled links, see PointToPointBundleNetDevice
+        bool valid;
+        Ipv4Address address[2];
+        Ipv4Mask mask;
+        Ipv4InterfaceContainer interfaces;
+    };
+
+    template <typename T>
+    void CreateServers(const std::vector<NodeInfo_t *> &nodeInfos, NodeContainer &layerNodes);
+    static void PlanP2PLinks(std::vector<P2PLinkPlan> &plans);
+    void BuildP2PLinks(std::vector<P2PLinkPlan> &plans, uint32_t pool, NetDeviceContainer &layerDevices);
+    static NetDeviceContainer InstallBundle(const P2PLinkPlan &plan);
+    void BuildCoreLayer();
+    void BuildEdgeLayer();
+    void BuildAccessLayer();
+
     NodeContainer CreateCsmaNetwork(NodeInfo *csma, Ptr<Node> &leader);
     NodeContainer CreateWifiNetwork(NodeInfo *wifi, Ptr<Node> &leader);
     NodeContainer CreateLteNetwork(NodeInfo *lte, Ptr<Node> &leader);
@@ -144,7 +200,23 @@ class CybertwinTopologyReader : public TopologyReader
     void ParseCoreCloud(const YAML::Node &coreLayer);
     void ParseEdgeCloud(const YAML::Node &edgeLayer);
     void ParseAccessNetwork(const YAML::Node &accessLayer);
-    void ConfigCNRS(const YAML::Node &cnrsConfig);
+
+    // per node construction, shared by explicit and generated nodes
+    void RegisterNodeInfo(NodeInfo_t *nodeInfo);
+    void AddCoreNode(NodeInfo_t *nodeInfo);
+    void AddEdgeNode(NodeInfo_t *nodeInfo);
+    void AddAccessCluster(NodeInfo_t *nodeInfo);
+
+    // automatic addressing of networks set to "auto"
+    void ReserveExplicitNetworks(const YAML::Node &cybertwinNetwork);
+    void CreateAddressPools();
+    void ResolveNetwork(std::string &network, uint32_t pool, uint32_t hosts);
+    void ConfigCNRS(const std::string &centralNode);
+    void ValidateTopology(const std::string &cnrsRoot);
+    void LoadApplications();
+
+    // compiled topology cache
+    void ReadFromCache(const CybertwinTopologyCache &cache);
 
     void ShowNetworkTopology();
 
@@ -169,8 +241,25 @@ class CybertwinTopologyReader : public TopologyReader
     std::unordered_map<std::string, Ptr<Node>> m_nodeName2Ptr;
     std::unordered_set<std::string> m_links;
 
+    // automatic addressing
+    std::string m_autoLinkNetwork;
+    std::string m_autoClusterNetwork;
+    CybertwinAddressAllocator m_addressAllocator;
+    uint32_t m_layerLinkPool[3];
+    uint32_t m_clusterPool;
+
+    // batched construction
+    InternetStackHelper m_stack;
+
+    // validation of the parsed topology
+    bool m_validate;
+
     // applications
     std::string m_appFils;
+    std::vector<ApplicationInfo_t> m_applications;
+
+    // compiled topology cache, disabled when empty
+    std::string m_cacheFile;
 
     // Cybertwin Name Resolution Service
     std::string m_cnrsNodeName;
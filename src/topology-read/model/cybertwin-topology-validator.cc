@@ -0,0 +1,507 @@
+#include "cybertwin-topology-validator.h"
+
+#include "cybertwin-address-allocator.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CybertwinTopologyValidator");
+
+namespace
+{
+
+// Order of magnitude of the cost of the built network. A node carries the
+// Internet stack, its routing and the Cybertwin applications, a device its
+// queue and traffic control layer.
+const uint64_t NODE_BYTES = 24 * 1024;
+const uint64_t DEVICE_BYTES = 4 * 1024;
+const uint64_t CHANNEL_BYTES = 256;
+const uint64_t EVENT_BYTES = 96;
+
+// Initialize and application start events of a node
+const uint64_t EVENTS_PER_NODE = 4;
+// TCP exchange of the registration of an end host to its cybertwin, about
+// ten packets over two hops, four events per packet and hop
+const uint64_t EVENTS_PER_REGISTRATION = 80;
+
+// delays above this are most likely a unit mistake
+const Time MAX_SANE_DELAY = Seconds(1);
+
+std::string
+LinkName(const std::string& source, const std::string& target)
+{
+    return "link " + source + " - " + target;
+}
+
+} // namespace
+
+CybertwinTopologyValidator::CybertwinTopologyValidator(const std::vector<NodeInfo_t*>& core,
+                                                       const std::vector<NodeInfo_t*>& edge,
+                                                       const std::vector<NodeInfo_t*>& clusters)
+    : m_minDelay(Time::Max()),
+      m_maxBdp(0),
+      m_estimate{0, 0, 0, 0, 0, 0}
+{
+    NS_LOG_FUNCTION(this);
+    const std::vector<NodeInfo_t*>* layers[] = {&core, &edge, &clusters};
+    for (uint32_t layer = CORE; layer <= ACCESS; layer++)
+    {
+        for (const NodeInfo_t* nodeInfo : *layers[layer])
+        {
+            m_index[nodeInfo->name] = m_nodes.size();
+            m_parent.push_back(m_nodes.size());
+            m_nodes.push_back(nodeInfo);
+            m_layers.push_back(static_cast<Layer_e>(layer));
+        }
+    }
+}
+
+void
+CybertwinTopologyValidator::SetApplications(const std::vector<ApplicationInfo_t>& applications)
+{
+    m_applications = applications;
+}
+
+void
+CybertwinTopologyValidator::SetCnrsRoot(const std::string& name)
+{
+    m_cnrsRoot = name;
+}
+
+const std::vector<std::string>&
+CybertwinTopologyValidator::GetErrors() const
+{
+    return m_errors;
+}
+
+const std::vector<std::string>&
+CybertwinTopologyValidator::GetWarnings() const
+{
+    return m_warnings;
+}
+
+CybertwinTopologyValidator::Estimate
+CybertwinTopologyValidator::GetEstimate() const
+{
+    return m_estimate;
+}
+
+void
+CybertwinTopologyValidator::Error(const std::string& message)
+{
+    NS_LOG_ERROR("[CybertwinTopologyValidator] " << message);
+    m_errors.push_back(message);
+}
+
+void
+CybertwinTopologyValidator::Warning(const std::string& message)
+{
+    NS_LOG_WARN("[CybertwinTopologyValidator] " << message);
+    m_warnings.push_back(message);
+}
+
+uint32_t
+CybertwinTopologyValidator::Find(uint32_t node)
+{
+    while (m_parent[node] != node)
+    {
+        m_parent[node] = m_parent[m_parent[node]];
+        node = m_parent[node];
+    }
+    return node;
+}
+
+bool
+CybertwinTopologyValidator::ParseDelay(const std::string& value, Time& delay)
+{
+    std::string::size_type n = value.find_first_not_of("+-0123456789.eE");
+    if (n == 0 || value.empty())
+    {
+        return false;
+    }
+
+    double number;
+    try
+    {
+        std::size_t parsed;
+        number = std::stod(value.substr(0, n), &parsed);
+        if (parsed != value.substr(0, n).size())
+        {
+            return false;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    std::string unit = n == std::string::npos ? "" : value.substr(n);
+    static const char* units[] = {"", "s", "ms", "us", "ns", "ps", "fs", "min", "h", "d", "y"};
+    if (std::find(std::begin(units), std::end(units), unit) == std::end(units) || number < 0)
+    {
+        return false;
+    }
+    delay = Time(value);
+    return true;
+}
+
+bool
+CybertwinTopologyValidator::Validate()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (uint32_t i = 0; i < m_nodes.size(); i++)
+    {
+        const NodeInfo_t* nodeInfo = m_nodes[i];
+        if (m_layers[i] == ACCESS)
+        {
+            const std::string what = "end cluster " + nodeInfo->name;
+            const std::string& type = nodeInfo->network_type;
+            if (type != "csma" && type != "wifi" && type != "lte" && type != "uan")
+            {
+                Error(what + ": unknown network type " + type);
+            }
+            if (nodeInfo->num_nodes <= 0)
+            {
+                Error(what + ": no hosts");
+            }
+            CheckNetwork(what, nodeInfo->local_network, std::max(nodeInfo->num_nodes, 0) + 1);
+
+            if (nodeInfo->gateways.empty())
+            {
+                Error(what + ": no gateway");
+                continue;
+            }
+            if (nodeInfo->gateways.size() > 1)
+            {
+                Warning(what + ": only the first gateway is connected");
+            }
+            const Gateway_t& gateway = nodeInfo->gateways[0];
+            if (CheckLink(nodeInfo, gateway.name, {EDGE}))
+            {
+                std::string link = LinkName(nodeInfo->name, gateway.name);
+                CheckLinkParameters(link, gateway.data_rate, gateway.delay);
+                CheckNetwork(link, gateway.network, 2);
+            }
+            continue;
+        }
+
+        // edge servers may link to other edge servers, the core layer is
+        // built before any edge link
+        std::vector<Layer_e> allowed = {CORE};
+        if (m_layers[i] == EDGE)
+        {
+            allowed.push_back(EDGE);
+        }
+
+        uint32_t uplinks = 0;
+        for (const Link_t& link : nodeInfo->links)
+        {
+            if (!CheckLink(nodeInfo, link.target, allowed))
+            {
+                continue;
+            }
+            std::string name = LinkName(nodeInfo->name, link.target);
+            CheckLinkParameters(name, link.data_rate, link.delay, link.members);
+            CheckNetwork(name, link.network, 2);
+            uplinks++;
+        }
+        if (m_layers[i] == EDGE && uplinks == 0)
+        {
+            Error("edge server " + nodeInfo->name + ": no uplink, it never powers on");
+        }
+    }
+
+    if (!m_cnrsRoot.empty())
+    {
+        auto root = m_index.find(m_cnrsRoot);
+        if (root == m_index.end() || m_layers[root->second] != CORE)
+        {
+            Error("CNRS root " + m_cnrsRoot + " is not a core server");
+        }
+    }
+
+    CheckConnectivity();
+    CheckApplications();
+    ComputeEstimate();
+
+    return m_errors.empty();
+}
+
+bool
+CybertwinTopologyValidator::CheckLink(const NodeInfo_t* source,
+                                      const std::string& target,
+                                      std::vector<Layer_e> allowed)
+{
+    auto it = m_index.find(target);
+    if (it == m_index.end())
+    {
+        Error(source->name + ": link to unknown node " + target);
+        return false;
+    }
+    if (target == source->name)
+    {
+        Error(source->name + ": link to itself");
+        return false;
+    }
+    if (std::find(allowed.begin(), allowed.end(), m_layers[it->second]) == allowed.end())
+    {
+        static const char* layerNames[] = {"core", "edge", "access"};
+        Error(source->name + ": link to " + target + " of the " + layerNames[m_layers[it->second]] +
+              " layer");
+        return false;
+    }
+
+    uint32_t a = m_index[source->name];
+    uint32_t b = it->second;
+    if (!m_links.emplace(std::make_pair(std::min(a, b), std::max(a, b)), source->name).second)
+    {
+        Warning(LinkName(source->name, target) + " declared twice, only the first is built");
+        return false;
+    }
+
+    m_parent[Find(a)] = Find(b);
+    return true;
+}
+
+void
+CybertwinTopologyValidator::CheckLinkParameters(const std::string& what,
+                                                const std::string& dataRate,
+                                                const std::string& delay,
+                                                uint32_t members)
+{
+    if (members == 0)
+    {
+        Error(what + ": bundle without members");
+        return;
+    }
+
+    DataRate rate;
+    std::istringstream is(dataRate);
+    is >> rate;
+    if (is.fail())
+    {
+        Error(what + ": malformed data rate " + dataRate);
+        return;
+    }
+    if (rate.GetBitRate() == 0)
+    {
+        Error(what + ": zero data rate");
+        return;
+    }
+
+    Time value;
+    if (!ParseDelay(delay, value))
+    {
+        Error(what + ": malformed delay " + delay);
+        return;
+    }
+    if (value.IsZero())
+    {
+        Warning(what + ": zero delay, the link gives no lookahead to a parallel run");
+    }
+    else if (value > MAX_SANE_DELAY)
+    {
+        Warning(what + ": delay " + delay + " above " + std::to_string(MAX_SANE_DELAY.GetSeconds()) +
+                "s");
+    }
+
+    m_minDelay = std::min(m_minDelay, value);
+    m_maxDelay = std::max(m_maxDelay, value);
+    m_maxBdp = std::max(m_maxBdp,
+                        static_cast<uint64_t>(rate.GetBitRate() * members * value.GetSeconds() / 8));
+}
+
+void
+CybertwinTopologyValidator::CheckNetwork(const std::string& what,
+                                         const std::string& network,
+                                         uint32_t hosts)
+{
+    if (network.empty() || network == "auto")
+    {
+        return;
+    }
+
+    uint32_t base;
+    uint32_t prefixLength;
+    if (!CybertwinAddressAllocator::Parse(network, base, prefixLength))
+    {
+        Error(what + ": malformed network " + network);
+        return;
+    }
+    if (prefixLength > 30 || (1ULL << (32 - prefixLength)) < uint64_t(hosts) + 2)
+    {
+        Error(what + ": network " + network + " too small for " + std::to_string(hosts) +
+              " addresses");
+        return;
+    }
+
+    // Parse clears the host part, check the address as written
+    uint32_t mask = prefixLength == 0 ? 0 : ~0U << (32 - prefixLength);
+    if (Ipv4Address(network.substr(0, network.find('/')).c_str()).Get() & ~mask)
+    {
+        Warning(what + ": network " + network + " has host bits set");
+    }
+    uint32_t first = base & mask;
+    uint32_t last = first | ~mask;
+
+    // the recorded ranges are disjoint, only the range before first and
+    // the first range starting after it can overlap
+    auto next = m_networks.upper_bound(first);
+    if (next != m_networks.end() && next->first <= last)
+    {
+        Error(what + ": network " + network + " overlaps " + next->second.second);
+        return;
+    }
+    if (next != m_networks.begin() && std::prev(next)->second.first >= first)
+    {
+        Error(what + ": network " + network + " overlaps " + std::prev(next)->second.second);
+        return;
+    }
+    m_networks[first] = std::make_pair(last, what + " (" + network + ")");
+}
+
+void
+CybertwinTopologyValidator::CheckConnectivity()
+{
+    // the component of the first core server is the network, report one
+    // node of every other component
+    std::map<uint32_t, uint32_t> components;
+    for (uint32_t i = 0; i < m_nodes.size(); i++)
+    {
+        components.emplace(Find(i), i);
+    }
+    if (components.size() <= 1)
+    {
+        return;
+    }
+
+    uint32_t main = Find(0);
+    std::ostringstream os;
+    os << "the network is split in " << components.size() << " parts, not connected to "
+       << m_nodes[0]->name << ":";
+    uint32_t shown = 0;
+    for (const auto& component : components)
+    {
+        if (component.first == main)
+        {
+            continue;
+        }
+        if (shown++ == 5)
+        {
+            os << " ...";
+            break;
+        }
+        os << " " << m_nodes[component.second]->name;
+    }
+    Error(os.str());
+}
+
+void
+CybertwinTopologyValidator::CheckApplications()
+{
+    for (const auto& app : m_applications)
+    {
+        for (const auto& target : app.targetNodes)
+        {
+            auto it = m_index.find(target);
+            if (it != m_index.end() && m_layers[it->second] != ACCESS)
+            {
+                continue;
+            }
+
+            // hosts of CSMA and WiFi clusters are named <cluster>_<i>
+            bool found = false;
+            std::string::size_type sep = target.rfind('_');
+            if (sep != std::string::npos && sep + 1 < target.size() &&
+                target.find_first_not_of("0123456789", sep + 1) == std::string::npos)
+            {
+                auto cluster = m_index.find(target.substr(0, sep));
+                if (cluster != m_index.end() && m_layers[cluster->second] == ACCESS)
+                {
+                    const NodeInfo_t* nodeInfo = m_nodes[cluster->second];
+                    found = (nodeInfo->network_type == "csma" || nodeInfo->network_type == "wifi") &&
+                            std::stoul(target.substr(sep + 1)) <
+                                static_cast<unsigned long>(std::max(nodeInfo->num_nodes, 0));
+                }
+            }
+            if (!found)
+            {
+                Error("application " + app.appName + ": unknown target node " + target);
+            }
+        }
+    }
+}
+
+void
+CybertwinTopologyValidator::ComputeEstimate()
+{
+    Estimate& e = m_estimate;
+    e.links = m_links.size();
+    e.channels = e.links;
+    e.devices = 2 * e.links;
+
+    uint64_t hosts = 0;
+    bool lte = false;
+    for (uint32_t i = 0; i < m_nodes.size(); i++)
+    {
+        if (m_layers[i] != ACCESS)
+        {
+            e.nodes++;
+            continue;
+        }
+        uint64_t clusterHosts = std::max(m_nodes[i]->num_nodes, 0);
+        hosts += clusterHosts;
+        e.nodes += clusterHosts + 1;
+        e.devices += clusterHosts + 1;
+        e.channels++;
+        lte = lte || m_nodes[i]->network_type == "lte";
+    }
+    if (lte)
+    {
+        // PGW, SGW and MME of the EPC, shared by the LTE clusters
+        e.nodes += 3;
+        e.devices += 4;
+        e.channels += 2;
+    }
+
+    e.bootEvents = e.nodes * EVENTS_PER_NODE + hosts * EVENTS_PER_REGISTRATION;
+    e.memory = e.nodes * NODE_BYTES + e.devices * DEVICE_BYTES + e.channels * CHANNEL_BYTES +
+               e.bootEvents * EVENT_BYTES;
+}
+
+void
+CybertwinTopologyValidator::Print(std::ostream& os) const
+{
+    os << "Topology validation: " << m_errors.size() << " errors, " << m_warnings.size()
+       << " warnings" << std::endl;
+    for (const auto& error : m_errors)
+    {
+        os << "  error: " << error << std::endl;
+    }
+    for (const auto& warning : m_warnings)
+    {
+        os << "  warning: " << warning << std::endl;
+    }
+
+    const Estimate& e = m_estimate;
+    os << "Estimated network: " << e.nodes << " nodes, " << e.devices << " devices, "
+       << e.channels << " channels, " << e.links << " point-to-point links, " << e.bootEvents
+       << " boot events, " << std::fixed << std::setprecision(1)
+       << e.memory / (1024.0 * 1024.0) << " MiB" << std::endl;
+    if (m_minDelay != Time::Max())
+    {
+        os << "Link delays " << m_minDelay.As(Time::MS) << " to " << m_maxDelay.As(Time::MS)
+           << ", largest bandwidth-delay product " << m_maxBdp << " bytes" << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,169 @@
+#ifndef CYBERTWIN_TOPOLOGY_VALIDATOR_H
+#define CYBERTWIN_TOPOLOGY_VALIDATOR_H
+
+#include "cybertwin-topology-reader.h"
+
+#include <map>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup topology
+ * \brief Static checks of a parsed Cybertwin topology, before it is built
+ *
+ * The reader accepts anything the YAML parser does and a mistake only
+ * shows up deep in the construction, or as a silently skipped link. The
+ * validator walks the parsed node descriptions instead, in time linear in
+ * the size of the file, and reports:
+ *
+ *   - errors: links and gateways to unknown nodes or to the wrong layer,
+ *     malformed or overlapping explicit networks, networks too small for
+ *     their hosts, unparsable or zero data rates and delays, disconnected
+ *     parts of the network, edge servers without uplink, an unknown CNRS
+ *     root and application targets that are not nodes of the network,
+ *   - warnings: duplicate links, zero or very long delays, unaligned
+ *     networks and unsupported extra gateways,
+ *   - an estimate of the nodes, devices, channels, boot events and memory
+ *     the network needs once built.
+ *
+ * Networks set to "auto" are allocated from pools skipping every explicit
+ * network, only explicit ones are checked for overlap. They are kept in an
+ * ordered set of disjoint address ranges: a new prefix overlaps only its
+ * predecessor or the range starting inside it.
+ */
+class CybertwinTopologyValidator
+{
+  public:
+    /// Estimated size of the built network
+    struct Estimate
+    {
+        uint64_t nodes;      //!< servers, routers and hosts
+        uint64_t devices;    //!< net devices
+        uint64_t channels;   //!< channels
+        uint64_t links;      //!< point-to-point links
+        uint64_t bootEvents; //!< events of the boot
+        uint64_t memory;     //!< bytes
+    };
+
+    /**
+     * \param core the core servers
+     * \param edge the edge servers
+     * \param clusters the end clusters
+     */
+    CybertwinTopologyValidator(const std::vector<NodeInfo_t*>& core,
+                               const std::vector<NodeInfo_t*>& edge,
+                               const std::vector<NodeInfo_t*>& clusters);
+
+    /**
+     * \brief Check the application targets too
+     * \param applications the applications to install
+     */
+    void SetApplications(const std::vector<ApplicationInfo_t>& applications);
+
+    /**
+     * \brief Check the CNRS root too
+     * \param name the name of the CNRS root
+     */
+    void SetCnrsRoot(const std::string& name);
+
+    /**
+     * \brief Run every check
+     * \return false if an error was found
+     */
+    bool Validate();
+
+    const std::vector<std::string>& GetErrors() const;
+    const std::vector<std::string>& GetWarnings() const;
+
+    /**
+     * \brief Get the estimated size of the network, after Validate
+     */
+    Estimate GetEstimate() const;
+
+    /**
+     * \brief Print the errors, warnings and estimate
+     * \param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * \brief Parse a delay of the topology file, e.g. "2ms"
+     * \param value the delay
+     * \param delay set to the delay
+     * \return false if the delay is malformed
+     */
+    static bool ParseDelay(const std::string& value, Time& delay);
+
+  private:
+    /// Layer of a node
+    enum Layer_e
+    {
+        CORE,
+        EDGE,
+        ACCESS,
+    };
+
+    /**
+     * \brief Check the data rate and delay of a link
+     * \param what the link, for the messages
+     * \param dataRate the data rate
+     * \param delay the delay
+     * \param members the member links of a bundle
+     */
+    void CheckLinkParameters(const std::string& what,
+                             const std::string& dataRate,
+                             const std::string& delay,
+                             uint32_t members = 1);
+
+    /**
+     * \brief Check an explicit network and record it
+     * \param what the owner of the network, for the messages
+     * \param network the network, "a.b.c.d/len" or "auto"
+     * \param hosts the number of host addresses it must hold
+     */
+    void CheckNetwork(const std::string& what, const std::string& network, uint32_t hosts);
+
+    /**
+     * \brief Check a link and join its ends
+     * \param source the node declaring the link
+     * \param target the name of the other end
+     * \param allowed the layers the other end may belong to
+     * \return true if the link is built
+     */
+    bool CheckLink(const NodeInfo_t* source, const std::string& target, std::vector<Layer_e> allowed);
+
+    void CheckConnectivity();
+    void CheckApplications();
+    void ComputeEstimate();
+
+    /// Union-find root of a node
+    uint32_t Find(uint32_t node);
+
+    void Error(const std::string& message);
+    void Warning(const std::string& message);
+
+    std::vector<const NodeInfo_t*> m_nodes;          //!< every node, by index
+    std::vector<Layer_e> m_layers;                   //!< layer of every node
+    std::map<std::string, uint32_t> m_index;         //!< index of a node name
+    std::vector<uint32_t> m_parent;                  //!< union-find forest
+    std::map<std::pair<uint32_t, uint32_t>, std::string> m_links; //!< unique links, network
+    std::map<uint32_t, std::pair<uint32_t, std::string>> m_networks; //!< first -> last, owner
+    std::vector<ApplicationInfo_t> m_applications;   //!< applications to check
+    std::string m_cnrsRoot;                          //!< CNRS root to check
+    std::vector<std::string> m_errors;               //!< errors found
+    std::vector<std::string> m_warnings;             //!< warnings found
+    Time m_minDelay;                                 //!< smallest link delay
+    Time m_maxDelay;                                 //!< largest link delay
+    uint64_t m_maxBdp;                               //!< largest bandwidth-delay product, bytes
+    Estimate m_estimate;                             //!< estimated size
+};
+
+} // namespace ns3
+
+#endif /* CYBERTWIN_TOPOLOGY_VALIDATOR_H */
@@ -0,0 +1,368 @@
+//-----------------------------------------------------------------------------
+// Unit tests
+//-----------------------------------------------------------------------------
+
+#include "ns3/csma-helper.h"
+#include "ns3/cybertwin-hierarchical-routing.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::CybertwinHierarchicalRouting test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Hierarchical Routing Summarize Test
+ */
+class CybertwinHierarchicalRoutingSummarizeTest : public TestCase
+{
+  public:
+    CybertwinHierarchicalRoutingSummarizeTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the summary of some prefixes
+     * \param prefixes the prefixes, as "a.b.c.d/len"
+     * \param expected the expected summary, in address order
+     * \param msg the message
+     */
+    void Check(const std::vector<std::string>& prefixes,
+               const std::vector<std::string>& expected,
+               const std::string& msg);
+};
+
+CybertwinHierarchicalRoutingSummarizeTest::CybertwinHierarchicalRoutingSummarizeTest()
+    : TestCase("CybertwinHierarchicalRoutingSummarizeTest")
+{
+}
+
+void
+CybertwinHierarchicalRoutingSummarizeTest::Check(const std::vector<std::string>& prefixes,
+                                                 const std::vector<std::string>& expected,
+                                                 const std::string& msg)
+{
+    std::vector<CybertwinHierarchicalRouting::Prefix> input;
+    for (const auto& prefix : prefixes)
+    {
+        std::size_t slash = prefix.find('/');
+        input.emplace_back(Ipv4Address(prefix.substr(0, slash).c_str()).Get(),
+                           std::stoul(prefix.substr(slash + 1)));
+    }
+
+    std::vector<std::string> result;
+    for (const auto& prefix : CybertwinHierarchicalRouting::Summarize(input))
+    {
+        std::ostringstream oss;
+        oss << Ipv4Address(prefix.first) << "/" << prefix.second;
+        result.push_back(oss.str());
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(result.size(), expected.size(), msg << ": prefix count");
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(result[i], expected[i], msg << ": prefix " << i);
+    }
+}
+
+void
+CybertwinHierarchicalRoutingSummarizeTest::DoRun()
+{
+    Check({}, {}, "empty");
+    Check({"10.0.0.0/25", "10.0.0.128/25"}, {"10.0.0.0/24"}, "siblings");
+    Check({"10.0.0.128/25", "10.0.1.0/25"},
+          {"10.0.0.128/25", "10.0.1.0/25"},
+          "adjacent but not siblings");
+    Check({"10.0.1.0/24", "10.0.2.0/24"}, {"10.0.1.0/24", "10.0.2.0/24"}, "different parents");
+    Check({"10.0.0.192/26", "10.0.0.0/26", "10.0.0.128/26", "10.0.0.64/26"},
+          {"10.0.0.0/24"},
+          "four quarters, in any order");
+    Check({"10.0.0.0/24", "10.0.1.0/24", "10.0.2.0/23"}, {"10.0.0.0/22"}, "repeated merge");
+    Check({"10.0.3.0/24", "10.0.0.0/16", "10.0.200.4/30"}, {"10.0.0.0/16"}, "covered prefixes");
+    Check({"10.0.0.5/30", "10.0.0.6/30"}, {"10.0.0.4/30"}, "host bits and duplicates");
+    Check({"0.0.0.0/1", "128.0.0.0/1"}, {"0.0.0.0/0"}, "both halves");
+    Check({"10.0.0.0/24", "10.0.1.0/25"},
+          {"10.0.0.0/24", "10.0.1.0/25"},
+          "half of a sibling");
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Hierarchical Routing Tiers Test
+ *
+ * A line of three core servers, an edge server below each end of the line
+ * and a CSMA end cluster below each edge server:
+ *
+ * \verbatim
+   core0 ------- core1 ------- core2
+     |                           |
+   edge0                       edge1
+     |                           |
+   router0 == h0, h1           router1 == h2, h3
+   \endverbatim
+ *
+ * Every tier gets its own routes, and packets between any two hosts go up
+ * the tree, along the core line and down again.
+ */
+class CybertwinHierarchicalRoutingTiersTest : public TestCase
+{
+  public:
+    CybertwinHierarchicalRoutingTiersTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Follow the routes of the nodes from a node to an address
+     * \param source the first node
+     * \param destination the destination address
+     * \return the nodes crossed, including the first and the last one
+     */
+    std::vector<Ptr<Node>> Walk(Ptr<Node> source, Ipv4Address destination) const;
+
+    /**
+     * \brief Get the node owning an address
+     * \param address the address
+     * \return the node, or nullptr
+     */
+    Ptr<Node> Owner(Ipv4Address address) const;
+
+    /**
+     * \brief Get the default gateway of a node
+     * \param node the node
+     * \return the gateway, or the any address without default route
+     */
+    static Ipv4Address DefaultGateway(Ptr<Node> node);
+};
+
+CybertwinHierarchicalRoutingTiersTest::CybertwinHierarchicalRoutingTiersTest()
+    : TestCase("CybertwinHierarchicalRoutingTiersTest")
+{
+}
+
+Ptr<Node>
+CybertwinHierarchicalRoutingTiersTest::Owner(Ipv4Address address) const
+{
+    for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    {
+        Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4>();
+        if (ipv4 && ipv4->GetInterfaceForAddress(address) >= 0)
+        {
+            return *node;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<Ptr<Node>>
+CybertwinHierarchicalRoutingTiersTest::Walk(Ptr<Node> source, Ipv4Address destination) const
+{
+    std::vector<Ptr<Node>> path{source};
+    Ptr<Node> node = source;
+    while (node->GetObject<Ipv4>()->GetInterfaceForAddress(destination) < 0 &&
+           path.size() <= NodeList::GetNNodes())
+    {
+        Ipv4Header header;
+        header.SetDestination(destination);
+        Socket::SocketErrno error;
+        Ptr<Ipv4Route> route = node->GetObject<Ipv4>()->GetRoutingProtocol()->RouteOutput(
+            Create<Packet>(),
+            header,
+            nullptr,
+            error);
+        if (!route)
+        {
+            break;
+        }
+        Ipv4Address gateway = route->GetGateway();
+        node = Owner(gateway == Ipv4Address::GetAny() ? destination : gateway);
+        if (!node)
+        {
+            break;
+        }
+        path.push_back(node);
+    }
+    return path;
+}
+
+Ipv4Address
+CybertwinHierarchicalRoutingTiersTest::DefaultGateway(Ptr<Node> node)
+{
+    Ptr<Ipv4StaticRouting> routing = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(
+        node->GetObject<Ipv4>()->GetRoutingProtocol());
+    for (uint32_t r = 0; r < routing->GetNRoutes(); r++)
+    {
+        Ipv4RoutingTableEntry route = routing->GetRoute(r);
+        if (route.IsDefault())
+        {
+            return route.GetGateway();
+        }
+    }
+    return Ipv4Address::GetAny();
+}
+
+void
+CybertwinHierarchicalRoutingTiersTest::DoRun()
+{
+    NodeContainer core;
+    core.Create(3);
+    NodeContainer edge;
+    edge.Create(2);
+    NodeContainer lan[2];
+    lan[0].Create(3);
+    lan[1].Create(3);
+
+    InternetStackHelper stack;
+    stack.Install(core);
+    stack.Install(edge);
+    stack.Install(lan[0]);
+    stack.Install(lan[1]);
+
+    PointToPointHelper p2p;
+    Ipv4AddressHelper address;
+    auto link = [&](Ptr<Node> a, Ptr<Node> b, const char* network) {
+        address.SetBase(network, "255.255.255.252");
+        return address.Assign(p2p.Install(a, b));
+    };
+    link(core.Get(0), core.Get(1), "10.0.0.0");
+    link(core.Get(1), core.Get(2), "10.0.0.4");
+    link(edge.Get(0), core.Get(0), "10.0.1.0");
+    link(edge.Get(1), core.Get(2), "10.0.1.4");
+    link(lan[0].Get(0), edge.Get(0), "10.0.2.0");
+    link(lan[1].Get(0), edge.Get(1), "10.0.2.4");
+
+    CsmaHelper csma;
+    Ipv4InterfaceContainer hosts[2];
+    address.SetBase("10.1.0.0", "255.255.255.0");
+    hosts[0] = address.Assign(csma.Install(lan[0]));
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    hosts[1] = address.Assign(csma.Install(lan[1]));
+
+    // a host configured by its own access technology keeps its default route
+    Ptr<Ipv4StaticRouting> preset = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(
+        lan[1].Get(2)->GetObject<Ipv4>()->GetRoutingProtocol());
+    preset->SetDefaultRoute(hosts[1].GetAddress(1), hosts[1].Get(2).second);
+
+    CybertwinHierarchicalRouting routing;
+    for (uint32_t i = 0; i < core.GetN(); i++)
+    {
+        routing.AddCoreNode(core.Get(i));
+    }
+    for (uint32_t i = 0; i < edge.GetN(); i++)
+    {
+        routing.AddEdgeNode(edge.Get(i));
+        routing.AddAccessCluster(lan[i].Get(0), edge.Get(i), lan[i]);
+    }
+    routing.Populate();
+
+    // access: 2 router defaults, 2 cluster networks at the edge, 3 host
+    // defaults; edge: 2 defaults; core: 6 remote networks on each server
+    NS_TEST_EXPECT_MSG_EQ(routing.GetRouteCount(), 7 + 2 + 18, "installed routes");
+
+    // access tier
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(lan[0].Get(0)),
+                          Ipv4Address("10.0.2.2"),
+                          "router default route to its gateway");
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(lan[0].Get(1)),
+                          hosts[0].GetAddress(0),
+                          "host default route to its router");
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(lan[1].Get(1)),
+                          hosts[1].GetAddress(0),
+                          "host default route to its router");
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(lan[1].Get(2)),
+                          hosts[1].GetAddress(1),
+                          "preset default route replaced");
+    std::vector<Ptr<Node>> path = Walk(edge.Get(0), hosts[0].GetAddress(2));
+    NS_TEST_EXPECT_MSG_EQ(path.size(), 3, "edge to a host of its cluster");
+    NS_TEST_EXPECT_MSG_EQ(path.back(), lan[0].Get(2), "edge to a host of its cluster");
+
+    // edge tier
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(edge.Get(0)),
+                          Ipv4Address("10.0.1.2"),
+                          "edge default route to its core parent");
+    NS_TEST_EXPECT_MSG_EQ(DefaultGateway(edge.Get(1)),
+                          Ipv4Address("10.0.1.6"),
+                          "edge default route to its core parent");
+
+    // core tier, no default route, every remote network via the BFS first hop
+    for (uint32_t i = 0; i < core.GetN(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(DefaultGateway(core.Get(i)),
+                              Ipv4Address::GetAny(),
+                              "core server with a default route");
+    }
+    path = Walk(core.Get(1), hosts[0].GetAddress(1));
+    NS_TEST_ASSERT_MSG_EQ(path.size(), 5, "core1 to cluster 0");
+    NS_TEST_EXPECT_MSG_EQ(path[1], core.Get(0), "core1 to cluster 0 via core0");
+    path = Walk(core.Get(0), Ipv4Address("10.0.2.5"));
+    NS_TEST_ASSERT_MSG_EQ(path.size(), 5, "core0 to the uplink of cluster 1");
+    NS_TEST_EXPECT_MSG_EQ(path[3], edge.Get(1), "core0 to the uplink of cluster 1");
+
+    // end to end
+    path = Walk(lan[0].Get(1), hosts[1].GetAddress(1));
+    std::vector<Ptr<Node>> expected{lan[0].Get(1),
+                                    lan[0].Get(0),
+                                    edge.Get(0),
+                                    core.Get(0),
+                                    core.Get(1),
+                                    core.Get(2),
+                                    edge.Get(1),
+                                    lan[1].Get(0),
+                                    lan[1].Get(1)};
+    NS_TEST_ASSERT_MSG_EQ(path.size(), expected.size(), "host to host path length");
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(path[i], expected[i], "host to host hop " << i);
+    }
+    path = Walk(lan[1].Get(1), hosts[0].GetAddress(2));
+    NS_TEST_EXPECT_MSG_EQ(path.size(), expected.size(), "host to host return path length");
+    NS_TEST_EXPECT_MSG_EQ(path.back(), lan[0].Get(2), "host to host return path");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Hierarchical Routing TestSuite
+ */
+class CybertwinHierarchicalRoutingTestSuite : public TestSuite
+{
+  public:
+    CybertwinHierarchicalRoutingTestSuite();
+};
+
+CybertwinHierarchicalRoutingTestSuite::CybertwinHierarchicalRoutingTestSuite()
+    : TestSuite("cybertwin-hierarchical-routing", UNIT)
+{
+    AddTestCase(new CybertwinHierarchicalRoutingSummarizeTest(), TestCase::QUICK);
+    AddTestCase(new CybertwinHierarchicalRoutingTiersTest(), TestCase::QUICK);
+}
+
+static CybertwinHierarchicalRoutingTestSuite
+    g_cybertwinHierarchicalRoutingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,274 @@
+//-----------------------------------------------------------------------------
+// Unit tests
+//-----------------------------------------------------------------------------
+
+#include "ns3/cybertwin-topology-cache.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::CybertwinTopologyCache test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Cache Test
+ *
+ * A compiled topology written to a cache file maps back to the same
+ * nodes, links, gateways and applications. A missing, stale or damaged
+ * file is rejected.
+ */
+class CybertwinTopologyCacheTest : public TestCase
+{
+  public:
+    CybertwinTopologyCacheTest();
+    ~CybertwinTopologyCacheTest() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Write a file
+     * \param path the file
+     * \param content the content
+     */
+    static void WriteFile(const std::string& path, const std::string& content);
+
+    /**
+     * \brief Read a file
+     * \param path the file
+     * \return the content
+     */
+    static std::string ReadFile(const std::string& path);
+
+    /// Check that a cached node matches its source
+    void CheckNode(const NodeInfo_t* cached, const NodeInfo_t* source);
+
+    std::vector<NodeInfo_t*> m_layers[3]; //!< source core, edge and access nodes
+};
+
+CybertwinTopologyCacheTest::CybertwinTopologyCacheTest()
+    : TestCase("CybertwinTopologyCacheTest")
+{
+}
+
+CybertwinTopologyCacheTest::~CybertwinTopologyCacheTest()
+{
+    for (auto& layer : m_layers)
+    {
+        for (auto node : layer)
+        {
+            delete node;
+        }
+    }
+}
+
+void
+CybertwinTopologyCacheTest::WriteFile(const std::string& path, const std::string& content)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+std::string
+CybertwinTopologyCacheTest::ReadFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void
+CybertwinTopologyCacheTest::CheckNode(const NodeInfo_t* cached, const NodeInfo_t* source)
+{
+    NS_TEST_ASSERT_MSG_NE(cached, nullptr, "missing node " << source->name);
+    NS_TEST_EXPECT_MSG_EQ(cached->name, source->name, "name");
+    NS_TEST_EXPECT_MSG_EQ(cached->type, source->type, "type of " << source->name);
+    NS_TEST_EXPECT_MSG_EQ(cached->position, source->position, "position of " << source->name);
+    NS_TEST_EXPECT_MSG_EQ(cached->num_nodes, source->num_nodes, "hosts of " << source->name);
+    NS_TEST_EXPECT_MSG_EQ(cached->network_type, source->network_type, "network type");
+    NS_TEST_EXPECT_MSG_EQ(cached->local_network, source->local_network, "local network");
+
+    NS_TEST_ASSERT_MSG_EQ(cached->links.size(), source->links.size(), "links");
+    for (uint32_t i = 0; i < source->links.size(); i++)
+    {
+        const Link_t& a = cached->links[i];
+        const Link_t& b = source->links[i];
+        NS_TEST_EXPECT_MSG_EQ(a.target, b.target, "link target");
+        NS_TEST_EXPECT_MSG_EQ(a.data_rate, b.data_rate, "link data rate");
+        NS_TEST_EXPECT_MSG_EQ(a.delay, b.delay, "link delay");
+        NS_TEST_EXPECT_MSG_EQ(a.network, b.network, "link network");
+        NS_TEST_EXPECT_MSG_EQ(a.members, b.members, "link members");
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(cached->gateways.size(), source->gateways.size(), "gateways");
+    for (uint32_t i = 0; i < source->gateways.size(); i++)
+    {
+        const Gateway_t& a = cached->gateways[i];
+        const Gateway_t& b = source->gateways[i];
+        NS_TEST_EXPECT_MSG_EQ(a.name, b.name, "gateway name");
+        NS_TEST_EXPECT_MSG_EQ(a.data_rate, b.data_rate, "gateway data rate");
+        NS_TEST_EXPECT_MSG_EQ(a.delay, b.delay, "gateway delay");
+        NS_TEST_EXPECT_MSG_EQ(a.network, b.network, "gateway network");
+    }
+}
+
+void
+CybertwinTopologyCacheTest::DoRun()
+{
+    std::string topology = CreateTempDirFilename("topology.yaml");
+    std::string apps = CreateTempDirFilename("apps.yaml");
+    WriteFile(topology, "core_layer: []\n");
+    WriteFile(apps, "apps: {}\n");
+
+    uint64_t hash = CybertwinTopologyCache::Hash({topology, apps}, "");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinTopologyCache::Hash({topology, apps}, ""),
+                          hash,
+                          "hash of the same sources");
+    NS_TEST_EXPECT_MSG_NE(CybertwinTopologyCache::Hash({topology, apps}, "salt"),
+                          hash,
+                          "hash ignores the settings");
+    NS_TEST_EXPECT_MSG_NE(CybertwinTopologyCache::Hash({apps, topology}, ""),
+                          hash,
+                          "hash ignores the file order");
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        NodeInfo_t* core = new NodeInfo_t();
+        core->name = "core" + std::to_string(i);
+        core->type = NodeType_e::HOST_SERVER;
+        core->position = Vector(i, 0, 0);
+        core->num_nodes = 0;
+        if (i > 0)
+        {
+            core->links.push_back({"core0", "10Gbps", "1ms", "10.0.0.0/30", 4});
+        }
+        m_layers[CybertwinTopologyCache::CORE].push_back(core);
+    }
+
+    NodeInfo_t* edge = new NodeInfo_t();
+    edge->name = "edge0";
+    edge->type = NodeType_e::HOST_SERVER;
+    edge->position = Vector(0.5, 10, 0);
+    edge->num_nodes = 0;
+    edge->links.push_back({"core0", "1Gbps", "2ms", "10.0.0.4/30", 1});
+    edge->links.push_back({"core1", "1Gbps", "2ms", "10.0.0.8/30", 2});
+    m_layers[CybertwinTopologyCache::EDGE].push_back(edge);
+
+    NodeInfo_t* cluster = new NodeInfo_t();
+    cluster->name = "cluster0";
+    cluster->type = NodeType_e::END_CLUSTER;
+    cluster->position = Vector(0.5, 20, 0);
+    cluster->num_nodes = 5;
+    cluster->network_type = "csma";
+    cluster->local_network = "10.1.0.0/29";
+    cluster->gateways.push_back({"edge0", "100Mbps", "5ms", "10.0.0.12/30"});
+    m_layers[CybertwinTopologyCache::ACCESS].push_back(cluster);
+
+    std::vector<ApplicationInfo_t> applications(2);
+    applications[0].appName = "download";
+    applications[0].targetNodes = {"cluster0", "edge0"};
+    applications[0].parameters = "{size: 1024}";
+    applications[1].appName = "idle";
+
+    std::string cacheFile = CreateTempDirFilename("topology.cache");
+    NS_TEST_ASSERT_MSG_EQ(
+        CybertwinTopologyCache::Write(cacheFile, hash, m_layers, applications, "core1"),
+        true,
+        "cache not written");
+
+    {
+        CybertwinTopologyCache cache;
+        NS_TEST_ASSERT_MSG_EQ(cache.Open(cacheFile, hash), true, "cache not mapped");
+        for (uint32_t layer = 0; layer < 3; layer++)
+        {
+            auto l = static_cast<CybertwinTopologyCache::Layer>(layer);
+            NS_TEST_ASSERT_MSG_EQ(cache.GetNodeCount(l), m_layers[layer].size(), "node count");
+            for (uint32_t i = 0; i < m_layers[layer].size(); i++)
+            {
+                NodeInfo_t* node = cache.CreateNodeInfo(l, i);
+                CheckNode(node, m_layers[layer][i]);
+                delete node;
+            }
+        }
+
+        std::vector<ApplicationInfo_t> cached = cache.GetApplications();
+        NS_TEST_ASSERT_MSG_EQ(cached.size(), applications.size(), "applications");
+        for (uint32_t i = 0; i < applications.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(cached[i].appName, applications[i].appName, "app name");
+            NS_TEST_EXPECT_MSG_EQ(cached[i].parameters, applications[i].parameters, "parameters");
+            NS_TEST_EXPECT_MSG_EQ((cached[i].targetNodes == applications[i].targetNodes),
+                                  true,
+                                  "targets of " << applications[i].appName);
+        }
+        NS_TEST_EXPECT_MSG_EQ(cache.GetCnrsNode(), "core1", "CNRS central node");
+
+        // reopening unmaps the previous file
+        NS_TEST_EXPECT_MSG_EQ(cache.Open(cacheFile, hash + 1), false, "stale cache accepted");
+        NS_TEST_EXPECT_MSG_EQ(cache.Open(cacheFile, hash), true, "cache not mapped again");
+    }
+
+    CybertwinTopologyCache cache;
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(CreateTempDirFilename("missing.cache"), hash),
+                          false,
+                          "missing cache accepted");
+
+    std::string image = ReadFile(cacheFile);
+    std::string damaged = CreateTempDirFilename("damaged.cache");
+
+    WriteFile(damaged, image.substr(0, image.size() - 8));
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(damaged, hash), false, "truncated cache accepted");
+
+    WriteFile(damaged, image + std::string(8, '\0'));
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(damaged, hash), false, "extended cache accepted");
+
+    WriteFile(damaged, image.substr(0, 16));
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(damaged, hash), false, "cache header accepted alone");
+
+    std::string corrupt = image;
+    corrupt[0] ^= 0xFF;
+    WriteFile(damaged, corrupt);
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(damaged, hash), false, "cache with bad magic accepted");
+
+    // the version follows the 8 byte magic
+    corrupt = image;
+    corrupt[8] ^= 0x01;
+    WriteFile(damaged, corrupt);
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(damaged, hash), false, "other cache version accepted");
+
+    // a change of the sources makes the cache stale
+    WriteFile(topology, "core_layer: [{name: core0}]\n");
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(cacheFile, CybertwinTopologyCache::Hash({topology, apps}, "")),
+                          false,
+                          "cache of other sources accepted");
+    NS_TEST_EXPECT_MSG_EQ(cache.Open(cacheFile, hash), true, "cache not mapped");
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Cache TestSuite
+ */
+class CybertwinTopologyCacheTestSuite : public TestSuite
+{
+  public:
+    CybertwinTopologyCacheTestSuite();
+};
+
+CybertwinTopologyCacheTestSuite::CybertwinTopologyCacheTestSuite()
+    : TestSuite("cybertwin-topology-cache", UNIT)
+{
+    AddTestCase(new CybertwinTopologyCacheTest(), TestCase::QUICK);
+}
+
+static CybertwinTopologyCacheTestSuite
+    g_cybertwinTopologyCacheTestSuite; //!< Static variable for test initialization
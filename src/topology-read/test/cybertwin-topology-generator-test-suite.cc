@@ -0,0 +1,439 @@
+//-----------------------------------------------------------------------------
+// Unit tests
+//-----------------------------------------------------------------------------
+
+#include "ns3/cybertwin-address-allocator.h"
+#include "ns3/cybertwin-topology-generator.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/test.h"
+
+#include <functional>
+#include <map>
+#include <numeric>
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::CybertwinTopologyGenerator and ns3::CybertwinAddressAllocator test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Expand a template and keep the emitted nodes
+ */
+class GeneratedTopology
+{
+  public:
+    /**
+     * \brief Expand a template
+     * \param spec the template entry, as YAML
+     * \param parents the nodes of the layer above
+     * \param replicaType node type of the replicate template
+     */
+    GeneratedTopology(const std::string& spec,
+                      const std::vector<NodeInfo_t*>& parents = {},
+                      NodeType_e replicaType = NodeType_e::HOST_SERVER)
+    {
+        CybertwinTopologyGenerator generator(
+            [this](NodeInfo_t* node) {
+                index[node->name] = nodes.size();
+                nodes.push_back(node);
+            },
+            replicaType);
+        count = generator.Expand(YAML::Load(spec), parents);
+    }
+
+    ~GeneratedTopology()
+    {
+        for (auto node : nodes)
+        {
+            delete node;
+        }
+    }
+
+    /**
+     * \brief Get the number of links of every node
+     * \return the degrees, by emission order
+     */
+    std::vector<uint32_t> Degrees() const
+    {
+        std::vector<uint32_t> degrees(nodes.size(), 0);
+        for (uint32_t i = 0; i < nodes.size(); i++)
+        {
+            for (const auto& link : nodes[i]->links)
+            {
+                degrees[i]++;
+                degrees[index.at(link.target)]++;
+            }
+        }
+        return degrees;
+    }
+
+    /**
+     * \brief Get the number of links
+     */
+    uint32_t Links() const
+    {
+        uint32_t links = 0;
+        for (auto node : nodes)
+        {
+            links += node->links.size();
+        }
+        return links;
+    }
+
+    /**
+     * \brief Check that every link targets a node emitted before its source
+     */
+    bool LinksPointBackwards() const
+    {
+        for (uint32_t i = 0; i < nodes.size(); i++)
+        {
+            for (const auto& link : nodes[i]->links)
+            {
+                auto it = index.find(link.target);
+                if (it == index.end() || it->second >= i)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Check that the links join every node
+     */
+    bool Connected() const
+    {
+        std::vector<uint32_t> parent(nodes.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        std::function<uint32_t(uint32_t)> find = [&](uint32_t i) {
+            return parent[i] == i ? i : parent[i] = find(parent[i]);
+        };
+        uint32_t components = nodes.size();
+        for (uint32_t i = 0; i < nodes.size(); i++)
+        {
+            for (const auto& link : nodes[i]->links)
+            {
+                uint32_t a = find(i);
+                uint32_t b = find(index.at(link.target));
+                if (a != b)
+                {
+                    parent[a] = b;
+                    components--;
+                }
+            }
+        }
+        return components <= 1;
+    }
+
+    /**
+     * \brief Get the links as (source, target) name pairs
+     */
+    std::set<std::pair<std::string, std::string>> LinkSet() const
+    {
+        std::set<std::pair<std::string, std::string>> links;
+        for (auto node : nodes)
+        {
+            for (const auto& link : node->links)
+            {
+                links.emplace(node->name, link.target);
+            }
+        }
+        return links;
+    }
+
+    uint32_t count;                          //!< count returned by Expand
+    std::vector<NodeInfo_t*> nodes;          //!< emitted nodes
+    std::map<std::string, uint32_t> index;   //!< emission order of a name
+};
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Generator Structured Templates Test
+ *
+ * The fat_tree and kary_tree templates give fixed graphs.
+ */
+class CybertwinTopologyGeneratorTreesTest : public TestCase
+{
+  public:
+    CybertwinTopologyGeneratorTreesTest();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinTopologyGeneratorTreesTest::CybertwinTopologyGeneratorTreesTest()
+    : TestCase("CybertwinTopologyGeneratorTreesTest")
+{
+}
+
+void
+CybertwinTopologyGeneratorTreesTest::DoRun()
+{
+    {
+        GeneratedTopology fatTree(
+            "{kind: fat_tree, k: 4, prefix: ft, data_rate: 10Gbps, delay: 2ms, members: 2}");
+        // (k/2)^2 core, k*k/2 aggregation and k*k/2 top-of-rack switches
+        NS_TEST_ASSERT_MSG_EQ(fatTree.nodes.size(), 20, "fat_tree nodes");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.count, 20, "fat_tree count");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.Links(), 32, "fat_tree links");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.LinksPointBackwards(), true, "fat_tree link order");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.Connected(), true, "fat_tree connectivity");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.index.count("ft_core3"), 1, "fat_tree core name");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.index.count("ft_agg3_1"), 1, "fat_tree agg name");
+        NS_TEST_EXPECT_MSG_EQ(fatTree.index.count("ft_tor3_1"), 1, "fat_tree tor name");
+
+        // every switch has k ports, the top-of-rack switches use k/2 upwards
+        std::vector<uint32_t> degrees = fatTree.Degrees();
+        for (uint32_t i = 0; i < fatTree.nodes.size(); i++)
+        {
+            const std::string& name = fatTree.nodes[i]->name;
+            uint32_t expected = name.find("_tor") != std::string::npos ? 2 : 4;
+            NS_TEST_EXPECT_MSG_EQ(degrees[i], expected, "fat_tree degree of " << name);
+        }
+
+        const Link_t& link = fatTree.nodes.back()->links.front();
+        NS_TEST_EXPECT_MSG_EQ(link.data_rate, "10Gbps", "fat_tree data rate");
+        NS_TEST_EXPECT_MSG_EQ(link.delay, "2ms", "fat_tree delay");
+        NS_TEST_EXPECT_MSG_EQ(link.network, "auto", "generated networks are auto");
+        NS_TEST_EXPECT_MSG_EQ(link.members, 2, "fat_tree members");
+    }
+
+    {
+        GeneratedTopology tree("{kind: kary_tree, k: 3, depth: 3, prefix: t}");
+        NS_TEST_ASSERT_MSG_EQ(tree.nodes.size(), 13, "kary_tree nodes");
+        NS_TEST_EXPECT_MSG_EQ(tree.Links(), 12, "kary_tree links");
+        NS_TEST_EXPECT_MSG_EQ(tree.nodes[0]->links.size(), 0, "kary_tree root");
+        for (uint32_t i = 1; i < tree.nodes.size(); i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(tree.nodes[i]->links.size(), 1, "kary_tree single parent");
+            NS_TEST_EXPECT_MSG_EQ(tree.nodes[i]->links[0].target,
+                                  "t" + std::to_string((i - 1) / 3),
+                                  "kary_tree parent of t" << i);
+        }
+    }
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Generator Random Templates Test
+ *
+ * The waxman and barabasi_albert templates are connected and expand to
+ * the same graph for the same seed.
+ */
+class CybertwinTopologyGeneratorRandomTest : public TestCase
+{
+  public:
+    CybertwinTopologyGeneratorRandomTest();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinTopologyGeneratorRandomTest::CybertwinTopologyGeneratorRandomTest()
+    : TestCase("CybertwinTopologyGeneratorRandomTest")
+{
+}
+
+void
+CybertwinTopologyGeneratorRandomTest::DoRun()
+{
+    std::string waxman = "{kind: waxman, count: 40, alpha: 0.3, beta: 0.4, prefix: w, seed: ";
+    GeneratedTopology w1(waxman + "7}");
+    GeneratedTopology w2(waxman + "7}");
+    GeneratedTopology w3(waxman + "8}");
+    NS_TEST_ASSERT_MSG_EQ(w1.nodes.size(), 40, "waxman nodes");
+    NS_TEST_EXPECT_MSG_EQ(w1.LinksPointBackwards(), true, "waxman link order");
+    NS_TEST_EXPECT_MSG_EQ(w1.Connected(), true, "waxman connectivity");
+    NS_TEST_EXPECT_MSG_EQ((w1.LinkSet() == w2.LinkSet()), true, "waxman seed reproducibility");
+    NS_TEST_EXPECT_MSG_EQ((w1.LinkSet() == w3.LinkSet()), false, "waxman seed ignored");
+
+    std::string ba = "{kind: barabasi_albert, count: 50, m: 2, prefix: ba, seed: ";
+    GeneratedTopology b1(ba + "3}");
+    GeneratedTopology b2(ba + "3}");
+    NS_TEST_ASSERT_MSG_EQ(b1.nodes.size(), 50, "barabasi_albert nodes");
+    // a clique of the first m + 1 nodes, then m links per node
+    NS_TEST_EXPECT_MSG_EQ(b1.Links(), 3 + 47 * 2, "barabasi_albert links");
+    NS_TEST_EXPECT_MSG_EQ(b1.LinkSet().size(), b1.Links(), "barabasi_albert duplicate link");
+    NS_TEST_EXPECT_MSG_EQ(b1.LinksPointBackwards(), true, "barabasi_albert link order");
+    NS_TEST_EXPECT_MSG_EQ(b1.Connected(), true, "barabasi_albert connectivity");
+    NS_TEST_EXPECT_MSG_EQ((b1.LinkSet() == b2.LinkSet()),
+                          true,
+                          "barabasi_albert seed reproducibility");
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Generator Replicate Test
+ *
+ * Replicas hang off the parents matching attach_to. Edge replicas link to
+ * uplinks consecutive parents, access replicas are end clusters with their
+ * parent as single gateway.
+ */
+class CybertwinTopologyGeneratorReplicateTest : public TestCase
+{
+  public:
+    CybertwinTopologyGeneratorReplicateTest();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinTopologyGeneratorReplicateTest::CybertwinTopologyGeneratorReplicateTest()
+    : TestCase("CybertwinTopologyGeneratorReplicateTest")
+{
+}
+
+void
+CybertwinTopologyGeneratorReplicateTest::DoRun()
+{
+    GeneratedTopology parents("{kind: kary_tree, k: 2, depth: 2, prefix: core}");
+    parents.nodes.push_back(new NodeInfo_t());
+    parents.nodes.back()->name = "other";
+    parents.nodes.back()->type = NodeType_e::HOST_SERVER;
+    parents.nodes.back()->num_nodes = 0;
+
+    GeneratedTopology edge("{kind: replicate, prefix: e, attach_to: core, count: 2, uplinks: 2}",
+                           parents.nodes);
+    NS_TEST_ASSERT_MSG_EQ(edge.nodes.size(), 6, "two replicas per matching parent");
+    for (uint32_t i = 0; i < edge.nodes.size(); i++)
+    {
+        const NodeInfo_t* node = edge.nodes[i];
+        uint32_t parent = i / 2;
+        NS_TEST_EXPECT_MSG_EQ(node->name, "e" + std::to_string(i), "replica name");
+        NS_TEST_EXPECT_MSG_EQ(node->type, NodeType_e::HOST_SERVER, "edge replica type");
+        NS_TEST_ASSERT_MSG_EQ(node->links.size(), 2, "edge replica uplinks");
+        NS_TEST_EXPECT_MSG_EQ(node->links[0].target,
+                              "core" + std::to_string(parent),
+                              "first uplink of " << node->name);
+        NS_TEST_EXPECT_MSG_EQ(node->links[1].target,
+                              "core" + std::to_string((parent + 1) % 3),
+                              "second uplink of " << node->name);
+    }
+
+    GeneratedTopology access("{kind: replicate, prefix: c, attach_to: core, count: 1, "
+                             "num_nodes: 3, network_type: [csma, wifi]}",
+                             parents.nodes,
+                             NodeType_e::END_CLUSTER);
+    NS_TEST_ASSERT_MSG_EQ(access.nodes.size(), 3, "one replica per matching parent");
+    for (uint32_t i = 0; i < access.nodes.size(); i++)
+    {
+        const NodeInfo_t* node = access.nodes[i];
+        NS_TEST_EXPECT_MSG_EQ(node->type, NodeType_e::END_CLUSTER, "access replica type");
+        NS_TEST_EXPECT_MSG_EQ(node->num_nodes, 3, "cluster size");
+        NS_TEST_EXPECT_MSG_EQ(node->network_type,
+                              (i % 2 ? "wifi" : "csma"),
+                              "network types are cycled");
+        NS_TEST_EXPECT_MSG_EQ(node->local_network, "auto", "cluster network");
+        NS_TEST_EXPECT_MSG_EQ(node->links.size(), 0, "end clusters have no links");
+        NS_TEST_ASSERT_MSG_EQ(node->gateways.size(), 1, "end clusters have one gateway");
+        NS_TEST_EXPECT_MSG_EQ(node->gateways[0].name,
+                              "core" + std::to_string(i),
+                              "gateway of " << node->name);
+    }
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Address Allocator Test
+ *
+ * Subnets are aligned, skip the reserved networks and never overlap,
+ * whichever pool they come from.
+ */
+class CybertwinAddressAllocatorTest : public TestCase
+{
+  public:
+    CybertwinAddressAllocatorTest();
+
+  private:
+    void DoRun() override;
+};
+
+CybertwinAddressAllocatorTest::CybertwinAddressAllocatorTest()
+    : TestCase("CybertwinAddressAllocatorTest")
+{
+}
+
+void
+CybertwinAddressAllocatorTest::DoRun()
+{
+    uint32_t base;
+    uint32_t prefixLength;
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::Parse("10.1.2.3/16", base, prefixLength),
+                          true,
+                          "valid network");
+    NS_TEST_EXPECT_MSG_EQ(Ipv4Address(base), Ipv4Address("10.1.0.0"), "host bits cleared");
+    NS_TEST_EXPECT_MSG_EQ(prefixLength, 16, "prefix length");
+    for (const auto& malformed : {"10.1.2.3", "10.1.2/24", "10.1.2.256/24", "10.1.2.3/33", "a/8"})
+    {
+        NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::Parse(malformed, base, prefixLength),
+                              false,
+                              "malformed network " << malformed);
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::PrefixLengthForHosts(1), 30, "1 host");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::PrefixLengthForHosts(6), 29, "6 hosts");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::PrefixLengthForHosts(7), 28, "7 hosts");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::PrefixLengthForHosts(254), 24, "254 hosts");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinAddressAllocator::PrefixLengthForHosts(255), 23, "255 hosts");
+
+    CybertwinAddressAllocator allocator;
+    NS_TEST_EXPECT_MSG_EQ(allocator.Reserve("10.0.0.0/24"), true, "first reservation");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Reserve("10.0.0.128/25"), false, "overlapping reservation");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Reserve("10.0.4.0/23"), true, "second reservation");
+
+    uint32_t links = allocator.AddPool("10.0.0.0/16");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(links, 24), "10.0.1.0/24", "reserved range skipped");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(links, 30), "10.0.2.0/30", "bump allocation");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(links, 24), "10.0.3.0/24", "aligned allocation");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(links, 24), "10.0.6.0/24", "reserved /23 skipped");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(links, 30), "10.0.7.0/30", "bump allocation");
+
+    // a second pool covering the first one skips its allocations
+    uint32_t clusters = allocator.AddPool("10.0.0.0/8");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(clusters, 16), "10.1.0.0/16", "used /16 skipped");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Allocate(clusters, 16), "10.2.0.0/16", "bump allocation");
+    NS_TEST_EXPECT_MSG_EQ(allocator.Reserve("10.1.128.0/24"),
+                          false,
+                          "allocated subnets are used");
+    NS_TEST_EXPECT_MSG_EQ(allocator.GetAllocated(), 7, "allocated subnets");
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Generator TestSuite
+ */
+class CybertwinTopologyGeneratorTestSuite : public TestSuite
+{
+  public:
+    CybertwinTopologyGeneratorTestSuite();
+};
+
+CybertwinTopologyGeneratorTestSuite::CybertwinTopologyGeneratorTestSuite()
+    : TestSuite("cybertwin-topology-generator", UNIT)
+{
+    AddTestCase(new CybertwinTopologyGeneratorTreesTest(), TestCase::QUICK);
+    AddTestCase(new CybertwinTopologyGeneratorRandomTest(), TestCase::QUICK);
+    AddTestCase(new CybertwinTopologyGeneratorReplicateTest(), TestCase::QUICK);
+    AddTestCase(new CybertwinAddressAllocatorTest(), TestCase::QUICK);
+}
+
+static CybertwinTopologyGeneratorTestSuite
+    g_cybertwinTopologyGeneratorTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,340 @@
+//-----------------------------------------------------------------------------
+// Unit tests
+//-----------------------------------------------------------------------------
+
+#include "ns3/cybertwin-topology-reader.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::CybertwinTopologyReader test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Reader Batched Build Test
+ *
+ * The layers built in batches hold the same nodes, devices and
+ * addresses as the same links built one at a time with a
+ * PointToPointHelper and an Ipv4AddressHelper.
+ */
+class CybertwinTopologyReaderBuildTest : public TestCase
+{
+  public:
+    CybertwinTopologyReaderBuildTest();
+
+  private:
+    void DoRun() override;
+
+    /// A link of the topology file
+    struct Link
+    {
+        std::string source;   //!< name of the first node
+        std::string target;   //!< name of the second node
+        std::string network;  //!< network of the link, or "auto"
+        std::string dataRate; //!< data rate of the link
+        std::string delay;    //!< delay of the link
+    };
+
+    /**
+     * \brief Find the device of a node linked to another node
+     * \param node the node
+     * \param peer the other end of the link
+     * \return the device, null if the nodes are not linked
+     */
+    static Ptr<PointToPointNetDevice> FindDevice(Ptr<Node> node, Ptr<Node> peer);
+
+    /**
+     * \brief Get the address of the interface of a device
+     * \param device the device
+     * \return the address
+     */
+    static Ipv4InterfaceAddress GetAddress(Ptr<NetDevice> device);
+
+    /**
+     * \brief Check a link built by the reader against the helpers
+     * \param link the link of the topology file
+     * \param nodes the nodes of the reader, by name
+     * \param networks the networks of the links checked so far
+     */
+    void CheckLink(const Link& link,
+                   const std::map<std::string, Ptr<Node>>& nodes,
+                   std::set<Ipv4Address>& networks);
+};
+
+CybertwinTopologyReaderBuildTest::CybertwinTopologyReaderBuildTest()
+    : TestCase("CybertwinTopologyReaderBuildTest")
+{
+}
+
+Ptr<PointToPointNetDevice>
+CybertwinTopologyReaderBuildTest::FindDevice(Ptr<Node> node, Ptr<Node> peer)
+{
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
+    {
+        Ptr<PointToPointNetDevice> device =
+            DynamicCast<PointToPointNetDevice>(node->GetDevice(i));
+        if (!device)
+        {
+            continue;
+        }
+        Ptr<Channel> channel = device->GetChannel();
+        for (std::size_t j = 0; j < channel->GetNDevices(); j++)
+        {
+            if (channel->GetDevice(j)->GetNode() == peer)
+            {
+                return device;
+            }
+        }
+    }
+    return nullptr;
+}
+
+Ipv4InterfaceAddress
+CybertwinTopologyReaderBuildTest::GetAddress(Ptr<NetDevice> device)
+{
+    Ptr<Ipv4> ipv4 = device->GetNode()->GetObject<Ipv4>();
+    int32_t interface = ipv4->GetInterfaceForDevice(device);
+    NS_ABORT_MSG_IF(interface == -1 || ipv4->GetNAddresses(interface) != 1,
+                    "No single address on device " << device->GetIfIndex());
+    return ipv4->GetAddress(interface, 0);
+}
+
+void
+CybertwinTopologyReaderBuildTest::CheckLink(const Link& link,
+                                           const std::map<std::string, Ptr<Node>>& nodes,
+                                           std::set<Ipv4Address>& networks)
+{
+    std::string name = link.source + "-" + link.target;
+    Ptr<Node> built[2] = {nodes.at(link.source), nodes.at(link.target)};
+    Ptr<PointToPointNetDevice> devices[2] = {FindDevice(built[0], built[1]),
+                                             FindDevice(built[1], built[0])};
+    NS_TEST_ASSERT_MSG_NE(devices[0], nullptr, "no device for " << name);
+    NS_TEST_ASSERT_MSG_NE(devices[1], nullptr, "no device for " << name);
+    NS_TEST_EXPECT_MSG_EQ(devices[0]->GetChannel(),
+                          devices[1]->GetChannel(),
+                          "sides on different channels for " << name);
+
+    Ipv4InterfaceAddress addresses[2] = {GetAddress(devices[0]), GetAddress(devices[1])};
+    Ipv4Address network = addresses[0].GetLocal().CombineMask(addresses[0].GetMask());
+    Ipv4Mask mask = addresses[0].GetMask();
+    if (link.network == "auto")
+    {
+        NS_TEST_EXPECT_MSG_EQ(mask, Ipv4Mask("/30"), "auto network of " << name);
+        NS_TEST_EXPECT_MSG_EQ(network.CombineMask(Ipv4Mask("/10")),
+                              Ipv4Address("100.64.0.0"),
+                              "auto network of " << name << " out of the pool");
+    }
+    else
+    {
+        std::size_t slash = link.network.find('/');
+        network = Ipv4Address(link.network.substr(0, slash).c_str());
+        mask = Ipv4Mask(link.network.substr(slash).c_str());
+    }
+    NS_TEST_EXPECT_MSG_EQ(networks.insert(network).second,
+                          true,
+                          "network of " << name << " shared with another link");
+
+    // the same link, one helper call at a time
+    NodeContainer reference(2);
+    InternetStackHelper stack;
+    stack.Install(reference);
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(link.dataRate));
+    p2p.SetChannelAttribute("Delay", StringValue(link.delay));
+    NetDeviceContainer referenceDevices = p2p.Install(reference);
+    Ipv4AddressHelper address;
+    address.SetBase(network, mask);
+    address.Assign(referenceDevices);
+
+    for (uint32_t side = 0; side < 2; side++)
+    {
+        Ptr<PointToPointNetDevice> expected =
+            DynamicCast<PointToPointNetDevice>(referenceDevices.Get(side));
+        Ipv4InterfaceAddress expectedAddress = GetAddress(expected);
+        NS_TEST_EXPECT_MSG_EQ(addresses[side].GetLocal(),
+                              expectedAddress.GetLocal(),
+                              "address of side " << side << " of " << name);
+        NS_TEST_EXPECT_MSG_EQ(addresses[side].GetMask(),
+                              expectedAddress.GetMask(),
+                              "mask of side " << side << " of " << name);
+        NS_TEST_EXPECT_MSG_EQ(devices[side]->GetMtu(),
+                              expected->GetMtu(),
+                              "MTU of side " << side << " of " << name);
+
+        DataRateValue rate;
+        DataRateValue expectedRate;
+        devices[side]->GetAttribute("DataRate", rate);
+        expected->GetAttribute("DataRate", expectedRate);
+        NS_TEST_EXPECT_MSG_EQ(rate.Get(),
+                              expectedRate.Get(),
+                              "data rate of side " << side << " of " << name);
+
+        Ptr<NetDeviceQueueInterface> queue =
+            devices[side]->GetObject<NetDeviceQueueInterface>();
+        NS_TEST_EXPECT_MSG_NE(queue, nullptr, "no queue interface on " << name);
+    }
+
+    TimeValue delay;
+    TimeValue expectedDelay;
+    devices[0]->GetChannel()->GetAttribute("Delay", delay);
+    referenceDevices.Get(0)->GetChannel()->GetAttribute("Delay", expectedDelay);
+    NS_TEST_EXPECT_MSG_EQ(delay.Get(), expectedDelay.Get(), "delay of " << name);
+}
+
+void
+CybertwinTopologyReaderBuildTest::DoRun()
+{
+    std::vector<Link> coreLinks = {
+        {"core1", "core2", "10.1.0.0/30", "1Gbps", "2ms"},
+        {"core1", "core3", "auto", "500Mbps", "3ms"},
+        {"core2", "core3", "10.1.0.4/30", "1Gbps", "4ms"},
+    };
+    std::vector<Link> edgeLinks = {
+        {"edge1", "core1", "10.2.0.0/30", "100Mbps", "5ms"},
+        {"edge2", "core2", "auto", "100Mbps", "5ms"},
+        {"edge3", "core3", "auto", "200Mbps", "6ms"},
+    };
+
+    std::string topology = CreateTempDirFilename("topology.yaml");
+    {
+        std::ofstream out(topology);
+        out << "cybertwin_network:\n";
+        auto writeLayer = [&out](const std::string& layer,
+                                 const std::vector<std::string>& names,
+                                 const std::vector<Link>& links) {
+            out << "  " << layer << ":\n    nodes:\n";
+            for (const auto& name : names)
+            {
+                out << "      - name: " << name << "\n"
+                    << "        type: host_server\n"
+                    << "        position: [0, 0, 0]\n"
+                    << "        connections:";
+                bool linked = false;
+                for (const auto& link : links)
+                {
+                    if (link.source == name)
+                    {
+                        out << (linked ? "" : "\n");
+                        linked = true;
+                        out << "          - target: " << link.target << "\n"
+                            << "            network: " << link.network << "\n"
+                            << "            data_rate: " << link.dataRate << "\n"
+                            << "            delay: " << link.delay << "\n";
+                    }
+                }
+                out << (linked ? "" : " []\n");
+            }
+        };
+        writeLayer("core_layer", {"core1", "core2", "core3"}, coreLinks);
+        writeLayer("edge_layer", {"edge1", "edge2", "edge3"}, edgeLinks);
+        out << "  access_layer:\n"
+            << "    nodes:\n"
+            << "      - name: cluster1\n"
+            << "        type: end_cluster\n"
+            << "        position: [0, 0, 0]\n"
+            << "        num_nodes: 2\n"
+            << "        network_type: csma\n"
+            << "        local_network: 192.168.1.0/24\n"
+            << "        gateways:\n"
+            << "          - target: edge1\n"
+            << "            network: 10.3.0.0/30\n"
+            << "            data_rate: 50Mbps\n"
+            << "            delay: 7ms\n"
+            << "  cnrs:\n"
+            << "    central_node: core1\n";
+    }
+
+    Ptr<CybertwinTopologyReader> reader = CreateObject<CybertwinTopologyReader>();
+    reader->SetFileName(topology);
+    NodeContainer nodes = reader->Read();
+
+    NS_TEST_EXPECT_MSG_EQ(reader->GetCoreCloudNodes().GetN(), 3, "core nodes");
+    NS_TEST_EXPECT_MSG_EQ(reader->GetEdgeCloudNodes().GetN(), 3, "edge nodes");
+    NS_TEST_EXPECT_MSG_EQ(reader->GetEndHostNodes().GetN(), 2, "end hosts");
+    // the servers and the hosts of the cluster, one of them its router
+    NS_TEST_EXPECT_MSG_EQ(nodes.GetN(), 8, "nodes");
+
+    std::map<std::string, Ptr<Node>> byName;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<CybertwinNode> node = DynamicCast<CybertwinNode>(nodes.Get(i));
+        if (node && !node->GetName().empty())
+        {
+            byName[node->GetName()] = node;
+        }
+    }
+
+    // every link, once, with the addresses and devices of the helpers
+    std::set<Ipv4Address> networks;
+    for (const auto& links : {coreLinks, edgeLinks})
+    {
+        for (const auto& link : links)
+        {
+            CheckLink(link, byName, networks);
+        }
+    }
+
+    // the loopback and one device per link
+    std::map<std::string, uint32_t> expectedDevices = {{"core1", 4},
+                                                       {"core2", 4},
+                                                       {"core3", 4},
+                                                       {"edge1", 3},
+                                                       {"edge2", 2},
+                                                       {"edge3", 2}};
+    for (const auto& expected : expectedDevices)
+    {
+        NS_TEST_EXPECT_MSG_EQ(byName.at(expected.first)->GetNDevices(),
+                              expected.second,
+                              "devices of " << expected.first);
+    }
+
+    // the gateway link of the cluster
+    Ptr<Node> edge1 = byName.at("edge1");
+    Ptr<Node> router;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        if (nodes.Get(i) != byName.at("core1") && FindDevice(edge1, nodes.Get(i)))
+        {
+            router = nodes.Get(i);
+        }
+    }
+    NS_TEST_ASSERT_MSG_NE(router, nullptr, "cluster not linked to its gateway");
+    Ipv4InterfaceAddress routerAddress = GetAddress(FindDevice(router, edge1));
+    Ipv4InterfaceAddress gatewayAddress = GetAddress(FindDevice(edge1, router));
+    NS_TEST_EXPECT_MSG_EQ(routerAddress.GetLocal(), Ipv4Address("10.3.0.1"), "router address");
+    NS_TEST_EXPECT_MSG_EQ(gatewayAddress.GetLocal(), Ipv4Address("10.3.0.2"), "gateway address");
+
+    Simulator::Destroy();
+    Ipv4AddressGenerator::Reset();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Reader TestSuite
+ */
+class CybertwinTopologyReaderTestSuite : public TestSuite
+{
+  public:
+    CybertwinTopologyReaderTestSuite();
+};
+
+CybertwinTopologyReaderTestSuite::CybertwinTopologyReaderTestSuite()
+    : TestSuite("cybertwin-topology-reader", UNIT)
+{
+    AddTestCase(new CybertwinTopologyReaderBuildTest(), TestCase::QUICK);
+}
+
+static CybertwinTopologyReaderTestSuite
+    g_cybertwinTopologyReaderTestSuite; //!< Static variable for test initialization
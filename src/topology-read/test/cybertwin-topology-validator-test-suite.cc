@@ -0,0 +1,288 @@
+//-----------------------------------------------------------------------------
+// Unit tests
+//-----------------------------------------------------------------------------
+
+#include "ns3/cybertwin-topology-validator.h"
+#include "ns3/test.h"
+
+#include <deque>
+#include <functional>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::CybertwinTopologyValidator test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief A small valid topology, modified by each check
+ *
+ * Two core servers, an edge server and a CSMA end cluster of three hosts:
+ * core1 - core0 - edge0 - cluster0.
+ */
+class ValidatorTopology
+{
+  public:
+    ValidatorTopology()
+    {
+        NodeInfo_t* core0 = Add(core, "core0", NodeType_e::HOST_SERVER);
+        NodeInfo_t* core1 = Add(core, "core1", NodeType_e::HOST_SERVER);
+        core1->links.push_back({core0->name, "10Gbps", "1ms", "10.0.0.0/30", 1});
+        NodeInfo_t* edge0 = Add(edge, "edge0", NodeType_e::HOST_SERVER);
+        edge0->links.push_back({core0->name, "1Gbps", "2ms", "auto", 2});
+        NodeInfo_t* cluster0 = Add(clusters, "cluster0", NodeType_e::END_CLUSTER);
+        cluster0->num_nodes = 3;
+        cluster0->network_type = "csma";
+        cluster0->local_network = "10.1.0.0/29";
+        cluster0->gateways.push_back({edge0->name, "100Mbps", "5ms", "auto"});
+    }
+
+    /**
+     * \brief Add a node
+     * \param layer the layer of the node
+     * \param name the node name
+     * \param type the node type
+     * \return the node
+     */
+    NodeInfo_t* Add(std::vector<NodeInfo_t*>& layer, const std::string& name, NodeType_e type)
+    {
+        m_storage.emplace_back();
+        NodeInfo_t* node = &m_storage.back();
+        node->name = name;
+        node->type = type;
+        node->num_nodes = 0;
+        layer.push_back(node);
+        return node;
+    }
+
+    std::vector<NodeInfo_t*> core;     //!< core servers
+    std::vector<NodeInfo_t*> edge;     //!< edge servers
+    std::vector<NodeInfo_t*> clusters; //!< end clusters
+
+  private:
+    std::deque<NodeInfo_t> m_storage; //!< the nodes
+};
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Validator Test
+ *
+ * Every mistake of the checked kinds is reported as an error or a warning
+ * of its own, and the estimate counts the built network.
+ */
+class CybertwinTopologyValidatorTest : public TestCase
+{
+  public:
+    CybertwinTopologyValidatorTest();
+
+  private:
+    void DoRun() override;
+
+    /// A change of the valid topology
+    typedef std::function<void(ValidatorTopology&)> Change;
+    /// Settings of the validator
+    typedef std::function<void(CybertwinTopologyValidator&)> Setup;
+
+    /**
+     * \brief Validate a changed topology
+     * \param change the change
+     * \param error text of the error expected, empty for none
+     * \param warning text of the warning expected, empty for none
+     * \param setup settings of the validator
+     */
+    void Check(Change change,
+               const std::string& error,
+               const std::string& warning,
+               Setup setup = nullptr);
+
+    /**
+     * \brief Check that one message contains a text
+     * \param messages the messages
+     * \param text the text, empty for no message
+     * \param kind the kind of messages, for the report
+     */
+    void CheckMessages(const std::vector<std::string>& messages,
+                       const std::string& text,
+                       const std::string& kind);
+};
+
+CybertwinTopologyValidatorTest::CybertwinTopologyValidatorTest()
+    : TestCase("CybertwinTopologyValidatorTest")
+{
+}
+
+void
+CybertwinTopologyValidatorTest::CheckMessages(const std::vector<std::string>& messages,
+                                              const std::string& text,
+                                              const std::string& kind)
+{
+    if (text.empty())
+    {
+        for (const auto& message : messages)
+        {
+            NS_TEST_EXPECT_MSG_EQ(message, "", "unexpected " << kind);
+        }
+        return;
+    }
+    bool found = false;
+    for (const auto& message : messages)
+    {
+        found = found || message.find(text) != std::string::npos;
+    }
+    NS_TEST_EXPECT_MSG_EQ(found, true, "missing " << kind << " '" << text << "'");
+}
+
+void
+CybertwinTopologyValidatorTest::Check(Change change,
+                                      const std::string& error,
+                                      const std::string& warning,
+                                      Setup setup)
+{
+    ValidatorTopology topology;
+    change(topology);
+    CybertwinTopologyValidator validator(topology.core, topology.edge, topology.clusters);
+    if (setup)
+    {
+        setup(validator);
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(validator.Validate(), error.empty(), "validation result");
+    CheckMessages(validator.GetErrors(), error, "error");
+    CheckMessages(validator.GetWarnings(), warning, "warning");
+}
+
+void
+CybertwinTopologyValidatorTest::DoRun()
+{
+    // the valid topology
+    {
+        ValidatorTopology topology;
+        CybertwinTopologyValidator validator(topology.core, topology.edge, topology.clusters);
+        validator.SetCnrsRoot("core0");
+        validator.SetApplications({{"app", {"core1", "edge0", "cluster0_0", "cluster0_2"}, ""}});
+        NS_TEST_EXPECT_MSG_EQ(validator.Validate(), true, "valid topology");
+        CheckMessages(validator.GetErrors(), "", "error");
+        CheckMessages(validator.GetWarnings(), "", "warning");
+
+        // 3 links, 3 servers, a router and 3 hosts on one more channel
+        CybertwinTopologyValidator::Estimate estimate = validator.GetEstimate();
+        NS_TEST_EXPECT_MSG_EQ(estimate.links, 3, "estimated links");
+        NS_TEST_EXPECT_MSG_EQ(estimate.nodes, 7, "estimated nodes");
+        NS_TEST_EXPECT_MSG_EQ(estimate.devices, 10, "estimated devices");
+        NS_TEST_EXPECT_MSG_EQ(estimate.channels, 4, "estimated channels");
+        NS_TEST_EXPECT_MSG_GT(estimate.bootEvents, estimate.nodes, "estimated boot events");
+        NS_TEST_EXPECT_MSG_GT(estimate.memory, 0, "estimated memory");
+    }
+
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].target = "nowhere"; },
+          "link to unknown node nowhere",
+          "");
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].target = "edge0"; },
+          "of the edge layer",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->gateways[0].name = "core0"; },
+          "of the core layer",
+          "");
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].target = "core1"; }, "link to itself", "");
+    Check([](ValidatorTopology& t) { t.edge[0]->links[0].network = "10.0.0.0/29"; },
+          "overlaps",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->local_network = "10.0.0.2/31"; },
+          "too small",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->local_network = "10.1.0.0/30"; },
+          "too small for 4 addresses",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->local_network = "10.1.0/29"; },
+          "malformed network",
+          "");
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].data_rate = "fast"; },
+          "malformed data rate",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->gateways[0].data_rate = "0bps"; },
+          "zero data rate",
+          "");
+    Check([](ValidatorTopology& t) { t.edge[0]->links[0].delay = "2 ms"; }, "malformed delay", "");
+    Check([](ValidatorTopology& t) { t.edge[0]->links[0].members = 0; },
+          "bundle without members",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->network_type = "token-ring"; },
+          "unknown network type",
+          "");
+    Check([](ValidatorTopology& t) { t.clusters[0]->gateways.clear(); }, "no gateway", "");
+    Check([](ValidatorTopology& t) { t.edge[0]->links.clear(); }, "no uplink", "");
+    Check([](ValidatorTopology& t) { t.Add(t.core, "core2", NodeType_e::HOST_SERVER); },
+          "split in 2 parts, not connected to core0: core2",
+          "");
+
+    auto none = [](ValidatorTopology&) {};
+    Check(none, "CNRS root edge0", "", [](CybertwinTopologyValidator& v) {
+        v.SetCnrsRoot("edge0");
+    });
+    Check(none, "unknown target node cluster0_3", "", [](CybertwinTopologyValidator& v) {
+        v.SetApplications({{"app", {"cluster0_3"}, ""}});
+    });
+    // an end cluster is not a node, its hosts are
+    Check(none, "unknown target node cluster0", "", [](CybertwinTopologyValidator& v) {
+        v.SetApplications({{"app", {"cluster0"}, ""}});
+    });
+
+    Check([](ValidatorTopology& t) {
+              t.core[0]->links.push_back(t.core[1]->links[0]);
+              t.core[0]->links.back().target = "core1";
+          },
+          "",
+          "declared twice");
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].delay = "0ms"; }, "", "zero delay");
+    Check([](ValidatorTopology& t) { t.core[1]->links[0].delay = "2s"; }, "", "delay 2s above");
+    Check([](ValidatorTopology& t) { t.clusters[0]->local_network = "10.1.0.1/29"; },
+          "",
+          "host bits set");
+    Check([](ValidatorTopology& t) {
+              t.clusters[0]->gateways.push_back(t.clusters[0]->gateways[0]);
+          },
+          "",
+          "only the first gateway");
+
+    Time delay;
+    NS_TEST_EXPECT_MSG_EQ(CybertwinTopologyValidator::ParseDelay("2ms", delay), true, "2ms");
+    NS_TEST_EXPECT_MSG_EQ(delay, MilliSeconds(2), "2ms");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinTopologyValidator::ParseDelay("1.5us", delay), true, "1.5us");
+    NS_TEST_EXPECT_MSG_EQ(delay, NanoSeconds(1500), "1.5us");
+    NS_TEST_EXPECT_MSG_EQ(CybertwinTopologyValidator::ParseDelay("3", delay), true, "3");
+    NS_TEST_EXPECT_MSG_EQ(delay, Seconds(3), "seconds without unit");
+    for (const auto& malformed : {"", "ms", "2 ms", "2xs", "-1ms", "1.2.3ms"})
+    {
+        NS_TEST_EXPECT_MSG_EQ(CybertwinTopologyValidator::ParseDelay(malformed, delay),
+                              false,
+                              "malformed delay '" << malformed << "'");
+    }
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Cybertwin Topology Validator TestSuite
+ */
+class CybertwinTopologyValidatorTestSuite : public TestSuite
+{
+  public:
+    CybertwinTopologyValidatorTestSuite();
+};
+
+CybertwinTopologyValidatorTestSuite::CybertwinTopologyValidatorTestSuite()
+    : TestSuite("cybertwin-topology-validator", UNIT)
+{
+    AddTestCase(new CybertwinTopologyValidatorTest(), TestCase::QUICK);
+}
+
+static CybertwinTopologyValidatorTestSuite
+    g_cybertwinTopologyValidatorTestSuite; //!< Static variable for test initialization
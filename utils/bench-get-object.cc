@@ -0,0 +1,161 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/command-line.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/udp-l4-protocol.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup system-tests-perf
+ *
+ * Benchmark Object::GetObject() on the nodes of an internet stack, as the
+ * protocols and the applications look up their neighbours for each packet.
+ */
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+namespace
+{
+
+/**
+ * Look up an aggregated type on a node.
+ *
+ * \tparam T The type looked up.
+ * \param [in] node The node.
+ * \returns 1 if the node has an aggregate of the type, 0 otherwise.
+ */
+template <typename T>
+uint32_t
+Find(Ptr<Node> node)
+{
+    return node->GetObject<T>() != nullptr;
+}
+
+/**
+ * Time some lookups on all the nodes.
+ *
+ * \tparam F \deduced The type of the lookups.
+ * \param [in] nodes The nodes.
+ * \param [in] lookups The number of lookups on each node.
+ * \param [in] name The name of the lookups, for the report.
+ * \param [in] count The number of GetObject() calls of the lookups.
+ * \param [in] lookup The lookups on a node, returning the number of objects found.
+ * \returns The mean time of a GetObject(), in nanoseconds.
+ */
+template <typename F>
+double
+Bench(const NodeContainer& nodes,
+      uint32_t lookups,
+      const std::string& name,
+      uint32_t count,
+      F lookup)
+{
+    uint64_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < lookups; ++i)
+    {
+        for (auto node = nodes.Begin(); node != nodes.End(); ++node)
+        {
+            found += lookup(*node);
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double calls = static_cast<double>(lookups) * nodes.GetN();
+    double ns = elapsed.count() / (calls * count);
+    LOG(std::left << std::setw(24) << name << std::setw(12) << ns << found / calls << "/"
+                  << count);
+    return ns;
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nodeCount = 100;
+    uint32_t lookups = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark Object::GetObject() on nodes with an internet stack.\n"
+              "\n"
+              "The table gives the mean time of a lookup of each type on\n"
+              "the nodes, the last one being aggregated to none of them,\n"
+              "then the mean time of the lookups of all the types in turn.");
+    cmd.AddValue("nodes", "number of nodes", nodeCount);
+    cmd.AddValue("lookups", "number of lookups of each type on each node", lookups);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(nodeCount);
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    uint32_t aggregates = 0;
+    for (Object::AggregateIterator i = nodes.Get(0)->GetAggregateIterator(); i.HasNext(); i.Next())
+    {
+        aggregates++;
+    }
+
+    LOG("Benchmark GetObject() on internet nodes");
+    LOG("  Nodes:                " << nodeCount);
+    LOG("  Aggregates per node:  " << aggregates);
+    LOG("  Lookups per node:     " << lookups);
+    LOG("");
+    LOG(std::left << std::setw(24) << "Type" << std::setw(12) << "Time (ns)"
+                  << "Found");
+
+    double total = 0;
+    total += Bench(nodes, lookups, "Ipv4", 1, &Find<Ipv4>);
+    total += Bench(nodes, lookups, "Ipv4L3Protocol", 1, &Find<Ipv4L3Protocol>);
+    total += Bench(nodes, lookups, "Ipv6", 1, &Find<Ipv6>);
+    total += Bench(nodes, lookups, "ArpL3Protocol", 1, &Find<ArpL3Protocol>);
+    total += Bench(nodes, lookups, "Icmpv4L4Protocol", 1, &Find<Icmpv4L4Protocol>);
+    total += Bench(nodes, lookups, "UdpL4Protocol", 1, &Find<UdpL4Protocol>);
+    total += Bench(nodes, lookups, "TcpL4Protocol", 1, &Find<TcpL4Protocol>);
+    total += Bench(nodes, lookups, "TrafficControlLayer", 1, &Find<TrafficControlLayer>);
+    total += Bench(nodes, lookups, "Ipv4RoutingProtocol", 1, &Find<Ipv4RoutingProtocol>);
+    LOG(std::left << std::setw(24) << "Mean" << total / 9);
+    LOG("");
+
+    // The protocols of a packet look up each other in turn
+    Bench(nodes, lookups, "All, interleaved", 9, [](Ptr<Node> node) {
+        return Find<Ipv4>(node) + Find<Ipv4L3Protocol>(node) + Find<Ipv6>(node) +
+               Find<ArpL3Protocol>(node) + Find<Icmpv4L4Protocol>(node) +
+               Find<UdpL4Protocol>(node) + Find<TcpL4Protocol>(node) +
+               Find<TrafficControlLayer>(node) + Find<Ipv4RoutingProtocol>(node);
+    });
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup system-tests-perf
+ *
+ * Benchmark Simulator::ScheduleWithContext() called from threads other
+ * than the main one, as realtime and emulation threads do, while the
+ * main thread runs the simulation.
+ */
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/**
+ * Several producer threads inject events into a running simulation.
+ *
+ * The main thread polls the events received every nanosecond of
+ * simulation time, so it keeps draining the events of the producers
+ * while they push theirs.
+ */
+class InjectionBench
+{
+  public:
+    /** The output. */
+    struct Result
+    {
+        double push; /**< Mean time (ns) of a ScheduleWithContext() in a producer. */
+        double wall; /**< Time (s) until the main thread ran all the events. */
+    };
+
+    /**
+     * Constructor.
+     * \param [in] producers The number of producer threads.
+     * \param [in] events The number of events of each producer.
+     */
+    InjectionBench(uint32_t producers, uint64_t events)
+        : m_producers(producers),
+          m_events(events),
+          m_received(0),
+          m_pushNs(0)
+    {
+    }
+
+    /**
+     * Run the benchmark once.
+     * \returns The Result.
+     */
+    Result Run();
+
+  private:
+    /**
+     * Body of a producer thread.
+     * \param [in] context The context of its events.
+     */
+    void Produce(uint32_t context);
+    /** Start the producer threads, from the main thread. */
+    void Start();
+    /** Stop polling once all the events have run. */
+    void Poll();
+    /** Event injected by the producers. */
+    void Receive();
+
+    uint32_t m_producers;             /**< Number of producer threads. */
+    uint64_t m_events;                /**< Number of events of each producer. */
+    uint64_t m_received;              /**< Events run, counted by the main thread. */
+    std::atomic<uint64_t> m_pushNs;   /**< Total time spent in the producers. */
+    std::vector<std::thread> m_threads; /**< The producer threads. */
+};
+
+void
+InjectionBench::Produce(uint32_t context)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < m_events; ++i)
+    {
+        Simulator::ScheduleWithContext(context, Time(0), &InjectionBench::Receive, this);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_pushNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void
+InjectionBench::Start()
+{
+    for (uint32_t i = 0; i < m_producers; ++i)
+    {
+        m_threads.emplace_back(&InjectionBench::Produce, this, i);
+    }
+    Poll();
+}
+
+void
+InjectionBench::Poll()
+{
+    if (m_received < m_producers * m_events)
+    {
+        Simulator::Schedule(NanoSeconds(1), &InjectionBench::Poll, this);
+    }
+}
+
+void
+InjectionBench::Receive()
+{
+    ++m_received;
+}
+
+InjectionBench::Result
+InjectionBench::Run()
+{
+    m_received = 0;
+    m_pushNs = 0;
+    Simulator::Schedule(Time(0), &InjectionBench::Start, this);
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+    Simulator::Destroy();
+
+    return Result{static_cast<double>(m_pushNs) / (m_producers * m_events), wall.count()};
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t producers = 4;
+    uint64_t events = 1000000;
+    uint32_t runs = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark Simulator::ScheduleWithContext() from several producer threads.\n"
+              "\n"
+              "Each producer thread schedules its events with no delay while\n"
+              "the main thread runs the simulation.  The table gives the mean\n"
+              "time of a call in the producers, and the rate at which the main\n"
+              "thread ran the injected events.");
+    cmd.AddValue("producers", "number of producer threads", producers);
+    cmd.AddValue("events", "number of events of each producer", events);
+    cmd.AddValue("runs", "number of runs", runs);
+    cmd.Parse(argc, argv);
+
+    LOG("Benchmark ScheduleWithContext() from other threads");
+    LOG("  Producer threads:     " << producers);
+    LOG("  Events per producer:  " << events);
+    LOG("  Hardware threads:     " << std::thread::hardware_concurrency());
+    LOG("");
+    LOG(std::left << std::setw(6) << "Run" << std::setw(16) << "Push (ns/ev)" << std::setw(12)
+                  << "Wall (s)"
+                  << "Rate (ev/s)");
+
+    double push = 0;
+    double wall = 0;
+    for (uint32_t run = 0; run < runs; ++run)
+    {
+        InjectionBench::Result r = InjectionBench(producers, events).Run();
+        LOG(std::left << std::setw(6) << run << std::setw(16) << r.push << std::setw(12) << r.wall
+                      << producers * events / r.wall);
+        push += r.push;
+        wall += r.wall;
+    }
+    LOG(std::left << std::setw(6) << "Avg" << std::setw(16) << push / runs << std::setw(12)
+                  << wall / runs << producers * events * runs / wall);
+
+    return 0;
+}
@@ -18,12 +18,16 @@
  */
 
 #include "ns3/core-module.h"
+#include "ns3/event-trace-recorder.h"
 
 #include <cmath> // sqrt
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <string.h>
+#include <unordered_set>
 #include <vector>
 
 using namespace ns3;
@@ -47,6 +51,54 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Flag to count the heap allocations. */
+bool g_allocs = false;
+/** Number of heap allocations, counted while g_allocs is set. */
+uint64_t g_heapAllocs = 0;
+
+/**
+ * Count the heap allocations of the whole program, for the \c --allocs mode.
+ * \param [in] size The size of the allocation.
+ * \returns The memory.
+ */
+void*
+operator new(std::size_t size)
+{
+    if (g_allocs)
+    {
+        ++g_heapAllocs;
+    }
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// The deallocation functions are kept out of line: inlined, GCC sees
+// std::free() on memory from operator new and warns of a mismatch.
+
+/**
+ * Release memory from the counting operator new.
+ * \param [in] p The memory.
+ */
+__attribute__((noinline)) void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Release memory from the counting operator new.
+ * \param [in] p The memory.
+ */
+__attribute__((noinline)) void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    std::free(p);
+}
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -100,13 +152,24 @@ class Bench
         m_total = total;
     }
 
+    /**
+     * Set the scheduler of every run.
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
+     */
+    void SetScheduler(const ObjectFactory& factory)
+    {
+        m_factory = factory;
+    }
+
     /** The output. */
     struct Result
     {
-        double init;     /**< Time (s) for initialization. */
-        double simu;     /**< Time (s) for simulation. */
-        uint64_t pop;    /**< Event population. */
-        uint64_t events; /**< Number of events executed. */
+        double init;          /**< Time (s) for initialization. */
+        double simu;          /**< Time (s) for simulation. */
+        uint64_t pop;         /**< Event population. */
+        uint64_t events;      /**< Number of events executed. */
+        uint64_t heapAllocs;  /**< Heap allocations during the simulation. */
+        uint64_t eventAllocs; /**< EventImpl allocations during the simulation. */
     };
 
     /**
@@ -127,6 +190,7 @@ class Bench
     uint64_t m_population;            /**< Event population size. */
     uint64_t m_total;                 /**< Total number of events to execute. */
     uint64_t m_count;                 /**< Count of events executed so far. */
+    ObjectFactory m_factory;          /**< Factory of the scheduler. */
 
 }; // class Bench
 
@@ -139,6 +203,8 @@ Bench::Run()
 
     DEB("initializing");
     m_count = 0;
+    // Simulator::Destroy() forgets the scheduler of the previous run
+    Simulator::SetScheduler(m_factory);
 
     timer.Start();
     for (uint64_t i = 0; i < m_population; ++i)
@@ -150,14 +216,18 @@ Bench::Run()
     DEB("initialization took " << init << "s");
 
     DEB("running");
+    uint64_t heapAllocs = g_heapAllocs;
+    uint64_t eventAllocs = EventImpl::GetPoolStats().allocations;
     timer.Start();
     Simulator::Run();
     simu = timer.End() / 1000.0;
+    heapAllocs = g_heapAllocs - heapAllocs;
+    eventAllocs = EventImpl::GetPoolStats().allocations - eventAllocs;
     DEB("run took " << simu << "s");
 
     Simulator::Destroy();
 
-    return Result{init, simu, m_population, m_count};
+    return Result{init, simu, m_population, m_count, heapAllocs, eventAllocs};
 }
 
 void
@@ -221,6 +291,8 @@ class BenchSuite
     {
         PhaseResult init; /**< Initialization phase results. */
         PhaseResult run;  /**< Run (simulation) phase results. */
+        double heap;      /**< Heap allocations per event in the run phase. */
+        double events;    /**< EventImpl allocations per event in the run phase. */
         /**
          * Construct from the individual run result.
          *
@@ -249,7 +321,9 @@ BenchSuite::Result
 BenchSuite::Result::Bench(Bench::Result r)
 {
     return Result{{r.init, r.pop / r.init, r.init / r.pop},
-                  {r.simu, r.events / r.simu, r.simu / r.events}};
+                  {r.simu, r.events / r.simu, r.simu / r.events},
+                  static_cast<double>(r.heapAllocs) / r.events,
+                  static_cast<double>(r.eventAllocs) / r.events};
 }
 
 template <typename T>
@@ -258,10 +332,15 @@ BenchSuite::Result::Log(T label) const
 {
     // Need std::left for string labels
 
-    LOG(std::left << std::setw(g_fwidth) << label << std::setw(g_fwidth) << init.time
-                  << std::setw(g_fwidth) << init.rate << std::setw(g_fwidth) << init.period
-                  << std::setw(g_fwidth) << run.time << std::setw(g_fwidth) << run.rate
-                  << std::setw(g_fwidth) << run.period);
+    std::cout << std::left << std::setw(g_fwidth) << label << std::setw(g_fwidth) << init.time
+              << std::setw(g_fwidth) << init.rate << std::setw(g_fwidth) << init.period
+              << std::setw(g_fwidth) << run.time << std::setw(g_fwidth) << run.rate
+              << std::setw(g_fwidth) << run.period;
+    if (g_allocs)
+    {
+        std::cout << std::setw(g_fwidth) << heap << std::setw(g_fwidth) << events;
+    }
+    std::cout << std::endl;
 }
 
 BenchSuite::BenchSuite(ObjectFactory& factory,
@@ -271,8 +350,6 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
                        Ptr<RandomVariableStream> eventStream,
                        bool calRev)
 {
-    Simulator::SetScheduler(factory);
-
     m_scheduler = factory.GetTypeId().GetName();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
@@ -284,6 +361,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     }
 
     Bench bench(pop, total);
+    bench.SetScheduler(factory);
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
     bench.SetTotal(total);
@@ -320,12 +398,16 @@ BenchSuite::Header() const
                   << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
                   << std::setw(g_fwidth) << "Per (s/ev)" << std::left << std::setw(g_fwidth)
                   << "Time (s)" << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
-                  << "Per (s/ev)");
+                  << std::setw(g_fwidth) << "Per (s/ev)" << std::left << std::setw(g_fwidth)
+                  << (g_allocs ? "Heap/ev" : "") << std::left << (g_allocs ? "Events/ev" : ""));
     LOG(std::setfill('-') << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
                           << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
-                          << std::right << std::setw(g_fwidth) << " " << std::setfill(' '));
+                          << std::right << std::setw(g_fwidth) << " " << std::right
+                          << std::setw(g_allocs ? g_fwidth : 0) << (g_allocs ? " " : "")
+                          << std::right << std::setw(g_allocs ? g_fwidth : 0)
+                          << (g_allocs ? " " : "") << std::setfill(' '));
 }
 
 void
@@ -345,8 +427,10 @@ BenchSuite::Log() const
 
     uint64_t n{0};                // number of samples
     Result average{m_results[0]}; // average
-    Result moment2{{0, 0, 0},     // 2nd moment, to calculate stdev
-                   {0, 0, 0}};
+    Result moment2{{0, 0, 0}, // 2nd moment, to calculate stdev
+                   {0, 0, 0},
+                   0,
+                   0};
 
     for (; n < m_results.size(); ++n)
     {
@@ -369,6 +453,13 @@ BenchSuite::Log() const
         ACCUMULATE(run, period);
 
 #undef ACCUMULATE
+
+        deltaPre = run.heap - average.heap;
+        average.heap += deltaPre / count;
+        moment2.heap += deltaPre * (run.heap - average.heap);
+        deltaPre = run.events - average.events;
+        average.events += deltaPre / count;
+        moment2.events += deltaPre * (run.events - average.events);
     }
 
     auto stdev = Result{{std::sqrt(moment2.init.time / n),
@@ -376,7 +467,9 @@ BenchSuite::Log() const
                          std::sqrt(moment2.init.period / n)},
                         {std::sqrt(moment2.run.time / n),
                          std::sqrt(moment2.run.rate / n),
-                         std::sqrt(moment2.run.period / n)}};
+                         std::sqrt(moment2.run.period / n)},
+                        std::sqrt(moment2.heap / n),
+                        std::sqrt(moment2.events / n)};
 
     average.Log("average");
     stdev.Log("stdev");
@@ -385,6 +478,180 @@ BenchSuite::Log() const
 
 } // BenchSuite::Log()
 
+/**
+ *  Replay of an event trace recorded by DefaultSimulatorImpl.
+ *
+ *  The operations of the trace are applied to a scheduler directly, without
+ *  a simulator or events to invoke, so the time measured is the time spent
+ *  in the scheduler.
+ */
+class ReplaySuite
+{
+  public:
+    /**
+     * Perform the replays for a single scheduler type.
+     *
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
+     * \param [in] trace The event trace.
+     * \param [in] runs The number of replications.
+     */
+    ReplaySuite(ObjectFactory& factory, const std::vector<EventTraceRecord>& trace, uint64_t runs);
+
+    /** Write the results to \c LOG() */
+    void Log() const;
+
+  private:
+    /**
+     * Replay the trace once.
+     *
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
+     * \param [in] trace The event trace.
+     * \returns The replay time (s).
+     */
+    double Replay(ObjectFactory& factory, const std::vector<EventTraceRecord>& trace);
+
+    std::string m_scheduler;     /**< Descriptive string for the scheduler. */
+    uint64_t m_operations;       /**< Number of records of the trace. */
+    uint64_t m_peak;             /**< Peak number of events in the scheduler. */
+    uint64_t m_mismatches;       /**< Events executed out of the recorded order. */
+    std::vector<double> m_times; /**< Replay times (s). */
+};
+
+ReplaySuite::ReplaySuite(ObjectFactory& factory,
+                         const std::vector<EventTraceRecord>& trace,
+                         uint64_t runs)
+    : m_scheduler(factory.GetTypeId().GetName()),
+      m_operations(trace.size()),
+      m_peak(0),
+      m_mismatches(0)
+{
+    LOG("");
+    LOG(m_scheduler);
+    LOG(std::left << std::setw(g_fwidth) << "Run #" << std::setw(g_fwidth) << "Time (s)"
+                  << std::setw(g_fwidth) << "Rate (op/s)" << "Per (s/op)");
+
+    // Prime
+    Replay(factory, trace);
+    for (uint64_t i = 0; i < runs; i++)
+    {
+        m_times.push_back(Replay(factory, trace));
+        LOG(std::left << std::setw(g_fwidth) << i << std::setw(g_fwidth) << m_times.back()
+                      << std::setw(g_fwidth) << m_operations / m_times.back()
+                      << m_times.back() / m_operations);
+    }
+}
+
+double
+ReplaySuite::Replay(ObjectFactory& factory, const std::vector<EventTraceRecord>& trace)
+{
+    Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+    std::unordered_set<uint32_t> cancelled;
+    uint64_t size = 0;
+    m_peak = 0;
+    m_mismatches = 0;
+
+    SystemWallClockMs timer;
+    timer.Start();
+    for (const auto& record : trace)
+    {
+        Scheduler::Event ev{nullptr, {record.ts, record.uid, record.context}};
+        switch (record.type)
+        {
+        case EventTraceRecord::INSERT:
+            scheduler->Insert(ev);
+            m_peak = std::max(m_peak, ++size);
+            break;
+        case EventTraceRecord::EXECUTE: {
+            Scheduler::Event next = scheduler->RemoveNext();
+            --size;
+            if (next.key.m_uid != record.uid)
+            {
+                ++m_mismatches;
+            }
+            cancelled.erase(next.key.m_uid);
+            break;
+        }
+        case EventTraceRecord::CANCEL:
+            cancelled.insert(record.uid);
+            break;
+        case EventTraceRecord::REMOVE:
+            scheduler->Remove(ev);
+            --size;
+            break;
+        case EventTraceRecord::COMPACT: {
+            // Into a fresh scheduler, as DefaultSimulatorImpl::Compact() does.
+            Ptr<Scheduler> compacted = factory.Create<Scheduler>();
+            size = 0;
+            while (!scheduler->IsEmpty())
+            {
+                Scheduler::Event next = scheduler->RemoveNext();
+                if (cancelled.count(next.key.m_uid) == 0)
+                {
+                    compacted->Insert(next);
+                    ++size;
+                }
+            }
+            scheduler = compacted;
+            cancelled.clear();
+            break;
+        }
+        }
+    }
+    return timer.End() / 1000.0;
+}
+
+void
+ReplaySuite::Log() const
+{
+    LOG("  Operations: " << m_operations << ", peak events: " << m_peak);
+    if (m_mismatches > 0)
+    {
+        LOG("  " << m_mismatches << " events executed out of the recorded order");
+    }
+    if (m_times.size() < 2)
+    {
+        LOG("");
+        return;
+    }
+
+    double average = 0;
+    for (double time : m_times)
+    {
+        average += time / m_times.size();
+    }
+    double moment2 = 0;
+    for (double time : m_times)
+    {
+        moment2 += (time - average) * (time - average);
+    }
+    double stdev = std::sqrt(moment2 / m_times.size());
+    LOG(std::left << std::setw(g_fwidth) << "average" << std::setw(g_fwidth) << average
+                  << std::setw(g_fwidth) << m_operations / average << average / m_operations);
+    LOG(std::left << std::setw(g_fwidth) << "stdev" << std::setw(g_fwidth) << stdev);
+    LOG("");
+}
+
+/**
+ *  Read an event trace.
+ *
+ *  \param [in] filename The trace file name.
+ *  \returns The records of the trace.
+ */
+std::vector<EventTraceRecord>
+ReadTrace(std::string filename)
+{
+    LOG("  Event trace:                  " << filename);
+    EventTraceReader reader(filename);
+    std::vector<EventTraceRecord> trace;
+    EventTraceRecord record;
+    while (reader.Next(record))
+    {
+        trace.push_back(record);
+    }
+    LOG("    Found " << trace.size() << " records");
+    return trace;
+}
+
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
@@ -458,11 +725,14 @@ main(int argc, char* argv[])
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
+    bool schedQuad = false;
 
     uint64_t pop = 100000;
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string replay = "";
+    std::string schedulerType = "";
     bool calRev = false;
 
     CommandLine cmd(__FILE__);
@@ -475,7 +745,16 @@ main(int argc, char* argv[])
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
-              "If no scheduler is specified the MapScheduler will be run.");
+              "If no scheduler is specified the MapScheduler will be run.\n"
+              "\n"
+              "With --allocs the heap allocations and the EventImpl\n"
+              "allocations per executed event are added to the table:\n"
+              "with the event pool the heap allocations are the ones\n"
+              "of the scheduler itself.\n"
+              "\n"
+              "With --replay=\"<filename>\" the schedulers are fed with an\n"
+              "event trace recorded by a simulation with\n"
+              "--ns3::DefaultSimulatorImpl::EventTraceFile=\"<filename>\".");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarSheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
@@ -483,12 +762,16 @@ main(int argc, char* argv[])
     cmd.AddValue("list", "use ListSheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
+    cmd.AddValue("quad", "use QuaternaryHeapScheduler", schedQuad);
+    cmd.AddValue("scheduler", "use the Scheduler of this TypeId only", schedulerType);
+    cmd.AddValue("replay", "replay the event trace in this file", replay);
     cmd.AddValue("debug", "enable debugging output", g_debug);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
+    cmd.AddValue("allocs", "count the allocations per event", g_allocs);
     cmd.Parse(argc, argv);
 
     g_me = cmd.GetName() + ": ";
@@ -503,53 +786,85 @@ main(int argc, char* argv[])
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedList = schedMap = schedPQ = schedQuad = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ || schedQuad))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    Ptr<RandomVariableStream> eventStream;
+    std::vector<EventTraceRecord> trace;
+    if (replay.empty())
+    {
+        eventStream = GetRandomStream(filename);
+    }
+    else
+    {
+        trace = ReadTrace(replay);
+    }
+
+    // Benchmark or replay with one scheduler
+    auto bench = [&](ObjectFactory& factory, uint64_t events, bool reverse) {
+        if (replay.empty())
+        {
+            BenchSuite(factory, pop, events, runs, eventStream, reverse).Log();
+        }
+        else
+        {
+            ReplaySuite(factory, trace, runs).Log();
+        }
+    };
 
     ObjectFactory factory("ns3::MapScheduler");
+    if (!schedulerType.empty())
+    {
+        factory.SetTypeId(schedulerType);
+        bench(factory, total, calRev);
+        return 0;
+    }
     if (schedCal)
     {
         factory.SetTypeId("ns3::CalendarScheduler");
         factory.Set("Reverse", BooleanValue(calRev));
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        bench(factory, total, calRev);
         if (allSched)
         {
             factory.Set("Reverse", BooleanValue(!calRev));
-            BenchSuite(factory, pop, total, runs, eventStream, !calRev).Log();
+            bench(factory, total, !calRev);
         }
     }
     if (schedHeap)
     {
         factory.SetTypeId("ns3::HeapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        bench(factory, total, calRev);
     }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
         auto listTotal = total;
-        if (allSched)
+        if (allSched && replay.empty())
         {
             LOG("Running List scheduler with 1/10 total events");
             listTotal /= 10;
         }
-        BenchSuite(factory, pop, listTotal, runs, eventStream, calRev).Log();
+        bench(factory, listTotal, calRev);
     }
     if (schedMap)
     {
         factory.SetTypeId("ns3::MapScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        bench(factory, total, calRev);
     }
     if (schedPQ)
     {
         factory.SetTypeId("ns3::PriorityQueueScheduler");
-        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+        bench(factory, total, calRev);
+    }
+    if (schedQuad)
+    {
+        factory.SetTypeId("ns3::QuaternaryHeapScheduler");
+        bench(factory, total, calRev);
     }
 
     return 0;
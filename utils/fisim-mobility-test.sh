@@ -34,13 +34,13 @@ function RunSimulation {
           sed -i 's/option(FISIM_NAME_FIRST_ROUTING "Use FISIM Name First Routing" OFF)/option(FISIM_NAME_FIRST_ROUTING "Use FISIM Name First Routing" ON)/g' CMakeLists.txt
           ./ns3 configure --disable-examples --disable-tests --disable-python --disable-mpi
           ./ns3 build
-          ./ns3 run scratch/mobility_test.cc -- --outpath="$OUTPUT_DIR_ON" --random_seed=177
+          ./ns3 run --no-build "fisim-sweep --sweep=utils/sweeps/fisim-mobility.yaml --output=$OUTPUT_DIR_ON --seed=177"
      else
           echo "******* 2 - Run the simulation with ID First Routing OFF *******\n"
           sed -i 's/option(FISIM_NAME_FIRST_ROUTING "Use FISIM Name First Routing" ON)/option(FISIM_NAME_FIRST_ROUTING "Use FISIM Name First Routing" OFF)/g' CMakeLists.txt
           ./ns3 configure --disable-examples --disable-tests --disable-python --disable-mpi
           ./ns3 build
-         ./ns3 run scratch/mobility_test.cc -- --outpath="$OUTPUT_DIR_OFF" --random_seed=147
+         ./ns3 run --no-build "fisim-sweep --sweep=utils/sweeps/fisim-mobility.yaml --output=$OUTPUT_DIR_OFF"
      fi
 }
 
@@ -64,7 +64,7 @@ import matplotlib.pyplot as plt
 time_interval = 0.07
 
 #first process the results with ID First Routing off
-output_dir_off = "/tmp/mobility-test/Routing_Off"
+output_dir_off = "/tmp/mobility-test/Routing_Off/run-0"
 df_off_1 = pd.read_csv(output_dir_off + "/receiver_2.log", sep=",")
 df_off_2 = pd.read_csv(output_dir_off + "/receiver_3.log", sep=",")
 df_off = pd.concat([df_off_1, df_off_2], ignore_index=True)
@@ -72,7 +72,7 @@ print(df_off)
 df_off_plt = df_off.groupby(pd.cut(df_off["time"], bins=pd.interval_range(start=0, end=df_off["time"].max(), freq=time_interval)))["packet_size"].sum().reset_index()
 
 #then process the results with ID First Routing on
-output_dir_on = "/tmp/mobility-test/Routing_On"
+output_dir_on = "/tmp/mobility-test/Routing_On/run-0"
 df_on_1 = pd.read_csv(output_dir_on + "/receiver_2.log", sep=",")
 df_on_2 = pd.read_csv(output_dir_on + "/receiver_3.log", sep=",")
 df_on = pd.concat([df_on_1, df_on_2], ignore_index=True)
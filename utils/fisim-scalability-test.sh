@@ -1,8 +1,6 @@
 #!/bin/bash
 
 outpath="/tmp/scalability-test/"
-coreCloudNodeVector=(1 4 8 12 16 20 24 28 32)
-#coreCloudNodeVector=(1 4 8)
 
 ################## STEP [0] ##################
 echo "===================== FISIM Scalability TEST =====================\n"
@@ -12,8 +10,7 @@ cd ../
 mkdir -p $outpath
 ./ns3 build
 
-for coreCloudNode in ${coreCloudNodeVector[@]}; do
-    echo "coreCloudNode: $coreCloudNode"
-    # Run the simulation
-    ./ns3 run scratch/scalability_test.cc -- --outpath="$outpath" --coreCloudNodeNum=$coreCloudNode
-done
+# Run the simulations on all cores, see utils/sweeps/fisim-scalability.yaml
+# for the core cloud node counts. The per-run statistics are merged into
+# $outpath/results.csv.
+./ns3 run --no-build "fisim-sweep --sweep=utils/sweeps/fisim-scalability.yaml --output=$outpath"
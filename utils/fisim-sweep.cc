@@ -0,0 +1,740 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * Parallel parameter sweep runner for FISim simulations.
+ *
+ * A sweep file describes the program to run, a grid of parameters and the
+ * YAML files the parameters apply to:
+ *
+ * \code
+ *   program: build/future-arch/Cybertwin/ctsim/ns3*-cybertwin*
+ *   args: ["--config={system_config}", "--headless"]
+ *   output: /tmp/fisim-sweep
+ *   jobs: 0                  # 0: one per core
+ *   replications: 3
+ *   seed: 1
+ *   metrics: "*.csv"         # per-run CSV files merged into the results
+ *   files:
+ *     topology: future-arch/Cybertwin/topology-generated.yaml
+ *     system_config: future-arch/system-config.yaml
+ *   set:
+ *     system_config:simulation.topology: "{topology}"
+ *     system_config:simulation.seed: "{seed}"
+ *   parameters:
+ *     - name: k
+ *       values: [4, 6, 8]
+ *       set: [topology:cybertwin_network.core_layer.generate.0.k]
+ * \endcode
+ *
+ * Every point of the grid is run `replications` times. Each run gets its
+ * own directory, `<output>/run-<index>`, with a copy of every file of
+ * `files` where the parameters are set, at the `set` paths given as
+ * `<file>:<key>.<key>.<sequence index>`. The `set` map of the sweep sets
+ * fixed values the same way.
+ *
+ * The program, its arguments and every string of the copied files can use
+ * the placeholders `{<parameter name>}`, `{<file name>}` (the path of the
+ * copy), `{run_dir}`, `{point}`, `{replication}`, `{seed}` (the base seed
+ * plus the replication) and `{run}` (the replication, starting at 1).
+ *
+ * Runs are forked from a work queue, at most `jobs` at a time, with their
+ * output in `stdout.log` and `stderr.log` of the run directory. When all
+ * runs are done, the rows of the `metrics` CSV files of each run are
+ * merged into `<output>/results.csv`, after the columns of the run: index,
+ * point, replication, seed, parameters, exit status, wall clock time and
+ * peak resident memory.
+ */
+
+#include "ns3/command-line.h"
+
+#include "yaml-cpp/yaml.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <glob.h>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/** Abort with a message */
+#define FAIL(x)                                                                                    \
+    do                                                                                             \
+    {                                                                                              \
+        std::cerr << "fisim-sweep: " << x << std::endl;                                            \
+        std::exit(1);                                                                              \
+    } while (false)
+
+namespace
+{
+
+/** A swept parameter */
+struct Parameter
+{
+    std::string name;                //!< placeholder name
+    std::vector<YAML::Node> values;  //!< values of the grid
+    std::vector<std::string> set;    //!< `<file>:<path>` targets
+};
+
+/** A sweep description */
+struct Sweep
+{
+    std::string program;                       //!< program to run
+    std::vector<std::string> args;             //!< program arguments
+    std::string output;                        //!< output directory
+    uint32_t jobs{0};                          //!< concurrent runs, 0 for one per core
+    uint32_t replications{1};                  //!< runs per grid point
+    uint64_t seed{1};                          //!< base seed
+    std::string metrics;                       //!< per-run metrics files pattern
+    std::vector<std::pair<std::string, std::string>> files; //!< name, source
+    std::vector<std::pair<std::string, std::string>> overrides; //!< `<file>:<path>`, value
+    std::vector<Parameter> parameters;         //!< the grid
+};
+
+/** A run of the sweep */
+struct Run
+{
+    uint32_t index;                                //!< run index
+    uint32_t point;                                //!< grid point
+    uint32_t replication;                          //!< replication of the point
+    std::map<std::string, std::string> variables;  //!< placeholders
+    std::vector<std::string> values;               //!< parameter values, in grid order
+    std::string dir;                               //!< run directory
+    pid_t pid{-1};                                 //!< process, while running
+    std::chrono::steady_clock::time_point start;   //!< start time
+    int status{-1};                                //!< exit status, -1 if killed
+    double wallTime{0};                            //!< wall clock time, seconds
+    long maxRss{0};                                //!< peak resident memory, KB
+};
+
+/** Text of a scalar or the flow form of a collection */
+std::string
+ToString(const YAML::Node& node)
+{
+    if (node.IsScalar())
+    {
+        return node.Scalar();
+    }
+    YAML::Emitter out;
+    out << YAML::Flow << node;
+    return out.c_str();
+}
+
+/** Replace the `{name}` placeholders of a string */
+std::string
+Expand(const std::string& text, const std::map<std::string, std::string>& variables)
+{
+    std::string result;
+    std::size_t pos = 0;
+    while (pos < text.size())
+    {
+        std::size_t open = text.find('{', pos);
+        std::size_t close = open == std::string::npos ? open : text.find('}', open);
+        if (close == std::string::npos)
+        {
+            result.append(text, pos, std::string::npos);
+            break;
+        }
+        auto it = variables.find(text.substr(open + 1, close - open - 1));
+        result.append(text, pos, open - pos);
+        if (it != variables.end())
+        {
+            result += it->second;
+        }
+        else
+        {
+            // not a placeholder, a YAML flow collection for instance
+            result.append(text, open, close - open + 1);
+        }
+        pos = close + 1;
+    }
+    return result;
+}
+
+/** Replace the placeholders of every string of a document */
+void
+ExpandNode(YAML::Node node, const std::map<std::string, std::string>& variables)
+{
+    if (node.IsScalar())
+    {
+        std::string expanded = Expand(node.Scalar(), variables);
+        if (expanded != node.Scalar())
+        {
+            node = expanded;
+        }
+    }
+    else if (node.IsSequence())
+    {
+        for (std::size_t i = 0; i < node.size(); i++)
+        {
+            ExpandNode(node[i], variables);
+        }
+    }
+    else if (node.IsMap())
+    {
+        for (auto it = node.begin(); it != node.end(); ++it)
+        {
+            ExpandNode(it->second, variables);
+        }
+    }
+}
+
+/** Set a value at a `key.key.index` path of a document */
+void
+SetPath(YAML::Node root, const std::string& path, const YAML::Node& value)
+{
+    YAML::Node node;
+    node.reset(root);
+    std::istringstream components(path);
+    std::string component;
+    std::vector<std::string> keys;
+    while (std::getline(components, component, '.'))
+    {
+        keys.push_back(component);
+    }
+    for (std::size_t k = 0; k < keys.size(); k++)
+    {
+        YAML::Node child;
+        if (node.IsSequence())
+        {
+            char* end = nullptr;
+            unsigned long index = std::strtoul(keys[k].c_str(), &end, 10);
+            if (*end != '\0' || index >= node.size())
+            {
+                FAIL("Bad sequence index " << keys[k] << " in " << path);
+            }
+            child.reset(node[index]);
+        }
+        else
+        {
+            child.reset(node[keys[k]]);
+        }
+
+        if (k + 1 == keys.size())
+        {
+            child = YAML::Clone(value);
+        }
+        node.reset(child);
+    }
+}
+
+/** Create a directory and its parents */
+void
+MakeDirectories(const std::string& path)
+{
+    std::string partial;
+    std::istringstream components(path);
+    std::string component;
+    if (!path.empty() && path[0] == '/')
+    {
+        partial = "/";
+    }
+    while (std::getline(components, component, '/'))
+    {
+        if (component.empty())
+        {
+            continue;
+        }
+        partial += component + "/";
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            FAIL("Cannot create " << partial << ": " << std::strerror(errno));
+        }
+    }
+}
+
+/** Paths matching a glob pattern, sorted */
+std::vector<std::string>
+Glob(const std::string& pattern)
+{
+    std::vector<std::string> paths;
+    glob_t matches;
+    if (glob(pattern.c_str(), 0, nullptr, &matches) == 0)
+    {
+        for (std::size_t i = 0; i < matches.gl_pathc; i++)
+        {
+            paths.emplace_back(matches.gl_pathv[i]);
+        }
+    }
+    globfree(&matches);
+    return paths;
+}
+
+/** Split a CSV line */
+std::vector<std::string>
+SplitCsv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::istringstream in(line);
+    std::string field;
+    while (std::getline(in, field, ','))
+    {
+        fields.push_back(field);
+    }
+    if (!line.empty() && line.back() == ',')
+    {
+        fields.emplace_back();
+    }
+    return fields;
+}
+
+Sweep
+LoadSweep(const std::string& file)
+{
+    YAML::Node spec;
+    try
+    {
+        spec = YAML::LoadFile(file);
+    }
+    catch (const YAML::Exception& e)
+    {
+        FAIL("Cannot load " << file << ": " << e.what());
+    }
+
+    Sweep sweep;
+    if (!spec["program"])
+    {
+        FAIL("No program in " << file);
+    }
+    sweep.program = spec["program"].as<std::string>();
+    for (const auto& arg : spec["args"])
+    {
+        sweep.args.push_back(arg.as<std::string>());
+    }
+    sweep.output = spec["output"] ? spec["output"].as<std::string>() : "/tmp/fisim-sweep";
+    sweep.jobs = spec["jobs"] ? spec["jobs"].as<uint32_t>() : 0;
+    sweep.replications = spec["replications"] ? spec["replications"].as<uint32_t>() : 1;
+    sweep.seed = spec["seed"] ? spec["seed"].as<uint64_t>() : 1;
+    sweep.metrics = spec["metrics"] ? spec["metrics"].as<std::string>() : "";
+    for (const auto& f : spec["files"])
+    {
+        sweep.files.emplace_back(f.first.as<std::string>(), f.second.as<std::string>());
+    }
+    for (const auto& o : spec["set"])
+    {
+        sweep.overrides.emplace_back(o.first.as<std::string>(), ToString(o.second));
+    }
+    for (const auto& p : spec["parameters"])
+    {
+        Parameter parameter;
+        parameter.name = p["name"].as<std::string>();
+        for (const auto& v : p["values"])
+        {
+            parameter.values.push_back(v);
+        }
+        if (p["set"] && p["set"].IsScalar())
+        {
+            parameter.set.push_back(p["set"].as<std::string>());
+        }
+        else
+        {
+            for (const auto& s : p["set"])
+            {
+                parameter.set.push_back(s.as<std::string>());
+            }
+        }
+        if (parameter.values.empty())
+        {
+            FAIL("No values for parameter " << parameter.name);
+        }
+        sweep.parameters.push_back(parameter);
+    }
+    return sweep;
+}
+
+/** Enumerate the runs, the last parameter varies fastest */
+std::vector<Run>
+PlanRuns(const Sweep& sweep)
+{
+    uint32_t points = 1;
+    for (const auto& parameter : sweep.parameters)
+    {
+        points *= parameter.values.size();
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(points * sweep.replications);
+    for (uint32_t point = 0; point < points; point++)
+    {
+        for (uint32_t replication = 0; replication < sweep.replications; replication++)
+        {
+            Run run;
+            run.index = runs.size();
+            run.point = point;
+            run.replication = replication;
+            run.dir = sweep.output + "/run-" + std::to_string(run.index);
+            run.variables["run_dir"] = run.dir;
+            run.variables["point"] = std::to_string(point);
+            run.variables["replication"] = std::to_string(replication);
+            run.variables["seed"] = std::to_string(sweep.seed + replication);
+            run.variables["run"] = std::to_string(replication + 1);
+            for (const auto& file : sweep.files)
+            {
+                std::string base = file.second.substr(file.second.find_last_of('/') + 1);
+                run.variables[file.first] = run.dir + "/" + base;
+            }
+
+            uint32_t rest = point;
+            run.values.resize(sweep.parameters.size());
+            for (std::size_t p = sweep.parameters.size(); p-- > 0;)
+            {
+                const Parameter& parameter = sweep.parameters[p];
+                run.values[p] =
+                    Expand(ToString(parameter.values[rest % parameter.values.size()]), run.variables);
+                rest /= parameter.values.size();
+            }
+            for (std::size_t p = 0; p < sweep.parameters.size(); p++)
+            {
+                run.variables[sweep.parameters[p].name] = run.values[p];
+            }
+            runs.push_back(run);
+        }
+    }
+    return runs;
+}
+
+/** Write the run directory and the copies of the swept files */
+void
+PrepareRun(const Sweep& sweep, const Run& run)
+{
+    MakeDirectories(run.dir);
+    for (const auto& file : sweep.files)
+    {
+        YAML::Node document;
+        try
+        {
+            document = YAML::LoadFile(file.second);
+        }
+        catch (const YAML::Exception& e)
+        {
+            FAIL("Cannot load " << file.second << ": " << e.what());
+        }
+        std::vector<std::pair<std::string, std::string>> targets = sweep.overrides;
+        for (std::size_t p = 0; p < sweep.parameters.size(); p++)
+        {
+            for (const auto& target : sweep.parameters[p].set)
+            {
+                targets.emplace_back(target, run.values[p]);
+            }
+        }
+        for (const auto& target : targets)
+        {
+            std::size_t colon = target.first.find(':');
+            if (colon == std::string::npos)
+            {
+                FAIL("Bad target " << target.first << ", expected <file>:<path>");
+            }
+            if (target.first.substr(0, colon) == file.first)
+            {
+                SetPath(document,
+                        target.first.substr(colon + 1),
+                        YAML::Load(Expand(target.second, run.variables)));
+            }
+        }
+        ExpandNode(document, run.variables);
+
+        std::ofstream out(run.variables.at(file.first));
+        out << document << std::endl;
+        if (!out)
+        {
+            FAIL("Cannot write " << run.variables.at(file.first));
+        }
+    }
+}
+
+/** Fork a run, its output goes to the run directory */
+pid_t
+StartRun(const std::string& program, const Sweep& sweep, const Run& run)
+{
+    std::vector<std::string> args;
+    args.push_back(program);
+    for (const auto& arg : sweep.args)
+    {
+        args.push_back(Expand(arg, run.variables));
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        FAIL("fork: " << std::strerror(errno));
+    }
+    if (pid == 0)
+    {
+        if (!freopen((run.dir + "/stdout.log").c_str(), "w", stdout) ||
+            !freopen((run.dir + "/stderr.log").c_str(), "w", stderr))
+        {
+            _exit(127);
+        }
+        std::vector<char*> argv;
+        for (auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        std::perror("execv");
+        _exit(127);
+    }
+    return pid;
+}
+
+/** Run everything, keeping at most jobs runs alive */
+void
+Execute(const std::string& program, const Sweep& sweep, std::vector<Run>& runs, uint32_t jobs)
+{
+    std::size_t next = 0;
+    std::size_t done = 0;
+    std::map<pid_t, Run*> running;
+    auto begin = std::chrono::steady_clock::now();
+    while (done < runs.size())
+    {
+        while (running.size() < jobs && next < runs.size())
+        {
+            Run& run = runs[next++];
+            PrepareRun(sweep, run);
+            run.start = std::chrono::steady_clock::now();
+            run.pid = StartRun(program, sweep, run);
+            running[run.pid] = &run;
+        }
+
+        int status;
+        struct rusage usage;
+        pid_t pid = wait4(-1, &status, 0, &usage);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            FAIL("wait4: " << std::strerror(errno));
+        }
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            continue;
+        }
+        Run& run = *it->second;
+        running.erase(it);
+        done++;
+
+        std::chrono::duration<double> wall = std::chrono::steady_clock::now() - run.start;
+        run.wallTime = wall.count();
+        run.maxRss = usage.ru_maxrss;
+        run.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        LOG("[" << done << "/" << runs.size() << "] run " << run.index << " point " << run.point
+                << " replication " << run.replication << ": status " << run.status << ", "
+                << run.wallTime << " s, " << run.maxRss << " KB (" << elapsed.count()
+                << " s elapsed)");
+    }
+}
+
+/** Merge the metrics of every run into one table */
+void
+WriteResults(const Sweep& sweep, const std::vector<Run>& runs, const std::string& file)
+{
+    // metric columns, in order of first appearance
+    std::vector<std::string> columns;
+    std::map<std::string, std::size_t> columnIndex;
+    std::vector<std::pair<const Run*, std::vector<std::string>>> rows;
+    for (const auto& run : runs)
+    {
+        bool any = false;
+        if (!sweep.metrics.empty())
+        {
+            for (const auto& path : Glob(run.dir + "/" + sweep.metrics))
+            {
+                std::ifstream in(path);
+                std::string line;
+                if (!std::getline(in, line))
+                {
+                    continue;
+                }
+                std::vector<std::size_t> map;
+                for (const auto& name : SplitCsv(line))
+                {
+                    auto it = columnIndex.find(name);
+                    if (it == columnIndex.end())
+                    {
+                        it = columnIndex.emplace(name, columns.size()).first;
+                        columns.push_back(name);
+                    }
+                    map.push_back(it->second);
+                }
+                while (std::getline(in, line))
+                {
+                    if (line.empty())
+                    {
+                        continue;
+                    }
+                    std::vector<std::string> fields = SplitCsv(line);
+                    std::vector<std::string> row(columns.size());
+                    for (std::size_t f = 0; f < fields.size() && f < map.size(); f++)
+                    {
+                        row[map[f]] = fields[f];
+                    }
+                    rows.emplace_back(&run, row);
+                    any = true;
+                }
+            }
+        }
+        if (!any)
+        {
+            rows.emplace_back(&run, std::vector<std::string>());
+        }
+    }
+
+    std::ofstream out(file);
+    out << "index,point,replication,seed";
+    for (const auto& parameter : sweep.parameters)
+    {
+        out << "," << parameter.name;
+    }
+    out << ",status,wall_time_s,max_rss_kb";
+    for (const auto& column : columns)
+    {
+        out << "," << column;
+    }
+    out << "\n";
+    for (const auto& row : rows)
+    {
+        const Run& run = *row.first;
+        out << run.index << "," << run.point << "," << run.replication << ","
+            << run.variables.at("seed");
+        for (const auto& value : run.values)
+        {
+            out << "," << value;
+        }
+        out << "," << run.status << "," << run.wallTime << "," << run.maxRss;
+        for (std::size_t c = 0; c < columns.size(); c++)
+        {
+            out << "," << (c < row.second.size() ? row.second[c] : "");
+        }
+        out << "\n";
+    }
+    if (!out)
+    {
+        FAIL("Cannot write " << file);
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string spec;
+    std::string output;
+    std::string program;
+    uint32_t jobs = 0;
+    uint64_t seed = 0;
+    bool dryRun = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Run a FISim parameter sweep on all cores and merge the results.");
+    cmd.AddValue("sweep", "The sweep file", spec);
+    cmd.AddValue("output", "Override the output directory of the sweep", output);
+    cmd.AddValue("program", "Override the program of the sweep", program);
+    cmd.AddValue("jobs", "Override the number of concurrent runs", jobs);
+    cmd.AddValue("seed", "Override the base seed of the sweep", seed);
+    cmd.AddValue("dry-run", "Only print the runs", dryRun);
+    cmd.Parse(argc, argv);
+
+    if (spec.empty())
+    {
+        FAIL("No sweep file, see --help");
+    }
+    Sweep sweep = LoadSweep(spec);
+    if (!output.empty())
+    {
+        sweep.output = output;
+    }
+    if (!program.empty())
+    {
+        sweep.program = program;
+    }
+    if (jobs)
+    {
+        sweep.jobs = jobs;
+    }
+    if (seed)
+    {
+        sweep.seed = seed;
+    }
+    if (!sweep.jobs)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        sweep.jobs = cores > 0 ? cores : 1;
+    }
+
+    // the program may be a pattern, the build directory names carry the
+    // version and the build profile
+    std::vector<std::string> programs = Glob(sweep.program);
+    if (programs.size() != 1)
+    {
+        FAIL(programs.size() << " programs match " << sweep.program);
+    }
+
+    std::vector<Run> runs = PlanRuns(sweep);
+    LOG(runs.size() << " runs (" << runs.size() / sweep.replications << " points x "
+                    << sweep.replications << " replications) of " << programs[0] << " on "
+                    << sweep.jobs << " jobs");
+    if (dryRun)
+    {
+        for (const auto& run : runs)
+        {
+            std::ostringstream line;
+            line << run.dir << ":";
+            for (const auto& arg : sweep.args)
+            {
+                line << " " << Expand(arg, run.variables);
+            }
+            LOG(line.str());
+        }
+        return 0;
+    }
+
+    MakeDirectories(sweep.output);
+    Execute(programs[0], sweep, runs, sweep.jobs);
+
+    std::string results = sweep.output + "/results.csv";
+    WriteResults(sweep, runs, results);
+    LOG("Results written to " << results);
+
+    uint32_t failed = 0;
+    for (const auto& run : runs)
+    {
+        failed += run.status != 0;
+    }
+    if (failed)
+    {
+        LOG(failed << " runs failed, see the stderr.log of their run directory");
+    }
+    return failed ? 1 : 0;
+}